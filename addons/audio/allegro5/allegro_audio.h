@@ -132,9 +132,46 @@ enum ALLEGRO_MIXER_QUALITY
    ALLEGRO_MIXER_QUALITY_POINT   = 0x110,
    ALLEGRO_MIXER_QUALITY_LINEAR  = 0x111,
    ALLEGRO_MIXER_QUALITY_CUBIC   = 0x112
+#if defined(ALLEGRO_UNSTABLE) || defined(ALLEGRO_INTERNAL_UNSTABLE) || defined(ALLEGRO_KCM_AUDIO_SRC)
+   ,
+   ALLEGRO_MIXER_QUALITY_SINC    = 0x113
+#endif
+};
+
+
+#if defined(ALLEGRO_UNSTABLE) || defined(ALLEGRO_INTERNAL_UNSTABLE) || defined(ALLEGRO_KCM_AUDIO_SRC)
+/* Enum: ALLEGRO_MIXER_EFFECT_TYPE
+ */
+enum ALLEGRO_MIXER_EFFECT_TYPE
+{
+   ALLEGRO_MIXER_EFFECT_LOWPASS     = 0x120,
+   ALLEGRO_MIXER_EFFECT_HIGHPASS    = 0x121,
+   ALLEGRO_MIXER_EFFECT_PEAKING     = 0x122,
+   ALLEGRO_MIXER_EFFECT_LOW_SHELF   = 0x123,
+   ALLEGRO_MIXER_EFFECT_HIGH_SHELF  = 0x124,
+   ALLEGRO_MIXER_EFFECT_COMPRESSOR  = 0x125,
+   ALLEGRO_MIXER_EFFECT_DELAY       = 0x126
 };
 
 
+/* Enum: ALLEGRO_MIXER_EFFECT_PARAM
+ */
+enum ALLEGRO_MIXER_EFFECT_PARAM
+{
+   ALLEGRO_MIXER_EFFECT_FREQUENCY   = 0,
+   ALLEGRO_MIXER_EFFECT_Q           = 1,
+   ALLEGRO_MIXER_EFFECT_GAIN        = 2,
+   ALLEGRO_MIXER_EFFECT_THRESHOLD   = 3,
+   ALLEGRO_MIXER_EFFECT_RATIO       = 4,
+   ALLEGRO_MIXER_EFFECT_ATTACK      = 5,
+   ALLEGRO_MIXER_EFFECT_RELEASE     = 6,
+   ALLEGRO_MIXER_EFFECT_TIME        = 7,
+   ALLEGRO_MIXER_EFFECT_FEEDBACK    = 8,
+   ALLEGRO_MIXER_EFFECT_MIX         = 9
+};
+#endif
+
+
 /* Enum: ALLEGRO_AUDIO_PAN_NONE
  */
 #define ALLEGRO_AUDIO_PAN_NONE      (-1000.0f)
@@ -178,6 +215,26 @@ typedef struct ALLEGRO_VOICE ALLEGRO_VOICE;
 /* Type: ALLEGRO_AUDIO_RECORDER
  */
 typedef struct ALLEGRO_AUDIO_RECORDER ALLEGRO_AUDIO_RECORDER;
+
+/* Type: ALLEGRO_MIXER_EFFECT
+ */
+typedef struct ALLEGRO_MIXER_EFFECT ALLEGRO_MIXER_EFFECT;
+
+/* Type: ALLEGRO_AUDIO_STATS
+ */
+typedef struct ALLEGRO_AUDIO_STATS ALLEGRO_AUDIO_STATS;
+
+struct ALLEGRO_AUDIO_STATS
+{
+   uint64_t frames;
+   double read_time;
+   unsigned int underruns;
+   unsigned int late_fragments;
+   uint64_t fed_fragments;
+   double decode_time;
+   double mean_refill_latency;
+   double max_refill_latency;
+};
 #endif
 
 
@@ -186,6 +243,10 @@ typedef enum ALLEGRO_AUDIO_DEPTH ALLEGRO_AUDIO_DEPTH;
 typedef enum ALLEGRO_CHANNEL_CONF ALLEGRO_CHANNEL_CONF;
 typedef enum ALLEGRO_PLAYMODE ALLEGRO_PLAYMODE;
 typedef enum ALLEGRO_MIXER_QUALITY ALLEGRO_MIXER_QUALITY;
+#if defined(ALLEGRO_UNSTABLE) || defined(ALLEGRO_INTERNAL_UNSTABLE) || defined(ALLEGRO_KCM_AUDIO_SRC)
+typedef enum ALLEGRO_MIXER_EFFECT_TYPE ALLEGRO_MIXER_EFFECT_TYPE;
+typedef enum ALLEGRO_MIXER_EFFECT_PARAM ALLEGRO_MIXER_EFFECT_PARAM;
+#endif
 #endif
 
 
@@ -322,6 +383,31 @@ ALLEGRO_KCM_AUDIO_FUNC(bool, al_set_mixer_gain, (ALLEGRO_MIXER *mixer, float gai
 ALLEGRO_KCM_AUDIO_FUNC(bool, al_set_mixer_playing, (ALLEGRO_MIXER *mixer, bool val));
 ALLEGRO_KCM_AUDIO_FUNC(bool, al_detach_mixer, (ALLEGRO_MIXER *mixer));
 
+#if defined(ALLEGRO_UNSTABLE) || defined(ALLEGRO_INTERNAL_UNSTABLE) || defined(ALLEGRO_KCM_AUDIO_SRC)
+/* Mixer effect functions */
+ALLEGRO_KCM_AUDIO_FUNC(ALLEGRO_MIXER_EFFECT *, al_create_mixer_effect, (
+   ALLEGRO_MIXER_EFFECT_TYPE type));
+ALLEGRO_KCM_AUDIO_FUNC(void, al_destroy_mixer_effect, (ALLEGRO_MIXER_EFFECT *effect));
+ALLEGRO_KCM_AUDIO_FUNC(bool, al_set_mixer_effect_param, (ALLEGRO_MIXER_EFFECT *effect,
+   ALLEGRO_MIXER_EFFECT_PARAM param, float value));
+ALLEGRO_KCM_AUDIO_FUNC(float, al_get_mixer_effect_param, (const ALLEGRO_MIXER_EFFECT *effect,
+   ALLEGRO_MIXER_EFFECT_PARAM param));
+ALLEGRO_KCM_AUDIO_FUNC(bool, al_attach_mixer_effect, (ALLEGRO_MIXER *mixer,
+   ALLEGRO_MIXER_EFFECT *effect));
+ALLEGRO_KCM_AUDIO_FUNC(bool, al_detach_mixer_effect, (ALLEGRO_MIXER_EFFECT *effect));
+ALLEGRO_KCM_AUDIO_FUNC(double, al_get_mixer_effect_time, (const ALLEGRO_MIXER_EFFECT *effect));
+
+/* Profiling */
+ALLEGRO_KCM_AUDIO_FUNC(void, al_get_sample_instance_stats, (
+   const ALLEGRO_SAMPLE_INSTANCE *spl, ALLEGRO_AUDIO_STATS *stats));
+ALLEGRO_KCM_AUDIO_FUNC(void, al_get_audio_stream_stats, (
+   const ALLEGRO_AUDIO_STREAM *stream, ALLEGRO_AUDIO_STATS *stats));
+ALLEGRO_KCM_AUDIO_FUNC(void, al_get_mixer_stats, (
+   const ALLEGRO_MIXER *mixer, ALLEGRO_AUDIO_STATS *stats));
+ALLEGRO_KCM_AUDIO_FUNC(void, al_get_voice_stats, (
+   const ALLEGRO_VOICE *voice, ALLEGRO_AUDIO_STATS *stats));
+#endif
+
 /* Voice functions */
 ALLEGRO_KCM_AUDIO_FUNC(ALLEGRO_VOICE*, al_create_voice, (unsigned int freq,
       ALLEGRO_AUDIO_DEPTH depth,
@@ -343,6 +429,13 @@ ALLEGRO_KCM_AUDIO_FUNC(bool, al_get_voice_playing, (const ALLEGRO_VOICE *voice))
 ALLEGRO_KCM_AUDIO_FUNC(bool, al_set_voice_position, (ALLEGRO_VOICE *voice, unsigned int val));
 ALLEGRO_KCM_AUDIO_FUNC(bool, al_set_voice_playing, (ALLEGRO_VOICE *voice, bool val));
 
+#if defined(ALLEGRO_UNSTABLE) || defined(ALLEGRO_INTERNAL_UNSTABLE) || defined(ALLEGRO_KCM_AUDIO_SRC)
+ALLEGRO_KCM_AUDIO_FUNC(bool, al_set_null_voice_callback, (ALLEGRO_VOICE *voice,
+   void (*callback)(ALLEGRO_VOICE *voice, const void *buf,
+      unsigned int samples, void *data),
+   void *data));
+#endif
+
 /* Misc. audio functions */
 ALLEGRO_KCM_AUDIO_FUNC(bool, al_install_audio, (void));
 ALLEGRO_KCM_AUDIO_FUNC(void, al_uninstall_audio, (void));
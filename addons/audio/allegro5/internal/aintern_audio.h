@@ -57,7 +57,8 @@ typedef enum ALLEGRO_AUDIO_DRIVER_ENUM
    ALLEGRO_AUDIO_DRIVER_AQUEUE     = 0x20005,
    ALLEGRO_AUDIO_DRIVER_PULSEAUDIO = 0x20006,
    ALLEGRO_AUDIO_DRIVER_OPENSL     = 0x20007,
-   ALLEGRO_AUDIO_DRIVER_SDL        = 0x20008
+   ALLEGRO_AUDIO_DRIVER_SDL        = 0x20008,
+   ALLEGRO_AUDIO_DRIVER_NULL       = 0x20009
 } ALLEGRO_AUDIO_DRIVER_ENUM;
 
 typedef struct ALLEGRO_AUDIO_DRIVER ALLEGRO_AUDIO_DRIVER;
@@ -126,6 +127,13 @@ struct ALLEGRO_VOICE {
 
    void                 *extra;
                         /* Extra data for use by the driver. */
+
+   uint64_t             read_frames;
+   double               read_time;
+                        /* Frames read from the attached mixer or stream,
+                         * and the time that took, for al_get_voice_stats.
+                         * Protected by 'mutex'.
+                         */
 };
 
 
@@ -236,10 +244,22 @@ struct ALLEGRO_SAMPLE_INSTANCE {
    sample_parent_t      parent;
                         /* The object that this sample is attached to, if any.
                          */
+
+   uint64_t             read_frames;
+   double               read_time;
+                        /* Frames read by the parent while playing, and the
+                         * time spent in spl_read, for
+                         * al_get_sample_instance_stats.  Updated with
+                         * 'mutex' locked.
+                         */
+
    _AL_LIST_ITEM        *dtor_item;
 };
 
 void _al_kcm_destroy_sample(ALLEGRO_SAMPLE_INSTANCE *sample, bool unregister);
+struct ALLEGRO_AUDIO_STATS;
+void _al_kcm_get_instance_stats(const ALLEGRO_SAMPLE_INSTANCE *spl,
+   struct ALLEGRO_AUDIO_STATS *stats);
 void _al_kcm_stream_set_mutex(ALLEGRO_SAMPLE_INSTANCE *stream, ALLEGRO_MUTEX *mutex);
 void _al_kcm_detach_from_parent(ALLEGRO_SAMPLE_INSTANCE *spl);
 
@@ -252,6 +272,18 @@ typedef double (*get_feeder_position_t)(ALLEGRO_AUDIO_STREAM *);
 typedef double (*get_feeder_length_t)(ALLEGRO_AUDIO_STREAM *);
 typedef bool (*set_feeder_loop_t)(ALLEGRO_AUDIO_STREAM *, double, double);
 
+/* A queue of stream fragments passed from one thread to one other thread
+ * without locking.  Only the producer writes 'tail' and only the consumer
+ * writes 'head'.  Both count modulo twice the size, so that a full queue can
+ * be told apart from an empty one.
+ */
+typedef struct _AL_KCM_FRAGMENT_QUEUE {
+   void                 **slots;
+   int                  size;
+   volatile int         head;
+   volatile int         tail;
+} _AL_KCM_FRAGMENT_QUEUE;
+
 struct ALLEGRO_AUDIO_STREAM {
    ALLEGRO_SAMPLE_INSTANCE spl;
                         /* ALLEGRO_AUDIO_STREAM is derived from
@@ -269,18 +301,29 @@ struct ALLEGRO_AUDIO_STREAM {
                          * at the start for linear/cubic interpolation.
                          */
 
-   void                 **pending_bufs;
-   void                 **used_bufs;
-                        /* Arrays of offsets into the main_buffer.
-                         * The arrays are each 'buf_count' long.
+   _AL_KCM_FRAGMENT_QUEUE pending_bufs;
+   _AL_KCM_FRAGMENT_QUEUE used_bufs;
+                        /* Queues of offsets into the main_buffer.
+                         * The queues can each hold 'buf_count' fragments.
                          *
                          * 'pending_bufs' holds pointers to fragments supplied
                          * by the user which are yet to be handed off to the
-                         * audio driver.
+                         * audio driver.  The fragment being played is
+                         * spl.spl_data.buffer.ptr.
                          *
                          * 'used_bufs' holds pointers to fragments which
                          * have been sent to the audio driver and so are
                          * ready to receive new data.
+                         *
+                         * The user (or feeder) adds to 'pending_bufs' and
+                         * takes from 'used_bufs', the mixer does the
+                         * opposite, so neither side needs the mixer lock.
+                         */
+
+   ALLEGRO_MUTEX        *feeder_mutex;
+                        /* Serialises calls into the feeder and its
+                         * rewind/seek functions, which may decode.  The
+                         * mixer never waits for it.
                          */
 
    volatile bool         is_draining;
@@ -312,6 +355,49 @@ struct ALLEGRO_AUDIO_STREAM {
                           * by a thread using the 'feeder' callback. Such
                           * streams don't need to be fed by the user.
                           */
+   bool                  feed_finished_event_sent;
+
+   bool                  feed_pooled;
+   bool                  feed_queued;
+   bool                  feed_busy;
+   double                feed_deadline;
+                         /* A stream with 'feed_pooled' set is fed by the
+                          * shared feeder pool instead of its own
+                          * 'feed_thread'.  'feed_queued' means it waits for
+                          * a worker, which should get to it before
+                          * 'feed_deadline' (al_get_time) to avoid an
+                          * underrun.  'feed_busy' is set while a worker
+                          * fills its fragments.  These are protected by the
+                          * pool's mutex.
+                          */
+
+   bool                  feed_draining;
+                         /* Set when the pool drains the stream after the
+                          * end of its data.  Protected by the stream's
+                          * mutex.
+                          */
+
+   double                *fragment_freed_at;
+                         /* al_get_time when the mixer was done with each
+                          * fragment, by position in main_buffer, or 0.
+                          */
+   volatile bool         starving;
+   unsigned int          underruns;
+                         /* Set by the mixer while it has run out of
+                          * fragments, and the number of times that
+                          * happened.  Protected by the stream's mutex.
+                          */
+
+   uint64_t              fed_fragments;
+   unsigned int          late_fragments;
+   unsigned int          refills_timed;
+   double                decode_time;
+   double                refill_latency_sum;
+   double                refill_latency_max;
+                         /* Counters of the feeder, for
+                          * al_get_audio_stream_stats.  Protected by
+                          * feeder_mutex.
+                          */
 
    _AL_LIST_ITEM        *dtor_item;
 
@@ -320,6 +406,7 @@ struct ALLEGRO_AUDIO_STREAM {
 };
 
 bool _al_kcm_refill_stream(ALLEGRO_AUDIO_STREAM *stream);
+int _al_kcm_get_queued_stream_fragments(const ALLEGRO_AUDIO_STREAM *stream);
 
 
 typedef void (*postprocess_callback_t)(void *buf, unsigned int samples,
@@ -344,6 +431,25 @@ struct ALLEGRO_MIXER {
                            /* Vector of ALLEGRO_SAMPLE_INSTANCE*.  Holds the list of
                             * streams being mixed together.
                             */
+   _AL_VECTOR              sinc_tables;
+                           /* Vector of resampling tables for
+                            * ALLEGRO_MIXER_QUALITY_SINC, see kcm_mixer.c.
+                            */
+   unsigned int            sinc_block;
+                           /* Counts mixed blocks, to find the least
+                            * recently used tables.
+                            */
+   bool                    parallel;
+                           /* Mix attached mixers on the worker threads. */
+   _AL_VECTOR              child_mixers;
+                           /* Scratch space for doing that. */
+   _AL_VECTOR              effects;
+                           /* Vector of ALLEGRO_MIXER_EFFECT*, applied in
+                            * order, see kcm_effect.c.
+                            */
+   bool                    dither;
+   uint32_t                dither_state[4];
+                           /* Dither the output for integer voices. */
    _AL_LIST_ITEM           *dtor_item;
 };
 
@@ -351,6 +457,15 @@ extern void _al_kcm_mixer_rejig_sample_matrix(ALLEGRO_MIXER *mixer,
    ALLEGRO_SAMPLE_INSTANCE *spl);
 extern void _al_kcm_mixer_read(void *source, void **buf, unsigned int *samples,
    ALLEGRO_AUDIO_DEPTH buffer_depth, size_t dest_maxc);
+extern void *_al_kcm_mixer_build_sinc_tables(ALLEGRO_MIXER *mixer, int step,
+   int step_denom);
+extern void _al_kcm_mixer_update_sinc_tables(ALLEGRO_MIXER *mixer,
+   void *tables);
+extern void _al_kcm_mixer_free_sinc_tables(ALLEGRO_MIXER *mixer);
+extern void _al_kcm_sample_to_float(float *out, const ALLEGRO_SAMPLE *data,
+   unsigned int pos, unsigned int n);
+extern void _al_kcm_run_mixer_effects(ALLEGRO_MIXER *mixer, unsigned int samples);
+extern void _al_kcm_detach_mixer_effects(ALLEGRO_MIXER *mixer);
 
 
 typedef enum {
@@ -365,9 +480,26 @@ extern void _al_set_error(int error, char* string);
 /* Supposedly internal */
 ALLEGRO_KCM_AUDIO_FUNC(void*, _al_kcm_feed_stream, (ALLEGRO_THREAD *self, void *vstream));
 
+bool _al_kcm_feed_stream_fragment(ALLEGRO_AUDIO_STREAM *stream);
+
 /* Helper to emit an event that the stream has got a buffer ready to be refilled. */
 void _al_kcm_emit_stream_events(ALLEGRO_AUDIO_STREAM *stream);
 
+/* Shared feeder pool, see kcm_feeder_pool.c. */
+ALLEGRO_KCM_AUDIO_FUNC(bool, _al_kcm_start_pooled_feeder, (ALLEGRO_AUDIO_STREAM *stream));
+ALLEGRO_KCM_AUDIO_FUNC(void, _al_kcm_stop_pooled_feeder, (ALLEGRO_AUDIO_STREAM *stream));
+void _al_kcm_schedule_pooled_feeder(ALLEGRO_AUDIO_STREAM *stream);
+void _al_kcm_drain_pooled_feeder(ALLEGRO_AUDIO_STREAM *stream);
+void _al_kcm_init_feeder_pool(void);
+void _al_kcm_shutdown_feeder_pool(void);
+
+/* Float copies of integer samples, see kcm_sample_cache.c. */
+const ALLEGRO_SAMPLE *_al_kcm_acquire_float_sample(const ALLEGRO_SAMPLE *data);
+void _al_kcm_release_float_sample(const ALLEGRO_SAMPLE *f32);
+void _al_kcm_forget_float_sample(const ALLEGRO_SAMPLE *data);
+void _al_kcm_init_sample_cache(void);
+void _al_kcm_shutdown_sample_cache(void);
+
 void _al_kcm_init_destructors(void);
 void _al_kcm_shutdown_destructors(void);
 _AL_LIST_ITEM *_al_kcm_register_destructor(char const *name, void *object,
@@ -49,6 +49,7 @@ ALLEGRO_AUDIO_DRIVER *_al_kcm_driver = NULL;
 #if defined(ALLEGRO_SDL)
    extern struct ALLEGRO_AUDIO_DRIVER _al_kcm_sdl_driver;
 #endif
+extern struct ALLEGRO_AUDIO_DRIVER _al_kcm_null_driver;
 
 /* Channel configuration helpers */
 
@@ -193,6 +194,9 @@ static ALLEGRO_AUDIO_DRIVER_ENUM get_config_audio_driver(void)
    if (0 == _al_stricmp(value, "DSOUND") || 0 == _al_stricmp(value, "DIRECTSOUND"))
       return ALLEGRO_AUDIO_DRIVER_DSOUND;
 
+   if (0 == _al_stricmp(value, "NULL"))
+      return ALLEGRO_AUDIO_DRIVER_NULL;
+
    return ALLEGRO_AUDIO_DRIVER_AUTODETECT;
 }
 
@@ -367,6 +371,15 @@ static bool do_install_audio(ALLEGRO_AUDIO_DRIVER_ENUM mode)
             return false;
          #endif
 
+      /* Never autodetected, only chosen through the config file. */
+      case ALLEGRO_AUDIO_DRIVER_NULL:
+         if (_al_kcm_null_driver.open() == 0) {
+            ALLEGRO_INFO("Using null driver\n");
+            _al_kcm_driver = &_al_kcm_null_driver;
+            return true;
+         }
+         return false;
+
       default:
          _al_set_error(ALLEGRO_INVALID_PARAM, "Invalid audio driver");
          return false;
@@ -386,6 +399,8 @@ bool al_install_audio(void)
     * because the user may still create samples.
     */
    _al_kcm_init_destructors();
+   _al_kcm_init_feeder_pool();
+   _al_kcm_init_sample_cache();
    _al_add_exit_func(al_uninstall_audio, "al_uninstall_audio");
 
    ret = do_install_audio(ALLEGRO_AUDIO_DRIVER_AUTODETECT);
@@ -399,11 +414,15 @@ void al_uninstall_audio(void)
    if (_al_kcm_driver) {
       _al_kcm_shutdown_default_mixer();
       _al_kcm_shutdown_destructors();
+      _al_kcm_shutdown_feeder_pool();
+      _al_kcm_shutdown_sample_cache();
       _al_kcm_driver->close();
       _al_kcm_driver = NULL;
    }
    else {
       _al_kcm_shutdown_destructors();
+      _al_kcm_shutdown_feeder_pool();
+      _al_kcm_shutdown_sample_cache();
    }
 }
 
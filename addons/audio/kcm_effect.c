@@ -0,0 +1,853 @@
+/*         ______   ___    ___
+ *        /\  _  \ /\_ \  /\_ \
+ *        \ \ \L\ \\//\ \ \//\ \      __     __   _ __   ___
+ *         \ \  __ \ \ \ \  \ \ \   /'__`\ /'_ `\/\`'__\/ __`\
+ *          \ \ \/\ \ \_\ \_ \_\ \_/\  __//\ \L\ \ \ \//\ \L\ \
+ *           \ \_\ \_\/\____\/\____\ \____\ \____ \ \_\\ \____/
+ *            \/_/\/_/\/____/\/____/\/____/\/___L\ \/_/ \/___/
+ *                                           /\____/
+ *                                           \_/__/
+ *
+ *      Built-in mixer effects.
+ *
+ *      Each float mixer has a chain of effects which are applied to its
+ *      output in place, after the attached streams are mixed and before
+ *      the post-processing callback.  The buffer is processed in blocks
+ *      small enough to stay in the first level cache, with every effect of
+ *      the chain run over a block before moving on to the next one.
+ *
+ *      See readme.txt for copyright information.
+ */
+
+/* Title: Mixer effects
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "allegro5/allegro_audio.h"
+#include "allegro5/internal/aintern.h"
+#include "allegro5/internal/aintern_audio.h"
+#include "allegro5/internal/aintern_cpu.h"
+#include "allegro5/internal/aintern_vector.h"
+
+#if defined(_AL_SIMD_X86)
+   #include <emmintrin.h>
+#endif
+
+ALLEGRO_DEBUG_CHANNEL("audio")
+
+
+/* Frames processed by the whole chain at a time.  256 frames of 7.1 audio
+ * are 8 kB.
+ */
+#define EFFECT_BLOCK       256
+
+#define MAX_DELAY_TIME     10.0f
+#define NUM_PARAMS         (ALLEGRO_MIXER_EFFECT_MIX + 1)
+
+/* Filter states smaller than this are flushed to zero after every block,
+ * so a filter fed with silence does not end up computing with denormals.
+ */
+#define DENORMAL_LIMIT     1e-20f
+
+
+typedef struct BIQUAD {
+   float b0, b1, b2, a1, a2;
+   float z1[ALLEGRO_MAX_CHANNELS];
+   float z2[ALLEGRO_MAX_CHANNELS];
+} BIQUAD;
+
+typedef struct COMPRESSOR {
+   float threshold;              /* linear */
+   float slope;                  /* 1 - 1/ratio */
+   float makeup;                 /* linear */
+   float attack, release;        /* envelope coefficients per frame */
+   float env;
+} COMPRESSOR;
+
+typedef struct DELAY {
+   float *buf;                   /* ring buffer of len frames */
+   int len;
+   int pos;
+   float feedback;
+   float mix;
+} DELAY;
+
+struct ALLEGRO_MIXER_EFFECT {
+   ALLEGRO_MIXER_EFFECT_TYPE type;
+   float params[NUM_PARAMS];
+   ALLEGRO_MIXER *mixer;         /* attached to, or NULL */
+   double time;                  /* seconds spent processing */
+
+   union {
+      BIQUAD biquad;
+      COMPRESSOR comp;
+      DELAY delay;
+   } u;
+
+   _AL_LIST_ITEM *dtor_item;
+};
+
+
+
+static void maybe_lock_mutex(ALLEGRO_MUTEX *mutex)
+{
+   if (mutex) {
+      al_lock_mutex(mutex);
+   }
+}
+
+
+static void maybe_unlock_mutex(ALLEGRO_MUTEX *mutex)
+{
+   if (mutex) {
+      al_unlock_mutex(mutex);
+   }
+}
+
+
+static bool is_biquad(ALLEGRO_MIXER_EFFECT_TYPE type)
+{
+   switch (type) {
+      case ALLEGRO_MIXER_EFFECT_LOWPASS:
+      case ALLEGRO_MIXER_EFFECT_HIGHPASS:
+      case ALLEGRO_MIXER_EFFECT_PEAKING:
+      case ALLEGRO_MIXER_EFFECT_LOW_SHELF:
+      case ALLEGRO_MIXER_EFFECT_HIGH_SHELF:
+         return true;
+      default:
+         return false;
+   }
+}
+
+
+/* Returns whether the effect type has the parameter at all. */
+static bool has_param(ALLEGRO_MIXER_EFFECT_TYPE type,
+   ALLEGRO_MIXER_EFFECT_PARAM param)
+{
+   switch (param) {
+      case ALLEGRO_MIXER_EFFECT_FREQUENCY:
+      case ALLEGRO_MIXER_EFFECT_Q:
+         return is_biquad(type);
+      case ALLEGRO_MIXER_EFFECT_GAIN:
+         return (is_biquad(type) && type != ALLEGRO_MIXER_EFFECT_LOWPASS &&
+            type != ALLEGRO_MIXER_EFFECT_HIGHPASS) ||
+            type == ALLEGRO_MIXER_EFFECT_COMPRESSOR;
+      case ALLEGRO_MIXER_EFFECT_THRESHOLD:
+      case ALLEGRO_MIXER_EFFECT_RATIO:
+      case ALLEGRO_MIXER_EFFECT_ATTACK:
+      case ALLEGRO_MIXER_EFFECT_RELEASE:
+         return type == ALLEGRO_MIXER_EFFECT_COMPRESSOR;
+      case ALLEGRO_MIXER_EFFECT_TIME:
+      case ALLEGRO_MIXER_EFFECT_FEEDBACK:
+      case ALLEGRO_MIXER_EFFECT_MIX:
+         return type == ALLEGRO_MIXER_EFFECT_DELAY;
+   }
+   return false;
+}
+
+
+static bool valid_param_value(ALLEGRO_MIXER_EFFECT_PARAM param, float value)
+{
+   if (!(value == value))
+      return false;
+
+   switch (param) {
+      case ALLEGRO_MIXER_EFFECT_FREQUENCY:
+      case ALLEGRO_MIXER_EFFECT_Q:
+         return value > 0.0f;
+      case ALLEGRO_MIXER_EFFECT_GAIN:
+      case ALLEGRO_MIXER_EFFECT_THRESHOLD:
+         return fabsf(value) <= 120.0f;
+      case ALLEGRO_MIXER_EFFECT_RATIO:
+         return value >= 1.0f;
+      case ALLEGRO_MIXER_EFFECT_ATTACK:
+      case ALLEGRO_MIXER_EFFECT_RELEASE:
+         return value >= 0.0f && value <= 60.0f;
+      case ALLEGRO_MIXER_EFFECT_TIME:
+         return value >= 0.0f && value <= MAX_DELAY_TIME;
+      case ALLEGRO_MIXER_EFFECT_FEEDBACK:
+         return value > -1.0f && value < 1.0f;
+      case ALLEGRO_MIXER_EFFECT_MIX:
+         return value >= 0.0f && value <= 1.0f;
+   }
+   return false;
+}
+
+
+static float db_to_linear(float db)
+{
+   return powf(10.0f, db / 20.0f);
+}
+
+
+/* Coefficient of a one pole smoother which gets within 1/e of its target
+ * after the given time.
+ */
+static float time_constant(float seconds, unsigned int freq)
+{
+   if (seconds * freq < 1.0f)
+      return 0.0f;
+   return expf(-1.0f / (seconds * freq));
+}
+
+
+
+/* Biquad filters, from Robert Bristow-Johnson's "Cookbook formulae for
+ * audio EQ biquad filter coefficients".  The filter is evaluated in
+ * transposed direct form II, one SSE lane per channel.
+ */
+static void setup_biquad(ALLEGRO_MIXER_EFFECT *effect, unsigned int freq)
+{
+   BIQUAD *bq = &effect->u.biquad;
+   double f0 = effect->params[ALLEGRO_MIXER_EFFECT_FREQUENCY];
+   double q = effect->params[ALLEGRO_MIXER_EFFECT_Q];
+   double A = pow(10.0, effect->params[ALLEGRO_MIXER_EFFECT_GAIN] / 40.0);
+   double sqrt_A = sqrt(A);
+   double w0, cos_w0, alpha;
+   double b0, b1, b2, a0, a1, a2;
+
+   if (f0 > 0.49 * freq)
+      f0 = 0.49 * freq;
+   w0 = 2.0 * ALLEGRO_PI * f0 / freq;
+   cos_w0 = cos(w0);
+   alpha = sin(w0) / (2.0 * q);
+
+   switch (effect->type) {
+      case ALLEGRO_MIXER_EFFECT_LOWPASS:
+         b0 = (1.0 - cos_w0) / 2.0;
+         b1 = 1.0 - cos_w0;
+         b2 = (1.0 - cos_w0) / 2.0;
+         a0 = 1.0 + alpha;
+         a1 = -2.0 * cos_w0;
+         a2 = 1.0 - alpha;
+         break;
+
+      case ALLEGRO_MIXER_EFFECT_HIGHPASS:
+         b0 = (1.0 + cos_w0) / 2.0;
+         b1 = -(1.0 + cos_w0);
+         b2 = (1.0 + cos_w0) / 2.0;
+         a0 = 1.0 + alpha;
+         a1 = -2.0 * cos_w0;
+         a2 = 1.0 - alpha;
+         break;
+
+      case ALLEGRO_MIXER_EFFECT_PEAKING:
+         b0 = 1.0 + alpha * A;
+         b1 = -2.0 * cos_w0;
+         b2 = 1.0 - alpha * A;
+         a0 = 1.0 + alpha / A;
+         a1 = -2.0 * cos_w0;
+         a2 = 1.0 - alpha / A;
+         break;
+
+      case ALLEGRO_MIXER_EFFECT_LOW_SHELF:
+         b0 = A * ((A + 1) - (A - 1) * cos_w0 + 2 * sqrt_A * alpha);
+         b1 = 2 * A * ((A - 1) - (A + 1) * cos_w0);
+         b2 = A * ((A + 1) - (A - 1) * cos_w0 - 2 * sqrt_A * alpha);
+         a0 = (A + 1) + (A - 1) * cos_w0 + 2 * sqrt_A * alpha;
+         a1 = -2 * ((A - 1) + (A + 1) * cos_w0);
+         a2 = (A + 1) + (A - 1) * cos_w0 - 2 * sqrt_A * alpha;
+         break;
+
+      case ALLEGRO_MIXER_EFFECT_HIGH_SHELF:
+      default:
+         b0 = A * ((A + 1) + (A - 1) * cos_w0 + 2 * sqrt_A * alpha);
+         b1 = -2 * A * ((A - 1) + (A + 1) * cos_w0);
+         b2 = A * ((A + 1) + (A - 1) * cos_w0 - 2 * sqrt_A * alpha);
+         a0 = (A + 1) - (A - 1) * cos_w0 + 2 * sqrt_A * alpha;
+         a1 = 2 * ((A - 1) - (A + 1) * cos_w0);
+         a2 = (A + 1) - (A - 1) * cos_w0 - 2 * sqrt_A * alpha;
+         break;
+   }
+
+   bq->b0 = b0 / a0;
+   bq->b1 = b1 / a0;
+   bq->b2 = b2 / a0;
+   bq->a1 = a1 / a0;
+   bq->a2 = a2 / a0;
+}
+
+
+static void flush_denormals(float *z, int n)
+{
+   int i;
+
+   for (i = 0; i < n; i++) {
+      if (fabsf(z[i]) < DENORMAL_LIMIT)
+         z[i] = 0.0f;
+   }
+}
+
+
+static void biquad_block(BIQUAD *bq, float *buf, int n, int maxc)
+{
+   const float b0 = bq->b0, b1 = bq->b1, b2 = bq->b2;
+   const float a1 = bq->a1, a2 = bq->a2;
+   int c, k;
+
+   for (c = 0; c < maxc; c++) {
+      float z1 = bq->z1[c];
+      float z2 = bq->z2[c];
+      float *p = buf + c;
+
+      for (k = 0; k < n; k++, p += maxc) {
+         float x = *p;
+         float y = b0 * x + z1;
+         z1 = (b1 * x - a1 * y) + z2;
+         z2 = b2 * x - a2 * y;
+         *p = y;
+      }
+
+      bq->z1[c] = z1;
+      bq->z2[c] = z2;
+   }
+}
+
+
+#if defined(_AL_SIMD_X86)
+
+_AL_TARGET_SSE2
+static __m128 load_lanes(const float *p, int lanes)
+{
+   switch (lanes) {
+      case 1:
+         return _mm_load_ss(p);
+      case 2:
+         return _mm_castpd_ps(_mm_load_sd((const double *)p));
+      case 3:
+         return _mm_setr_ps(p[0], p[1], p[2], 0.0f);
+      default:
+         return _mm_loadu_ps(p);
+   }
+}
+
+
+_AL_TARGET_SSE2
+static void store_lanes(float *p, __m128 v, int lanes)
+{
+   switch (lanes) {
+      case 1:
+         _mm_store_ss(p, v);
+         break;
+      case 2:
+         _mm_store_sd((double *)p, _mm_castps_pd(v));
+         break;
+      case 3:
+         _mm_store_sd((double *)p, _mm_castps_pd(v));
+         _mm_store_ss(p + 2, _mm_movehl_ps(v, v));
+         break;
+      default:
+         _mm_storeu_ps(p, v);
+         break;
+   }
+}
+
+
+/* Same as biquad_block, for up to four channels at a time. */
+_AL_TARGET_SSE2
+static void biquad_block_sse2(BIQUAD *bq, float *buf, int n, int maxc)
+{
+   const __m128 b0 = _mm_set1_ps(bq->b0);
+   const __m128 b1 = _mm_set1_ps(bq->b1);
+   const __m128 b2 = _mm_set1_ps(bq->b2);
+   const __m128 a1 = _mm_set1_ps(bq->a1);
+   const __m128 a2 = _mm_set1_ps(bq->a2);
+   int c, k;
+
+   for (c = 0; c < maxc; c += 4) {
+      const int lanes = maxc - c < 4 ? maxc - c : 4;
+      __m128 z1 = _mm_loadu_ps(bq->z1 + c);
+      __m128 z2 = _mm_loadu_ps(bq->z2 + c);
+      float *p = buf + c;
+
+      for (k = 0; k < n; k++, p += maxc) {
+         __m128 x = load_lanes(p, lanes);
+         __m128 y = _mm_add_ps(_mm_mul_ps(b0, x), z1);
+         z1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1, x), _mm_mul_ps(a1, y)), z2);
+         z2 = _mm_sub_ps(_mm_mul_ps(b2, x), _mm_mul_ps(a2, y));
+         store_lanes(p, y, lanes);
+      }
+
+      _mm_storeu_ps(bq->z1 + c, z1);
+      _mm_storeu_ps(bq->z2 + c, z2);
+   }
+}
+
+#endif
+
+
+static void run_biquad(ALLEGRO_MIXER_EFFECT *effect, float *buf, int n,
+   int maxc)
+{
+   BIQUAD *bq = &effect->u.biquad;
+
+#if defined(_AL_SIMD_X86)
+   if (_al_get_cpu_features() & _AL_CPU_SSE2)
+      biquad_block_sse2(bq, buf, n, maxc);
+   else
+#endif
+      biquad_block(bq, buf, n, maxc);
+
+   flush_denormals(bq->z1, maxc);
+   flush_denormals(bq->z2, maxc);
+}
+
+
+
+/* Feed forward compressor with a peak envelope follower.  All channels are
+ * compressed by the same amount, taken from the loudest one, so the stereo
+ * image does not move around.  A very large ratio makes it a limiter.
+ */
+static void setup_compressor(ALLEGRO_MIXER_EFFECT *effect, unsigned int freq)
+{
+   COMPRESSOR *comp = &effect->u.comp;
+
+   comp->threshold = db_to_linear(effect->params[ALLEGRO_MIXER_EFFECT_THRESHOLD]);
+   comp->slope = 1.0f - 1.0f / effect->params[ALLEGRO_MIXER_EFFECT_RATIO];
+   comp->makeup = db_to_linear(effect->params[ALLEGRO_MIXER_EFFECT_GAIN]);
+   comp->attack = time_constant(effect->params[ALLEGRO_MIXER_EFFECT_ATTACK], freq);
+   comp->release = time_constant(effect->params[ALLEGRO_MIXER_EFFECT_RELEASE], freq);
+}
+
+
+static void apply_frame_gains(float *buf, const float *gains, int n, int maxc)
+{
+   int c, k;
+
+#if defined(_AL_SIMD_X86)
+   /* Other channel counts are handled well enough by the compiler. */
+   if (maxc == 2 && (_al_get_cpu_features() & _AL_CPU_SSE2)) {
+      for (k = 0; k + 2 <= n; k += 2) {
+         __m128 g = _mm_setr_ps(gains[k], gains[k], gains[k + 1], gains[k + 1]);
+         _mm_storeu_ps(buf + 2 * k, _mm_mul_ps(_mm_loadu_ps(buf + 2 * k), g));
+      }
+      for (; k < n; k++) {
+         buf[2 * k] *= gains[k];
+         buf[2 * k + 1] *= gains[k];
+      }
+      return;
+   }
+#endif
+
+   for (k = 0; k < n; k++) {
+      for (c = 0; c < maxc; c++)
+         buf[k * maxc + c] *= gains[k];
+   }
+}
+
+
+static void run_compressor(ALLEGRO_MIXER_EFFECT *effect, float *buf, int n,
+   int maxc)
+{
+   COMPRESSOR *comp = &effect->u.comp;
+   float gains[EFFECT_BLOCK];
+   float env = comp->env;
+   int c, k;
+
+   for (k = 0; k < n; k++) {
+      const float *p = buf + k * maxc;
+      float peak = 0.0f;
+
+      for (c = 0; c < maxc; c++) {
+         float a = fabsf(p[c]);
+         if (a > peak)
+            peak = a;
+      }
+
+      if (peak > env)
+         env = peak + comp->attack * (env - peak);
+      else
+         env = peak + comp->release * (env - peak);
+
+      gains[k] = comp->makeup;
+      if (env > comp->threshold)
+         gains[k] *= powf(env / comp->threshold, -comp->slope);
+   }
+
+   if (env < DENORMAL_LIMIT)
+      env = 0.0f;
+   comp->env = env;
+
+   apply_frame_gains(buf, gains, n, maxc);
+}
+
+
+
+/* Feedback delay line.  The ring buffer holds exactly the delay, so the
+ * same slot is read and then overwritten for each frame.
+ */
+static bool setup_delay(ALLEGRO_MIXER_EFFECT *effect, unsigned int freq,
+   int maxc)
+{
+   DELAY *delay = &effect->u.delay;
+   int len = (int)(effect->params[ALLEGRO_MIXER_EFFECT_TIME] * freq + 0.5f);
+
+   if (len < 1)
+      len = 1;
+
+   if (len != delay->len || !delay->buf) {
+      float *buf = al_calloc(len * maxc, sizeof(float));
+      if (!buf) {
+         _al_set_error(ALLEGRO_GENERIC_ERROR,
+            "Out of memory allocating delay buffer");
+         return false;
+      }
+      al_free(delay->buf);
+      delay->buf = buf;
+      delay->len = len;
+      delay->pos = 0;
+   }
+
+   delay->feedback = effect->params[ALLEGRO_MIXER_EFFECT_FEEDBACK];
+   delay->mix = effect->params[ALLEGRO_MIXER_EFFECT_MIX];
+   return true;
+}
+
+
+static void delay_span(float *buf, float *line, int count, float feedback,
+   float mix)
+{
+   int i = 0;
+
+#if defined(_AL_SIMD_X86)
+   if (_al_get_cpu_features() & _AL_CPU_SSE2) {
+      const __m128 fb = _mm_set1_ps(feedback);
+      const __m128 wet = _mm_set1_ps(mix);
+
+      for (; i + 4 <= count; i += 4) {
+         __m128 x = _mm_loadu_ps(buf + i);
+         __m128 d = _mm_loadu_ps(line + i);
+         _mm_storeu_ps(line + i, _mm_add_ps(x, _mm_mul_ps(fb, d)));
+         _mm_storeu_ps(buf + i,
+            _mm_add_ps(x, _mm_mul_ps(wet, _mm_sub_ps(d, x))));
+      }
+   }
+#endif
+
+   for (; i < count; i++) {
+      float x = buf[i];
+      float d = line[i];
+      line[i] = x + feedback * d;
+      buf[i] = x + mix * (d - x);
+   }
+}
+
+
+static void run_delay(ALLEGRO_MIXER_EFFECT *effect, float *buf, int n,
+   int maxc)
+{
+   DELAY *delay = &effect->u.delay;
+
+   while (n > 0) {
+      int span = delay->len - delay->pos;
+      if (span > n)
+         span = n;
+
+      delay_span(buf, delay->buf + delay->pos * maxc, span * maxc,
+         delay->feedback, delay->mix);
+
+      buf += span * maxc;
+      n -= span;
+      delay->pos += span;
+      if (delay->pos == delay->len)
+         delay->pos = 0;
+   }
+}
+
+
+
+/* Recomputes the effect's coefficients for the mixer it is attached to.
+ * Must be called with the mixer's mutex locked.
+ */
+static bool setup_effect(ALLEGRO_MIXER_EFFECT *effect)
+{
+   const ALLEGRO_MIXER *mixer = effect->mixer;
+   unsigned int freq = mixer->ss.spl_data.frequency;
+   int maxc = al_get_channel_count(mixer->ss.spl_data.chan_conf);
+
+   if (is_biquad(effect->type)) {
+      setup_biquad(effect, freq);
+      return true;
+   }
+   if (effect->type == ALLEGRO_MIXER_EFFECT_COMPRESSOR) {
+      setup_compressor(effect, freq);
+      return true;
+   }
+   return setup_delay(effect, freq, maxc);
+}
+
+
+static void reset_effect(ALLEGRO_MIXER_EFFECT *effect)
+{
+   if (is_biquad(effect->type)) {
+      memset(effect->u.biquad.z1, 0, sizeof(effect->u.biquad.z1));
+      memset(effect->u.biquad.z2, 0, sizeof(effect->u.biquad.z2));
+   }
+   else if (effect->type == ALLEGRO_MIXER_EFFECT_COMPRESSOR) {
+      effect->u.comp.env = 0.0f;
+   }
+   else {
+      al_free(effect->u.delay.buf);
+      effect->u.delay.buf = NULL;
+      effect->u.delay.len = 0;
+      effect->u.delay.pos = 0;
+   }
+}
+
+
+
+/* Function: al_create_mixer_effect
+ */
+ALLEGRO_MIXER_EFFECT *al_create_mixer_effect(ALLEGRO_MIXER_EFFECT_TYPE type)
+{
+   ALLEGRO_MIXER_EFFECT *effect;
+
+   if (!is_biquad(type) && type != ALLEGRO_MIXER_EFFECT_COMPRESSOR &&
+         type != ALLEGRO_MIXER_EFFECT_DELAY) {
+      _al_set_error(ALLEGRO_INVALID_PARAM, "Invalid mixer effect type");
+      return NULL;
+   }
+
+   effect = al_calloc(1, sizeof(*effect));
+   if (!effect) {
+      _al_set_error(ALLEGRO_GENERIC_ERROR,
+         "Out of memory allocating mixer effect");
+      return NULL;
+   }
+
+   effect->type = type;
+   effect->params[ALLEGRO_MIXER_EFFECT_FREQUENCY] = 1000.0f;
+   effect->params[ALLEGRO_MIXER_EFFECT_Q] = 0.70710678f;
+   effect->params[ALLEGRO_MIXER_EFFECT_GAIN] = 0.0f;
+   effect->params[ALLEGRO_MIXER_EFFECT_THRESHOLD] = -12.0f;
+   effect->params[ALLEGRO_MIXER_EFFECT_RATIO] = 4.0f;
+   effect->params[ALLEGRO_MIXER_EFFECT_ATTACK] = 0.005f;
+   effect->params[ALLEGRO_MIXER_EFFECT_RELEASE] = 0.1f;
+   effect->params[ALLEGRO_MIXER_EFFECT_TIME] = 0.25f;
+   effect->params[ALLEGRO_MIXER_EFFECT_FEEDBACK] = 0.3f;
+   effect->params[ALLEGRO_MIXER_EFFECT_MIX] = 0.5f;
+
+   effect->dtor_item = _al_kcm_register_destructor("mixer_effect", effect,
+      (void (*)(void *)) al_destroy_mixer_effect);
+
+   return effect;
+}
+
+
+/* Function: al_destroy_mixer_effect
+ */
+void al_destroy_mixer_effect(ALLEGRO_MIXER_EFFECT *effect)
+{
+   if (effect) {
+      _al_kcm_unregister_destructor(effect->dtor_item);
+      al_detach_mixer_effect(effect);
+      al_free(effect);
+   }
+}
+
+
+/* Function: al_set_mixer_effect_param
+ */
+bool al_set_mixer_effect_param(ALLEGRO_MIXER_EFFECT *effect,
+   ALLEGRO_MIXER_EFFECT_PARAM param, float value)
+{
+   ALLEGRO_MIXER *mixer;
+   float old_value;
+   bool ret = true;
+
+   ASSERT(effect);
+
+   if ((int)param < 0 || (int)param >= NUM_PARAMS || !has_param(effect->type, param)) {
+      _al_set_error(ALLEGRO_INVALID_PARAM,
+         "Mixer effect does not have this parameter");
+      return false;
+   }
+   if (!valid_param_value(param, value)) {
+      _al_set_error(ALLEGRO_INVALID_PARAM,
+         "Mixer effect parameter out of range");
+      return false;
+   }
+
+   mixer = effect->mixer;
+   if (!mixer) {
+      effect->params[param] = value;
+      return true;
+   }
+
+   maybe_lock_mutex(mixer->ss.mutex);
+   old_value = effect->params[param];
+   effect->params[param] = value;
+   if (!setup_effect(effect)) {
+      effect->params[param] = old_value;
+      ret = false;
+   }
+   maybe_unlock_mutex(mixer->ss.mutex);
+
+   return ret;
+}
+
+
+/* Function: al_get_mixer_effect_param
+ */
+float al_get_mixer_effect_param(const ALLEGRO_MIXER_EFFECT *effect,
+   ALLEGRO_MIXER_EFFECT_PARAM param)
+{
+   ASSERT(effect);
+
+   if ((int)param < 0 || (int)param >= NUM_PARAMS || !has_param(effect->type, param)) {
+      _al_set_error(ALLEGRO_INVALID_PARAM,
+         "Mixer effect does not have this parameter");
+      return 0.0f;
+   }
+
+   return effect->params[param];
+}
+
+
+/* Function: al_attach_mixer_effect
+ */
+bool al_attach_mixer_effect(ALLEGRO_MIXER *mixer, ALLEGRO_MIXER_EFFECT *effect)
+{
+   ALLEGRO_MIXER_EFFECT **slot;
+
+   ASSERT(mixer);
+   ASSERT(effect);
+
+   if (effect->mixer) {
+      _al_set_error(ALLEGRO_INVALID_OBJECT,
+         "Attempted to attach a mixer effect that is already attached");
+      return false;
+   }
+
+   if (mixer->ss.spl_data.depth != ALLEGRO_AUDIO_DEPTH_FLOAT32) {
+      _al_set_error(ALLEGRO_INVALID_PARAM,
+         "Mixer effects need a float mixer");
+      return false;
+   }
+
+   maybe_lock_mutex(mixer->ss.mutex);
+
+   effect->mixer = mixer;
+   reset_effect(effect);
+   slot = _al_vector_alloc_back(&mixer->effects);
+   if (!slot || !setup_effect(effect)) {
+      if (slot)
+         _al_vector_delete_at(&mixer->effects,
+            _al_vector_size(&mixer->effects) - 1);
+      effect->mixer = NULL;
+      reset_effect(effect);
+      maybe_unlock_mutex(mixer->ss.mutex);
+      if (!slot)
+         _al_set_error(ALLEGRO_GENERIC_ERROR,
+            "Out of memory allocating attachment pointers");
+      return false;
+   }
+   *slot = effect;
+
+   maybe_unlock_mutex(mixer->ss.mutex);
+
+   return true;
+}
+
+
+/* Function: al_detach_mixer_effect
+ */
+bool al_detach_mixer_effect(ALLEGRO_MIXER_EFFECT *effect)
+{
+   ALLEGRO_MIXER *mixer;
+
+   ASSERT(effect);
+
+   mixer = effect->mixer;
+   if (!mixer)
+      return true;
+
+   maybe_lock_mutex(mixer->ss.mutex);
+   _al_vector_find_and_delete(&mixer->effects, &effect);
+   effect->mixer = NULL;
+   reset_effect(effect);
+   maybe_unlock_mutex(mixer->ss.mutex);
+
+   return true;
+}
+
+
+/* Function: al_get_mixer_effect_time
+ */
+double al_get_mixer_effect_time(const ALLEGRO_MIXER_EFFECT *effect)
+{
+   ALLEGRO_MIXER *mixer;
+   double time;
+
+   ASSERT(effect);
+
+   mixer = effect->mixer;
+   if (!mixer)
+      return effect->time;
+
+   maybe_lock_mutex(mixer->ss.mutex);
+   time = effect->time;
+   maybe_unlock_mutex(mixer->ss.mutex);
+
+   return time;
+}
+
+
+/* Internal function: _al_kcm_run_mixer_effects
+ *  Applies the mixer's effects to its buffer.  Called by the mixer with
+ *  its mutex locked.
+ */
+void _al_kcm_run_mixer_effects(ALLEGRO_MIXER *mixer, unsigned int samples)
+{
+   const unsigned int num_effects = _al_vector_size(&mixer->effects);
+   const int maxc = al_get_channel_count(mixer->ss.spl_data.chan_conf);
+   float *buf = mixer->ss.spl_data.buffer.f32;
+   unsigned int done;
+   unsigned int i;
+
+   ASSERT(mixer->ss.spl_data.depth == ALLEGRO_AUDIO_DEPTH_FLOAT32);
+
+   for (done = 0; done < samples; done += EFFECT_BLOCK) {
+      int n = samples - done < EFFECT_BLOCK ? samples - done : EFFECT_BLOCK;
+      float *block = buf + done * maxc;
+      double t0 = al_get_time();
+
+      for (i = 0; i < num_effects; i++) {
+         ALLEGRO_MIXER_EFFECT *effect =
+            *(ALLEGRO_MIXER_EFFECT **)_al_vector_ref(&mixer->effects, i);
+         double t1;
+
+         if (is_biquad(effect->type))
+            run_biquad(effect, block, n, maxc);
+         else if (effect->type == ALLEGRO_MIXER_EFFECT_COMPRESSOR)
+            run_compressor(effect, block, n, maxc);
+         else
+            run_delay(effect, block, n, maxc);
+
+         t1 = al_get_time();
+         effect->time += t1 - t0;
+         t0 = t1;
+      }
+   }
+}
+
+
+/* Internal function: _al_kcm_detach_mixer_effects
+ *  Called when the mixer is destroyed.
+ */
+void _al_kcm_detach_mixer_effects(ALLEGRO_MIXER *mixer)
+{
+   while (!_al_vector_is_empty(&mixer->effects)) {
+      ALLEGRO_MIXER_EFFECT *effect =
+         *(ALLEGRO_MIXER_EFFECT **)_al_vector_ref_back(&mixer->effects);
+      _al_vector_delete_at(&mixer->effects,
+         _al_vector_size(&mixer->effects) - 1);
+      effect->mixer = NULL;
+      reset_effect(effect);
+   }
+   _al_vector_free(&mixer->effects);
+}
+
+/* vim: set sts=3 sw=3 et: */
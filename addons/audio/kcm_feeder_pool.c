@@ -0,0 +1,375 @@
+/*         ______   ___    ___
+ *        /\  _  \ /\_ \  /\_ \
+ *        \ \ \L\ \\//\ \ \//\ \      __     __   _ __   ___
+ *         \ \  __ \ \ \ \  \ \ \   /'__`\ /'_ `\/\`'__\/ __`\
+ *          \ \ \/\ \ \_\ \_ \_\ \_/\  __//\ \L\ \ \ \//\ \L\ \
+ *           \ \_\ \_\/\____\/\____\ \____\ \____ \ \_\\ \____/
+ *            \/_/\/_/\/____/\/____/\/____/\/___L\ \/_/ \/___/
+ *                                           /\____/
+ *                                           \_/__/
+ *
+ *      Shared feeder threads for streams loaded from files.
+ *
+ *      Normally every stream created by al_load_audio_stream runs its own
+ *      feeder thread.  If the stream_feeder_threads key in the [audio]
+ *      config section is set, such streams are instead fed by a fixed
+ *      number of shared worker threads.  Streams with free fragments wait
+ *      in a queue, and the workers always take the stream closest to
+ *      running out of audio first.
+ *
+ *      See readme.txt for copyright information.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "allegro5/allegro.h"
+#include "allegro5/allegro_audio.h"
+#include "allegro5/internal/aintern_audio.h"
+#include "allegro5/internal/aintern_vector.h"
+
+ALLEGRO_DEBUG_CHANNEL("audio")
+
+#define MAX_FEEDER_THREADS 64
+
+
+static ALLEGRO_MUTEX *pool_mutex = NULL;
+static ALLEGRO_COND *work_cond = NULL;
+static ALLEGRO_COND *idle_cond = NULL;
+static ALLEGRO_THREAD *pool_threads[MAX_FEEDER_THREADS];
+static int num_pool_threads = 0;
+static bool quit_pool = false;
+
+/* Streams waiting for a worker, protected by pool_mutex. */
+static _AL_VECTOR queued_streams = _AL_VECTOR_INITIALIZER(ALLEGRO_AUDIO_STREAM *);
+
+
+
+static int get_num_feeder_threads(void)
+{
+   const char *val = al_get_config_value(al_get_system_config(),
+      "audio", "stream_feeder_threads");
+   int n;
+
+   if (!val || val[0] == '\0')
+      return 0;
+   n = atoi(val);
+   if (n < 0)
+      n = 0;
+   if (n > MAX_FEEDER_THREADS)
+      n = MAX_FEEDER_THREADS;
+   return n;
+}
+
+
+
+/* Returns the index of the queued stream with the earliest deadline.
+ * Must be called with pool_mutex locked and a non-empty queue.
+ */
+static unsigned int most_urgent_stream(void)
+{
+   unsigned int best = 0;
+   double best_deadline = 0.0;
+   unsigned int i;
+
+   for (i = 0; i < _al_vector_size(&queued_streams); i++) {
+      ALLEGRO_AUDIO_STREAM **slot = _al_vector_ref(&queued_streams, i);
+      if (i == 0 || (*slot)->feed_deadline < best_deadline) {
+         best = i;
+         best_deadline = (*slot)->feed_deadline;
+      }
+   }
+
+   return best;
+}
+
+
+
+/* Must be called with pool_mutex locked. */
+static void queue_stream(ALLEGRO_AUDIO_STREAM *stream)
+{
+   ALLEGRO_AUDIO_STREAM **slot = _al_vector_alloc_back(&queued_streams);
+   if (slot) {
+      *slot = stream;
+      al_signal_cond(work_cond);
+   }
+   else {
+      stream->feed_queued = false;
+   }
+}
+
+
+
+static void *feeder_pool_proc(ALLEGRO_THREAD *self, void *unused)
+{
+   (void)self;
+   (void)unused;
+
+   al_lock_mutex(pool_mutex);
+   while (!quit_pool) {
+      ALLEGRO_AUDIO_STREAM *stream;
+      unsigned int i;
+
+      if (_al_vector_is_empty(&queued_streams)) {
+         al_wait_cond(work_cond, pool_mutex);
+         continue;
+      }
+
+      i = most_urgent_stream();
+      stream = *(ALLEGRO_AUDIO_STREAM **)_al_vector_ref(&queued_streams, i);
+      _al_vector_delete_at(&queued_streams, i);
+      stream->feed_queued = false;
+      stream->feed_busy = true;
+      al_unlock_mutex(pool_mutex);
+
+      while (!stream->is_draining && _al_kcm_feed_stream_fragment(stream))
+         ;
+
+      al_lock_mutex(pool_mutex);
+      stream->feed_busy = false;
+      /* Rescheduled while we were busy with it. */
+      if (stream->feed_queued)
+         queue_stream(stream);
+      al_broadcast_cond(idle_cond);
+   }
+   al_unlock_mutex(pool_mutex);
+
+   return NULL;
+}
+
+
+
+static void emit_finished_event(ALLEGRO_AUDIO_STREAM *stream)
+{
+   ALLEGRO_EVENT fin_event;
+
+   fin_event.user.type = ALLEGRO_EVENT_AUDIO_STREAM_FINISHED;
+   fin_event.user.timestamp = al_get_time();
+   al_emit_user_event(&stream->spl.es, &fin_event, NULL);
+}
+
+
+
+/* Must be called with pool_mutex locked. */
+static bool start_pool(void)
+{
+   int n = get_num_feeder_threads();
+   int i;
+
+   if (num_pool_threads > 0)
+      return true;
+
+   for (i = 0; i < n; i++) {
+      pool_threads[i] = al_create_thread(feeder_pool_proc, NULL);
+      if (!pool_threads[i])
+         break;
+      al_start_thread(pool_threads[i]);
+   }
+   num_pool_threads = i;
+
+   if (num_pool_threads > 0)
+      ALLEGRO_INFO("Started %d stream feeder threads\n", num_pool_threads);
+   return num_pool_threads > 0;
+}
+
+
+
+/* Internal function: _al_kcm_start_pooled_feeder
+ *  Hands the stream to the feeder pool.  Returns false if the pool is not
+ *  enabled, in which case the caller should start a feeder thread itself.
+ */
+bool _al_kcm_start_pooled_feeder(ALLEGRO_AUDIO_STREAM *stream)
+{
+   ASSERT(stream);
+   ASSERT(stream->feeder);
+
+   if (!pool_mutex)
+      return false;
+
+   al_lock_mutex(pool_mutex);
+   if (!start_pool()) {
+      al_unlock_mutex(pool_mutex);
+      return false;
+   }
+
+   stream->feed_pooled = true;
+   stream->feed_busy = false;
+   stream->feed_draining = false;
+
+   /* Fill the stream up front, like a feeder thread would. */
+   stream->feed_deadline = al_get_time();
+   stream->feed_queued = true;
+   queue_stream(stream);
+   al_unlock_mutex(pool_mutex);
+
+   return true;
+}
+
+
+
+/* Internal function: _al_kcm_stop_pooled_feeder
+ *  Takes the stream out of the pool, waiting for a worker that is still
+ *  feeding it.
+ */
+void _al_kcm_stop_pooled_feeder(ALLEGRO_AUDIO_STREAM *stream)
+{
+   ASSERT(stream);
+   ASSERT(stream->feed_pooled);
+
+   if (pool_mutex) {
+      al_lock_mutex(pool_mutex);
+      if (stream->feed_queued && !stream->feed_busy)
+         _al_vector_find_and_delete(&queued_streams, &stream);
+      stream->feed_pooled = false;
+      stream->feed_queued = false;
+      while (stream->feed_busy)
+         al_wait_cond(idle_cond, pool_mutex);
+      al_unlock_mutex(pool_mutex);
+   }
+   else {
+      stream->feed_pooled = false;
+   }
+
+   emit_finished_event(stream);
+}
+
+
+
+/* How long the stream can keep playing from the fragments it already has.
+ * Must be called with the stream's mutex locked.
+ */
+static double time_until_underrun(const ALLEGRO_AUDIO_STREAM *stream)
+{
+   const ALLEGRO_SAMPLE_INSTANCE *spl = &stream->spl;
+   double rate = spl->spl_data.frequency * fabs(spl->speed);
+   int frames;
+
+   if (!spl->is_playing || rate <= 0.0)
+      return 0.0;
+
+   frames = _al_kcm_get_queued_stream_fragments(stream) * spl->spl_data.len
+      - spl->pos;
+
+   return frames > 0 ? frames / rate : 0.0;
+}
+
+
+
+/* Internal function: _al_kcm_schedule_pooled_feeder
+ *  Queues a pooled stream which has free fragments.  Called with the
+ *  stream's mutex locked, when fragment events are emitted or the stream
+ *  is stopped.
+ */
+void _al_kcm_schedule_pooled_feeder(ALLEGRO_AUDIO_STREAM *stream)
+{
+   double deadline;
+
+   if (stream->feed_draining) {
+      if (!stream->spl.is_playing) {
+         stream->feed_draining = false;
+         stream->is_draining = false;
+         emit_finished_event(stream);
+      }
+      return;
+   }
+
+   /* A stopped stream is refilled when it starts playing again, possibly
+    * after being rewound or seeked.
+    */
+   if (!stream->spl.is_playing || !pool_mutex)
+      return;
+
+   deadline = al_get_time() + time_until_underrun(stream);
+
+   al_lock_mutex(pool_mutex);
+   if (!stream->feed_pooled) {
+      /* Being removed from the pool. */
+   }
+   else if (stream->feed_queued) {
+      if (deadline < stream->feed_deadline)
+         stream->feed_deadline = deadline;
+   }
+   else {
+      stream->feed_deadline = deadline;
+      stream->feed_queued = true;
+      if (!stream->feed_busy)
+         queue_stream(stream);
+   }
+   al_unlock_mutex(pool_mutex);
+}
+
+
+
+/* Internal function: _al_kcm_drain_pooled_feeder
+ *  Called by a worker once the feeder ran out of data.  Unlike
+ *  al_drain_audio_stream this returns at once; the finished event is sent
+ *  when the mixer stops the stream (see above).
+ */
+void _al_kcm_drain_pooled_feeder(ALLEGRO_AUDIO_STREAM *stream)
+{
+   ALLEGRO_MUTEX *stream_mutex = stream->spl.mutex;
+
+   if (!al_get_audio_stream_attached(stream)) {
+      al_set_audio_stream_playing(stream, false);
+      emit_finished_event(stream);
+      return;
+   }
+
+   if (stream_mutex)
+      al_lock_mutex(stream_mutex);
+   stream->is_draining = true;
+   stream->feed_draining = true;
+   if (!stream->spl.is_playing)
+      _al_kcm_schedule_pooled_feeder(stream);
+   if (stream_mutex)
+      al_unlock_mutex(stream_mutex);
+}
+
+
+
+/* Internal function: _al_kcm_init_feeder_pool
+ *  The workers themselves are only started once a stream needs them.
+ */
+void _al_kcm_init_feeder_pool(void)
+{
+   if (pool_mutex)
+      return;
+
+   pool_mutex = al_create_mutex();
+   work_cond = al_create_cond();
+   idle_cond = al_create_cond();
+}
+
+
+
+/* Internal function: _al_kcm_shutdown_feeder_pool
+ */
+void _al_kcm_shutdown_feeder_pool(void)
+{
+   int i;
+
+   if (!pool_mutex)
+      return;
+
+   al_lock_mutex(pool_mutex);
+   quit_pool = true;
+   al_broadcast_cond(work_cond);
+   al_unlock_mutex(pool_mutex);
+
+   for (i = 0; i < num_pool_threads; i++) {
+      al_join_thread(pool_threads[i], NULL);
+      al_destroy_thread(pool_threads[i]);
+   }
+   num_pool_threads = 0;
+   quit_pool = false;
+
+   _al_vector_free(&queued_streams);
+   al_destroy_cond(work_cond);
+   al_destroy_cond(idle_cond);
+   al_destroy_mutex(pool_mutex);
+   work_cond = NULL;
+   idle_cond = NULL;
+   pool_mutex = NULL;
+}
+
+/* vim: set sts=3 sw=3 et: */
@@ -88,6 +88,9 @@ static void stream_free(ALLEGRO_SAMPLE_INSTANCE *spl)
          }
 
          _al_vector_free(&mixer->streams);
+         _al_kcm_mixer_free_sinc_tables(mixer);
+         _al_vector_free(&mixer->child_mixers);
+         _al_kcm_detach_mixer_effects(mixer);
 
          if (spl->spl_data.buffer.ptr) {
             ASSERT(spl->spl_data.free_buf);
@@ -136,6 +139,9 @@ void _al_kcm_detach_from_parent(ALLEGRO_SAMPLE_INSTANCE *spl)
 
          spl->spl_read = NULL;
 
+         /* Free its resampling tables, if there are too many. */
+         _al_kcm_mixer_update_sinc_tables(mixer, NULL);
+
          maybe_unlock_mutex(mixer->ss.mutex);
 
          break;
@@ -427,18 +433,24 @@ bool al_set_sample_instance_speed(ALLEGRO_SAMPLE_INSTANCE *spl, float val)
    spl->speed = val;
    if (spl->parent.u.mixer) {
       ALLEGRO_MIXER *mixer = spl->parent.u.mixer;
+      int step = (spl->spl_data.frequency) * spl->speed;
+      void *sinc_tables;
 
-      maybe_lock_mutex(spl->mutex);
-
-      spl->step = (spl->spl_data.frequency) * spl->speed;
-      spl->step_denom = mixer->ss.spl_data.frequency;
       /* Don't wanna be trapped with a step value of 0 */
-      if (spl->step == 0) {
+      if (step == 0) {
          if (spl->speed > 0.0f)
-            spl->step = 1;
+            step = 1;
          else
-            spl->step = -1;
+            step = -1;
       }
+      sinc_tables = _al_kcm_mixer_build_sinc_tables(mixer, step,
+         mixer->ss.spl_data.frequency);
+
+      maybe_lock_mutex(spl->mutex);
+
+      spl->step = step;
+      spl->step_denom = mixer->ss.spl_data.frequency;
+      _al_kcm_mixer_update_sinc_tables(mixer, sinc_tables);
 
       maybe_unlock_mutex(spl->mutex);
    }
@@ -687,4 +699,34 @@ bool al_set_sample_instance_channel_matrix(ALLEGRO_SAMPLE_INSTANCE *spl, const f
 }
 
 
+/* _al_kcm_get_instance_stats:
+ *  Fills in the counters every sample instance, stream and mixer has, and
+ *  clears the others.
+ */
+void _al_kcm_get_instance_stats(const ALLEGRO_SAMPLE_INSTANCE *spl,
+   ALLEGRO_AUDIO_STATS *stats)
+{
+   ALLEGRO_MUTEX *mutex = spl->mutex;
+
+   memset(stats, 0, sizeof(*stats));
+
+   maybe_lock_mutex(mutex);
+   stats->frames = spl->read_frames;
+   stats->read_time = spl->read_time;
+   maybe_unlock_mutex(mutex);
+}
+
+
+/* Function: al_get_sample_instance_stats
+ */
+void al_get_sample_instance_stats(const ALLEGRO_SAMPLE_INSTANCE *spl,
+   ALLEGRO_AUDIO_STATS *stats)
+{
+   ASSERT(spl);
+   ASSERT(stats);
+
+   _al_kcm_get_instance_stats(spl, stats);
+}
+
+
 /* vim: set sts=3 sw=3 et: */
@@ -15,6 +15,12 @@
 #include "allegro5/internal/aintern.h"
 #include "allegro5/internal/aintern_audio.h"
 #include "allegro5/internal/aintern_audio_cfg.h"
+#include "allegro5/internal/aintern_cpu.h"
+#include "allegro5/internal/aintern_workers.h"
+
+#if defined(_AL_SIMD_X86)
+   #include <emmintrin.h>
+#endif
 
 ALLEGRO_DEBUG_CHANNEL("audio")
 
@@ -248,22 +254,6 @@ static bool fix_looped_position(ALLEGRO_SAMPLE_INSTANCE *spl)
 #include "kcm_mixer_helpers.inc"
 
 
-static INLINE int32_t clamp(int32_t val, int32_t min, int32_t max)
-{
-   /* Clamp to min */
-   val -= min;
-   val &= (~val) >> 31;
-   val += min;
-
-   /* Clamp to max */
-   val -= max;
-   val &= val >> 31;
-   val += max;
-
-   return val;
-}
-
-
 /* Mix as many sample values as possible from the source sample into a mixer
  * buffer.  Implements stream_reader_t.
  *
@@ -345,31 +335,1061 @@ static void NAME(void *source, void **vbuf, unsigned int *samples,            \
    (void)buffer_depth;                                                        \
 }
 
-MAKE_MIXER(read_to_mixer_point_float_32, point_spl32, float)
-MAKE_MIXER(read_to_mixer_linear_float_32, linear_spl32, float)
-MAKE_MIXER(read_to_mixer_cubic_float_32, cubic_spl32, float)
-MAKE_MIXER(read_to_mixer_point_int16_t_16, point_spl16, int16_t)
-MAKE_MIXER(read_to_mixer_linear_int16_t_16, linear_spl16, int16_t)
+MAKE_MIXER(read_to_mixer_point_int16_t_16, point_spl16, int16_t)
+MAKE_MIXER(read_to_mixer_linear_int16_t_16, linear_spl16, int16_t)
+
+#undef MAKE_MIXER
+
+
+/* The float mixers below work on blocks of up to this many frames.  Each
+ * block is first resampled into a temporary float buffer by one of the
+ * *_block32 interpolators, switching on the sample depth once per block,
+ * then matrix-mixed into the mixer buffer.  Close to the ends of the sample
+ * or loop, where the interpolators have to adjust the positions they read
+ * from and fix_looped_position may act, they fall back to going one frame
+ * at a time like MAKE_MIXER.  Both ways give the same results.
+ */
+#define MIXER_BLOCK  128
+
+typedef struct RESAMPLER {
+   const void *(*next_sample_value)(SAMP_BUF *samp_buf,
+      const ALLEGRO_SAMPLE_INSTANCE *spl, unsigned int maxc);
+   void (*block)(float *out, const ALLEGRO_SAMPLE_INSTANCE *spl,
+      unsigned int maxc, int pos, int err, int delta, int delta_error, int n);
+   /* Sample positions read around spl->pos: [pos + lo_tap, pos + hi_tap] */
+   int lo_tap, hi_tap;
+   /* How many samples the interpolator lags behind for audio streams. */
+   int stream_lag;
+} RESAMPLER;
+
+static const RESAMPLER point_resampler = {
+   point_spl32, point_block32, 0, 0, 0
+};
+static const RESAMPLER linear_resampler = {
+   linear_spl32, linear_block32, 0, 1, 1
+};
+static const RESAMPLER cubic_resampler = {
+   cubic_spl32, cubic_block32, -1, 2, 2
+};
+
+
+static bool is_stream_playmode(const ALLEGRO_SAMPLE_INSTANCE *spl)
+{
+   return spl->loop == _ALLEGRO_PLAYMODE_STREAM_ONCE ||
+      spl->loop == _ALLEGRO_PLAYMODE_STREAM_ONEDIR;
+}
+
+
+/* Returns how many frames, at most max, can be produced from the current
+ * position on without the per-frame interpolator adjusting any of the
+ * positions it reads, or fix_looped_position doing anything.
+ */
+static int count_block_frames(const ALLEGRO_SAMPLE_INSTANCE *spl,
+   const RESAMPLER *r, int max)
+{
+   int first, last;  /* range of valid spl->pos */
+   int64_t p, n;
+
+   switch (spl->loop) {
+      case ALLEGRO_PLAYMODE_ONCE:
+         first = 0 - r->lo_tap;
+         last = spl->spl_data.len - 1 - r->hi_tap;
+         break;
+
+      case ALLEGRO_PLAYMODE_LOOP:
+      case ALLEGRO_PLAYMODE_BIDIR:
+         first = spl->loop_start - r->lo_tap;
+         last = spl->loop_end - 1 - r->hi_tap;
+         break;
+
+      case _ALLEGRO_PLAYMODE_STREAM_ONCE:
+      case _ALLEGRO_PLAYMODE_STREAM_ONEDIR:
+         /* The stream buffers hold enough history for the interpolators to
+          * look back, and with the lag they never look past spl->pos.
+          */
+         if (spl->step <= 0)
+            return 0;
+         first = spl->pos;
+         last = spl->spl_data.len - 1;
+         break;
+
+      default:
+         return 0;
+   }
+
+   if (spl->pos < first || spl->pos > last)
+      return 0;
+
+   /* Frame k is read from position floor(p + k * step) / step_denom. */
+   p = (int64_t)spl->pos * spl->step_denom + spl->pos_bresenham_error;
+   if (spl->step > 0) {
+      int64_t end = (int64_t)(last + 1) * spl->step_denom;
+      n = (end - p + spl->step - 1) / spl->step;
+   }
+   else {
+      int64_t start = (int64_t)first * spl->step_denom;
+      n = (p - start) / -spl->step + 1;
+   }
+
+   return n < max ? (int)n : max;
+}
+
+
+/* Moves the sample position forward by n frames. */
+static void advance_position(ALLEGRO_SAMPLE_INSTANCE *spl, int n)
+{
+   int64_t p = (int64_t)spl->pos * spl->step_denom +
+      spl->pos_bresenham_error + (int64_t)n * spl->step;
+   int64_t pos = p / spl->step_denom;
+
+   if (p - pos * spl->step_denom < 0)
+      pos--;
+   spl->pos = (int)pos;
+   spl->pos_bresenham_error = (int)(p - pos * spl->step_denom);
+}
+
+
+#if defined(_AL_SIMD_X86)
+
+_AL_TARGET_SSE2
+static void int16_to_float_sse2(float *out, const int16_t *in, int count)
+{
+   const __m128 scale = _mm_set1_ps((float)0x7FFF + 0.5f);
+   int i;
+
+   for (i = 0; i + 8 <= count; i += 8) {
+      __m128i x = _mm_loadu_si128((const __m128i *)(in + i));
+      __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+      __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+      _mm_storeu_ps(out + i, _mm_div_ps(_mm_cvtepi32_ps(lo), scale));
+      _mm_storeu_ps(out + i + 4, _mm_div_ps(_mm_cvtepi32_ps(hi), scale));
+   }
+   for (; i < count; i++) {
+      out[i] = (float)in[i] / ((float)0x7FFF + 0.5f);
+   }
+}
+
+#endif
+
+
+/* Reads n frames starting at pos when playing at the sample's own rate.
+ * Every interpolator then returns the sample values unchanged.
+ */
+static void read_unit_step_block32(float *out,
+   const ALLEGRO_SAMPLE_INSTANCE *spl, unsigned int maxc, int pos, int n)
+{
+   const int first = pos * (int)maxc;
+   const int count = n * (int)maxc;
+
+   switch (spl->spl_data.depth) {
+      case ALLEGRO_AUDIO_DEPTH_FLOAT32:
+         memcpy(out, spl->spl_data.buffer.f32 + first, count * sizeof(float));
+         return;
+
+      case ALLEGRO_AUDIO_DEPTH_INT16:
+#if defined(_AL_SIMD_X86)
+         if (_al_get_cpu_features() & _AL_CPU_SSE2) {
+            int16_to_float_sse2(out, spl->spl_data.buffer.s16 + first, count);
+            return;
+         }
+#endif
+         break;
+
+      default:
+         break;
+   }
+
+   point_block32(out, spl, maxc, pos, 0, 1, 0, n);
+}
+
+
+/* _al_kcm_sample_to_float:
+ *  Converts n frames of the sample data, starting at frame pos, to float,
+ *  to the same values the mixers use.
+ */
+void _al_kcm_sample_to_float(float *out, const ALLEGRO_SAMPLE *data,
+   unsigned int pos, unsigned int n)
+{
+   ALLEGRO_SAMPLE_INSTANCE spl;
+
+   memset(&spl, 0, sizeof(spl));
+   spl.spl_data = *data;
+   spl.step = 1;
+   spl.step_denom = 1;
+
+   read_unit_step_block32(out, &spl, al_get_channel_count(data->chan_conf),
+      pos, n);
+}
+
+
+/* Band-limited resampling, for ALLEGRO_MIXER_QUALITY_SINC.
+ *
+ * Each output frame is a weighted sum of the SINC_TAPS input frames around
+ * its position.  The weights are a Kaiser windowed sinc, cut off at the
+ * lower of the input and output Nyquist frequencies, and only depend on the
+ * fractional part of the position.  Each mixer keeps a few tables of them,
+ * one row per fractional position ("phase"):
+ *
+ * - If the ratio of the sample rates repeats within SINC_MAX_EXACT_PHASES
+ *   output frames, as 44100 Hz <-> 48000 Hz does (147:160), there is a row
+ *   for every position the mixer can reach.
+ * - Otherwise the weights are interpolated between SINC_PHASES + 1 rows.
+ *
+ * The tables are built when a sample is attached or its speed is set,
+ * outside the mixer lock, never while mixing.  Up to SINC_MAX_TABLES tables
+ * are kept; past that, the least recently used tables are freed once no
+ * attached sample needs them.
+ *
+ * Audio streams lag by SINC_HALF samples, so that no sample past spl->pos
+ * is read.
+ */
+#define SINC_HALF             8
+#define SINC_TAPS             (2 * SINC_HALF)
+#define SINC_PHASES           256
+#define SINC_MAX_EXACT_PHASES 512
+#define SINC_CUTOFFS          64    /* steps of cutoff for interpolated tables */
+#define SINC_MAX_TABLES       8
+#define SINC_BETA             7.0
+#define SINC_SPAN             256   /* input frames converted at once */
+
+typedef struct SINC_TABLE {
+   bool exact;
+   int key_step, key_denom;
+      /* exact: the reduced rate ratio, otherwise 0 and the cutoff step */
+   int phases;
+   unsigned int last_used;  /* value of mixer->sinc_block */
+   float *coefs;  /* SINC_TAPS per row */
+   struct SINC_TABLE *next;  /* while being handed to the mixer */
+} SINC_TABLE;
+
+
+static int gcd(int a, int b)
+{
+   while (b != 0) {
+      int t = a % b;
+      a = b;
+      b = t;
+   }
+   return a;
+}
+
+
+/* Modified Bessel function of the first kind, order zero. */
+static double bessel_i0(double x)
+{
+   double sum = 1.0;
+   double term = 1.0;
+   int k;
+
+   for (k = 1; k < 50; k++) {
+      term *= (x / (2 * k)) * (x / (2 * k));
+      sum += term;
+      if (term < sum * 1e-12)
+         break;
+   }
+   return sum;
+}
+
+
+/* Fills in the weights for a frame lying t (0 <= t <= 1) past the tap at
+ * SINC_HALF - 1, with the cutoff fc relative to the input Nyquist frequency.
+ * The weights are scaled to add up to one.
+ */
+static void make_sinc_row(float *row, double t, double fc)
+{
+   double h[SINC_TAPS];
+   double sum = 0.0;
+   int j;
+
+   for (j = 0; j < SINC_TAPS; j++) {
+      double x = j - (SINC_HALF - 1) - t;
+      double u = x / SINC_HALF;
+
+      if (fabs(u) >= 1.0) {
+         h[j] = 0.0;
+      }
+      else {
+         double y = ALLEGRO_PI * fc * x;
+         h[j] = (y == 0.0 ? 1.0 : sin(y) / y) *
+            bessel_i0(SINC_BETA * sqrt(1.0 - u * u));
+      }
+      sum += h[j];
+   }
+
+   for (j = 0; j < SINC_TAPS; j++)
+      row[j] = h[j] / sum;
+}
+
+
+static SINC_TABLE *create_sinc_table(bool exact, int key_step, int key_denom)
+{
+   int phases = exact ? key_denom : SINC_PHASES;
+   int rows = exact ? phases : phases + 1;
+   double fc;
+   SINC_TABLE *table;
+   int r;
+
+   table = al_malloc(sizeof(*table) + rows * SINC_TAPS * sizeof(float));
+   if (!table)
+      return NULL;
+
+   table->exact = exact;
+   table->key_step = key_step;
+   table->key_denom = key_denom;
+   table->phases = phases;
+   table->coefs = (float *)(table + 1);
+
+   if (exact)
+      fc = key_step > key_denom ? (double)key_denom / key_step : 1.0;
+   else
+      fc = (double)key_denom / SINC_CUTOFFS;
+
+   for (r = 0; r < rows; r++)
+      make_sinc_row(table->coefs + r * SINC_TAPS, (double)r / phases, fc);
+
+   return table;
+}
+
+
+/* Works out the keys of the tables for a sample playing at step/denom: the
+ * exact table, and the interpolated table, whose key_denom is the cutoff.
+ * Returns false if the ratio does not repeat often enough for an exact
+ * table.
+ */
+static bool get_sinc_keys(int step, int denom, int *exact_step,
+   int *exact_denom, int *cutoff)
+{
+   int g;
+
+   if (step < 0)
+      step = -step;
+   g = gcd(step, denom);
+   *exact_step = step / g;
+   *exact_denom = denom / g;
+
+   /* Round the cutoff down, so that there is never any aliasing. */
+   if (step <= denom)
+      *cutoff = SINC_CUTOFFS;
+   else
+      *cutoff = (int)((int64_t)denom * SINC_CUTOFFS / step);
+   if (*cutoff < 1)
+      *cutoff = 1;
+
+   return *exact_denom <= SINC_MAX_EXACT_PHASES;
+}
+
+
+static SINC_TABLE *find_sinc_table(ALLEGRO_MIXER *mixer, bool exact,
+   int key_step, int key_denom)
+{
+   unsigned int i;
+
+   for (i = 0; i < _al_vector_size(&mixer->sinc_tables); i++) {
+      SINC_TABLE *table = *(SINC_TABLE **)_al_vector_ref(&mixer->sinc_tables, i);
+      if (table->exact == exact && table->key_step == key_step &&
+            table->key_denom == key_denom) {
+         return table;
+      }
+   }
+   return NULL;
+}
+
+
+/* Returns the table to use for the sample's current speed, given the
+ * Bresenham error of a frame.  Only looks the table up, it was built when
+ * the speed was set; returns NULL if that failed.
+ */
+static const SINC_TABLE *get_sinc_table(const ALLEGRO_SAMPLE_INSTANCE *spl,
+   int err)
+{
+   ALLEGRO_MIXER *mixer = spl->parent.u.mixer;
+   int exact_step, exact_denom, cutoff;
+   SINC_TABLE *table = NULL;
+
+   if (get_sinc_keys(spl->step, spl->step_denom, &exact_step, &exact_denom,
+         &cutoff) && err % (spl->step_denom / exact_denom) == 0) {
+      table = find_sinc_table(mixer, true, exact_step, exact_denom);
+   }
+   if (!table)
+      table = find_sinc_table(mixer, false, 0, cutoff);
+   if (table)
+      table->last_used = mixer->sinc_block;
+
+   return table;
+}
+
+
+/* _al_kcm_mixer_build_sinc_tables:
+ *  Builds the resampling tables that a sample playing at step/step_denom
+ *  needs and the mixer does not have yet, if it uses
+ *  ALLEGRO_MIXER_QUALITY_SINC.  Call it without holding the mixer lock, and
+ *  pass the result to _al_kcm_mixer_update_sinc_tables once the step is set.
+ */
+void *_al_kcm_mixer_build_sinc_tables(ALLEGRO_MIXER *mixer, int step,
+   int step_denom)
+{
+   SINC_TABLE *tables = NULL;
+   SINC_TABLE *table;
+   int exact_step, exact_denom, cutoff;
+   bool need_exact, need_interp;
+
+   maybe_lock_mutex(mixer->ss.mutex);
+   if (mixer->quality != ALLEGRO_MIXER_QUALITY_SINC ||
+         mixer->ss.spl_data.depth != ALLEGRO_AUDIO_DEPTH_FLOAT32) {
+      maybe_unlock_mutex(mixer->ss.mutex);
+      return NULL;
+   }
+   need_exact = get_sinc_keys(step, step_denom, &exact_step, &exact_denom,
+      &cutoff) && !find_sinc_table(mixer, true, exact_step, exact_denom);
+   need_interp = !find_sinc_table(mixer, false, 0, cutoff);
+   maybe_unlock_mutex(mixer->ss.mutex);
+
+   /* The interpolated table is needed even with an exact one, for when the
+    * speed is changed while the sample plays.
+    */
+   if (need_exact) {
+      table = create_sinc_table(true, exact_step, exact_denom);
+      if (table) {
+         table->next = tables;
+         tables = table;
+      }
+   }
+   if (need_interp) {
+      table = create_sinc_table(false, 0, cutoff);
+      if (table) {
+         table->next = tables;
+         tables = table;
+      }
+   }
+
+   return tables;
+}
+
+
+/* Returns whether a sample attached to the mixer uses the table. */
+static bool sinc_table_in_use(ALLEGRO_MIXER *mixer, const SINC_TABLE *table)
+{
+   int exact_step, exact_denom, cutoff;
+   bool has_exact;
+   unsigned int i;
+
+   for (i = 0; i < _al_vector_size(&mixer->streams); i++) {
+      ALLEGRO_SAMPLE_INSTANCE *spl =
+         *(ALLEGRO_SAMPLE_INSTANCE **)_al_vector_ref(&mixer->streams, i);
+
+      if (spl->is_mixer)
+         continue;
+      has_exact = get_sinc_keys(spl->step, spl->step_denom, &exact_step,
+         &exact_denom, &cutoff);
+      if (table->exact) {
+         if (has_exact && table->key_step == exact_step &&
+               table->key_denom == exact_denom) {
+            return true;
+         }
+      }
+      else if (table->key_denom == cutoff) {
+         return true;
+      }
+   }
+   return false;
+}
+
+
+/* _al_kcm_mixer_update_sinc_tables:
+ *  Adds the tables from _al_kcm_mixer_build_sinc_tables to the mixer, then
+ *  frees the least recently used tables that no attached sample needs, until
+ *  at most SINC_MAX_TABLES are left.  The mixer lock must be held.
+ */
+void _al_kcm_mixer_update_sinc_tables(ALLEGRO_MIXER *mixer, void *tables)
+{
+   SINC_TABLE *table = tables;
+   SINC_TABLE *next;
+   SINC_TABLE **slot;
+
+   for (; table; table = next) {
+      next = table->next;
+
+      /* Another thread may have added it meanwhile. */
+      if (find_sinc_table(mixer, table->exact, table->key_step,
+            table->key_denom)) {
+         al_free(table);
+         continue;
+      }
+
+      slot = _al_vector_alloc_back(&mixer->sinc_tables);
+      if (!slot) {
+         al_free(table);
+         continue;
+      }
+      table->last_used = mixer->sinc_block;
+      *slot = table;
+   }
+
+   while (_al_vector_size(&mixer->sinc_tables) > SINC_MAX_TABLES) {
+      unsigned int age, max_age = 0;
+      int oldest = -1;
+      unsigned int i;
+
+      for (i = 0; i < _al_vector_size(&mixer->sinc_tables); i++) {
+         table = *(SINC_TABLE **)_al_vector_ref(&mixer->sinc_tables, i);
+         age = mixer->sinc_block - table->last_used;
+         if ((oldest < 0 || age > max_age) && !sinc_table_in_use(mixer, table)) {
+            max_age = age;
+            oldest = i;
+         }
+      }
+      if (oldest < 0)
+         break;
+
+      al_free(*(SINC_TABLE **)_al_vector_ref(&mixer->sinc_tables, oldest));
+      _al_vector_delete_at(&mixer->sinc_tables, oldest);
+   }
+}
+
+
+/* _al_kcm_mixer_free_sinc_tables:
+ *  Frees the resampling tables of a mixer.
+ */
+void _al_kcm_mixer_free_sinc_tables(ALLEGRO_MIXER *mixer)
+{
+   unsigned int i;
+
+   for (i = 0; i < _al_vector_size(&mixer->sinc_tables); i++)
+      al_free(*(SINC_TABLE **)_al_vector_ref(&mixer->sinc_tables, i));
+   _al_vector_free(&mixer->sinc_tables);
+}
+
+
+/* Returns the weights for a frame with the given Bresenham error, using buf
+ * if they need to be interpolated.
+ */
+static INLINE const float *sinc_coefs(float *buf, const SINC_TABLE *table,
+   int err, int step_denom)
+{
+   const float *c0, *c1;
+   int64_t x;
+   float f;
+   int j;
+
+   if (table->exact) {
+      /* err is a multiple of step_denom / phases here. */
+      x = (int64_t)err * table->phases / step_denom;
+      return table->coefs + x * SINC_TAPS;
+   }
+
+   x = (int64_t)err * SINC_PHASES;
+   c0 = table->coefs + (x / step_denom) * SINC_TAPS;
+   c1 = c0 + SINC_TAPS;
+   f = (float)(x % step_denom) / step_denom;
+   for (j = 0; j < SINC_TAPS; j++)
+      buf[j] = c0[j] + f * (c1[j] - c0[j]);
+   return buf;
+}
+
+
+/* Computes one frame of maxc channels from SINC_TAPS input frames at x. */
+static INLINE void sinc_dot(float *out, const float *x, const float *c,
+   unsigned int maxc)
+{
+   unsigned int i;
+   int j;
+
+   for (i = 0; i < maxc; i++) {
+      float s = 0.0f;
+      for (j = 0; j < SINC_TAPS; j++)
+         s += c[j] * x[j * maxc + i];
+      out[i] = s;
+   }
+}
+
+
+static int sinc_stream_lag(const ALLEGRO_SAMPLE_INSTANCE *spl)
+{
+   return is_stream_playmode(spl) ? SINC_HALF : 0;
+}
+
+
+/* Reads the frame at pos as float, wrapping around loops and reading
+ * silence outside a sample played once.
+ */
+static void sinc_read_tap(float *out, const ALLEGRO_SAMPLE_INSTANCE *spl,
+   unsigned int maxc, int pos)
+{
+   unsigned int i;
+
+   switch (spl->loop) {
+      case ALLEGRO_PLAYMODE_ONCE:
+         if (pos < 0 || pos >= (int)spl->spl_data.len) {
+            for (i = 0; i < maxc; i++)
+               out[i] = 0.0f;
+            return;
+         }
+         break;
+
+      case ALLEGRO_PLAYMODE_LOOP:
+      case ALLEGRO_PLAYMODE_BIDIR:
+         /* Bidirectional loops should really bounce, like with cubic
+          * interpolation that's hardly noticeable.
+          */
+         if (spl->loop_end > spl->loop_start) {
+            int len = spl->loop_end - spl->loop_start;
+            pos = (pos - spl->loop_start) % len;
+            if (pos < 0)
+               pos += len;
+            pos += spl->loop_start;
+         }
+         break;
+
+      default:
+         break;
+   }
+
+   read_unit_step_block32(out, spl, maxc, pos, 1);
+}
+
+
+static const void *sinc_spl32(SAMP_BUF *samp_buf,
+   const ALLEGRO_SAMPLE_INSTANCE *spl, unsigned int maxc)
+{
+   const int first = spl->pos - sinc_stream_lag(spl) - (SINC_HALF - 1);
+   const SINC_TABLE *table = get_sinc_table(spl, spl->pos_bresenham_error);
+   float x[SINC_TAPS * ALLEGRO_MAX_CHANNELS];
+   float buf[SINC_TAPS];
+   int j;
+
+   if (!table) {
+      sinc_read_tap(samp_buf->f32, spl, maxc, first + SINC_HALF - 1);
+      return samp_buf->f32;
+   }
+
+   for (j = 0; j < SINC_TAPS; j++)
+      sinc_read_tap(x + j * maxc, spl, maxc, first + j);
+
+   sinc_dot(samp_buf->f32, x,
+      sinc_coefs(buf, table, spl->pos_bresenham_error, spl->step_denom), maxc);
+   return samp_buf->f32;
+}
+
+
+static void sinc_block32(float *out, const ALLEGRO_SAMPLE_INSTANCE *spl,
+   unsigned int maxc, int pos, int err, int delta, int delta_error, int n)
+{
+   const int lag = sinc_stream_lag(spl);
+   const int step = spl->step < 0 ? -spl->step : spl->step;
+   const SINC_TABLE *table = get_sinc_table(spl, err);
+   float span[SINC_SPAN * ALLEGRO_MAX_CHANNELS];
+   float buf[SINC_TAPS];
+
+   if (!table) {
+      point_block32(out, spl, maxc, pos - lag, err, delta, delta_error, n);
+      return;
+   }
+
+   while (n > 0) {
+      /* Take as many frames as fit the span, converting their input once. */
+      int m = (int)((int64_t)(SINC_SPAN - SINC_TAPS - 1) * spl->step_denom
+         / step) + 1;
+      int64_t last;
+      int last_pos, lo, hi, first;
+      const float *x;
+      int k;
+
+      if (m > n)
+         m = n;
+
+      last = (int64_t)pos * spl->step_denom + err
+         + (int64_t)(m - 1) * spl->step;
+      last_pos = (int)(last / spl->step_denom);
+      if (last - (int64_t)last_pos * spl->step_denom < 0)
+         last_pos--;
+      lo = pos < last_pos ? pos : last_pos;
+      hi = pos < last_pos ? last_pos : pos;
+      first = lo - lag - (SINC_HALF - 1);
+
+      if (spl->spl_data.depth == ALLEGRO_AUDIO_DEPTH_FLOAT32) {
+         x = spl->spl_data.buffer.f32 + first * (int)maxc;
+      }
+      else {
+         read_unit_step_block32(span, spl, maxc, first,
+            hi - lo + SINC_TAPS);
+         x = span;
+      }
+
+      for (k = 0; k < m; k++) {
+         sinc_dot(out, x + (pos - lo) * (int)maxc,
+            sinc_coefs(buf, table, err, spl->step_denom), maxc);
+         out += maxc;
+
+         pos += delta;
+         err += delta_error;
+         if (err >= spl->step_denom) {
+            pos++;
+            err -= spl->step_denom;
+         }
+      }
+
+      n -= m;
+   }
+}
+
+static const RESAMPLER sinc_resampler = {
+   sinc_spl32, sinc_block32, -(SINC_HALF - 1), SINC_HALF, SINC_HALF
+};
+
+
+/* Adds n frames of maxc channels, mixed down to dest_maxc channels by
+ * the matrix, to buf.  The products are summed in the same order as in
+ * MAKE_MIXER.
+ */
+static void mix_block32_c(float *buf, const float *s, int n, size_t maxc,
+   const float *matrix, size_t dest_maxc)
+{
+   int k;
+   size_t c, j;
+
+   for (k = 0; k < n; k++) {
+      for (c = 0; c < dest_maxc; c++) {
+         const float *m = matrix + c * maxc;
+         float x = *buf;
+         for (j = maxc; j-- > 0; ) {
+            x += s[j] * m[j];
+         }
+         *buf++ = x;
+      }
+      s += maxc;
+   }
+}
+
+
+#if defined(_AL_SIMD_X86)
+
+/* Mono and stereo sources into a stereo mixer. */
+_AL_TARGET_SSE2
+static bool mix_block32_sse2(float *buf, const float *s, int n, size_t maxc,
+   const float *m, size_t dest_maxc)
+{
+   int k = 0;
+
+   if (dest_maxc != 2)
+      return false;
+
+   if (maxc == 1) {
+      const __m128 mm = _mm_setr_ps(m[0], m[1], m[0], m[1]);
+      for (; k + 4 <= n; k += 4) {
+         __m128 x = _mm_loadu_ps(s + k);
+         __m128 b0 = _mm_loadu_ps(buf + 2 * k);
+         __m128 b1 = _mm_loadu_ps(buf + 2 * k + 4);
+         b0 = _mm_add_ps(b0, _mm_mul_ps(_mm_unpacklo_ps(x, x), mm));
+         b1 = _mm_add_ps(b1, _mm_mul_ps(_mm_unpackhi_ps(x, x), mm));
+         _mm_storeu_ps(buf + 2 * k, b0);
+         _mm_storeu_ps(buf + 2 * k + 4, b1);
+      }
+   }
+   else if (maxc == 2) {
+      const __m128 ml = _mm_setr_ps(m[0], m[2], m[0], m[2]);
+      const __m128 mr = _mm_setr_ps(m[1], m[3], m[1], m[3]);
+      for (; k + 2 <= n; k += 2) {
+         __m128 x = _mm_loadu_ps(s + 2 * k);
+         __m128 l = _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 2, 0, 0));
+         __m128 r = _mm_shuffle_ps(x, x, _MM_SHUFFLE(3, 3, 1, 1));
+         __m128 b = _mm_loadu_ps(buf + 2 * k);
+         b = _mm_add_ps(b, _mm_mul_ps(r, mr));
+         b = _mm_add_ps(b, _mm_mul_ps(l, ml));
+         _mm_storeu_ps(buf + 2 * k, b);
+      }
+   }
+   else {
+      return false;
+   }
+
+   mix_block32_c(buf + 2 * k, s + maxc * k, n - k, maxc, m, dest_maxc);
+   return true;
+}
+
+#endif
+
+
+static void mix_block32(float *buf, const float *s, int n, size_t maxc,
+   const float *matrix, size_t dest_maxc)
+{
+#if defined(_AL_SIMD_X86)
+   if ((_al_get_cpu_features() & _AL_CPU_SSE2) &&
+         mix_block32_sse2(buf, s, n, maxc, matrix, dest_maxc))
+      return;
+#endif
+   mix_block32_c(buf, s, n, maxc, matrix, dest_maxc);
+}
+
+
+/* Mix as many sample values as possible from the source sample into a float
+ * mixer buffer, like MAKE_MIXER but a block at a time.
+ *
+ * The interpolators read the sample data from src, which is either spl itself
+ * or a copy of it playing the cached float version of the sample.  The copy
+ * is kept at the same position as spl.
+ */
+static INLINE void mix_float_32(ALLEGRO_SAMPLE_INSTANCE *spl,
+   ALLEGRO_SAMPLE_INSTANCE *src, float *buf, size_t samples_l,
+   size_t dest_maxc, const RESAMPLER *r)
+{
+   size_t maxc = al_get_channel_count(spl->spl_data.chan_conf);
+   int delta, delta_error;
+   SAMP_BUF samp_buf;
+   float block[MIXER_BLOCK * ALLEGRO_MAX_CHANNELS];
+
+   BRESENHAM;
+
+   while (samples_l > 0) {
+      int old_step = spl->step;
+      int n;
+
+      if (!fix_looped_position(spl))
+         return;
+      if (old_step != spl->step) {
+         BRESENHAM;
+      }
+      if (src != spl) {
+         src->pos = spl->pos;
+         src->pos_bresenham_error = spl->pos_bresenham_error;
+         src->step = spl->step;
+      }
+
+      n = count_block_frames(spl, r,
+         samples_l < MIXER_BLOCK ? (int)samples_l : MIXER_BLOCK);
+
+      if (n > 0) {
+         if (delta == 1 && delta_error == 0 &&
+               spl->pos_bresenham_error == 0) {
+            int lag = is_stream_playmode(spl) ? r->stream_lag : 0;
+            read_unit_step_block32(block, src, maxc, spl->pos - lag, n);
+         }
+         else {
+            r->block(block, src, maxc, spl->pos, spl->pos_bresenham_error,
+               delta, delta_error, n);
+         }
+         mix_block32(buf, block, n, maxc, spl->matrix, dest_maxc);
+         advance_position(spl, n);
+      }
+      else {
+         const float *s = r->next_sample_value(&samp_buf, src, maxc);
+         mix_block32(buf, s, 1, maxc, spl->matrix, dest_maxc);
+         n = 1;
+
+         spl->pos += delta;
+         spl->pos_bresenham_error += delta_error;
+         if (spl->pos_bresenham_error >= spl->step_denom) {
+            spl->pos++;
+            spl->pos_bresenham_error -= spl->step_denom;
+         }
+      }
+
+      buf += n * dest_maxc;
+      samples_l -= n;
+   }
+   fix_looped_position(spl);
+}
+
+static INLINE void read_to_mixer_float_32(void *source, void **vbuf,
+   unsigned int *samples, size_t dest_maxc, const RESAMPLER *r)
+{
+   ALLEGRO_SAMPLE_INSTANCE *spl = (ALLEGRO_SAMPLE_INSTANCE *)source;
+   const ALLEGRO_SAMPLE *f32 = NULL;
+   ALLEGRO_SAMPLE_INSTANCE copy;
+
+   if (!spl->is_playing)
+      return;
+
+   if (spl->spl_data.depth != ALLEGRO_AUDIO_DEPTH_FLOAT32 &&
+         !is_stream_playmode(spl))
+      f32 = _al_kcm_acquire_float_sample(&spl->spl_data);
+
+   if (f32) {
+      copy = *spl;
+      copy.spl_data = *f32;
+      mix_float_32(spl, &copy, *vbuf, *samples, dest_maxc, r);
+      _al_kcm_release_float_sample(f32);
+   }
+   else {
+      mix_float_32(spl, spl, *vbuf, *samples, dest_maxc, r);
+   }
+}
+
+static void read_to_mixer_point_float_32(void *source, void **vbuf,
+   unsigned int *samples, ALLEGRO_AUDIO_DEPTH buffer_depth, size_t dest_maxc)
+{
+   (void)buffer_depth;
+   read_to_mixer_float_32(source, vbuf, samples, dest_maxc, &point_resampler);
+}
+
+static void read_to_mixer_linear_float_32(void *source, void **vbuf,
+   unsigned int *samples, ALLEGRO_AUDIO_DEPTH buffer_depth, size_t dest_maxc)
+{
+   (void)buffer_depth;
+   read_to_mixer_float_32(source, vbuf, samples, dest_maxc, &linear_resampler);
+}
+
+static void read_to_mixer_cubic_float_32(void *source, void **vbuf,
+   unsigned int *samples, ALLEGRO_AUDIO_DEPTH buffer_depth, size_t dest_maxc)
+{
+   (void)buffer_depth;
+   read_to_mixer_float_32(source, vbuf, samples, dest_maxc, &cubic_resampler);
+}
+
+static void read_to_mixer_sinc_float_32(void *source, void **vbuf,
+   unsigned int *samples, ALLEGRO_AUDIO_DEPTH buffer_depth, size_t dest_maxc)
+{
+   (void)buffer_depth;
+   read_to_mixer_float_32(source, vbuf, samples, dest_maxc, &sinc_resampler);
+}
+
+#undef MIXER_BLOCK
+
+
+static bool mix_streams(ALLEGRO_MIXER *m, unsigned int samples,
+   bool apply_gain);
+
+
+/* A child mixer evaluated by mix_children. */
+typedef struct CHILD_MIXER {
+   ALLEGRO_MIXER *mixer;
+   bool mixed;
+} CHILD_MIXER;
+
+typedef struct CHILD_MIXER_JOB {
+   CHILD_MIXER *children;
+   unsigned int samples;
+} CHILD_MIXER_JOB;
+
+
+static void mix_child_job(int job, void *arg)
+{
+   CHILD_MIXER_JOB *j = arg;
+   CHILD_MIXER *child = &j->children[job];
+   double t0 = al_get_time();
+
+   child->mixed = mix_streams(child->mixer, j->samples, true);
+
+   /* As spl_read would in mix_streams. */
+   if (child->mixed)
+      child->mixer->ss.read_frames += j->samples;
+   child->mixer->ss.read_time += al_get_time() - t0;
+}
+
+
+/* Mixes the child mixers attached to the mixer into their own buffers in
+ * parallel, if the mixer was created with parallel_mixers set and there
+ * are at least two of them.  The children are independent of each other,
+ * so this is safe while the calling thread holds the mixer's mutex.
+ * Returns the number of children mixed, which are listed in
+ * m->child_mixers.
+ */
+static int mix_children(ALLEGRO_MIXER *m, unsigned int samples)
+{
+   CHILD_MIXER_JOB job;
+   int num_children = 0;
+   int child = 0;
+   unsigned int i;
+
+   if (!m->parallel)
+      return 0;
+
+   for (i = 0; i < _al_vector_size(&m->streams); i++) {
+      ALLEGRO_SAMPLE_INSTANCE **slot = _al_vector_ref(&m->streams, i);
+      if ((*slot)->is_mixer && (*slot)->is_playing)
+         num_children++;
+   }
+   if (num_children < 2)
+      return 0;
+
+   /* The vector never shrinks, so this rarely allocates. */
+   while ((int)_al_vector_size(&m->child_mixers) < num_children) {
+      if (!_al_vector_alloc_back(&m->child_mixers))
+         return 0;
+   }
+   for (i = 0; i < _al_vector_size(&m->streams); i++) {
+      ALLEGRO_SAMPLE_INSTANCE **slot = _al_vector_ref(&m->streams, i);
+      CHILD_MIXER *c;
+
+      if (!(*slot)->is_mixer || !(*slot)->is_playing)
+         continue;
+      c = _al_vector_ref(&m->child_mixers, child++);
+      c->mixer = (ALLEGRO_MIXER *)*slot;
+      c->mixed = false;
+   }
+
+   job.children = _al_vector_ref_front(&m->child_mixers);
+   job.samples = samples;
+   _al_run_parallel(num_children, mix_child_job, &job);
+
+   return num_children;
+}
+
 
-#undef MAKE_MIXER
+/* Adds the mixed output of a child mixer to its parent's buffer. */
+static void add_to_parent(const ALLEGRO_MIXER *mixer, void *buf,
+   unsigned int samples)
+{
+   int maxc = al_get_channel_count(mixer->ss.spl_data.chan_conf);
+   int samples_l = samples * maxc;
+
+   switch (mixer->ss.spl_data.depth) {
+      case ALLEGRO_AUDIO_DEPTH_FLOAT32: {
+         /* We don't need to clamp in the mixer yet. */
+         float *lbuf = buf;
+         float *src = mixer->ss.spl_data.buffer.f32;
+         while (samples_l-- > 0) {
+            *lbuf += *src;
+            lbuf++;
+            src++;
+         }
+         break;
+      }
 
+      case ALLEGRO_AUDIO_DEPTH_INT16: {
+         int16_t *lbuf = buf;
+         int16_t *src = mixer->ss.spl_data.buffer.s16;
+         while (samples_l-- > 0) {
+            int32_t x = *lbuf + *src;
+            if (x < -32768)
+               x = -32768;
+            else if (x > 32767)
+               x = 32767;
+            *lbuf = (int16_t)x;
+            lbuf++;
+            src++;
+         }
+         break;
+      }
 
-/* _al_kcm_mixer_read:
- *  Mixes the streams attached to the mixer and writes additively to the
- *  specified buffer (or if *buf is NULL, indicating a voice, convert it and
- *  set it to the buffer pointer).
+      case ALLEGRO_AUDIO_DEPTH_INT8:
+      case ALLEGRO_AUDIO_DEPTH_INT24:
+      case ALLEGRO_AUDIO_DEPTH_UINT8:
+      case ALLEGRO_AUDIO_DEPTH_UINT16:
+      case ALLEGRO_AUDIO_DEPTH_UINT24:
+         /* Unsupported mixer depths. */
+         ASSERT(false);
+         break;
+   }
+}
+
+
+/* Mixes the streams attached to the mixer into the mixer's own buffer,
+ * then applies the post-processing callback and the gain.  Returns false
+ * if there is nothing to play.
  */
-void _al_kcm_mixer_read(void *source, void **buf, unsigned int *samples,
-   ALLEGRO_AUDIO_DEPTH buffer_depth, size_t dest_maxc)
+static bool mix_streams(ALLEGRO_MIXER *m, unsigned int samples,
+   bool apply_gain)
 {
    const ALLEGRO_MIXER *mixer;
-   ALLEGRO_MIXER *m = (ALLEGRO_MIXER *)source;
    int maxc = al_get_channel_count(m->ss.spl_data.chan_conf);
-   int samples_l = *samples;
+   int samples_l = samples;
+   int num_children;
+   int child = 0;
+   double t0;
    int i;
 
    if (!m->ss.is_playing)
-      return;
+      return false;
 
    /* Make sure the mixer buffer is big enough. */
    if (m->ss.spl_data.len*maxc < samples_l*maxc) {
@@ -379,35 +1399,66 @@ void _al_kcm_mixer_read(void *source, void **buf, unsigned int *samples,
          _al_set_error(ALLEGRO_GENERIC_ERROR,
             "Out of memory allocating mixer buffer");
          m->ss.spl_data.len = 0;
-         return;
+         return false;
       }
       m->ss.spl_data.len = samples_l;
    }
 
+   m->sinc_block++;
+   num_children = mix_children(m, samples);
+
    mixer = m;
 
    /* Clear the buffer to silence. */
    memset(mixer->ss.spl_data.buffer.ptr, 0, samples_l * maxc * al_get_audio_depth_size(mixer->ss.spl_data.depth));
 
-   /* Mix the streams into the mixer buffer. */
+   /* Mix the streams into the mixer buffer.  Child mixers which were
+    * already mixed in parallel are added in the same order they would be
+    * mixed in otherwise, so the result is the same.
+    */
+   t0 = al_get_time();
    for (i = _al_vector_size(&mixer->streams) - 1; i >= 0; i--) {
       ALLEGRO_SAMPLE_INSTANCE **slot = _al_vector_ref(&mixer->streams, i);
       ALLEGRO_SAMPLE_INSTANCE *spl = *slot;
+      bool was_playing = spl->is_playing;
+      double t1;
       ASSERT(spl->spl_read);
-      spl->spl_read(spl, (void **) &mixer->ss.spl_data.buffer.ptr, samples,
+
+      if (num_children > 0 && spl->is_mixer && was_playing) {
+         /* The children are listed in the opposite order. */
+         CHILD_MIXER *c = _al_vector_ref(&mixer->child_mixers,
+            num_children - 1 - child++);
+         ASSERT(c->mixer == (ALLEGRO_MIXER *)spl);
+         if (c->mixed)
+            add_to_parent(c->mixer, mixer->ss.spl_data.buffer.ptr, samples);
+         t0 = al_get_time();
+         continue;
+      }
+
+      spl->spl_read(spl, (void **) &mixer->ss.spl_data.buffer.ptr, &samples,
          m->ss.spl_data.depth, maxc);
+
+      /* One clock read per stream keeps this cheap enough to leave on. */
+      t1 = al_get_time();
+      if (was_playing)
+         spl->read_frames += samples;
+      spl->read_time += t1 - t0;
+      t0 = t1;
    }
 
+   if (!_al_vector_is_empty(&m->effects))
+      _al_kcm_run_mixer_effects(m, samples);
+
    /* Call the post-processing callback. */
    if (mixer->postprocess_callback) {
       mixer->postprocess_callback(mixer->ss.spl_data.buffer.ptr,
-         *samples, mixer->pp_callback_userdata);
+         samples, mixer->pp_callback_userdata);
    }
 
    samples_l *= maxc;
 
    /* Apply the gain if necessary. */
-   if (mixer->ss.gain != 1.0f) {
+   if (apply_gain && mixer->ss.gain != 1.0f) {
       float mixer_gain = mixer->ss.gain;
       unsigned long i = samples_l;
 
@@ -439,174 +1490,388 @@ void _al_kcm_mixer_read(void *source, void **buf, unsigned int *samples,
       }
    }
 
-   /* Feeding to a non-voice.
-    * Currently we only support mixers of the same audio depth doing this.
-    */
-   if (*buf) {
-      switch (m->ss.spl_data.depth) {
-         case ALLEGRO_AUDIO_DEPTH_FLOAT32: {
-            /* We don't need to clamp in the mixer yet. */
-            float *lbuf = *buf;
-            float *src = mixer->ss.spl_data.buffer.f32;
-            while (samples_l-- > 0) {
-               *lbuf += *src;
-               lbuf++;
-               src++;
-            }
-            break;
+   return true;
+}
 
-         case ALLEGRO_AUDIO_DEPTH_INT16: {
-            int16_t *lbuf = *buf;
-            int16_t *src = mixer->ss.spl_data.buffer.s16;
-            while (samples_l-- > 0) {
-               int32_t x = *lbuf + *src;
-               if (x < -32768)
-                  x = -32768;
-               else if (x > 32767)
-                  x = 32767;
-               *lbuf = (int16_t)x;
-               lbuf++;
-               src++;
-            }
-            break;
-         }
 
-         case ALLEGRO_AUDIO_DEPTH_INT8:
-         case ALLEGRO_AUDIO_DEPTH_INT24:
-         case ALLEGRO_AUDIO_DEPTH_UINT8:
-         case ALLEGRO_AUDIO_DEPTH_UINT16:
-         case ALLEGRO_AUDIO_DEPTH_UINT24:
-            /* Unsupported mixer depths. */
-            ASSERT(false);
-            break;
-         }
-      }
-      return;
+/* Conversion of the output of a float mixer for its voice.
+ *
+ * The mixer's gain is applied on the way, and the samples are scaled,
+ * clamped and packed into the voice's format in one pass.  Without dither
+ * the values are truncated, with dither they are rounded after adding TPDF
+ * noise of up to 1 LSB: the difference of two uniform random numbers.  Each
+ * of the four SSE lanes has its own xorshift generator, and sample i always
+ * uses lane i % 4, so the SSE2 and plain C versions give the same result.
+ */
+typedef struct VOICE_CONV {
+   float gain;
+   float scale;
+   float lo, hi;
+   uint32_t *dither;             /* four generator states, or NULL */
+} VOICE_CONV;
+
+
+static INLINE uint32_t xorshift32(uint32_t *state)
+{
+   uint32_t x = *state;
+   x ^= x << 13;
+   x ^= x >> 17;
+   x ^= x << 5;
+   *state = x;
+   return x;
+}
+
+
+/* Returns a number between 1 and 2 from the top bits of x. */
+static INLINE float uniform_from_bits(uint32_t x)
+{
+   union { uint32_t i; float f; } u;
+   u.i = (x >> 9) | 0x3F800000;
+   return u.f;
+}
+
+
+static INLINE int32_t conv_sample(const VOICE_CONV *c, float x, int i)
+{
+   x *= c->gain;
+   x *= c->scale;
+   if (c->dither) {
+      uint32_t *state = &c->dither[i & 3];
+      float a = uniform_from_bits(xorshift32(state));
+      float b = uniform_from_bits(xorshift32(state));
+      x += a - b;
    }
+   /* Written so NaN ends up as lo, like with _mm_max_ps. */
+   if (!(x > c->lo))
+      x = c->lo;
+   if (x > c->hi)
+      x = c->hi;
+   if (c->dither)
+      x = floorf(x + 0.5f);
+   return (int32_t)x;
+}
 
-   /* We're feeding to a voice.
-    * Clamp and convert the mixed data for the voice.
-    */
-   *buf = mixer->ss.spl_data.buffer.ptr;
-   switch (buffer_depth & ~ALLEGRO_AUDIO_DEPTH_UNSIGNED) {
 
+static void float_to_int8(int8_t *out, const float *src, int n,
+   const VOICE_CONV *c, int8_t flip)
+{
+   int i;
+   for (i = 0; i < n; i++)
+      out[i] = (int8_t)conv_sample(c, src[i], i) ^ flip;
+}
+
+
+static void float_to_int16(int16_t *out, const float *src, int n,
+   const VOICE_CONV *c, int16_t flip)
+{
+   int i;
+   for (i = 0; i < n; i++)
+      out[i] = (int16_t)conv_sample(c, src[i], i) ^ flip;
+}
+
+
+static void float_to_int24(int32_t *out, const float *src, int n,
+   const VOICE_CONV *c, int32_t off)
+{
+   int i;
+   for (i = 0; i < n; i++)
+      out[i] = conv_sample(c, src[i], i) + off;
+}
+
+
+#if defined(_AL_SIMD_X86)
+
+typedef struct VOICE_CONV_SSE2 {
+   __m128 gain, scale, lo, hi;
+   __m128i state;
+   bool dither;
+} VOICE_CONV_SSE2;
+
+
+_AL_TARGET_SSE2
+static void init_conv_sse2(VOICE_CONV_SSE2 *v, const VOICE_CONV *c)
+{
+   v->gain = _mm_set1_ps(c->gain);
+   v->scale = _mm_set1_ps(c->scale);
+   v->lo = _mm_set1_ps(c->lo);
+   v->hi = _mm_set1_ps(c->hi);
+   v->dither = c->dither != NULL;
+   if (v->dither)
+      v->state = _mm_loadu_si128((const __m128i *)c->dither);
+}
+
+
+_AL_TARGET_SSE2
+static void finish_conv_sse2(const VOICE_CONV_SSE2 *v, const VOICE_CONV *c)
+{
+   if (v->dither)
+      _mm_storeu_si128((__m128i *)c->dither, v->state);
+}
+
+
+_AL_TARGET_SSE2
+static __m128 uniform_sse2(__m128i *state)
+{
+   __m128i x = *state;
+   x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+   x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+   x = _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+   *state = x;
+   return _mm_castsi128_ps(_mm_or_si128(_mm_srli_epi32(x, 9),
+      _mm_set1_epi32(0x3F800000)));
+}
+
+
+/* conv_sample for four samples. */
+_AL_TARGET_SSE2
+static __m128i conv_sse2(VOICE_CONV_SSE2 *v, const float *src)
+{
+   __m128 x = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(src), v->gain), v->scale);
+
+   if (v->dither) {
+      __m128 a = uniform_sse2(&v->state);
+      __m128 b = uniform_sse2(&v->state);
+      __m128i t;
+
+      x = _mm_add_ps(x, _mm_sub_ps(a, b));
+      x = _mm_min_ps(_mm_max_ps(x, v->lo), v->hi);
+
+      /* floor(x + 0.5): truncate, then subtract one where that rounded
+       * up, using the all ones comparison mask as -1.
+       */
+      x = _mm_add_ps(x, _mm_set1_ps(0.5f));
+      t = _mm_cvttps_epi32(x);
+      return _mm_add_epi32(t,
+         _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(t), x)));
+   }
+
+   x = _mm_min_ps(_mm_max_ps(x, v->lo), v->hi);
+   return _mm_cvttps_epi32(x);
+}
+
+
+/* The output may overlap the input, as long as it does not start after
+ * it, since each block is read before it is written.
+ */
+_AL_TARGET_SSE2
+static int float_to_int8_sse2(int8_t *out, const float *src, int n,
+   const VOICE_CONV *c, int8_t flip)
+{
+   const __m128i flip8 = _mm_set1_epi8(flip);
+   VOICE_CONV_SSE2 v;
+   int i;
+
+   init_conv_sse2(&v, c);
+   for (i = 0; i + 16 <= n; i += 16) {
+      __m128i a = conv_sse2(&v, src + i);
+      __m128i b = conv_sse2(&v, src + i + 4);
+      __m128i d = conv_sse2(&v, src + i + 8);
+      __m128i e = conv_sse2(&v, src + i + 12);
+      __m128i p = _mm_packs_epi16(_mm_packs_epi32(a, b),
+         _mm_packs_epi32(d, e));
+      _mm_storeu_si128((__m128i *)(out + i), _mm_xor_si128(p, flip8));
+   }
+   finish_conv_sse2(&v, c);
+
+   return i;
+}
+
+
+_AL_TARGET_SSE2
+static int float_to_int16_sse2(int16_t *out, const float *src, int n,
+   const VOICE_CONV *c, int16_t flip)
+{
+   const __m128i flip16 = _mm_set1_epi16(flip);
+   VOICE_CONV_SSE2 v;
+   int i;
+
+   init_conv_sse2(&v, c);
+   for (i = 0; i + 8 <= n; i += 8) {
+      __m128i a = conv_sse2(&v, src + i);
+      __m128i b = conv_sse2(&v, src + i + 4);
+      __m128i p = _mm_packs_epi32(a, b);
+      _mm_storeu_si128((__m128i *)(out + i), _mm_xor_si128(p, flip16));
+   }
+   finish_conv_sse2(&v, c);
+
+   return i;
+}
+
+
+_AL_TARGET_SSE2
+static int float_to_int24_sse2(int32_t *out, const float *src, int n,
+   const VOICE_CONV *c, int32_t off)
+{
+   const __m128i off32 = _mm_set1_epi32(off);
+   VOICE_CONV_SSE2 v;
+   int i;
+
+   init_conv_sse2(&v, c);
+   for (i = 0; i + 4 <= n; i += 4) {
+      __m128i a = conv_sse2(&v, src + i);
+      _mm_storeu_si128((__m128i *)(out + i), _mm_add_epi32(a, off32));
+   }
+   finish_conv_sse2(&v, c);
+
+   return i;
+}
+
+
+_AL_TARGET_SSE2
+static int scale_float_sse2(float *buf, int n, float gain)
+{
+   const __m128 g = _mm_set1_ps(gain);
+   int i;
+
+   for (i = 0; i + 4 <= n; i += 4)
+      _mm_storeu_ps(buf + i, _mm_mul_ps(_mm_loadu_ps(buf + i), g));
+
+   return i;
+}
+
+#endif
+
+
+/* Converts n mixed float samples in the mixer's buffer for a voice of the
+ * given depth, in place.
+ */
+static void float_to_voice(ALLEGRO_MIXER *mixer, ALLEGRO_AUDIO_DEPTH depth,
+   int n)
+{
+   const bool is_unsigned = (depth & ALLEGRO_AUDIO_DEPTH_UNSIGNED) != 0;
+   float *src = mixer->ss.spl_data.buffer.f32;
+   VOICE_CONV c;
+   int i = 0;
+#if defined(_AL_SIMD_X86)
+   const bool sse2 = (_al_get_cpu_features() & _AL_CPU_SSE2) != 0;
+#endif
+
+   c.gain = mixer->ss.gain;
+   c.dither = mixer->dither ? mixer->dither_state : NULL;
+
+   switch (depth & ~ALLEGRO_AUDIO_DEPTH_UNSIGNED) {
       case ALLEGRO_AUDIO_DEPTH_FLOAT32:
          /* Do we need to clamp? */
+         if (c.gain == 1.0f)
+            break;
+#if defined(_AL_SIMD_X86)
+         if (sse2)
+            i = scale_float_sse2(src, n, c.gain);
+#endif
+         for (; i < n; i++)
+            src[i] *= c.gain;
          break;
 
-      case ALLEGRO_AUDIO_DEPTH_INT24:
-         switch (mixer->ss.spl_data.depth) {
-            case ALLEGRO_AUDIO_DEPTH_FLOAT32: {
-               int32_t off = ((buffer_depth & ALLEGRO_AUDIO_DEPTH_UNSIGNED)
-                              ? 0x800000 : 0);
-               int32_t *lbuf = mixer->ss.spl_data.buffer.s24;
-               float *src = mixer->ss.spl_data.buffer.f32;
+      case ALLEGRO_AUDIO_DEPTH_INT24: {
+         int32_t *out = mixer->ss.spl_data.buffer.s24;
+         int32_t off = is_unsigned ? 0x800000 : 0;
+         c.scale = (float)0x7FFFFF + 0.5f;
+         c.lo = ~0x7FFFFF;
+         c.hi = 0x7FFFFF;
+#if defined(_AL_SIMD_X86)
+         if (sse2)
+            i = float_to_int24_sse2(out, src, n, &c, off);
+#endif
+         float_to_int24(out + i, src + i, n - i, &c, off);
+         break;
+      }
 
-               while (samples_l > 0) {
-                  *lbuf = clamp(*(src++) * ((float)0x7FFFFF + 0.5f),
-                     ~0x7FFFFF, 0x7FFFFF);
-                  *lbuf += off;
-                  lbuf++;
-                  samples_l--;
-               }
-               break;
-            }
+      case ALLEGRO_AUDIO_DEPTH_INT16: {
+         int16_t *out = mixer->ss.spl_data.buffer.s16;
+         int16_t flip = is_unsigned ? (int16_t)0x8000 : 0;
+         c.scale = (float)0x7FFF + 0.5f;
+         c.lo = ~0x7FFF;
+         c.hi = 0x7FFF;
+#if defined(_AL_SIMD_X86)
+         if (sse2)
+            i = float_to_int16_sse2(out, src, n, &c, flip);
+#endif
+         float_to_int16(out + i, src + i, n - i, &c, flip);
+         break;
+      }
 
-            case ALLEGRO_AUDIO_DEPTH_INT16:
-               /* XXX not yet implemented */
-               ASSERT(false);
-               break;
-
-            case ALLEGRO_AUDIO_DEPTH_INT8:
-            case ALLEGRO_AUDIO_DEPTH_INT24:
-            case ALLEGRO_AUDIO_DEPTH_UINT8:
-            case ALLEGRO_AUDIO_DEPTH_UINT16:
-            case ALLEGRO_AUDIO_DEPTH_UINT24:
-               /* Unsupported mixer depths. */
-               ASSERT(false);
-               break;
-         }
+      /* Ugh, do we really want to support 8-bit output? */
+      case ALLEGRO_AUDIO_DEPTH_INT8: {
+         int8_t *out = mixer->ss.spl_data.buffer.s8;
+         int8_t flip = is_unsigned ? (int8_t)0x80 : 0;
+         c.scale = (float)0x7F + 0.5f;
+         c.lo = ~0x7F;
+         c.hi = 0x7F;
+#if defined(_AL_SIMD_X86)
+         if (sse2)
+            i = float_to_int8_sse2(out, src, n, &c, flip);
+#endif
+         float_to_int8(out + i, src + i, n - i, &c, flip);
          break;
+      }
 
-      case ALLEGRO_AUDIO_DEPTH_INT16:
-         switch (mixer->ss.spl_data.depth) {
-            case ALLEGRO_AUDIO_DEPTH_FLOAT32: {
-               int16_t off = ((buffer_depth & ALLEGRO_AUDIO_DEPTH_UNSIGNED)
-                              ? 0x8000 : 0);
-               int16_t *lbuf = mixer->ss.spl_data.buffer.s16;
-               float *src = mixer->ss.spl_data.buffer.f32;
+      default:
+         /* Impossible. */
+         ASSERT(false);
+         break;
+   }
+}
 
-               while (samples_l > 0) {
-                  *lbuf = clamp(*(src++) * ((float)0x7FFF + 0.5f), ~0x7FFF, 0x7FFF);
-                  *lbuf += off;
-                  lbuf++;
-                  samples_l--;
-               }
-               break;
-            }
 
-            case ALLEGRO_AUDIO_DEPTH_INT16:
-               /* Handle signedness differences. */
-               if (buffer_depth != ALLEGRO_AUDIO_DEPTH_INT16) {
-                  int16_t *lbuf = mixer->ss.spl_data.buffer.s16;
-                  while (samples_l > 0) {
-                     *lbuf++ ^= 0x8000;
-                     samples_l--;
-                  }
-               }
-               break;
-
-            case ALLEGRO_AUDIO_DEPTH_INT8:
-            case ALLEGRO_AUDIO_DEPTH_INT24:
-            case ALLEGRO_AUDIO_DEPTH_UINT8:
-            case ALLEGRO_AUDIO_DEPTH_UINT16:
-            case ALLEGRO_AUDIO_DEPTH_UINT24:
-               /* Unsupported mixer depths. */
-               ASSERT(false);
-               break;
-         }
-         break;
+/* _al_kcm_mixer_read:
+ *  Mixes the streams attached to the mixer and writes additively to the
+ *  specified buffer (or if *buf is NULL, indicating a voice, convert it and
+ *  set it to the buffer pointer).
+ */
+void _al_kcm_mixer_read(void *source, void **buf, unsigned int *samples,
+   ALLEGRO_AUDIO_DEPTH buffer_depth, size_t dest_maxc)
+{
+   ALLEGRO_MIXER *mixer = (ALLEGRO_MIXER *)source;
+   int maxc = al_get_channel_count(mixer->ss.spl_data.chan_conf);
+   int samples_l = *samples * maxc;
+   bool to_voice = (*buf == NULL);
+   bool is_float = (mixer->ss.spl_data.depth == ALLEGRO_AUDIO_DEPTH_FLOAT32);
+
+   /* For a voice, float_to_voice applies the gain of a float mixer. */
+   if (!mix_streams(mixer, *samples, !(to_voice && is_float)))
+      return;
 
-      /* Ugh, do we really want to support 8-bit output? */
-      case ALLEGRO_AUDIO_DEPTH_INT8:
-         switch (mixer->ss.spl_data.depth) {
-            case ALLEGRO_AUDIO_DEPTH_FLOAT32: {
-               int8_t off = ((buffer_depth & ALLEGRO_AUDIO_DEPTH_UNSIGNED)
-                              ? 0x80 : 0);
-               int8_t *lbuf = mixer->ss.spl_data.buffer.s8;
-               float *src = mixer->ss.spl_data.buffer.f32;
+   /* Feeding to a non-voice.
+    * Currently we only support mixers of the same audio depth doing this.
+    */
+   if (!to_voice) {
+      add_to_parent(mixer, *buf, *samples);
+      return;
+   }
+
+   /* We're feeding to a voice.
+    * Clamp and convert the mixed data for the voice.
+    */
+   *buf = mixer->ss.spl_data.buffer.ptr;
+
+   if (is_float) {
+      float_to_voice(mixer, buffer_depth, samples_l);
+   }
+   else if (mixer->ss.spl_data.depth == ALLEGRO_AUDIO_DEPTH_INT16) {
+      switch (buffer_depth & ~ALLEGRO_AUDIO_DEPTH_UNSIGNED) {
+         case ALLEGRO_AUDIO_DEPTH_FLOAT32:
+            break;
 
+         case ALLEGRO_AUDIO_DEPTH_INT16:
+            /* Handle signedness differences. */
+            if (buffer_depth != ALLEGRO_AUDIO_DEPTH_INT16) {
+               int16_t *lbuf = mixer->ss.spl_data.buffer.s16;
                while (samples_l > 0) {
-                  *lbuf = clamp(*(src++) * ((float)0x7F + 0.5f), ~0x7F, 0x7F);
-                  *lbuf += off;
-                  lbuf++;
+                  *lbuf++ ^= 0x8000;
                   samples_l--;
                }
-               break;
             }
+            break;
 
-            case ALLEGRO_AUDIO_DEPTH_INT16:
-               /* XXX not yet implemented */
-               ASSERT(false);
-               break;
-
-            case ALLEGRO_AUDIO_DEPTH_INT8:
-            case ALLEGRO_AUDIO_DEPTH_INT24:
-            case ALLEGRO_AUDIO_DEPTH_UINT8:
-            case ALLEGRO_AUDIO_DEPTH_UINT16:
-            case ALLEGRO_AUDIO_DEPTH_UINT24:
-               /* Unsupported mixer depths. */
-               ASSERT(false);
-               break;
-         }
-         break;
-
-      case ALLEGRO_AUDIO_DEPTH_UINT8:
-      case ALLEGRO_AUDIO_DEPTH_UINT16:
-      case ALLEGRO_AUDIO_DEPTH_UINT24:
-         /* Impossible. */
-         ASSERT(false);
-         break;
+         default:
+            /* XXX not yet implemented */
+            ASSERT(false);
+            break;
+      }
+   }
+   else {
+      /* Unsupported mixer depths. */
+      ASSERT(false);
    }
 
    (void)dest_maxc;
@@ -620,6 +1885,8 @@ ALLEGRO_MIXER *al_create_mixer(unsigned int freq,
 {
    ALLEGRO_MIXER *mixer;
    int default_mixer_quality = ALLEGRO_MIXER_QUALITY_LINEAR;
+   bool parallel = false;
+   bool dither = false;
    const char *p;
 
    /* XXX this is in the wrong place */
@@ -638,8 +1905,21 @@ ALLEGRO_MIXER *al_create_mixer(unsigned int freq,
          ALLEGRO_INFO("Cubic interpolation\n");
          default_mixer_quality = ALLEGRO_MIXER_QUALITY_CUBIC;
       }
+      else if (!_al_stricmp(p, "sinc")) {
+         ALLEGRO_INFO("Sinc interpolation\n");
+         default_mixer_quality = ALLEGRO_MIXER_QUALITY_SINC;
+      }
    }
 
+   p = al_get_config_value(al_get_system_config(), "audio",
+      "parallel_mixers");
+   if (p && !_al_stricmp(p, "true"))
+      parallel = true;
+
+   p = al_get_config_value(al_get_system_config(), "audio", "dither");
+   if (p && !_al_stricmp(p, "true"))
+      dither = true;
+
    if (!freq) {
       _al_set_error(ALLEGRO_INVALID_PARAM,
          "Attempted to create mixer with no frequency");
@@ -673,8 +1953,18 @@ ALLEGRO_MIXER *al_create_mixer(unsigned int freq,
    mixer->ss.spl_read = NULL;
 
    mixer->quality = default_mixer_quality;
+   mixer->parallel = parallel;
+   mixer->dither = dither;
+   /* Any non-zero seeds will do. */
+   mixer->dither_state[0] = 0x9E3779B9;
+   mixer->dither_state[1] = 0x243F6A88;
+   mixer->dither_state[2] = 0xB7E15162;
+   mixer->dither_state[3] = 0x6A09E667;
 
    _al_vector_init(&mixer->streams, sizeof(ALLEGRO_SAMPLE_INSTANCE *));
+   _al_vector_init(&mixer->sinc_tables, sizeof(SINC_TABLE *));
+   _al_vector_init(&mixer->child_mixers, sizeof(CHILD_MIXER));
+   _al_vector_init(&mixer->effects, sizeof(ALLEGRO_MIXER_EFFECT *));
 
    mixer->dtor_item = _al_kcm_register_destructor("mixer", mixer, (void (*)(void *)) al_destroy_mixer);
 
@@ -700,6 +1990,8 @@ bool al_attach_sample_instance_to_mixer(ALLEGRO_SAMPLE_INSTANCE *spl,
    ALLEGRO_MIXER *mixer)
 {
    ALLEGRO_SAMPLE_INSTANCE **slot;
+   void *sinc_tables = NULL;
+   int step;
 
    ASSERT(mixer);
    ASSERT(spl);
@@ -711,12 +2003,26 @@ bool al_attach_sample_instance_to_mixer(ALLEGRO_SAMPLE_INSTANCE *spl,
       return false;
    }
 
+   step = (spl->spl_data.frequency) * spl->speed;
+   /* Don't want to be trapped with a step value of 0. */
+   if (step == 0) {
+      if (spl->speed > 0.0f)
+         step = 1;
+      else
+         step = -1;
+   }
+   if (!spl->is_mixer) {
+      sinc_tables = _al_kcm_mixer_build_sinc_tables(mixer, step,
+         mixer->ss.spl_data.frequency);
+   }
+
    maybe_lock_mutex(mixer->ss.mutex);
    
    _al_kcm_stream_set_mutex(spl, mixer->ss.mutex);
 
    slot = _al_vector_alloc_back(&mixer->streams);
    if (!slot) {
+      _al_kcm_mixer_update_sinc_tables(mixer, sinc_tables);
       if (mixer->ss.mutex) {
          al_unlock_mutex(mixer->ss.mutex);
       }
@@ -726,15 +2032,8 @@ bool al_attach_sample_instance_to_mixer(ALLEGRO_SAMPLE_INSTANCE *spl,
    }
    (*slot) = spl;
 
-   spl->step = (spl->spl_data.frequency) * spl->speed;
+   spl->step = step;
    spl->step_denom = mixer->ss.spl_data.frequency;
-   /* Don't want to be trapped with a step value of 0. */
-   if (spl->step == 0) {
-      if (spl->speed > 0.0f)
-         spl->step = 1;
-      else
-         spl->step = -1;
-   }
 
    /* Set the proper sample stream reader. */
    ASSERT(spl->spl_read == NULL);
@@ -754,6 +2053,9 @@ bool al_attach_sample_instance_to_mixer(ALLEGRO_SAMPLE_INSTANCE *spl,
                case ALLEGRO_MIXER_QUALITY_CUBIC:
                   spl->spl_read = read_to_mixer_cubic_float_32;
                   break;
+               case ALLEGRO_MIXER_QUALITY_SINC:
+                  spl->spl_read = read_to_mixer_sinc_float_32;
+                  break;
             }
             break;
 
@@ -763,6 +2065,7 @@ bool al_attach_sample_instance_to_mixer(ALLEGRO_SAMPLE_INSTANCE *spl,
                   spl->spl_read = read_to_mixer_point_int16_t_16;
                   break;
                case ALLEGRO_MIXER_QUALITY_CUBIC:
+               case ALLEGRO_MIXER_QUALITY_SINC:
                   ALLEGRO_WARN("Falling back to linear interpolation\n");
                   /* fallthrough */
                case ALLEGRO_MIXER_QUALITY_LINEAR:
@@ -787,6 +2090,8 @@ bool al_attach_sample_instance_to_mixer(ALLEGRO_SAMPLE_INSTANCE *spl,
    spl->parent.u.mixer = mixer;
    spl->parent.is_voice = false;
 
+   _al_kcm_mixer_update_sinc_tables(mixer, sinc_tables);
+
    maybe_unlock_mutex(mixer->ss.mutex);
 
    return true;
@@ -1018,4 +2323,15 @@ bool al_detach_mixer(ALLEGRO_MIXER *mixer)
 }
 
 
+/* Function: al_get_mixer_stats
+ */
+void al_get_mixer_stats(const ALLEGRO_MIXER *mixer, ALLEGRO_AUDIO_STATS *stats)
+{
+   ASSERT(mixer);
+   ASSERT(stats);
+
+   _al_kcm_get_instance_stats(&mixer->ss, stats);
+}
+
+
 /* vim: set sts=3 sw=3 et: */
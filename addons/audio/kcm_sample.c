@@ -191,6 +191,7 @@ void al_destroy_sample(ALLEGRO_SAMPLE *spl)
       _al_kcm_foreach_destructor(stop_sample_instances_helper,
          al_get_sample_data(spl));
       _al_kcm_unregister_destructor(spl->dtor_item);
+      _al_kcm_forget_float_sample(spl);
 
       if (spl->free_buf && spl->buffer.ptr) {
          al_free(spl->buffer.ptr);
@@ -0,0 +1,333 @@
+/*         ______   ___    ___
+ *        /\  _  \ /\_ \  /\_ \
+ *        \ \ \L\ \\//\ \ \//\ \      __     __   _ __   ___
+ *         \ \  __ \ \ \ \  \ \ \   /'__`\ /'_ `\/\`'__\/ __`\
+ *          \ \ \/\ \ \_\ \_ \_\ \_/\  __//\ \L\ \ \ \//\ \L\ \
+ *           \ \_\ \_\/\____\/\____\ \____\ \____ \ \_\\ \____/
+ *            \/_/\/_/\/____/\/____/\/____/\/___L\ \/_/ \/___/
+ *                                           /\____/
+ *                                           \_/__/
+ *
+ *      Cache of samples converted to float.
+ *
+ *      A float mixer converts every sample value of an integer sample each
+ *      time it plays it.  If the sample_cache_size key in the [audio]
+ *      config section is set, the mixers instead convert a sample once, a
+ *      piece per mixer block while they first play it, and keep the float
+ *      copy around.  Until the copy is complete the sample is mixed from
+ *      the original as before.  Once the copies take up more than the given
+ *      size, the least recently played ones are freed again.
+ *
+ *      See readme.txt for copyright information.
+ */
+
+#include <stdlib.h>
+
+#include "allegro5/allegro.h"
+#include "allegro5/allegro_audio.h"
+#include "allegro5/internal/aintern_audio.h"
+#include "allegro5/internal/aintern_vector.h"
+
+ALLEGRO_DEBUG_CHANNEL("audio")
+
+
+typedef struct CACHED_SAMPLE {
+   ALLEGRO_SAMPLE f32;           /* the float copy, must come first */
+   const void *orig;             /* buffer of the original, or NULL once
+                                  * that is destroyed */
+   ALLEGRO_AUDIO_DEPTH orig_depth;
+   size_t size;
+   int converted;                /* frames of the copy filled in so far */
+   bool converting;              /* a mixer is filling in more frames */
+   int refs;                     /* mixers currently reading the copy */
+   double last_used;
+} CACHED_SAMPLE;
+
+/* At most this many frames are converted by each call of
+ * _al_kcm_acquire_float_sample, which runs in the mixer callback.
+ */
+#define CONVERT_FRAMES  8192
+
+/* Copies used more recently than this are not freed to make room for new
+ * ones.  Samples which keep playing are read every few milliseconds, so if
+ * they do not all fit they would otherwise keep pushing each other out.
+ */
+#define MIN_IDLE_TIME   0.5
+
+
+static ALLEGRO_MUTEX *cache_mutex = NULL;
+static size_t cache_budget = 0;
+static size_t cache_used = 0;
+
+/* Vector of CACHED_SAMPLE *, protected by cache_mutex. */
+static _AL_VECTOR cached_samples = _AL_VECTOR_INITIALIZER(CACHED_SAMPLE *);
+
+
+
+static size_t get_cache_budget(void)
+{
+   const char *val = al_get_config_value(al_get_system_config(),
+      "audio", "sample_cache_size");
+   int kb;
+
+   if (!val || val[0] == '\0')
+      return 0;
+   kb = atoi(val);
+   if (kb <= 0)
+      return 0;
+   return (size_t)kb * 1024;
+}
+
+
+
+/* Must be called with cache_mutex locked. */
+static void free_cached_sample(unsigned int i)
+{
+   CACHED_SAMPLE *entry =
+      *(CACHED_SAMPLE **)_al_vector_ref(&cached_samples, i);
+
+   ASSERT(entry->refs == 0);
+
+   cache_used -= entry->size;
+   _al_vector_delete_at(&cached_samples, i);
+   al_free(entry->f32.buffer.ptr);
+   al_free(entry);
+}
+
+
+
+/* Frees least recently used copies until size more bytes fit the budget.
+ * Copies being read or used recently are kept.  Must be called with
+ * cache_mutex locked.
+ */
+static bool make_room(size_t size, double now)
+{
+   while (cache_used + size > cache_budget) {
+      int oldest = -1;
+      double oldest_use = now - MIN_IDLE_TIME;
+      unsigned int i;
+
+      for (i = 0; i < _al_vector_size(&cached_samples); i++) {
+         CACHED_SAMPLE *entry =
+            *(CACHED_SAMPLE **)_al_vector_ref(&cached_samples, i);
+         if (entry->refs == 0 && entry->last_used < oldest_use) {
+            oldest = i;
+            oldest_use = entry->last_used;
+         }
+      }
+
+      if (oldest < 0)
+         return false;
+      free_cached_sample(oldest);
+   }
+
+   return true;
+}
+
+
+
+/* Must be called with cache_mutex locked. */
+static CACHED_SAMPLE *create_cached_sample(const ALLEGRO_SAMPLE *data,
+   size_t size, double now)
+{
+   CACHED_SAMPLE *entry;
+   CACHED_SAMPLE **slot;
+
+   if (!make_room(size, now))
+      return NULL;
+
+   entry = al_calloc(1, sizeof(*entry));
+   if (!entry)
+      return NULL;
+   entry->f32.buffer.f32 = al_malloc(size);
+   slot = _al_vector_alloc_back(&cached_samples);
+   if (!entry->f32.buffer.f32 || !slot) {
+      if (slot)
+         _al_vector_delete_at(&cached_samples,
+            _al_vector_size(&cached_samples) - 1);
+      al_free(entry->f32.buffer.f32);
+      al_free(entry);
+      return NULL;
+   }
+   *slot = entry;
+
+   entry->f32.depth = ALLEGRO_AUDIO_DEPTH_FLOAT32;
+   entry->f32.chan_conf = data->chan_conf;
+   entry->f32.frequency = data->frequency;
+   entry->f32.len = data->len;
+   entry->orig = data->buffer.ptr;
+   entry->orig_depth = data->depth;
+   entry->size = size;
+   cache_used += size;
+
+   return entry;
+}
+
+
+
+/* Internal function: _al_kcm_acquire_float_sample
+ *  Returns a float copy of the sample data, or NULL if there is none yet.
+ *  Each call converts up to CONVERT_FRAMES more frames of a new copy,
+ *  without holding cache_mutex, until it is complete.  NULL is also
+ *  returned if the cache is disabled or full of samples in use.  The copy
+ *  is kept until it is released with _al_kcm_release_float_sample.
+ */
+const ALLEGRO_SAMPLE *_al_kcm_acquire_float_sample(const ALLEGRO_SAMPLE *data)
+{
+   size_t size;
+   double now;
+   CACHED_SAMPLE *entry = NULL;
+   unsigned int i;
+   int maxc, pos, n;
+
+   ASSERT(data);
+
+   if (cache_budget == 0 || !data->buffer.ptr ||
+         data->depth == ALLEGRO_AUDIO_DEPTH_FLOAT32)
+      return NULL;
+
+   /* Long samples would push everything else out of the cache. */
+   size = (size_t)data->len * al_get_channel_count(data->chan_conf) *
+      sizeof(float);
+   if (size == 0 || size > cache_budget / 4)
+      return NULL;
+
+   now = al_get_time();
+   al_lock_mutex(cache_mutex);
+
+   for (i = 0; i < _al_vector_size(&cached_samples); i++) {
+      CACHED_SAMPLE *e = *(CACHED_SAMPLE **)_al_vector_ref(&cached_samples, i);
+      if (e->orig == data->buffer.ptr && e->orig_depth == data->depth &&
+            e->f32.chan_conf == data->chan_conf && e->f32.len == data->len) {
+         entry = e;
+         break;
+      }
+   }
+
+   if (!entry)
+      entry = create_cached_sample(data, size, now);
+   if (!entry || entry->converting) {
+      al_unlock_mutex(cache_mutex);
+      return NULL;
+   }
+
+   entry->refs++;
+   entry->last_used = now;
+   if (entry->converted == entry->f32.len) {
+      al_unlock_mutex(cache_mutex);
+      return &entry->f32;
+   }
+
+   /* Convert the next piece.  The reference keeps the entry alive. */
+   entry->converting = true;
+   pos = entry->converted;
+   n = entry->f32.len - pos;
+   if (n > CONVERT_FRAMES)
+      n = CONVERT_FRAMES;
+   al_unlock_mutex(cache_mutex);
+
+   maxc = al_get_channel_count(data->chan_conf);
+   _al_kcm_sample_to_float(entry->f32.buffer.f32 + (size_t)pos * maxc,
+      data, pos, n);
+
+   al_lock_mutex(cache_mutex);
+   entry->converted += n;
+   entry->converting = false;
+   if (entry->converted == entry->f32.len) {
+      ALLEGRO_DEBUG("Cached %u frames as float, %u of %u kB used\n",
+         entry->f32.len, (unsigned)(cache_used / 1024),
+         (unsigned)(cache_budget / 1024));
+      al_unlock_mutex(cache_mutex);
+      return &entry->f32;
+   }
+   al_unlock_mutex(cache_mutex);
+
+   _al_kcm_release_float_sample(&entry->f32);
+   return NULL;
+}
+
+
+
+/* Internal function: _al_kcm_release_float_sample
+ */
+void _al_kcm_release_float_sample(const ALLEGRO_SAMPLE *f32)
+{
+   CACHED_SAMPLE *entry = (CACHED_SAMPLE *)f32;
+
+   al_lock_mutex(cache_mutex);
+   ASSERT(entry->refs > 0);
+   if (--entry->refs == 0 && !entry->orig)
+      free_cached_sample(_al_vector_find(&cached_samples, &entry));
+   al_unlock_mutex(cache_mutex);
+}
+
+
+
+/* Internal function: _al_kcm_forget_float_sample
+ *  Called when the sample data is about to be freed.
+ */
+void _al_kcm_forget_float_sample(const ALLEGRO_SAMPLE *data)
+{
+   unsigned int i;
+
+   if (!cache_mutex || !data->buffer.ptr)
+      return;
+
+   al_lock_mutex(cache_mutex);
+   i = 0;
+   while (i < _al_vector_size(&cached_samples)) {
+      CACHED_SAMPLE *entry =
+         *(CACHED_SAMPLE **)_al_vector_ref(&cached_samples, i);
+      if (entry->orig != data->buffer.ptr) {
+         i++;
+      }
+      else if (entry->refs > 0) {
+         /* Freed once the last mixer releases it. */
+         entry->orig = NULL;
+         i++;
+      }
+      else {
+         free_cached_sample(i);
+      }
+   }
+   al_unlock_mutex(cache_mutex);
+}
+
+
+
+/* Internal function: _al_kcm_init_sample_cache
+ */
+void _al_kcm_init_sample_cache(void)
+{
+   if (cache_mutex)
+      return;
+
+   cache_mutex = al_create_mutex();
+   if (cache_mutex)
+      cache_budget = get_cache_budget();
+   if (cache_budget > 0)
+      ALLEGRO_INFO("Caching float samples, up to %u kB\n",
+         (unsigned)(cache_budget / 1024));
+}
+
+
+
+/* Internal function: _al_kcm_shutdown_sample_cache
+ *  Must be called after all mixers are destroyed.
+ */
+void _al_kcm_shutdown_sample_cache(void)
+{
+   if (!cache_mutex)
+      return;
+
+   while (!_al_vector_is_empty(&cached_samples))
+      free_cached_sample(_al_vector_size(&cached_samples) - 1);
+   _al_vector_free(&cached_samples);
+
+   al_destroy_mutex(cache_mutex);
+   cache_mutex = NULL;
+   cache_budget = 0;
+   cache_used = 0;
+}
+
+/* vim: set sts=3 sw=3 et: */
@@ -13,15 +13,16 @@
 #include "allegro5/allegro_audio.h"
 #include "allegro5/internal/aintern_audio.h"
 #include "allegro5/internal/aintern_audio_cfg.h"
+#include "allegro5/internal/aintern_atomicops.h"
 
 ALLEGRO_DEBUG_CHANNEL("audio")
 
 /*
- * The highest quality interpolator is a cubic interpolator requiring
- * four sample points.  In the streaming case we lag the true sample
- * position by three.
+ * The highest quality interpolator is the sinc interpolator requiring
+ * sixteen sample points.  In the streaming case we lag the true sample
+ * position by fifteen.
  */
-#define MAX_LAG   (3)
+#define MAX_LAG   (15)
 
 
 /*
@@ -44,6 +45,53 @@ static void maybe_unlock_mutex(ALLEGRO_MUTEX *mutex)
    }
 }
 
+
+/* Fragment queues.  Each queue has one producing and one consuming thread,
+ * see _AL_KCM_FRAGMENT_QUEUE.  The acquire/release pairs make sure a
+ * fragment's contents are visible before it is seen in the queue, and that
+ * the consumer is done with a slot before the producer reuses it.
+ */
+static int queue_count(const _AL_KCM_FRAGMENT_QUEUE *queue)
+{
+   int n = _al_load_acquire((volatile int *)&queue->tail)
+      - _al_load_acquire((volatile int *)&queue->head);
+
+   if (n < 0)
+      n += 2 * queue->size;
+   return n;
+}
+
+
+static bool queue_push(_AL_KCM_FRAGMENT_QUEUE *queue, void *fragment)
+{
+   int tail = queue->tail;
+   int n = tail - _al_load_acquire(&queue->head);
+
+   if (n < 0)
+      n += 2 * queue->size;
+   if (n == queue->size)
+      return false;
+
+   queue->slots[tail % queue->size] = fragment;
+   _al_store_release(&queue->tail, (tail + 1) % (2 * queue->size));
+   return true;
+}
+
+
+static void *queue_pop(_AL_KCM_FRAGMENT_QUEUE *queue)
+{
+   int head = queue->head;
+   void *fragment;
+
+   if (head == _al_load_acquire(&queue->tail))
+      return NULL;
+
+   fragment = queue->slots[head % queue->size];
+   _al_store_release(&queue->head, (head + 1) % (2 * queue->size));
+   return fragment;
+}
+
+
 /* Function: al_create_audio_stream
  */
 ALLEGRO_AUDIO_STREAM *al_create_audio_stream(size_t fragment_count,
@@ -99,15 +147,25 @@ ALLEGRO_AUDIO_STREAM *al_create_audio_stream(size_t fragment_count,
 
    stream->buf_count = fragment_count;
 
-   stream->used_bufs = al_calloc(1, fragment_count * sizeof(void *) * 2);
-   if (!stream->used_bufs) {
-      al_free(stream->used_bufs);
+   stream->used_bufs.slots = al_calloc(1, fragment_count * sizeof(void *) * 2);
+   if (!stream->used_bufs.slots) {
       al_free(stream);
       _al_set_error(ALLEGRO_GENERIC_ERROR,
          "Out of memory allocating stream buffer pointers");
       return NULL;
    }
-   stream->pending_bufs = stream->used_bufs + fragment_count;
+   stream->used_bufs.size = fragment_count;
+   stream->pending_bufs.slots = stream->used_bufs.slots + fragment_count;
+   stream->pending_bufs.size = fragment_count;
+
+   stream->feeder_mutex = al_create_mutex();
+   if (!stream->feeder_mutex) {
+      al_free(stream->used_bufs.slots);
+      al_free(stream);
+      _al_set_error(ALLEGRO_GENERIC_ERROR,
+         "Out of memory allocating stream feeder mutex");
+      return NULL;
+   }
 
    /* The main_buffer holds all the buffer fragments in contiguous memory.
     * To support interpolation across buffer fragments, we allocate extra
@@ -117,18 +175,30 @@ ALLEGRO_AUDIO_STREAM *al_create_audio_stream(size_t fragment_count,
    stream->main_buffer = al_calloc(1,
       (MAX_LAG * bytes_per_sample + bytes_per_frag_buf) * fragment_count);
    if (!stream->main_buffer) {
-      al_free(stream->used_bufs);
+      al_destroy_mutex(stream->feeder_mutex);
+      al_free(stream->used_bufs.slots);
       al_free(stream);
       _al_set_error(ALLEGRO_GENERIC_ERROR,
          "Out of memory allocating stream buffer");
       return NULL;
    }
 
+   stream->fragment_freed_at = al_calloc(fragment_count, sizeof(double));
+   if (!stream->fragment_freed_at) {
+      al_free(stream->main_buffer);
+      al_destroy_mutex(stream->feeder_mutex);
+      al_free(stream->used_bufs.slots);
+      al_free(stream);
+      _al_set_error(ALLEGRO_GENERIC_ERROR,
+         "Out of memory allocating stream fragment times");
+      return NULL;
+   }
+
    for (i = 0; i < fragment_count; i++) {
       char *buffer = (char *)stream->main_buffer
          + i * (MAX_LAG * bytes_per_sample + bytes_per_frag_buf);
       al_fill_silence(buffer, MAX_LAG, depth, chan_conf);
-      stream->used_bufs[i] = buffer + MAX_LAG * bytes_per_sample;
+      queue_push(&stream->used_bufs, buffer + MAX_LAG * bytes_per_sample);
    }
 
    al_init_user_event_source(&stream->spl.es);
@@ -145,16 +215,23 @@ ALLEGRO_AUDIO_STREAM *al_create_audio_stream(size_t fragment_count,
 void al_destroy_audio_stream(ALLEGRO_AUDIO_STREAM *stream)
 {
    if (stream) {
-      if (stream->feed_thread) {
+      if (stream->unload_feeder &&
+            (stream->feed_thread || stream->feed_pooled)) {
          stream->unload_feeder(stream);
       }
+      /* The pool must let go of the stream even if nothing else stops it. */
+      if (stream->feed_pooled) {
+         _al_kcm_stop_pooled_feeder(stream);
+      }
       /* See commented out call to _al_kcm_register_destructor. */
       /* _al_kcm_unregister_destructor(stream->dtor_item); */
       _al_kcm_detach_from_parent(&stream->spl);
 
       al_destroy_user_event_source(&stream->spl.es);
+      al_destroy_mutex(stream->feeder_mutex);
       al_free(stream->main_buffer);
-      al_free(stream->used_bufs);
+      al_free(stream->fragment_freed_at);
+      al_free(stream->used_bufs.slots);
       al_free(stream);
    }
 }
@@ -215,12 +292,22 @@ unsigned int al_get_audio_stream_fragments(const ALLEGRO_AUDIO_STREAM *stream)
 unsigned int al_get_available_audio_stream_fragments(
    const ALLEGRO_AUDIO_STREAM *stream)
 {
-   unsigned int i;
    ASSERT(stream);
 
-   for (i = 0; i < stream->buf_count && stream->used_bufs[i]; i++)
-      ;
-   return i;
+   return queue_count(&stream->used_bufs);
+}
+
+
+/* _al_kcm_get_queued_stream_fragments:
+ *  Returns the number of fragments the mixer has yet to play, including the
+ *  one it is playing.
+ */
+int _al_kcm_get_queued_stream_fragments(const ALLEGRO_AUDIO_STREAM *stream)
+{
+   ASSERT(stream);
+
+   return queue_count(&stream->pending_bufs)
+      + (stream->spl.spl_data.buffer.ptr ? 1 : 0);
 }
 
 
@@ -331,28 +418,10 @@ uint64_t al_get_audio_stream_played_samples(const ALLEGRO_AUDIO_STREAM *stream)
 */
 void *al_get_audio_stream_fragment(const ALLEGRO_AUDIO_STREAM *stream)
 {
-   size_t i;
-   void *fragment;
-   ALLEGRO_MUTEX *stream_mutex;
    ASSERT(stream);
 
-   stream_mutex = maybe_lock_mutex(stream->spl.mutex);
-
-   if (!stream->used_bufs[0]) {
-      /* No free fragments are available. */
-      fragment = NULL;
-   }
-   else {
-      fragment = stream->used_bufs[0];
-      for (i = 0; i < stream->buf_count-1 && stream->used_bufs[i]; i++) {
-         stream->used_bufs[i] = stream->used_bufs[i+1];
-      }
-      stream->used_bufs[i] = NULL;
-   }
-
-   maybe_unlock_mutex(stream_mutex);
-
-   return fragment;
+   /* Returns NULL if no free fragments are available. */
+   return queue_pop((_AL_KCM_FRAGMENT_QUEUE *)&stream->used_bufs);
 }
 
 
@@ -377,14 +446,22 @@ bool al_set_audio_stream_speed(ALLEGRO_AUDIO_STREAM *stream, float val)
    stream->spl.speed = val;
    if (stream->spl.parent.u.mixer) {
       ALLEGRO_MIXER *mixer = stream->spl.parent.u.mixer;
-      ALLEGRO_MUTEX *stream_mutex = maybe_lock_mutex(stream->spl.mutex);
+      ALLEGRO_MUTEX *stream_mutex;
+      int step = (stream->spl.spl_data.frequency) * stream->spl.speed;
+      void *sinc_tables;
 
-      stream->spl.step = (stream->spl.spl_data.frequency) * stream->spl.speed;
-      stream->spl.step_denom = mixer->ss.spl_data.frequency;
       /* Don't wanna be trapped with a step value of 0 */
-      if (stream->spl.step == 0) {
-         stream->spl.step = 1;
+      if (step == 0) {
+         step = 1;
       }
+      sinc_tables = _al_kcm_mixer_build_sinc_tables(mixer, step,
+         mixer->ss.spl_data.frequency);
+
+      stream_mutex = maybe_lock_mutex(stream->spl.mutex);
+
+      stream->spl.step = step;
+      stream->spl.step_denom = mixer->ss.spl_data.frequency;
+      _al_kcm_mixer_update_sinc_tables(mixer, sinc_tables);
 
       maybe_unlock_mutex(stream_mutex);
    }
@@ -490,7 +567,8 @@ static void reset_stopped_stream(ALLEGRO_AUDIO_STREAM *stream)
       al_get_audio_depth_size(stream->spl.spl_data.depth);
    const int fragment_buffer_size =
       bytes_per_sample * (stream->spl.spl_data.len + MAX_LAG);
-   size_t i, n;
+   void *fragment;
+   size_t i;
 
    /* Write silence to the "invisible" part in between fragment buffers to
     * avoid interpolation artifacts.  It's tempting to zero the complete
@@ -504,21 +582,17 @@ static void reset_stopped_stream(ALLEGRO_AUDIO_STREAM *stream)
          MAX_LAG, stream->spl.spl_data.depth, stream->spl.spl_data.chan_conf);
    }
 
-   /* Get the current number of entries in the used_buf list. */
-   for (n = 0; n < stream->buf_count && stream->used_bufs[n]; n++)
-      ;
+   /* Move the playing fragment and everything from pending_bufs to
+    * used_bufs.  We are on the mixer's side of both queues here.
+    */
+   if (stream->spl.spl_data.buffer.ptr)
+      queue_push(&stream->used_bufs, stream->spl.spl_data.buffer.ptr);
+   while ((fragment = queue_pop(&stream->pending_bufs)))
+      queue_push(&stream->used_bufs, fragment);
 
-   /* Move everything from pending_bufs to used_bufs. */
-   i = 0;
-   while (i < stream->buf_count &&
-         n < stream->buf_count &&
-         stream->pending_bufs[i])
-   {
-      stream->used_bufs[n] = stream->pending_bufs[i];
-      stream->pending_bufs[i] = NULL;
-      n++;
-      i++;
-   }
+   /* Fragments freed by stopping are not late when refilled. */
+   memset(stream->fragment_freed_at, 0, stream->buf_count * sizeof(double));
+   stream->starving = false;
 
    /* No fragment buffer is currently playing. */
    stream->spl.spl_data.buffer.ptr = NULL;
@@ -556,6 +630,8 @@ bool al_set_audio_stream_playing(ALLEGRO_AUDIO_STREAM *stream, bool val)
    }
    else if (!val) {
       reset_stopped_stream(stream);
+      if (stream->feed_pooled)
+         _al_kcm_schedule_pooled_feeder(stream);
    }
 
    maybe_unlock_mutex(stream_mutex);
@@ -580,28 +656,30 @@ bool al_detach_audio_stream(ALLEGRO_AUDIO_STREAM *stream)
  */
 bool al_set_audio_stream_fragment(ALLEGRO_AUDIO_STREAM *stream, void *val)
 {
-   size_t i;
-   bool ret;
-   ALLEGRO_MUTEX *stream_mutex;
    ASSERT(stream);
 
-   stream_mutex = maybe_lock_mutex(stream->spl.mutex);
-
-   for (i = 0; i < stream->buf_count && stream->pending_bufs[i] ; i++)
-      ;
-   if (i < stream->buf_count) {
-      stream->pending_bufs[i] = val;
-      ret = true;
-   }
-   else {
+   if (!queue_push(&stream->pending_bufs, val)) {
       _al_set_error(ALLEGRO_INVALID_OBJECT,
          "Attempted to set a stream buffer with a full pending list");
-      ret = false;
+      return false;
    }
 
-   maybe_unlock_mutex(stream_mutex);
+   return true;
+}
+
+
+/* Returns the position of a fragment in main_buffer. */
+static int fragment_index(const ALLEGRO_AUDIO_STREAM *stream,
+   const void *fragment)
+{
+   const int bytes_per_sample =
+      al_get_channel_count(stream->spl.spl_data.chan_conf) *
+      al_get_audio_depth_size(stream->spl.spl_data.depth);
+   const int fragment_buffer_size =
+      bytes_per_sample * (stream->spl.spl_data.len + MAX_LAG);
 
-   return ret;
+   return ((const char *)fragment - (const char *)stream->main_buffer) /
+      fragment_buffer_size;
 }
 
 
@@ -619,36 +697,15 @@ bool _al_kcm_refill_stream(ALLEGRO_AUDIO_STREAM *stream)
    ALLEGRO_SAMPLE_INSTANCE *spl = &stream->spl;
    void *old_buf = spl->spl_data.buffer.ptr;
    void *new_buf;
-   size_t i;
    int new_pos = spl->pos - spl->spl_data.len;
 
-   if (old_buf) {
-      /* Slide the buffers down one position and put the
-       * completed buffer into the used array to be refilled.
-       */
-      for (i = 0;
-            i < stream->buf_count-1 && stream->pending_bufs[i];
-            i++) {
-         stream->pending_bufs[i] = stream->pending_bufs[i+1];
-      }
-      stream->pending_bufs[i] = NULL;
-
-      for (i = 0; stream->used_bufs[i]; i++)
-         ;
-      stream->used_bufs[i] = old_buf;
-   }
-
-   new_buf = stream->pending_bufs[0];
+   new_buf = queue_pop(&stream->pending_bufs);
    stream->spl.spl_data.buffer.ptr = new_buf;
-   if (!new_buf) {
-      ALLEGRO_WARN("Out of buffers\n");
-      return false;
-   }
 
    /* Copy the last MAX_LAG sample values to the front of the new buffer
     * for interpolation.
     */
-   if (old_buf) {
+   if (old_buf && new_buf) {
       const int bytes_per_sample =
          al_get_channel_count(spl->spl_data.chan_conf) *
          al_get_audio_depth_size(spl->spl_data.depth);
@@ -661,12 +718,133 @@ bool _al_kcm_refill_stream(ALLEGRO_AUDIO_STREAM *stream)
       stream->consumed_fragments++;
    }
 
+   /* Put the completed buffer into the used queue to be refilled.  This must
+    * come last, as the feeder may start overwriting it straight away.
+    */
+   if (old_buf) {
+      stream->fragment_freed_at[fragment_index(stream, old_buf)] =
+         al_get_time();
+      queue_push(&stream->used_bufs, old_buf);
+   }
+
+   if (!new_buf) {
+      ALLEGRO_WARN("Out of buffers\n");
+      if (!stream->is_draining && !stream->starving) {
+         stream->starving = true;
+         stream->underruns++;
+      }
+      return false;
+   }
+
+   stream->starving = false;
+
    stream->spl.pos = new_pos;
 
    return true;
 }
 
 
+/* _al_kcm_feed_stream_fragment:
+ *  Fills one free fragment of the stream from its feeder and hands it back
+ *  to the stream.  Returns false if no more fragments should be filled for
+ *  now, e.g. because there are none free or the data ran out.
+ */
+bool _al_kcm_feed_stream_fragment(ALLEGRO_AUDIO_STREAM *stream)
+{
+   char *fragment;
+   unsigned long bytes;
+   unsigned long bytes_written;
+   double freed_at;
+   double t0;
+
+   fragment = al_get_audio_stream_fragment(stream);
+   if (!fragment) {
+      /* This is not an error. */
+      return false;
+   }
+
+   bytes = (stream->spl.spl_data.len) *
+         al_get_channel_count(stream->spl.spl_data.chan_conf) *
+         al_get_audio_depth_size(stream->spl.spl_data.depth);
+
+   freed_at = stream->fragment_freed_at[fragment_index(stream, fragment)];
+
+   al_lock_mutex(stream->feeder_mutex);
+   t0 = al_get_time();
+   bytes_written = stream->feeder(stream, fragment, bytes);
+   stream->decode_time += al_get_time() - t0;
+   al_unlock_mutex(stream->feeder_mutex);
+
+   if (stream->spl.loop == _ALLEGRO_PLAYMODE_STREAM_ONEDIR) {
+      /* Keep rewinding until the fragment is filled. */
+      while (bytes_written < bytes &&
+               stream->spl.loop == _ALLEGRO_PLAYMODE_STREAM_ONEDIR) {
+         size_t bw;
+         al_rewind_audio_stream(stream);
+         al_lock_mutex(stream->feeder_mutex);
+         t0 = al_get_time();
+         bw = stream->feeder(stream, fragment + bytes_written,
+            bytes - bytes_written);
+         stream->decode_time += al_get_time() - t0;
+         bytes_written += bw;
+         al_unlock_mutex(stream->feeder_mutex);
+      }
+   }
+   else if (bytes_written < bytes) {
+      /* Fill the rest of the fragment with silence. */
+      int silence_samples = (bytes - bytes_written) /
+         (al_get_channel_count(stream->spl.spl_data.chan_conf) *
+          al_get_audio_depth_size(stream->spl.spl_data.depth));
+      al_fill_silence(fragment + bytes_written, silence_samples,
+                      stream->spl.spl_data.depth, stream->spl.spl_data.chan_conf);
+   }
+
+   if (!al_set_audio_stream_fragment(stream, fragment)) {
+      ALLEGRO_ERROR("Error setting stream buffer.\n");
+      return false;
+   }
+
+   al_lock_mutex(stream->feeder_mutex);
+   stream->fed_fragments++;
+   if (stream->starving)
+      stream->late_fragments++;
+   if (freed_at > 0.0) {
+      double latency = al_get_time() - freed_at;
+      stream->refill_latency_sum += latency;
+      if (latency > stream->refill_latency_max)
+         stream->refill_latency_max = latency;
+      stream->refills_timed++;
+   }
+   al_unlock_mutex(stream->feeder_mutex);
+
+   /* The streaming source doesn't feed any more, so drain buffers.
+    * Don't quit in case the user decides to seek and then restart the
+    * stream. */
+   if (bytes_written != bytes &&
+      stream->spl.loop == _ALLEGRO_PLAYMODE_STREAM_ONCE) {
+      if (stream->feed_pooled) {
+         /* Pool workers must not wait for the drain. */
+         _al_kcm_drain_pooled_feeder(stream);
+         return false;
+      }
+
+      al_drain_audio_stream(stream);
+
+      if (!stream->feed_finished_event_sent) {
+         ALLEGRO_EVENT fin_event;
+         fin_event.user.type = ALLEGRO_EVENT_AUDIO_STREAM_FINISHED;
+         fin_event.user.timestamp = al_get_time();
+         al_emit_user_event(&stream->spl.es, &fin_event, NULL);
+         stream->feed_finished_event_sent = true;
+      }
+   } else {
+      stream->feed_finished_event_sent = false;
+   }
+
+   return true;
+}
+
+
 /* _al_kcm_feed_stream:
  * A routine running in another thread that feeds the stream buffers as
  * necessary, usually getting data from some file reader backend.
@@ -675,7 +853,6 @@ void *_al_kcm_feed_stream(ALLEGRO_THREAD *self, void *vstream)
 {
    ALLEGRO_AUDIO_STREAM *stream = vstream;
    ALLEGRO_EVENT_QUEUE *queue;
-   bool finished_event_sent = false;
    (void)self;
 
    ALLEGRO_DEBUG("Stream feeder thread started.\n");
@@ -689,77 +866,16 @@ void *_al_kcm_feed_stream(ALLEGRO_THREAD *self, void *vstream)
    al_unlock_mutex(stream->feed_thread_started_mutex);
 
    stream->quit_feed_thread = false;
+   stream->feed_finished_event_sent = false;
 
    while (!stream->quit_feed_thread) {
-      char *fragment;
       ALLEGRO_EVENT event;
 
       al_wait_for_event(queue, &event);
 
       if (event.type == ALLEGRO_EVENT_AUDIO_STREAM_FRAGMENT
           && !stream->is_draining) {
-         unsigned long bytes;
-         unsigned long bytes_written;
-         ALLEGRO_MUTEX *stream_mutex;
-
-         fragment = al_get_audio_stream_fragment(stream);
-         if (!fragment) {
-            /* This is not an error. */
-            continue;
-         }
-
-         bytes = (stream->spl.spl_data.len) *
-               al_get_channel_count(stream->spl.spl_data.chan_conf) *
-               al_get_audio_depth_size(stream->spl.spl_data.depth);
-
-         stream_mutex = maybe_lock_mutex(stream->spl.mutex);
-         bytes_written = stream->feeder(stream, fragment, bytes);
-         maybe_unlock_mutex(stream_mutex);
-
-         if (stream->spl.loop == _ALLEGRO_PLAYMODE_STREAM_ONEDIR) {
-            /* Keep rewinding until the fragment is filled. */
-            while (bytes_written < bytes &&
-                     stream->spl.loop == _ALLEGRO_PLAYMODE_STREAM_ONEDIR) {
-               size_t bw;
-               al_rewind_audio_stream(stream);
-               stream_mutex = maybe_lock_mutex(stream->spl.mutex);
-               bw = stream->feeder(stream, fragment + bytes_written,
-                  bytes - bytes_written);
-               bytes_written += bw;
-               maybe_unlock_mutex(stream_mutex);
-            }
-         }
-         else if (bytes_written < bytes) {
-            /* Fill the rest of the fragment with silence. */
-            int silence_samples = (bytes - bytes_written) /
-               (al_get_channel_count(stream->spl.spl_data.chan_conf) *
-                al_get_audio_depth_size(stream->spl.spl_data.depth));
-            al_fill_silence(fragment + bytes_written, silence_samples,
-                            stream->spl.spl_data.depth, stream->spl.spl_data.chan_conf);
-         }
-
-         if (!al_set_audio_stream_fragment(stream, fragment)) {
-            ALLEGRO_ERROR("Error setting stream buffer.\n");
-            continue;
-         }
-
-         /* The streaming source doesn't feed any more, so drain buffers.
-          * Don't quit in case the user decides to seek and then restart the
-          * stream. */
-         if (bytes_written != bytes &&
-            stream->spl.loop == _ALLEGRO_PLAYMODE_STREAM_ONCE) {
-            al_drain_audio_stream(stream);
-
-            if (!finished_event_sent) {
-               ALLEGRO_EVENT fin_event;
-               fin_event.user.type = ALLEGRO_EVENT_AUDIO_STREAM_FINISHED;
-               fin_event.user.timestamp = al_get_time();
-               al_emit_user_event(&stream->spl.es, &fin_event, NULL);
-               finished_event_sent = true;
-            }
-         } else {
-            finished_event_sent = false;
-         }
+         _al_kcm_feed_stream_fragment(stream);
       }
       else if (event.type == _KCM_STREAM_FEEDER_QUIT_EVENT_TYPE) {
          ALLEGRO_EVENT fin_event;
@@ -794,6 +910,9 @@ void _al_kcm_emit_stream_events(ALLEGRO_AUDIO_STREAM *stream)
     */
    int count = al_get_available_audio_stream_fragments(stream);
 
+   if (count > 0 && stream->feed_pooled)
+      _al_kcm_schedule_pooled_feeder(stream);
+
    while (count--) {
       ALLEGRO_EVENT event;
       event.user.type = ALLEGRO_EVENT_AUDIO_STREAM_FRAGMENT;
@@ -810,9 +929,9 @@ bool al_rewind_audio_stream(ALLEGRO_AUDIO_STREAM *stream)
    bool ret;
 
    if (stream->rewind_feeder) {
-      ALLEGRO_MUTEX *stream_mutex = maybe_lock_mutex(stream->spl.mutex);
+      al_lock_mutex(stream->feeder_mutex);
       ret = stream->rewind_feeder(stream);
-      maybe_unlock_mutex(stream_mutex);
+      al_unlock_mutex(stream->feeder_mutex);
       return ret;
    }
 
@@ -827,9 +946,9 @@ bool al_seek_audio_stream_secs(ALLEGRO_AUDIO_STREAM *stream, double time)
    bool ret;
 
    if (stream->seek_feeder) {
-      ALLEGRO_MUTEX *stream_mutex = maybe_lock_mutex(stream->spl.mutex);
+      al_lock_mutex(stream->feeder_mutex);
       ret = stream->seek_feeder(stream, time);
-      maybe_unlock_mutex(stream_mutex);
+      al_unlock_mutex(stream->feeder_mutex);
       return ret;
    }
 
@@ -844,9 +963,9 @@ double al_get_audio_stream_position_secs(ALLEGRO_AUDIO_STREAM *stream)
    double ret;
 
    if (stream->get_feeder_position) {
-      ALLEGRO_MUTEX *stream_mutex = maybe_lock_mutex(stream->spl.mutex);
+      al_lock_mutex(stream->feeder_mutex);
       ret = stream->get_feeder_position(stream);
-      maybe_unlock_mutex(stream_mutex);
+      al_unlock_mutex(stream->feeder_mutex);
       return ret;
    }
 
@@ -861,9 +980,9 @@ double al_get_audio_stream_length_secs(ALLEGRO_AUDIO_STREAM *stream)
    double ret;
 
    if (stream->get_feeder_length) {
-      ALLEGRO_MUTEX *stream_mutex = maybe_lock_mutex(stream->spl.mutex);
+      al_lock_mutex(stream->feeder_mutex);
       ret = stream->get_feeder_length(stream);
-      maybe_unlock_mutex(stream_mutex);
+      al_unlock_mutex(stream->feeder_mutex);
       return ret;
    }
 
@@ -882,9 +1001,9 @@ bool al_set_audio_stream_loop_secs(ALLEGRO_AUDIO_STREAM *stream,
       return false;
 
    if (stream->set_feeder_loop) {
-      ALLEGRO_MUTEX *stream_mutex = maybe_lock_mutex(stream->spl.mutex);
+      al_lock_mutex(stream->feeder_mutex);
       ret = stream->set_feeder_loop(stream, start, end);
-      maybe_unlock_mutex(stream_mutex);
+      al_unlock_mutex(stream->feeder_mutex);
       return ret;
    }
 
@@ -913,4 +1032,33 @@ bool al_set_audio_stream_channel_matrix(ALLEGRO_AUDIO_STREAM *stream, const floa
    return al_set_sample_instance_channel_matrix(&stream->spl, matrix);
 }
 
+
+/* Function: al_get_audio_stream_stats
+ */
+void al_get_audio_stream_stats(const ALLEGRO_AUDIO_STREAM *stream,
+   ALLEGRO_AUDIO_STATS *stats)
+{
+   ALLEGRO_MUTEX *stream_mutex;
+
+   ASSERT(stream);
+   ASSERT(stats);
+
+   _al_kcm_get_instance_stats(&stream->spl, stats);
+
+   stream_mutex = maybe_lock_mutex(stream->spl.mutex);
+   stats->underruns = stream->underruns;
+   maybe_unlock_mutex(stream_mutex);
+
+   al_lock_mutex(stream->feeder_mutex);
+   stats->late_fragments = stream->late_fragments;
+   stats->fed_fragments = stream->fed_fragments;
+   stats->decode_time = stream->decode_time;
+   if (stream->refills_timed > 0) {
+      stats->mean_refill_latency =
+         stream->refill_latency_sum / stream->refills_timed;
+   }
+   stats->max_refill_latency = stream->refill_latency_max;
+   al_unlock_mutex(stream->feeder_mutex);
+}
+
 /* vim: set sts=3 sw=3 et: */
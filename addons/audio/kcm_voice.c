@@ -50,9 +50,20 @@ const void *_al_voice_update(ALLEGRO_VOICE *voice, ALLEGRO_MUTEX *mutex,
 
    al_lock_mutex(voice->mutex);
    if (voice->attached_stream) {
-      ASSERT(voice->attached_stream->spl_read);
-      voice->attached_stream->spl_read(voice->attached_stream, &buf, samples,
-         voice->depth, 0);
+      ALLEGRO_SAMPLE_INSTANCE *spl = voice->attached_stream;
+      double t0 = al_get_time();
+      double dt;
+
+      ASSERT(spl->spl_read);
+      spl->spl_read(spl, &buf, samples, voice->depth, 0);
+
+      dt = al_get_time() - t0;
+      if (buf) {
+         spl->read_frames += *samples;
+         voice->read_frames += *samples;
+      }
+      spl->read_time += dt;
+      voice->read_time += dt;
    }
    al_unlock_mutex(voice->mutex);
 
@@ -216,15 +227,19 @@ static void stream_read(void *source, void **vbuf, unsigned int *samples,
       /* XXX: Handle the case where we need to call _al_kcm_refill_stream
        * multiple times due to ludicrous playback speed. */
       _al_kcm_refill_stream(stream);
-      if (!stream->pending_bufs[0]) {
+      if (!stream->spl.spl_data.buffer.ptr) {
          if (stream->is_draining) {
             stream->spl.is_playing = false;
+            /* As in the mixer, this lets a pooled stream send its
+             * finished event.
+             */
+            _al_kcm_emit_stream_events(stream);
          }
          *vbuf = NULL;
          *samples = 0;
          return;
       }
-      *vbuf = stream->pending_bufs[0];
+      *vbuf = stream->spl.spl_data.buffer.ptr;
       pos = *samples;
 
       _al_kcm_emit_stream_events(stream);
@@ -232,7 +247,7 @@ static void stream_read(void *source, void **vbuf, unsigned int *samples,
    else {
       int bytes = pos * al_get_channel_count(stream->spl.spl_data.chan_conf)
                       * al_get_audio_depth_size(stream->spl.spl_data.depth);
-      *vbuf = ((char *)stream->pending_bufs[0]) + bytes;
+      *vbuf = ((char *)stream->spl.spl_data.buffer.ptr) + bytes;
 
       if (pos + *samples > len)
          *samples = len - pos;
@@ -541,4 +556,20 @@ bool _al_kcm_set_voice_playing(ALLEGRO_VOICE *voice, ALLEGRO_MUTEX *mutex,
 }
 
 
+/* Function: al_get_voice_stats
+ */
+void al_get_voice_stats(const ALLEGRO_VOICE *voice, ALLEGRO_AUDIO_STATS *stats)
+{
+   ASSERT(voice);
+   ASSERT(stats);
+
+   memset(stats, 0, sizeof(*stats));
+
+   al_lock_mutex(voice->mutex);
+   stats->frames = voice->read_frames;
+   stats->read_time = voice->read_time;
+   al_unlock_mutex(voice->mutex);
+}
+
+
 /* vim: set sts=3 sw=3 et: */
@@ -0,0 +1,569 @@
+/*         ______   ___    ___
+ *        /\  _  \ /\_ \  /\_ \
+ *        \ \ \L\ \\//\ \ \//\ \      __     __   _ __   ___
+ *         \ \  __ \ \ \ \  \ \ \   /'__`\ /'_ `\/\`'__\/ __`\
+ *          \ \ \/\ \ \_\ \_ \_\ \_/\  __//\ \L\ \ \ \//\ \L\ \
+ *           \ \_\ \_\/\____\/\____\ \____\ \____ \ \_\\ \____/
+ *            \/_/\/_/\/____/\/____/\/____/\/___L\ \/_/ \/___/
+ *                                           /\____/
+ *                                           \_/__/
+ *
+ *      Null sound driver.
+ *
+ *      Voices are driven by a thread that pulls the attached mixer or
+ *      sample either in real time, at a scaled rate or as fast as possible,
+ *      and hands the output to a user callback and/or a WAV file instead
+ *      of a sound card.
+ *
+ *      See readme.txt for copyright information.
+ */
+
+#include <stdlib.h>
+
+#include "allegro5/allegro.h"
+#include "allegro5/internal/aintern_audio.h"
+
+ALLEGRO_DEBUG_CHANNEL("null audio")
+
+enum NULL_VOICE_STATUS {
+   NV_IDLE,
+   NV_PLAYING,
+   NV_STOPPING,
+   NV_JOIN
+};
+
+typedef struct NULL_VOICE
+{
+   unsigned int buffer_size_in_frames;
+   unsigned int frame_size_in_bytes;
+   double speed;
+
+   ALLEGRO_THREAD *thread;
+   /* status_cond, status, callback and callback_data are protected by
+    * voice->mutex, like the PulseAudio driver does.
+    */
+   ALLEGRO_COND *status_cond;
+   enum NULL_VOICE_STATUS status;
+
+   void (*callback)(ALLEGRO_VOICE *voice, const void *buf,
+      unsigned int samples, void *data);
+   void *callback_data;
+
+   /* Played in place of a missing mixer buffer. */
+   void *silence;
+
+   /* WAV output, only touched by the voice thread once it is running. */
+   ALLEGRO_FILE *wav;
+   int64_t wav_data_size;
+
+   /* Direct buffer (non-streaming), protected by buffer_mutex. */
+   ALLEGRO_MUTEX *buffer_mutex;
+   char *buffer;
+   char *buffer_end;
+} NULL_VOICE;
+
+#define DEFAULT_BUFFER_SIZE   1024
+#define MIN_BUFFER_SIZE       16
+
+/* Only one voice at a time may write the configured WAV file. */
+static ALLEGRO_MUTEX *wav_mutex = NULL;
+static ALLEGRO_VOICE *wav_voice = NULL;
+
+static unsigned int get_buffer_size(const ALLEGRO_CONFIG *config)
+{
+   if (config) {
+      const char *val = al_get_config_value(config, "null", "buffer_size");
+      if (val && val[0] != '\0') {
+         int n = atoi(val);
+         if (n < MIN_BUFFER_SIZE)
+            n = MIN_BUFFER_SIZE;
+         return n;
+      }
+   }
+
+   return DEFAULT_BUFFER_SIZE;
+}
+
+static double get_speed(const ALLEGRO_CONFIG *config)
+{
+   if (config) {
+      const char *val = al_get_config_value(config, "null", "speed");
+      if (val && val[0] != '\0') {
+         double speed = atof(val);
+         return speed > 0.0 ? speed : 0.0;
+      }
+   }
+
+   return 1.0;
+}
+
+static const char *get_output_file(const ALLEGRO_CONFIG *config)
+{
+   if (config) {
+      const char *val = al_get_config_value(config, "null", "output_file");
+      if (val && val[0] != '\0')
+         return val;
+   }
+
+   return NULL;
+}
+
+static bool wav_supports_depth(ALLEGRO_AUDIO_DEPTH depth)
+{
+   return depth == ALLEGRO_AUDIO_DEPTH_UINT8 ||
+      depth == ALLEGRO_AUDIO_DEPTH_INT16 ||
+      depth == ALLEGRO_AUDIO_DEPTH_FLOAT32;
+}
+
+/* Writes a RIFF header with placeholder sizes, which wav_close fills in. */
+static ALLEGRO_FILE *wav_open(const char *filename, ALLEGRO_VOICE *voice)
+{
+   const int channels = al_get_channel_count(voice->chan_conf);
+   const int sample_size = al_get_audio_depth_size(voice->depth);
+   const bool is_float = (voice->depth == ALLEGRO_AUDIO_DEPTH_FLOAT32);
+   ALLEGRO_FILE *f;
+
+   f = al_fopen(filename, "wb");
+   if (!f)
+      return NULL;
+
+   al_fputs(f, "RIFF");
+   al_fwrite32le(f, 0);
+   al_fputs(f, "WAVE");
+
+   al_fputs(f, "fmt ");
+   al_fwrite32le(f, 16);
+   al_fwrite16le(f, is_float ? 3 : 1);
+   al_fwrite16le(f, channels);
+   al_fwrite32le(f, voice->frequency);
+   al_fwrite32le(f, voice->frequency * channels * sample_size);
+   al_fwrite16le(f, channels * sample_size);
+   al_fwrite16le(f, sample_size * 8);
+
+   al_fputs(f, "data");
+   al_fwrite32le(f, 0);
+
+   if (al_ferror(f)) {
+      al_fclose(f);
+      return NULL;
+   }
+
+   return f;
+}
+
+static void wav_close(ALLEGRO_FILE *f, int64_t data_size)
+{
+   /* RIFF sizes are 32 bits; a longer recording keeps the maximum. */
+   if (data_size > 0x7FFFFFF0)
+      data_size = 0x7FFFFFF0;
+
+   if (al_fseek(f, 4, ALLEGRO_SEEK_SET)) {
+      al_fwrite32le(f, 36 + data_size);
+      al_fseek(f, 40, ALLEGRO_SEEK_SET);
+      al_fwrite32le(f, data_size);
+   }
+   al_fclose(f);
+}
+
+static int null_open(void)
+{
+   wav_mutex = al_create_mutex();
+   if (!wav_mutex)
+      return 1;
+   return 0;
+}
+
+static void null_close(void)
+{
+   al_destroy_mutex(wav_mutex);
+   wav_mutex = NULL;
+   wav_voice = NULL;
+}
+
+/* Hands one buffer of output to the callback and the WAV file. */
+static void null_output(ALLEGRO_VOICE *voice, const void *data,
+   unsigned int frames)
+{
+   NULL_VOICE *nv = voice->extra;
+   void (*callback)(ALLEGRO_VOICE *, const void *, unsigned int, void *);
+   void *callback_data;
+   size_t size = frames * nv->frame_size_in_bytes;
+
+   al_lock_mutex(voice->mutex);
+   callback = nv->callback;
+   callback_data = nv->callback_data;
+   al_unlock_mutex(voice->mutex);
+
+   if (callback)
+      callback(voice, data, frames, callback_data);
+
+   if (nv->wav) {
+      if (al_fwrite(nv->wav, data, size) == size) {
+         nv->wav_data_size += size;
+      }
+      else {
+         ALLEGRO_ERROR("Failed writing WAV output, closing it.\n");
+         wav_close(nv->wav, nv->wav_data_size);
+         nv->wav = NULL;
+      }
+   }
+}
+
+/* Returns the number of frames copied from the direct buffer. */
+static unsigned int null_read_direct(ALLEGRO_VOICE *voice,
+   const char **data, unsigned int frames)
+{
+   NULL_VOICE *nv = voice->extra;
+   unsigned int len = frames * nv->frame_size_in_bytes;
+
+   al_lock_mutex(nv->buffer_mutex);
+   *data = nv->buffer;
+   nv->buffer += len;
+   if (nv->buffer >= nv->buffer_end) {
+      len = nv->buffer_end - *data;
+      nv->buffer = voice->attached_stream->spl_data.buffer.ptr;
+      voice->attached_stream->pos = 0;
+      if (voice->attached_stream->loop == ALLEGRO_PLAYMODE_ONCE) {
+         al_lock_mutex(voice->mutex);
+         nv->status = NV_STOPPING;
+         al_broadcast_cond(nv->status_cond);
+         al_unlock_mutex(voice->mutex);
+      }
+   }
+   else {
+      voice->attached_stream->pos += frames;
+   }
+   al_unlock_mutex(nv->buffer_mutex);
+
+   return len / nv->frame_size_in_bytes;
+}
+
+/* Sleeps until the simulated clock catches up with the frames played so
+ * far, waking early if the voice is stopped.
+ */
+static void null_wait(ALLEGRO_VOICE *voice, double start_time,
+   uint64_t frames_played)
+{
+   NULL_VOICE *nv = voice->extra;
+   double delay;
+   ALLEGRO_TIMEOUT timeout;
+
+   delay = start_time + frames_played / (voice->frequency * nv->speed)
+      - al_get_time();
+   if (delay <= 0.0)
+      return;
+
+   al_init_timeout(&timeout, delay);
+   al_lock_mutex(voice->mutex);
+   while (nv->status == NV_PLAYING) {
+      if (al_wait_cond_until(nv->status_cond, voice->mutex, &timeout) != 0)
+         break;
+   }
+   al_unlock_mutex(voice->mutex);
+}
+
+static void *null_update(ALLEGRO_THREAD *self, void *data)
+{
+   ALLEGRO_VOICE *voice = data;
+   NULL_VOICE *nv = voice->extra;
+   double start_time = 0.0;
+   uint64_t frames_played = 0;
+   bool was_playing = false;
+   (void)self;
+
+   for (;;) {
+      enum NULL_VOICE_STATUS status;
+
+      al_lock_mutex(voice->mutex);
+      while ((status = nv->status) == NV_IDLE) {
+         al_wait_cond(nv->status_cond, voice->mutex);
+      }
+      al_unlock_mutex(voice->mutex);
+
+      if (status == NV_JOIN) {
+         break;
+      }
+
+      /* The simulated clock restarts whenever the voice starts playing. */
+      if (status == NV_PLAYING && !was_playing) {
+         start_time = al_get_time();
+         frames_played = 0;
+      }
+      was_playing = (status == NV_PLAYING);
+
+      if (status == NV_PLAYING) {
+         unsigned int frames = nv->buffer_size_in_frames;
+         const char *buf;
+
+         if (voice->is_streaming) {
+            buf = _al_voice_update(voice, voice->mutex, &frames);
+            if (!buf)
+               buf = nv->silence;
+         }
+         else {
+            frames = null_read_direct(voice, &buf, frames);
+         }
+
+         if (frames > 0) {
+            null_output(voice, buf, frames);
+            frames_played += frames;
+         }
+
+         if (nv->speed > 0.0)
+            null_wait(voice, start_time, frames_played);
+      }
+      else if (status == NV_STOPPING) {
+         al_lock_mutex(voice->mutex);
+         nv->status = NV_IDLE;
+         al_broadcast_cond(nv->status_cond);
+         al_unlock_mutex(voice->mutex);
+      }
+   }
+
+   return NULL;
+}
+
+static int null_allocate_voice(ALLEGRO_VOICE *voice)
+{
+   const ALLEGRO_CONFIG *config = al_get_system_config();
+   const char *filename = get_output_file(config);
+   NULL_VOICE *nv;
+
+   nv = al_calloc(1, sizeof(*nv));
+   if (!nv)
+      return 1;
+
+   if (filename) {
+      al_lock_mutex(wav_mutex);
+      if (wav_voice) {
+         ALLEGRO_WARN("%s is already written by another voice.\n", filename);
+         filename = NULL;
+      }
+      else {
+         wav_voice = voice;
+      }
+      al_unlock_mutex(wav_mutex);
+   }
+
+   /* We are free to choose the voice format, so pick one WAV can store. */
+   if (filename && !wav_supports_depth(voice->depth)) {
+      ALLEGRO_INFO("Using float32 voice for WAV output.\n");
+      voice->depth = ALLEGRO_AUDIO_DEPTH_FLOAT32;
+   }
+
+   nv->buffer_size_in_frames = voice->buffer_size ? voice->buffer_size
+      : get_buffer_size(config);
+   nv->frame_size_in_bytes = al_get_channel_count(voice->chan_conf) *
+      al_get_audio_depth_size(voice->depth);
+   nv->speed = get_speed(config);
+
+   nv->silence = al_malloc(nv->buffer_size_in_frames * nv->frame_size_in_bytes);
+   nv->status_cond = al_create_cond();
+   nv->buffer_mutex = al_create_mutex();
+   if (!nv->silence || !nv->status_cond || !nv->buffer_mutex)
+      goto Error;
+   al_fill_silence(nv->silence, nv->buffer_size_in_frames, voice->depth,
+      voice->chan_conf);
+
+   if (filename) {
+      nv->wav = wav_open(filename, voice);
+      if (!nv->wav) {
+         ALLEGRO_ERROR("Unable to open %s for writing.\n", filename);
+         goto Error;
+      }
+      ALLEGRO_INFO("Writing voice output to %s\n", filename);
+   }
+
+   nv->status = NV_IDLE;
+   voice->extra = nv;
+
+   nv->thread = al_create_thread(null_update, voice);
+   if (!nv->thread)
+      goto Error;
+   al_start_thread(nv->thread);
+
+   ALLEGRO_DEBUG("Allocated voice, %u frames per buffer, speed %g\n",
+      nv->buffer_size_in_frames, nv->speed);
+   return 0;
+
+Error:
+   if (nv->wav)
+      al_fclose(nv->wav);
+   if (filename) {
+      al_lock_mutex(wav_mutex);
+      wav_voice = NULL;
+      al_unlock_mutex(wav_mutex);
+   }
+   if (nv->buffer_mutex)
+      al_destroy_mutex(nv->buffer_mutex);
+   if (nv->status_cond)
+      al_destroy_cond(nv->status_cond);
+   al_free(nv->silence);
+   al_free(nv);
+   voice->extra = NULL;
+   return 1;
+}
+
+static void null_deallocate_voice(ALLEGRO_VOICE *voice)
+{
+   NULL_VOICE *nv = voice->extra;
+
+   al_lock_mutex(voice->mutex);
+   nv->status = NV_JOIN;
+   al_broadcast_cond(nv->status_cond);
+   al_unlock_mutex(voice->mutex);
+
+   /* We do NOT hold the voice mutex here, so this does NOT result in a
+    * deadlock when the thread calls _al_voice_update.
+    */
+   al_join_thread(nv->thread, NULL);
+   al_destroy_thread(nv->thread);
+
+   if (nv->wav) {
+      wav_close(nv->wav, nv->wav_data_size);
+   }
+
+   al_lock_mutex(wav_mutex);
+   if (wav_voice == voice)
+      wav_voice = NULL;
+   al_unlock_mutex(wav_mutex);
+
+   al_destroy_cond(nv->status_cond);
+   al_destroy_mutex(nv->buffer_mutex);
+   al_free(nv->silence);
+   al_free(nv);
+   voice->extra = NULL;
+}
+
+static int null_load_voice(ALLEGRO_VOICE *voice, const void *data)
+{
+   NULL_VOICE *nv = voice->extra;
+   (void)data;
+
+   if (voice->attached_stream->loop == ALLEGRO_PLAYMODE_BIDIR) {
+      ALLEGRO_INFO("Backwards playing not supported by the driver.\n");
+      return 1;
+   }
+
+   voice->attached_stream->pos = 0;
+
+   nv->buffer = voice->attached_stream->spl_data.buffer.ptr;
+   nv->buffer_end = nv->buffer +
+      (voice->attached_stream->spl_data.len) * nv->frame_size_in_bytes;
+
+   return 0;
+}
+
+static void null_unload_voice(ALLEGRO_VOICE *voice)
+{
+   (void) voice;
+}
+
+static int null_start_voice(ALLEGRO_VOICE *voice)
+{
+   NULL_VOICE *nv = voice->extra;
+
+   /* We hold the voice->mutex already. */
+
+   if (nv->status == NV_IDLE) {
+      nv->status = NV_PLAYING;
+      al_broadcast_cond(nv->status_cond);
+      return 0;
+   }
+
+   return 1;
+}
+
+static int null_stop_voice(ALLEGRO_VOICE *voice)
+{
+   NULL_VOICE *nv = voice->extra;
+
+   /* We hold the voice->mutex already. */
+
+   if (nv->status == NV_PLAYING) {
+      nv->status = NV_STOPPING;
+      al_broadcast_cond(nv->status_cond);
+   }
+
+   while (nv->status != NV_IDLE) {
+      al_wait_cond(nv->status_cond, voice->mutex);
+   }
+
+   return 0;
+}
+
+static bool null_voice_is_playing(const ALLEGRO_VOICE *voice)
+{
+   NULL_VOICE *nv = voice->extra;
+   return (nv->status == NV_PLAYING);
+}
+
+static unsigned int null_get_voice_position(const ALLEGRO_VOICE *voice)
+{
+   return voice->attached_stream->pos;
+}
+
+static int null_set_voice_position(ALLEGRO_VOICE *voice, unsigned int pos)
+{
+   NULL_VOICE *nv = voice->extra;
+
+   al_lock_mutex(nv->buffer_mutex);
+   voice->attached_stream->pos = pos;
+   nv->buffer = (char *)voice->attached_stream->spl_data.buffer.ptr +
+      pos * nv->frame_size_in_bytes;
+   al_unlock_mutex(nv->buffer_mutex);
+
+   return 0;
+}
+
+ALLEGRO_AUDIO_DRIVER _al_kcm_null_driver =
+{
+   "Null",
+
+   null_open,
+   null_close,
+
+   null_allocate_voice,
+   null_deallocate_voice,
+
+   null_load_voice,
+   null_unload_voice,
+
+   null_start_voice,
+   null_stop_voice,
+
+   null_voice_is_playing,
+
+   null_get_voice_position,
+   null_set_voice_position,
+
+   NULL,
+   NULL
+};
+
+/* Function: al_set_null_voice_callback
+ */
+bool al_set_null_voice_callback(ALLEGRO_VOICE *voice,
+   void (*callback)(ALLEGRO_VOICE *voice, const void *buf,
+      unsigned int samples, void *data),
+   void *data)
+{
+   NULL_VOICE *nv;
+   ASSERT(voice);
+
+   if (voice->driver != &_al_kcm_null_driver) {
+      _al_set_error(ALLEGRO_INVALID_OBJECT,
+         "Voice was not allocated by the null driver");
+      return false;
+   }
+
+   nv = voice->extra;
+   al_lock_mutex(voice->mutex);
+   nv->callback = callback;
+   nv->callback_data = data;
+   al_unlock_mutex(voice->mutex);
+
+   return true;
+}
+
+/* vim: set sts=3 sw=3 et: */
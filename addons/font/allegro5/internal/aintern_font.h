@@ -38,4 +38,6 @@ struct ALLEGRO_FONT_VTABLE
    ALLEGRO_FONT_METHOD(bool, get_glyph, (const ALLEGRO_FONT *f, int prev_codepoint, int codepoint, ALLEGRO_GLYPH *glyph));
 };
 
+ALLEGRO_FONT_FUNC(void, _al_align_to_integer_pixel, (float *x, float *y));
+
 #endif
@@ -57,7 +57,8 @@ static void align_to_integer_pixel_inner(
    al_transform_coordinates(inv, x, y);
 }
 
-static void align_to_integer_pixel(float *x, float *y)
+/* Also used by the TTF addon's text layouts. */
+void _al_align_to_integer_pixel(float *x, float *y)
 {
    ALLEGRO_TRANSFORM const *fwd;
    ALLEGRO_TRANSFORM inv;
@@ -90,7 +91,7 @@ void al_draw_ustr(const ALLEGRO_FONT *font,
    }
 
    if (flags & ALLEGRO_ALIGN_INTEGER)
-      align_to_integer_pixel(&x, &y);
+      _al_align_to_integer_pixel(&x, &y);
 
    font->vtable->render(font, color, ustr, x, y);
 }
@@ -155,7 +156,7 @@ void al_draw_justified_ustr(const ALLEGRO_FONT *font,
    if ((space <= 0) || (space > diff) || (num_words < 2)) {
       /* can't justify */
       if (flags & ALLEGRO_ALIGN_INTEGER)
-         align_to_integer_pixel(&x1, &y);
+         _al_align_to_integer_pixel(&x1, &y);
       font->vtable->render(font, color, ustr, x1, y);
       return; 
    }
@@ -25,6 +25,9 @@
 #include "allegro5/internal/aintern_prim_soft.h"
 #include "allegro5/internal/aintern_prim.h"
 #include "allegro5/internal/aintern_tri_soft.h"
+#include "allegro5/internal/aintern_workers.h"
+#include <math.h>
+#include <stdlib.h>
 
 /*
 The vertex cache allows for bulk transformation of vertices, for faster run speeds
@@ -100,6 +103,213 @@ static void convert_vtx(ALLEGRO_BITMAP* texture, const char* src, ALLEGRO_VERTEX
    }
 }
 
+/*
+Triangle batches drawn onto large memory bitmaps can be rasterized by several
+threads at once, if enabled by the graphics/primitives_threads config key.
+The triangles are collected into a batch first, then the rows they touch are
+split into bands. Each band draws every triangle of the batch in order, but
+only its own rows, so the result is the same as drawing them one by one.
+*/
+#define MIN_BAND_ROWS     32
+#define MIN_BAND_PIXELS   (256 * 256)
+
+typedef struct TRIANGLE_BATCH {
+   ALLEGRO_BITMAP* texture;
+   ALLEGRO_BITMAP* target;
+   ALLEGRO_STATE state;
+   ALLEGRO_VERTEX* vtxs;
+   int num_tris;
+   int max_tris;
+   float min_x, min_y, max_x, max_y;
+   int y1, y2;
+   int num_bands;
+} TRIANGLE_BATCH;
+
+static int max_render_threads = 1;
+
+/*
+Reads the primitives_threads config key. This is done once, as looking it up
+while drawing could change al_get_errno. An explicit thread count starts that
+many worker threads even on fewer CPUs
+*/
+void _al_init_prim_soft(void)
+{
+   const char* value = al_get_config_value(al_get_system_config(), "graphics",
+      "primitives_threads");
+
+   max_render_threads = 1;
+   if (!value)
+      return;
+   if (!_al_stricmp(value, "auto")) {
+      max_render_threads = _al_get_num_workers();
+      return;
+   }
+   if (atoi(value) > 1) {
+      _al_request_workers(atoi(value));
+      max_render_threads = _ALLEGRO_MIN(atoi(value), _al_get_num_workers());
+   }
+}
+
+static int get_max_render_threads(void)
+{
+   return max_render_threads;
+}
+
+/*
+Returns the batch to collect the triangles into, or NULL if they should be
+drawn straight away
+*/
+static TRIANGLE_BATCH* begin_batch(TRIANGLE_BATCH* batch, ALLEGRO_BITMAP* texture, int type, int num_vtx)
+{
+   ALLEGRO_BITMAP* target = al_get_target_bitmap();
+   int max_tris;
+
+   if (type == ALLEGRO_PRIM_TRIANGLE_LIST)
+      max_tris = num_vtx / 3;
+   else if (type == ALLEGRO_PRIM_TRIANGLE_STRIP)
+      max_tris = num_vtx - 2;
+   else if (type == ALLEGRO_PRIM_TRIANGLE_FAN)
+      max_tris = num_vtx - 1;
+   else
+      return NULL;
+
+   if (max_tris < 1 || !(al_get_bitmap_flags(target) & ALLEGRO_MEMORY_BITMAP))
+      return NULL;
+   /* The bands would read texels that other bands are still writing. */
+   if (texture && (texture->parent ? texture->parent : texture) ==
+         (target->parent ? target->parent : target))
+      return NULL;
+   if (get_max_render_threads() < 2)
+      return NULL;
+
+   batch->vtxs = al_malloc(max_tris * 3 * sizeof(ALLEGRO_VERTEX));
+   if (!batch->vtxs)
+      return NULL;
+
+   batch->texture = texture;
+   batch->target = target;
+   batch->num_tris = 0;
+   batch->max_tris = max_tris;
+   batch->min_x = batch->min_y = HUGE_VAL;
+   batch->max_x = batch->max_y = -HUGE_VAL;
+   return batch;
+}
+
+static void add_triangle(TRIANGLE_BATCH* batch, ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX* v2, ALLEGRO_VERTEX* v3)
+{
+   ALLEGRO_VERTEX* v = &batch->vtxs[batch->num_tris * 3];
+   int ii;
+
+   ASSERT(batch->num_tris < batch->max_tris);
+   v[0] = *v1;
+   v[1] = *v2;
+   v[2] = *v3;
+   batch->num_tris++;
+
+   for (ii = 0; ii < 3; ii++) {
+      batch->min_x = _ALLEGRO_MIN(batch->min_x, v[ii].x);
+      batch->min_y = _ALLEGRO_MIN(batch->min_y, v[ii].y);
+      batch->max_x = _ALLEGRO_MAX(batch->max_x, v[ii].x);
+      batch->max_y = _ALLEGRO_MAX(batch->max_y, v[ii].y);
+   }
+}
+
+static void draw_triangle(TRIANGLE_BATCH* batch, ALLEGRO_BITMAP* texture, ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX* v2, ALLEGRO_VERTEX* v3)
+{
+   if (batch)
+      add_triangle(batch, v1, v2, v3);
+   else
+      _al_triangle_2d(texture, v1, v2, v3);
+}
+
+static void draw_band(int band, void* arg)
+{
+   TRIANGLE_BATCH* batch = arg;
+   int h = batch->y2 - batch->y1;
+   int y1 = batch->y1 + h * band / batch->num_bands;
+   int y2 = batch->y1 + h * (band + 1) / batch->num_bands;
+   ALLEGRO_STATE state;
+   ALLEGRO_VERTEX* v = batch->vtxs;
+   int ii;
+
+   /* The band may run on a worker thread, which has a target bitmap and
+    * blender of its own, so use the caller's and put them back afterwards.
+    */
+   al_store_state(&state, ALLEGRO_STATE_TARGET_BITMAP | ALLEGRO_STATE_BLENDER);
+   al_restore_state(&batch->state);
+
+   for (ii = 0; ii < batch->num_tris; ii++, v += 3) {
+      _al_triangle_2d_rows(batch->texture, &v[0], &v[1], &v[2], y1, y2);
+   }
+
+   al_restore_state(&state);
+}
+
+/*
+Works out the region that the batch may touch (in the same way as
+_al_triangle_2d does for each triangle) and how many bands to split it into
+*/
+static int get_num_bands(TRIANGLE_BATCH* batch, int* x1, int* w)
+{
+   int clip_x, clip_y, clip_w, clip_h;
+   float fx1, fy1, fx2, fy2;
+   int rows, n;
+
+   al_get_clipping_rectangle(&clip_x, &clip_y, &clip_w, &clip_h);
+
+   fx1 = _ALLEGRO_MAX(floorf(batch->min_x) - 1, (float)clip_x);
+   fy1 = _ALLEGRO_MAX(floorf(batch->min_y) - 1, (float)clip_y);
+   fx2 = _ALLEGRO_MIN(ceilf(batch->max_x) + 1, (float)(clip_x + clip_w));
+   fy2 = _ALLEGRO_MIN(ceilf(batch->max_y) + 1, (float)(clip_y + clip_h));
+   if (!(fx2 > fx1 && fy2 > fy1))
+      return 1;
+   *x1 = (int)fx1;
+   *w = (int)fx2 - *x1;
+   batch->y1 = (int)fy1;
+   batch->y2 = (int)fy2;
+
+   rows = batch->y2 - batch->y1;
+   n = _ALLEGRO_MIN(get_max_render_threads(), (int64_t)*w * rows / MIN_BAND_PIXELS);
+   /* Twice as many bands as threads evens out unbalanced scenes. */
+   n = _ALLEGRO_MIN(n * 2, rows / MIN_BAND_ROWS);
+   return n;
+}
+
+static void end_batch(TRIANGLE_BATCH* batch)
+{
+   ALLEGRO_BITMAP* target = batch->target;
+   ALLEGRO_BITMAP* root = target->parent ? target->parent : target;
+   bool need_unlock = false;
+   int x1, w;
+   int ii;
+
+   if (batch->num_tris > 0) {
+      batch->num_bands = get_num_bands(batch, &x1, &w);
+
+      if (batch->num_bands > 1 && !al_is_bitmap_locked(root)) {
+         if (al_lock_bitmap_region(target, x1, batch->y1, w, batch->y2 - batch->y1, ALLEGRO_PIXEL_FORMAT_ANY, 0))
+            need_unlock = true;
+         else
+            batch->num_bands = 1;
+      }
+
+      if (batch->num_bands > 1) {
+         al_store_state(&batch->state, ALLEGRO_STATE_TARGET_BITMAP | ALLEGRO_STATE_BLENDER);
+         _al_run_parallel(batch->num_bands, draw_band, batch);
+      } else {
+         ALLEGRO_VERTEX* v = batch->vtxs;
+         for (ii = 0; ii < batch->num_tris; ii++, v += 3) {
+            _al_triangle_2d(batch->texture, &v[0], &v[1], &v[2]);
+         }
+      }
+
+      if (need_unlock)
+         al_unlock_bitmap(target);
+   }
+
+   al_free(batch->vtxs);
+}
+
 int _al_draw_prim_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const ALLEGRO_VERTEX_DECL* decl, int start, int end, int type)
 {
    LOCAL_VERTEX_CACHE;
@@ -108,6 +318,8 @@ int _al_draw_prim_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const ALLEGRO_
    int use_cache;
    int stride = decl ? decl->stride : (int)sizeof(ALLEGRO_VERTEX);
    const ALLEGRO_TRANSFORM* global_trans = al_get_current_transform();
+   TRIANGLE_BATCH batch_data;
+   TRIANGLE_BATCH* batch;
    
    num_primitives = 0;
    num_vtx = end - start;
@@ -115,6 +327,8 @@ int _al_draw_prim_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const ALLEGRO_
 
    if (texture)
       al_lock_bitmap(texture, ALLEGRO_PIXEL_FORMAT_ANY, ALLEGRO_LOCK_READONLY);
+
+   batch = begin_batch(&batch_data, texture, type, num_vtx);
       
    if (use_cache) {
       int ii;
@@ -199,7 +413,7 @@ int _al_draw_prim_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const ALLEGRO_
          if (use_cache) {
             int ii;
             for (ii = 0; ii < num_vtx - 2; ii += 3) {
-               _al_triangle_2d(texture, &vertex_cache[ii], &vertex_cache[ii + 1], &vertex_cache[ii + 2]);
+               draw_triangle(batch, texture, &vertex_cache[ii], &vertex_cache[ii + 1], &vertex_cache[ii + 2]);
             }
          } else {
             int ii;
@@ -209,7 +423,7 @@ int _al_draw_prim_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const ALLEGRO_
                SET_VERTEX(v2, ii + 1);
                SET_VERTEX(v3, ii + 2);
                
-               _al_triangle_2d(texture, &v1, &v2, &v3);
+               draw_triangle(batch, texture, &v1, &v2, &v3);
             }
          }
          num_primitives = num_vtx / 3;
@@ -219,7 +433,7 @@ int _al_draw_prim_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const ALLEGRO_
          if (use_cache) {
             int ii;
             for (ii = 2; ii < num_vtx; ii++) {
-               _al_triangle_2d(texture, &vertex_cache[ii - 2], &vertex_cache[ii - 1], &vertex_cache[ii]);
+               draw_triangle(batch, texture, &vertex_cache[ii - 2], &vertex_cache[ii - 1], &vertex_cache[ii]);
             }
          } else {
             int ii;
@@ -230,7 +444,7 @@ int _al_draw_prim_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const ALLEGRO_
             for (ii = start + 2; ii < end; ii++) {
                SET_VERTEX(vtx[idx], ii);
                
-               _al_triangle_2d(texture, &vtx[0], &vtx[1], &vtx[2]);
+               draw_triangle(batch, texture, &vtx[0], &vtx[1], &vtx[2]);
                idx = (idx + 1) % 3;
             }
          }
@@ -241,7 +455,7 @@ int _al_draw_prim_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const ALLEGRO_
          if (use_cache) {
             int ii;
             for (ii = 1; ii < num_vtx; ii++) {
-               _al_triangle_2d(texture, &vertex_cache[0], &vertex_cache[ii], &vertex_cache[ii - 1]);
+               draw_triangle(batch, texture, &vertex_cache[0], &vertex_cache[ii], &vertex_cache[ii - 1]);
             }
          } else {
             int ii;
@@ -252,7 +466,7 @@ int _al_draw_prim_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const ALLEGRO_
             SET_VERTEX(vtx[0], start + 1);
             for (ii = start + 1; ii < end; ii++) {
                SET_VERTEX(vtx[idx], ii)
-               _al_triangle_2d(texture, &v0, &vtx[0], &vtx[1]);
+               draw_triangle(batch, texture, &v0, &vtx[0], &vtx[1]);
                idx = 1 - idx;
             }
          }
@@ -278,6 +492,9 @@ int _al_draw_prim_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const ALLEGRO_
          break;
       };
    }
+
+   if (batch)
+      end_batch(batch);
    
    if(texture)
        al_unlock_bitmap(texture);
@@ -296,6 +513,8 @@ int _al_draw_prim_indexed_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const
    int ii;
    int stride = decl ? decl->stride : (int)sizeof(ALLEGRO_VERTEX);
    const ALLEGRO_TRANSFORM* global_trans = al_get_current_transform();
+   TRIANGLE_BATCH batch_data;
+   TRIANGLE_BATCH* batch;
 
    num_primitives = 0;   
    use_cache = 1;
@@ -318,6 +537,8 @@ int _al_draw_prim_indexed_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const
 
    if (texture)
       al_lock_bitmap(texture, ALLEGRO_PIXEL_FORMAT_ANY, ALLEGRO_LOCK_READONLY);
+
+   batch = begin_batch(&batch_data, texture, type, num_vtx);
       
    if (use_cache) {
       int ii;
@@ -419,7 +640,7 @@ int _al_draw_prim_indexed_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const
                int idx1 = indices[ii] - min_idx;
                int idx2 = indices[ii + 1] - min_idx;
                int idx3 = indices[ii + 2] - min_idx;
-               _al_triangle_2d(texture, &vertex_cache[idx1], &vertex_cache[idx2], &vertex_cache[idx3]);
+               draw_triangle(batch, texture, &vertex_cache[idx1], &vertex_cache[idx2], &vertex_cache[idx3]);
             }
          } else {
             int ii;
@@ -433,7 +654,7 @@ int _al_draw_prim_indexed_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const
                SET_VERTEX(v2, idx2);
                SET_VERTEX(v3, idx3);
                
-               _al_triangle_2d(texture, &v1, &v2, &v3);
+               draw_triangle(batch, texture, &v1, &v2, &v3);
             }
          }
          num_primitives = num_vtx / 3;
@@ -446,7 +667,7 @@ int _al_draw_prim_indexed_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const
                int idx1 = indices[ii - 2] - min_idx;
                int idx2 = indices[ii - 1] - min_idx;
                int idx3 = indices[ii] - min_idx;
-               _al_triangle_2d(texture, &vertex_cache[idx1], &vertex_cache[idx2], &vertex_cache[idx3]);
+               draw_triangle(batch, texture, &vertex_cache[idx1], &vertex_cache[idx2], &vertex_cache[idx3]);
             }
          } else {
             int ii;
@@ -457,7 +678,7 @@ int _al_draw_prim_indexed_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const
             for (ii = 2; ii < num_vtx; ii ++) {
                SET_VERTEX(vtx[idx], indices[ii]);
                
-               _al_triangle_2d(texture, &vtx[0], &vtx[1], &vtx[2]);
+               draw_triangle(batch, texture, &vtx[0], &vtx[1], &vtx[2]);
                idx = (idx + 1) % 3;
             }
          }
@@ -471,7 +692,7 @@ int _al_draw_prim_indexed_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const
             for (ii = 1; ii < num_vtx; ii++) {
                int idx1 = indices[ii] - min_idx;
                int idx2 = indices[ii - 1] - min_idx;
-               _al_triangle_2d(texture, &vertex_cache[idx0], &vertex_cache[idx1], &vertex_cache[idx2]);
+               draw_triangle(batch, texture, &vertex_cache[idx0], &vertex_cache[idx1], &vertex_cache[idx2]);
             }
          } else {
             int ii;
@@ -482,7 +703,7 @@ int _al_draw_prim_indexed_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const
             SET_VERTEX(vtx[0], indices[1]);
             for (ii = 2; ii < num_vtx; ii ++) {
                SET_VERTEX(vtx[idx], indices[ii])
-               _al_triangle_2d(texture, &v0, &vtx[0], &vtx[1]);
+               draw_triangle(batch, texture, &v0, &vtx[0], &vtx[1]);
                idx = 1 - idx;
             }
          }
@@ -510,6 +731,9 @@ int _al_draw_prim_indexed_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const
       };
    }
 
+   if (batch)
+      end_batch(batch);
+
    if(texture)
        al_unlock_bitmap(texture);
    
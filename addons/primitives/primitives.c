@@ -47,6 +47,7 @@ bool al_init_primitives_addon(void)
 {
    bool ret = true;
    ret &= _al_init_d3d_driver();
+   _al_init_prim_soft();
    
    addon_initialized = ret;
    
@@ -43,6 +43,37 @@ ALLEGRO_TTF_FUNC(bool, al_is_ttf_addon_initialized, (void));
 ALLEGRO_TTF_FUNC(void, al_shutdown_ttf_addon, (void));
 ALLEGRO_TTF_FUNC(uint32_t, al_get_allegro_ttf_version, (void));
 
+#if defined(ALLEGRO_UNSTABLE) || defined(ALLEGRO_INTERNAL_UNSTABLE) || defined(ALLEGRO_TTF_SRC)
+/* Type: ALLEGRO_TTF_CACHE_STATS
+ */
+typedef struct ALLEGRO_TTF_CACHE_STATS ALLEGRO_TTF_CACHE_STATS;
+
+struct ALLEGRO_TTF_CACHE_STATS
+{
+   uint64_t hits;
+   uint64_t misses;
+   uint64_t evictions;
+   unsigned int evicted_pages;
+   unsigned int pages;
+   size_t size;
+   size_t used;
+};
+
+/* Type: ALLEGRO_TTF_TEXT_LAYOUT
+ */
+typedef struct ALLEGRO_TTF_TEXT_LAYOUT ALLEGRO_TTF_TEXT_LAYOUT;
+
+ALLEGRO_TTF_FUNC(bool, al_set_ttf_cache_size, (ALLEGRO_FONT *font, size_t size));
+ALLEGRO_TTF_FUNC(bool, al_get_ttf_cache_stats, (ALLEGRO_FONT const *font, ALLEGRO_TTF_CACHE_STATS *stats));
+ALLEGRO_TTF_FUNC(bool, al_prefetch_ttf_glyphs, (ALLEGRO_FONT *font, const ALLEGRO_USTR *text));
+ALLEGRO_TTF_FUNC(bool, al_prefetch_ttf_glyph_range, (ALLEGRO_FONT *font, int first, int last));
+ALLEGRO_TTF_FUNC(int, al_get_ttf_pending_glyphs, (ALLEGRO_FONT const *font));
+ALLEGRO_TTF_FUNC(ALLEGRO_TTF_TEXT_LAYOUT *, al_create_ttf_text_layout, (ALLEGRO_FONT *font, const ALLEGRO_USTR *text));
+ALLEGRO_TTF_FUNC(void, al_destroy_ttf_text_layout, (ALLEGRO_TTF_TEXT_LAYOUT *layout));
+ALLEGRO_TTF_FUNC(int, al_get_ttf_text_layout_width, (ALLEGRO_TTF_TEXT_LAYOUT const *layout));
+ALLEGRO_TTF_FUNC(void, al_draw_ttf_text_layout, (ALLEGRO_TTF_TEXT_LAYOUT *layout, ALLEGRO_COLOR color, float x, float y, int flags));
+#endif
+
 #ifdef __cplusplus
    }
 #endif
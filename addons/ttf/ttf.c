@@ -17,6 +17,8 @@
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
+#include <limits.h>
+#include <math.h>
 #include <stdlib.h>
 
 ALLEGRO_DEBUG_CHANNEL("font")
@@ -37,6 +39,16 @@ ALLEGRO_DEBUG_CHANNEL("font")
 
 #define RANGE_SIZE   128
 
+/* Kerning values looked up from FreeType are kept in a hash table, which
+ * starts over once it would need more than KERNING_CACHE_MAX entries.
+ */
+#define KERNING_CACHE_MIN     256
+#define KERNING_CACHE_MAX     65536
+#define KERNING_EMPTY         0xFFFFFFFFu
+
+/* Marks pairs in the Latin kerning table whose kerning does not fit. */
+#define LATIN_KERNING_NONE    -128
+
 
 typedef struct REGION
 {
@@ -47,13 +59,33 @@ typedef struct REGION
 } REGION;
 
 
+/* The top edge of the glyphs packed into a page so far is kept as a list of
+ * horizontal segments, left to right.  New glyphs are put on top of it.
+ */
+typedef struct SKYLINE_SEGMENT
+{
+   short x;
+   short y;
+   short w;
+} SKYLINE_SEGMENT;
+
+
+typedef struct ALLEGRO_TTF_PAGE
+{
+   ALLEGRO_BITMAP *bitmap;
+   unsigned int last_used;    /* use_count of the font when last drawn from */
+   _AL_VECTOR skyline;        /* of SKYLINE_SEGMENT */
+} ALLEGRO_TTF_PAGE;
+
+
 typedef struct ALLEGRO_TTF_GLYPH_DATA
 {
-   ALLEGRO_BITMAP *page_bitmap;
+   ALLEGRO_TTF_PAGE *page;
    REGION region;
    short offset_x;
    short offset_y;
    short advance;
+   bool queued;               /* requested from the prefetch thread */
 } ALLEGRO_TTF_GLYPH_DATA;
 
 
@@ -64,16 +96,82 @@ typedef struct ALLEGRO_TTF_GLYPH_RANGE
 } ALLEGRO_TTF_GLYPH_RANGE;
 
 
+/* A glyph of a text layout, ready to be drawn. */
+typedef struct LAYOUT_GLYPH
+{
+   ALLEGRO_TTF_PAGE *page;
+   short sx, sy, sw, sh;      /* region on the page, without the border */
+   float dx, dy;              /* position relative to the text */
+} LAYOUT_GLYPH;
+
+
+struct ALLEGRO_TTF_TEXT_LAYOUT
+{
+   ALLEGRO_FONT *font;
+   ALLEGRO_USTR *text;
+   int width;
+
+   /* The glyphs are sorted by page, so that each page is drawn at once.
+    * They are only up to date as long as the glyph cache of the font did not
+    * change since they were laid out, which is when cache_changes still
+    * matches, so glyphs uploaded from the prefetch thread show up too.
+    */
+   LAYOUT_GLYPH *glyphs;
+   int num_glyphs;
+   unsigned int cache_changes;
+   bool valid;                /* false if the pages changed while laying out */
+   bool uses_fallback;        /* drawn with al_draw_ustr instead */
+};
+
+
+typedef struct KERNING_PAIR
+{
+   uint32_t key;              /* first glyph index << 16 | second */
+   int kerning;
+} KERNING_PAIR;
+
+
+/* A glyph rendered by the prefetch thread, waiting to be put on a page. */
+typedef struct STAGED_GLYPH
+{
+   int ft_index;
+   short offset_x;
+   short offset_y;
+   short advance;
+   short w;
+   short h;
+   unsigned char *pixels;     /* w * h ABGR pixels, NULL if w or h is 0 or
+                               * if out of memory */
+} STAGED_GLYPH;
+
+
+/* Renders glyphs in the background.  FreeType objects may not be shared
+ * between threads, so the thread has its own face, read from a copy of the
+ * font file.
+ */
+typedef struct TTF_PREFETCHER
+{
+   ALLEGRO_THREAD *thread;
+   ALLEGRO_MUTEX *mutex;
+   ALLEGRO_COND *cond;
+   FT_Library library;
+   FT_Face face;
+   unsigned char *font_buffer;
+
+   /* Protected by mutex. */
+   _AL_VECTOR queue;          /* of int, glyph indices, newest last */
+   _AL_VECTOR staged;         /* of STAGED_GLYPH */
+   int rendering;
+} TTF_PREFETCHER;
+
+
 typedef struct ALLEGRO_TTF_FONT_DATA
 {
    FT_Face face;
    int flags;
    _AL_VECTOR glyph_ranges;  /* sorted array of of ALLEGRO_TTF_GLYPH_RANGE */
 
-   _AL_VECTOR page_bitmaps;  /* of ALLEGRO_BITMAP pointers */
-   int page_pos_x;
-   int page_pos_y;
-   int page_line_height;
+   _AL_VECTOR pages;  /* of ALLEGRO_TTF_PAGE pointers, the last is filled */
    ALLEGRO_LOCKED_REGION *page_lr;
 
    FT_StreamRec stream;
@@ -88,6 +186,35 @@ typedef struct ALLEGRO_TTF_FONT_DATA
    int max_page_size;
 
    bool skip_cache_misses;
+
+   /* Once the pages take up more than cache_size bytes, the least recently
+    * used one is cleared and reused for new glyphs.  0 means no limit.
+    */
+   size_t cache_size;
+   size_t cache_used;
+   size_t glyph_bytes;       /* part of cache_used packed with glyphs */
+   unsigned int use_count;   /* incremented for each text drawn */
+   uint64_t hits;
+   uint64_t misses;
+   uint64_t evictions;
+   unsigned int evicted_pages;
+   unsigned int cache_changes;  /* glyphs cached or pages evicted so far */
+
+   int size_w;
+   int size_h;
+   TTF_PREFETCHER *prefetcher;  /* created by the first prefetch request */
+
+   KERNING_PAIR *kerning_cache; /* [kerning_mask + 1], open addressing */
+   unsigned int kerning_mask;
+   unsigned int kerning_count;
+
+   /* With the latin_kerning_table option, the kerning of all pairs of
+    * glyphs used by Latin-1 characters, indexed by latin_slots[glyph index].
+    */
+   signed char *latin_kerning;
+   unsigned char *latin_slots;   /* 0 for glyphs not in the table */
+   int num_latin_slots;          /* size of latin_slots */
+   int num_latin_glyphs;
 } ALLEGRO_TTF_FONT_DATA;
 
 
@@ -149,7 +276,7 @@ static bool get_glyph(ALLEGRO_TTF_FONT_DATA *data,
    *glyph = &range->glyphs[ft_index - range_start]; 
    
    /* If we're skipping cache misses and it isn't already cached, return it as invalid. */
-   if (data->skip_cache_misses && !(*glyph)->page_bitmap && (*glyph)->region.x >= 0) {
+   if (data->skip_cache_misses && !(*glyph)->page && (*glyph)->region.x >= 0) {
       return false;
    }
 
@@ -160,20 +287,199 @@ static bool get_glyph(ALLEGRO_TTF_FONT_DATA *data,
 static void unlock_current_page(ALLEGRO_TTF_FONT_DATA *data)
 {
    if (data->page_lr) {
-      ALLEGRO_BITMAP **back = _al_vector_ref_back(&data->page_bitmaps);
-      ASSERT(al_is_bitmap_locked(*back));
-      al_unlock_bitmap(*back);
+      ALLEGRO_TTF_PAGE **back = _al_vector_ref_back(&data->pages);
+      ASSERT(al_is_bitmap_locked((*back)->bitmap));
+      al_unlock_bitmap((*back)->bitmap);
       data->page_lr = NULL;
-      ALLEGRO_DEBUG("Unlocking page: %p\n", *back);
+      ALLEGRO_DEBUG("Unlocking page: %p\n", (*back)->bitmap);
+   }
+}
+
+
+static size_t page_bytes(ALLEGRO_TTF_PAGE *page)
+{
+   return (size_t)al_get_bitmap_width(page->bitmap) *
+      al_get_bitmap_height(page->bitmap) * 4;
+}
+
+
+static void destroy_page(ALLEGRO_TTF_FONT_DATA *data, ALLEGRO_TTF_PAGE *page)
+{
+   data->cache_used -= page_bytes(page);
+   al_destroy_bitmap(page->bitmap);
+   _al_vector_free(&page->skyline);
+   al_free(page);
+}
+
+
+static void clear_skyline(ALLEGRO_TTF_PAGE *page)
+{
+   SKYLINE_SEGMENT *seg;
+
+   _al_vector_free(&page->skyline);
+   seg = _al_vector_alloc_back(&page->skyline);
+   seg->x = 0;
+   seg->y = 0;
+   seg->w = al_get_bitmap_width(page->bitmap);
+}
+
+
+/* Returns the lowest y at which a w x h rectangle with its left edge at
+ * segment i fits on top of the skyline, or -1 if it does not fit there.
+ */
+static int skyline_fit(ALLEGRO_TTF_PAGE *page, unsigned int i, int w, int h)
+{
+   SKYLINE_SEGMENT *seg = _al_vector_ref(&page->skyline, i);
+   int left = w;
+   int y = 0;
+
+   if (seg->x + w > al_get_bitmap_width(page->bitmap))
+      return -1;
+
+   while (left > 0) {
+      seg = _al_vector_ref(&page->skyline, i++);
+      if (seg->y > y)
+         y = seg->y;
+      if (y + h > al_get_bitmap_height(page->bitmap))
+         return -1;
+      left -= seg->w;
    }
+
+   return y;
+}
+
+
+/* Finds the place for a w x h rectangle whose top edge is lowest, preferring
+ * narrow gaps on ties.  Returns false if the page has no room for it.
+ */
+static bool skyline_find(ALLEGRO_TTF_PAGE *page, int w, int h,
+   unsigned int *best_i, int *best_y)
+{
+   int best_top = INT_MAX;
+   int best_w = INT_MAX;
+   unsigned int i;
+
+   for (i = 0; i < _al_vector_size(&page->skyline); i++) {
+      SKYLINE_SEGMENT *seg = _al_vector_ref(&page->skyline, i);
+      int y = skyline_fit(page, i, w, h);
+      if (y >= 0 && (y + h < best_top || (y + h == best_top && seg->w < best_w))) {
+         best_top = y + h;
+         best_w = seg->w;
+         *best_i = i;
+         *best_y = y;
+      }
+   }
+
+   return best_top != INT_MAX;
+}
+
+
+/* Raises the skyline over a w x h rectangle placed at segment i. */
+static void skyline_add(ALLEGRO_TTF_PAGE *page, unsigned int i, int y,
+   int w, int h)
+{
+   SKYLINE_SEGMENT *seg = _al_vector_ref(&page->skyline, i);
+   int x = seg->x;
+
+   seg = _al_vector_alloc_mid(&page->skyline, i);
+   seg->x = x;
+   seg->y = y + h;
+   seg->w = w;
+
+   /* Cut away the segments now covered by it. */
+   i++;
+   while (i < _al_vector_size(&page->skyline)) {
+      int covered;
+      seg = _al_vector_ref(&page->skyline, i);
+      covered = x + w - seg->x;
+      if (covered <= 0)
+         break;
+      if (covered < seg->w) {
+         seg->x += covered;
+         seg->w -= covered;
+         break;
+      }
+      _al_vector_delete_at(&page->skyline, i);
+   }
+
+   /* Merge neighbours of the same height. */
+   for (i = 0; i + 1 < _al_vector_size(&page->skyline); ) {
+      SKYLINE_SEGMENT *a = _al_vector_ref(&page->skyline, i);
+      SKYLINE_SEGMENT *b = _al_vector_ref(&page->skyline, i + 1);
+      if (a->y == b->y) {
+         a->w += b->w;
+         _al_vector_delete_at(&page->skyline, i + 1);
+      }
+      else {
+         i++;
+      }
+   }
+}
+
+
+/* Returns the index of the least recently used page, or -1 if all pages
+ * were used for the text being drawn.
+ */
+static int find_lru_page(ALLEGRO_TTF_FONT_DATA *data)
+{
+   unsigned int max_age = 0;
+   int lru = -1;
+   int i;
+
+   /* Evicted glyphs would be skipped from then on. */
+   if (data->skip_cache_misses)
+      return -1;
+
+   for (i = 0; i < (int)_al_vector_size(&data->pages); i++) {
+      ALLEGRO_TTF_PAGE **page = _al_vector_ref(&data->pages, i);
+      unsigned int age = data->use_count - (*page)->last_used;
+      if (age > max_age) {
+         max_age = age;
+         lru = i;
+      }
+   }
+
+   return lru;
+}
+
+
+/* Removes the page from the font and forgets all glyphs on it, so they are
+ * cached again the next time they are used.
+ */
+static ALLEGRO_TTF_PAGE *evict_page(ALLEGRO_TTF_FONT_DATA *data, int index)
+{
+   ALLEGRO_TTF_PAGE *page =
+      *(ALLEGRO_TTF_PAGE **)_al_vector_ref(&data->pages, index);
+   int i, j;
+
+   _al_vector_delete_at(&data->pages, index);
+
+   for (i = 0; i < (int)_al_vector_size(&data->glyph_ranges); i++) {
+      ALLEGRO_TTF_GLYPH_RANGE *range = _al_vector_ref(&data->glyph_ranges, i);
+      for (j = 0; j < RANGE_SIZE; j++) {
+         if (range->glyphs[j].page == page) {
+            REGION *r = &range->glyphs[j].region;
+            data->glyph_bytes -= (size_t)align4(r->w) * align4(r->h) * 4;
+            memset(&range->glyphs[j], 0, sizeof(ALLEGRO_TTF_GLYPH_DATA));
+            data->evictions++;
+         }
+      }
+   }
+   data->evicted_pages++;
+   data->cache_changes++;
+
+   ALLEGRO_DEBUG("Evicted page %p, %u kB of %u kB used\n", page->bitmap,
+      (unsigned)(data->cache_used / 1024), (unsigned)(data->cache_size / 1024));
+   return page;
 }
 
 
 static ALLEGRO_BITMAP *push_new_page(ALLEGRO_TTF_FONT_DATA *data, int glyph_size)
 {
-    ALLEGRO_BITMAP **back;
-    ALLEGRO_BITMAP *page;
+    ALLEGRO_TTF_PAGE **back;
+    ALLEGRO_TTF_PAGE *page = NULL;
     ALLEGRO_STATE state;
+    bool flushed = false;
     int page_size = 1;
     /* 16 seems to work well. A particular problem are fixed width fonts which
      * take an inordinate amount of space. */
@@ -194,86 +500,149 @@ static ALLEGRO_BITMAP *push_new_page(ALLEGRO_TTF_FONT_DATA *data, int glyph_size
 
     unlock_current_page(data);
 
-    /* The bitmap will be destroyed when the parent font is destroyed so
-     * it is not safe to register a destructor for it.
+    /* Over the budget, make room by evicting the least recently used pages
+     * and reuse the first one that is large enough.
      */
-    _al_push_destructor_owner();
-    al_store_state(&state, ALLEGRO_STATE_NEW_BITMAP_PARAMETERS);
-    al_set_new_bitmap_format(data->bitmap_format);
-    al_set_new_bitmap_flags(data->bitmap_flags);
-    page = al_create_bitmap(page_size, page_size);
-    al_restore_state(&state);
-    _al_pop_destructor_owner();
-
-    if (page) {
-       back = _al_vector_alloc_back(&data->page_bitmaps);
-       *back = page;
-
-       data->page_pos_x = 0;
-       data->page_pos_y = 0;
-       data->page_line_height = 0;
+    while (data->cache_size > 0 && data->cache_used +
+          (page ? 0 : (size_t)page_size * page_size * 4) > data->cache_size) {
+       int lru = find_lru_page(data);
+       ALLEGRO_TTF_PAGE *evicted;
+       if (lru < 0)
+          break;
+       /* Glyphs from the evicted pages may still be waiting to be drawn. */
+       if (!flushed && al_is_bitmap_drawing_held()) {
+          al_hold_bitmap_drawing(false);
+          al_hold_bitmap_drawing(true);
+       }
+       flushed = true;
+       evicted = evict_page(data, lru);
+       if (!page && al_get_bitmap_width(evicted->bitmap) >= page_size)
+          page = evicted;
+       else
+          destroy_page(data, evicted);
     }
 
-    return page;
+    if (!page) {
+       ALLEGRO_BITMAP *bitmap;
+
+       /* The bitmap will be destroyed when the parent font is destroyed so
+        * it is not safe to register a destructor for it.
+        */
+       _al_push_destructor_owner();
+       al_store_state(&state, ALLEGRO_STATE_NEW_BITMAP_PARAMETERS);
+       al_set_new_bitmap_format(data->bitmap_format);
+       al_set_new_bitmap_flags(data->bitmap_flags);
+       bitmap = al_create_bitmap(page_size, page_size);
+       al_restore_state(&state);
+       _al_pop_destructor_owner();
+
+       if (!bitmap)
+          return NULL;
+
+       page = al_malloc(sizeof *page);
+       if (!page) {
+          al_destroy_bitmap(bitmap);
+          return NULL;
+       }
+       page->bitmap = bitmap;
+       _al_vector_init(&page->skyline, sizeof(SKYLINE_SEGMENT));
+       data->cache_used += page_bytes(page);
+    }
+
+    clear_skyline(page);
+    page->last_used = data->use_count;
+    back = _al_vector_alloc_back(&data->pages);
+    *back = page;
+
+    return page->bitmap;
+}
+
+
+/* Looks for room on the existing pages, oldest first so the gaps left there
+ * are filled, and makes the page the current one.  When the whole current
+ * page is locked only that page may be used, as the others would be cleared
+ * when locked.
+ */
+static ALLEGRO_TTF_PAGE *find_page_room(ALLEGRO_TTF_FONT_DATA *data,
+   int w, int h, bool lock_whole_page, unsigned int *seg, int *y)
+{
+   ALLEGRO_TTF_PAGE *page = NULL;
+   int n = _al_vector_size(&data->pages);
+   int i;
+
+   for (i = lock_whole_page ? n - 1 : 0; i >= 0 && i < n; i++) {
+      page = *(ALLEGRO_TTF_PAGE **)_al_vector_ref(&data->pages, i);
+      if (skyline_find(page, w, h, seg, y))
+         break;
+   }
+   if (i < 0 || i >= n)
+      return NULL;
+
+   if (i < n - 1) {
+      ALLEGRO_TTF_PAGE **back;
+      unlock_current_page(data);
+      _al_vector_delete_at(&data->pages, i);
+      back = _al_vector_alloc_back(&data->pages);
+      *back = page;
+   }
+
+   return page;
 }
 
 
 static unsigned char *alloc_glyph_region(ALLEGRO_TTF_FONT_DATA *data,
-   int ft_index, int w, int h, bool new, ALLEGRO_TTF_GLYPH_DATA *glyph,
+   int ft_index, int w, int h, ALLEGRO_TTF_GLYPH_DATA *glyph,
    bool lock_whole_page)
 {
-   ALLEGRO_BITMAP *page;
+   ALLEGRO_TTF_PAGE *page;
    int w4 = align4(w);
    int h4 = align4(h);
    int glyph_size = w4 > h4 ? w4 : h4;
    bool lock = false;
+   bool new = false;
+   unsigned int seg;
+   int y;
 
-   if (_al_vector_is_empty(&data->page_bitmaps) || new) {
-      page = push_new_page(data, glyph_size);
-      if (!page) {
+   page = find_page_room(data, w4, h4, lock_whole_page, &seg, &y);
+   if (!page) {
+      if (!push_new_page(data, glyph_size)) {
          ALLEGRO_ERROR("Failed to create a new page for glyph %d.\n", ft_index);
          return NULL;
       }
-   }
-   else {
-      ALLEGRO_BITMAP **back = _al_vector_ref_back(&data->page_bitmaps);
-      page = *back;
+      page = *(ALLEGRO_TTF_PAGE **)_al_vector_ref_back(&data->pages);
+      if (!skyline_find(page, w4, h4, &seg, &y)) {
+         ALLEGRO_ERROR("Glyph %d does not fit on a new page.\n", ft_index);
+         return NULL;
+      }
+      new = true;
    }
 
    ALLEGRO_DEBUG("Glyph %d: %dx%d (%dx%d)%s\n",
       ft_index, w, h, w4, h4, new ? " new" : "");
 
-   if (data->page_pos_x + w4 > al_get_bitmap_width(page)) {
-      data->page_pos_y += data->page_line_height;
-      data->page_pos_y = align4(data->page_pos_y);
-      data->page_pos_x = 0;
-      data->page_line_height = 0;
-   }
-
-   if (data->page_pos_y + h4 > al_get_bitmap_height(page)) {
-      return alloc_glyph_region(data, ft_index, w, h, true, glyph, lock_whole_page);
-   }
-
-   glyph->page_bitmap = page;
-   glyph->region.x = data->page_pos_x;
-   glyph->region.y = data->page_pos_y;
+   /* The glyph is about to be drawn, so its page must not be evicted for
+    * another glyph of the same text.
+    */
+   glyph->page = page;
+   page->last_used = data->use_count;
+   glyph->region.x = ((SKYLINE_SEGMENT *)_al_vector_ref(&page->skyline, seg))->x;
+   glyph->region.y = y;
    glyph->region.w = w;
    glyph->region.h = h;
+   data->glyph_bytes += (size_t)w4 * h4 * 4;
+   data->cache_changes++;
 
-   data->page_pos_x = align4(data->page_pos_x + w4);
-   if (h > data->page_line_height) {
-      data->page_line_height = h4;
-   }
+   skyline_add(page, seg, y, w4, h4);
 
    REGION lock_rect;
    if (lock_whole_page) {
       lock_rect.x = 0;
       lock_rect.y = 0;
-      lock_rect.w = al_get_bitmap_width(page);
-      lock_rect.h = al_get_bitmap_height(page);
+      lock_rect.w = al_get_bitmap_width(page->bitmap);
+      lock_rect.h = al_get_bitmap_height(page->bitmap);
       if (!data->page_lr) {
          lock = true;
-         ALLEGRO_DEBUG("Locking whole page: %p\n", page);
+         ALLEGRO_DEBUG("Locking whole page: %p\n", page->bitmap);
       }
    }
    else {
@@ -284,7 +653,7 @@ static unsigned char *alloc_glyph_region(ALLEGRO_TTF_FONT_DATA *data,
       lock_rect.w = w4;
       lock_rect.h = h4;
       lock = true;
-      ALLEGRO_DEBUG("Locking glyph region: %p %d %d %d %d\n", page,
+      ALLEGRO_DEBUG("Locking glyph region: %p %d %d %d %d\n", page->bitmap,
          lock_rect.x, lock_rect.y, lock_rect.w, lock_rect.h);
    }
 
@@ -292,7 +661,7 @@ static unsigned char *alloc_glyph_region(ALLEGRO_TTF_FONT_DATA *data,
       char *ptr;
       int i;
 
-      data->page_lr = al_lock_bitmap_region(page,
+      data->page_lr = al_lock_bitmap_region(page->bitmap,
          lock_rect.x, lock_rect.y, lock_rect.w, lock_rect.h,
          ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE, ALLEGRO_LOCK_WRITEONLY);
 
@@ -321,9 +690,8 @@ static unsigned char *alloc_glyph_region(ALLEGRO_TTF_FONT_DATA *data,
 
 
 static void copy_glyph_mono(ALLEGRO_TTF_FONT_DATA *font_data, FT_Face face,
-   unsigned char *glyph_data)
+   unsigned char *glyph_data, int pitch)
 {
-   int pitch = font_data->page_lr->pitch;
    int x, y;
 
    for (y = 0; y < (int)face->glyph->bitmap.rows; y++) {
@@ -362,9 +730,8 @@ static void copy_glyph_mono(ALLEGRO_TTF_FONT_DATA *font_data, FT_Face face,
 
 
 static void copy_glyph_color(ALLEGRO_TTF_FONT_DATA *font_data, FT_Face face,
-   unsigned char *glyph_data)
+   unsigned char *glyph_data, int pitch)
 {
-   int pitch = font_data->page_lr->pitch;
    int x, y;
 
    for (y = 0; y < (int)face->glyph->bitmap.rows; y++) {
@@ -395,6 +762,28 @@ static void copy_glyph_color(ALLEGRO_TTF_FONT_DATA *font_data, FT_Face face,
 }
 
 
+static FT_Int32 get_load_flags(ALLEGRO_TTF_FONT_DATA const *data)
+{
+    FT_Int32 ft_load_flags;
+
+    // FIXME: make this a config setting? FT_LOAD_FORCE_AUTOHINT
+
+    // FIXME: Investigate why some fonts don't work without the
+    // NO_BITMAP flags. Supposedly using that flag makes small sizes
+    // look bad so ideally we would not used it.
+    ft_load_flags = FT_LOAD_RENDER | FT_LOAD_NO_BITMAP;
+    if (data->flags & ALLEGRO_TTF_MONOCHROME)
+       ft_load_flags |= FT_LOAD_TARGET_MONO;
+    if (data->flags & ALLEGRO_TTF_NO_AUTOHINT)
+       ft_load_flags |= FT_LOAD_NO_AUTOHINT;
+
+    return ft_load_flags;
+}
+
+
+static void upload_staged_glyphs(ALLEGRO_TTF_FONT_DATA *data);
+
+
 /* NOTE: this function may disable the bitmap hold drawing state
  * and leave the current page bitmap locked.
  * 
@@ -404,30 +793,30 @@ static void copy_glyph_color(ALLEGRO_TTF_FONT_DATA *font_data, FT_Face face,
 static void cache_glyph(ALLEGRO_TTF_FONT_DATA *font_data, FT_Face face,
    int ft_index, ALLEGRO_TTF_GLYPH_DATA *glyph, bool lock_whole_page)
 {
-    FT_Int32 ft_load_flags;
     FT_Error e;
     int w, h;
     unsigned char *glyph_data;
 
-    if (glyph->page_bitmap || glyph->region.x < 0)
+    if (glyph->page || glyph->region.x < 0) {
+        if (glyph->page)
+           glyph->page->last_used = font_data->use_count;
+        font_data->hits++;
         return;
+    }
+
+    /* The prefetch thread may have rendered it already. */
+    if (font_data->prefetcher && !lock_whole_page) {
+        upload_staged_glyphs(font_data);
+        if (glyph->page || glyph->region.x < 0)
+           return;
+    }
+    font_data->misses++;
    
     /* We shouldn't ever get here, as cache misses
      * should have been set to ft_index = 0. */
     ASSERT(!(font_data->skip_cache_misses && !lock_whole_page));
 
-    // FIXME: make this a config setting? FT_LOAD_FORCE_AUTOHINT
-
-    // FIXME: Investigate why some fonts don't work without the
-    // NO_BITMAP flags. Supposedly using that flag makes small sizes
-    // look bad so ideally we would not used it.
-    ft_load_flags = FT_LOAD_RENDER | FT_LOAD_NO_BITMAP;
-    if (font_data->flags & ALLEGRO_TTF_MONOCHROME)
-       ft_load_flags |= FT_LOAD_TARGET_MONO;
-    if (font_data->flags & ALLEGRO_TTF_NO_AUTOHINT)
-       ft_load_flags |= FT_LOAD_NO_AUTOHINT;
-
-    e = FT_Load_Glyph(face, ft_index, ft_load_flags);
+    e = FT_Load_Glyph(face, ft_index, get_load_flags(font_data));
     if (e) {
        ALLEGRO_WARN("Failed loading glyph %d from.\n", ft_index);
     }
@@ -443,6 +832,7 @@ static void cache_glyph(ALLEGRO_TTF_FONT_DATA *font_data, FT_Face face,
        /* Mark this glyph so we won't try to cache it next time. */
        glyph->region.x = -1;
        glyph->region.y = -1;
+       font_data->cache_changes++;
        ALLEGRO_DEBUG("Glyph %d has zero size.\n", ft_index);
        return;
     }
@@ -451,16 +841,16 @@ static void cache_glyph(ALLEGRO_TTF_FONT_DATA *font_data, FT_Face face,
      * even against the outer bitmap edge, to ensure consistent rendering.
      */
     glyph_data = alloc_glyph_region(font_data, ft_index,
-       w + 2, h + 2, false, glyph, lock_whole_page);
+       w + 2, h + 2, glyph, lock_whole_page);
 
     if (glyph_data == NULL) {
        return;
     }
 
     if (font_data->flags & ALLEGRO_TTF_MONOCHROME)
-       copy_glyph_mono(font_data, face, glyph_data);
+       copy_glyph_mono(font_data, face, glyph_data, font_data->page_lr->pitch);
     else
-       copy_glyph_color(font_data, face, glyph_data);
+       copy_glyph_color(font_data, face, glyph_data, font_data->page_lr->pitch);
 
     if (!lock_whole_page) {
        unlock_current_page(font_data);
@@ -489,15 +879,433 @@ static void cache_glyphs(ALLEGRO_TTF_FONT_DATA *data, const char *text, size_t t
 }
 
 
-static int get_kerning(ALLEGRO_TTF_FONT_DATA const *data, FT_Face face,
+/* Runs in the prefetch thread. */
+static void render_staged_glyph(ALLEGRO_TTF_FONT_DATA const *data,
+   FT_Face face, STAGED_GLYPH *staged)
+{
+   int w, h;
+
+   if (FT_Load_Glyph(face, staged->ft_index, get_load_flags(data))) {
+      ALLEGRO_WARN("Failed loading glyph %d in the background.\n",
+         staged->ft_index);
+   }
+
+   staged->offset_x = face->glyph->bitmap_left;
+   staged->offset_y = (face->size->metrics.ascender >> 6) - face->glyph->bitmap_top;
+   staged->advance = face->glyph->advance.x >> 6;
+
+   w = face->glyph->bitmap.width;
+   h = face->glyph->bitmap.rows;
+   staged->w = w;
+   staged->h = h;
+   staged->pixels = NULL;
+
+   if (w > 0 && h > 0) {
+      staged->pixels = al_malloc(w * h * 4);
+      if (!staged->pixels)
+         return;
+      if (data->flags & ALLEGRO_TTF_MONOCHROME)
+         copy_glyph_mono((ALLEGRO_TTF_FONT_DATA *)data, face, staged->pixels, w * 4);
+      else
+         copy_glyph_color((ALLEGRO_TTF_FONT_DATA *)data, face, staged->pixels, w * 4);
+   }
+}
+
+
+static void *prefetch_proc(ALLEGRO_THREAD *thread, void *arg)
+{
+   ALLEGRO_TTF_FONT_DATA *data = arg;
+   TTF_PREFETCHER *pf = data->prefetcher;
+
+   al_lock_mutex(pf->mutex);
+   while (!al_get_thread_should_stop(thread)) {
+      STAGED_GLYPH staged;
+      STAGED_GLYPH *slot;
+
+      if (_al_vector_is_empty(&pf->queue)) {
+         al_wait_cond(pf->cond, pf->mutex);
+         continue;
+      }
+
+      /* Most recently requested first. */
+      staged.ft_index = *(int *)_al_vector_ref_back(&pf->queue);
+      _al_vector_delete_at(&pf->queue, _al_vector_size(&pf->queue) - 1);
+      pf->rendering++;
+      al_unlock_mutex(pf->mutex);
+
+      render_staged_glyph(data, pf->face, &staged);
+
+      al_lock_mutex(pf->mutex);
+      pf->rendering--;
+      slot = _al_vector_alloc_back(&pf->staged);
+      *slot = staged;
+   }
+   al_unlock_mutex(pf->mutex);
+
+   return NULL;
+}
+
+
+static void set_face_size(FT_Face face, int w, int h)
+{
+    if (h > 0) {
+       FT_Set_Pixel_Sizes(face, w, h);
+    }
+    else {
+       /* Set the "real dimension" of the font to be the passed size,
+        * in pixels.
+        */
+       FT_Size_RequestRec req;
+       ASSERT(w <= 0);
+       ASSERT(h <= 0);
+       req.type = FT_SIZE_REQUEST_TYPE_REAL_DIM;
+       req.width = (-w) << 6;
+       req.height = (-h) << 6;
+       req.horiResolution = 0;
+       req.vertResolution = 0;
+       FT_Request_Size(face, &req);
+    }
+}
+
+
+static void destroy_prefetcher(ALLEGRO_TTF_FONT_DATA *data)
+{
+   TTF_PREFETCHER *pf = data->prefetcher;
+   unsigned int i;
+
+   if (!pf)
+      return;
+
+   if (pf->thread) {
+      al_lock_mutex(pf->mutex);
+      al_set_thread_should_stop(pf->thread);
+      al_broadcast_cond(pf->cond);
+      al_unlock_mutex(pf->mutex);
+      al_join_thread(pf->thread, NULL);
+      al_destroy_thread(pf->thread);
+   }
+
+   for (i = 0; i < _al_vector_size(&pf->staged); i++) {
+      STAGED_GLYPH *staged = _al_vector_ref(&pf->staged, i);
+      al_free(staged->pixels);
+   }
+   _al_vector_free(&pf->staged);
+   _al_vector_free(&pf->queue);
+
+   if (pf->face)
+      FT_Done_Face(pf->face);
+   if (pf->library)
+      FT_Done_FreeType(pf->library);
+   if (pf->cond)
+      al_destroy_cond(pf->cond);
+   if (pf->mutex)
+      al_destroy_mutex(pf->mutex);
+   al_free(pf->font_buffer);
+   al_free(pf);
+   data->prefetcher = NULL;
+}
+
+
+static bool create_prefetcher(ALLEGRO_TTF_FONT_DATA *data)
+{
+   TTF_PREFETCHER *pf;
+   unsigned long size = data->stream.size;
+
+   pf = al_calloc(1, sizeof *pf);
+   if (!pf)
+      return false;
+   data->prefetcher = pf;
+   _al_vector_init(&pf->queue, sizeof(int));
+   _al_vector_init(&pf->staged, sizeof(STAGED_GLYPH));
+
+   /* The font file is read through data->file, which only this thread may
+    * use, so the prefetch thread gets its own copy.
+    */
+   pf->font_buffer = al_malloc(size);
+   if (!pf->font_buffer || !data->file ||
+         !al_fseek(data->file, data->base_offset, ALLEGRO_SEEK_SET) ||
+         al_fread(data->file, pf->font_buffer, size) != size) {
+      ALLEGRO_ERROR("Failed to read the font file for prefetching.\n");
+      destroy_prefetcher(data);
+      return false;
+   }
+   data->offset = size;
+
+   if (FT_Init_FreeType(&pf->library) ||
+         FT_New_Memory_Face(pf->library, pf->font_buffer, size, 0, &pf->face)) {
+      ALLEGRO_ERROR("Failed to open the font for prefetching.\n");
+      pf->face = NULL;
+      destroy_prefetcher(data);
+      return false;
+   }
+   set_face_size(pf->face, data->size_w, data->size_h);
+
+   pf->mutex = al_create_mutex();
+   pf->cond = al_create_cond();
+   if (pf->mutex && pf->cond)
+      pf->thread = al_create_thread(prefetch_proc, data);
+   if (!pf->thread) {
+      ALLEGRO_ERROR("Failed to create the prefetch thread.\n");
+      destroy_prefetcher(data);
+      return false;
+   }
+   al_start_thread(pf->thread);
+
+   ALLEGRO_DEBUG("Started prefetching glyphs.\n");
+   return true;
+}
+
+
+/* Puts the glyphs rendered by the prefetch thread so far on pages. */
+static void upload_staged_glyphs(ALLEGRO_TTF_FONT_DATA *data)
+{
+   TTF_PREFETCHER *pf = data->prefetcher;
+   _AL_VECTOR staged;
+   unsigned int i;
+
+   if (!pf)
+      return;
+
+   al_lock_mutex(pf->mutex);
+   staged = pf->staged;
+   _al_vector_init(&pf->staged, sizeof(STAGED_GLYPH));
+   al_unlock_mutex(pf->mutex);
+
+   for (i = 0; i < _al_vector_size(&staged); i++) {
+      STAGED_GLYPH *s = _al_vector_ref(&staged, i);
+      ALLEGRO_TTF_GLYPH_DATA *glyph;
+      unsigned char *glyph_data;
+      int y;
+
+      get_glyph(data, s->ft_index, &glyph);
+      glyph->queued = false;
+      if (glyph->page || glyph->region.x < 0)
+         goto next;
+
+      /* If the prefetch thread ran out of memory, leave the glyph to be
+       * cached the usual way the next time it is used.
+       */
+      if (!s->pixels && s->w > 0 && s->h > 0)
+         goto next;
+
+      data->misses++;
+      glyph->offset_x = s->offset_x;
+      glyph->offset_y = s->offset_y;
+      glyph->advance = s->advance;
+
+      if (!s->pixels) {
+         /* Zero size, as in cache_glyph. */
+         glyph->region.x = -1;
+         glyph->region.y = -1;
+         data->cache_changes++;
+         goto next;
+      }
+
+      glyph_data = alloc_glyph_region(data, s->ft_index, s->w + 2, s->h + 2,
+         glyph, false);
+      if (glyph_data) {
+         for (y = 0; y < s->h; y++) {
+            memcpy(glyph_data + y * data->page_lr->pitch,
+               s->pixels + y * s->w * 4, s->w * 4);
+         }
+         unlock_current_page(data);
+      }
+
+   next:
+      al_free(s->pixels);
+   }
+
+   _al_vector_free(&staged);
+}
+
+
+/* Queues the glyph for the codepoint unless it is cached or queued
+ * already.  Must be called with the prefetcher's mutex locked.
+ */
+static void queue_glyph(ALLEGRO_TTF_FONT_DATA *data, int32_t ch)
+{
+   ALLEGRO_TTF_GLYPH_DATA *glyph;
+   int ft_index = FT_Get_Char_Index(data->face, ch);
+   int *slot;
+
+   get_glyph(data, ft_index, &glyph);
+   if (glyph->page || glyph->region.x < 0 || glyph->queued)
+      return;
+
+   slot = _al_vector_alloc_back(&data->prefetcher->queue);
+   if (slot) {
+      *slot = ft_index;
+      glyph->queued = true;
+   }
+}
+
+
+static int lookup_kerning(FT_Face face, int prev_ft_index, int ft_index)
+{
+   FT_Vector delta;
+   FT_Get_Kerning(face, prev_ft_index, ft_index, FT_KERNING_DEFAULT, &delta);
+   return delta.x >> 6;
+}
+
+
+static INLINE unsigned int kerning_hash(uint32_t key, unsigned int mask)
+{
+   return ((key * 0x9E3779B1u) >> 16) & mask;
+}
+
+
+/* Makes room for one more pair, returning false if out of memory. */
+static bool grow_kerning_cache(ALLEGRO_TTF_FONT_DATA *data)
+{
+   KERNING_PAIR *old = data->kerning_cache;
+   unsigned int old_size = old ? data->kerning_mask + 1 : 0;
+   unsigned int size;
+   unsigned int i;
+
+   if ((data->kerning_count + 1) * 2 <= old_size)
+      return true;
+
+   size = old_size ? old_size * 2 : KERNING_CACHE_MIN;
+   if (size > KERNING_CACHE_MAX) {
+      /* Start over rather than grow without bounds. */
+      size = KERNING_CACHE_MAX;
+      old_size = 0;
+   }
+
+   data->kerning_cache = al_malloc(size * sizeof(KERNING_PAIR));
+   if (!data->kerning_cache) {
+      data->kerning_cache = old;
+      return false;
+   }
+   for (i = 0; i < size; i++)
+      data->kerning_cache[i].key = KERNING_EMPTY;
+   data->kerning_mask = size - 1;
+   data->kerning_count = 0;
+
+   for (i = 0; i < old_size; i++) {
+      if (old[i].key != KERNING_EMPTY) {
+         unsigned int j = kerning_hash(old[i].key, data->kerning_mask);
+         while (data->kerning_cache[j].key != KERNING_EMPTY)
+            j = (j + 1) & data->kerning_mask;
+         data->kerning_cache[j] = old[i];
+         data->kerning_count++;
+      }
+   }
+   al_free(old);
+
+   return true;
+}
+
+
+static int get_cached_kerning(ALLEGRO_TTF_FONT_DATA *data, FT_Face face,
+   int prev_ft_index, int ft_index)
+{
+   uint32_t key;
+   unsigned int i;
+   int kerning;
+
+   if (prev_ft_index >= 0xFFFF || ft_index >= 0xFFFF)
+      return lookup_kerning(face, prev_ft_index, ft_index);
+
+   key = (uint32_t)prev_ft_index << 16 | ft_index;
+   if (data->kerning_cache) {
+      i = kerning_hash(key, data->kerning_mask);
+      while (data->kerning_cache[i].key != KERNING_EMPTY) {
+         if (data->kerning_cache[i].key == key)
+            return data->kerning_cache[i].kerning;
+         i = (i + 1) & data->kerning_mask;
+      }
+   }
+
+   kerning = lookup_kerning(face, prev_ft_index, ft_index);
+
+   if (grow_kerning_cache(data)) {
+      i = kerning_hash(key, data->kerning_mask);
+      while (data->kerning_cache[i].key != KERNING_EMPTY)
+         i = (i + 1) & data->kerning_mask;
+      data->kerning_cache[i].key = key;
+      data->kerning_cache[i].kerning = kerning;
+      data->kerning_count++;
+   }
+
+   return kerning;
+}
+
+
+static void create_latin_kerning_table(ALLEGRO_TTF_FONT_DATA *data)
+{
+   FT_Face face = data->face;
+   int indices[256];
+   int max_index = 0;
+   int n = 0;
+   int ch, i, j;
+
+   if (!FT_HAS_KERNING(face))
+      return;
+
+   for (ch = 0x20; ch <= 0xFF; ch++) {
+      if (ch >= 0x7F && ch < 0xA0)
+         continue;
+      indices[n] = FT_Get_Char_Index(face, ch);
+      if (indices[n] > 0 && indices[n] < 0xFFFF) {
+         if (indices[n] > max_index)
+            max_index = indices[n];
+         n++;
+      }
+   }
+
+   data->latin_slots = al_calloc(max_index + 1, 1);
+   data->latin_kerning = al_malloc(n * n);
+   if (!data->latin_slots || !data->latin_kerning) {
+      al_free(data->latin_slots);
+      al_free(data->latin_kerning);
+      data->latin_slots = NULL;
+      data->latin_kerning = NULL;
+      return;
+   }
+   data->num_latin_slots = max_index + 1;
+
+   /* Characters sharing a glyph get the first slot. */
+   j = 0;
+   for (i = 0; i < n; i++) {
+      if (!data->latin_slots[indices[i]]) {
+         indices[j] = indices[i];
+         data->latin_slots[indices[i]] = ++j;
+      }
+   }
+   data->num_latin_glyphs = j;
+
+   for (i = 0; i < j; i++) {
+      for (ch = 0; ch < j; ch++) {
+         int kerning = lookup_kerning(face, indices[i], indices[ch]);
+         if (kerning <= LATIN_KERNING_NONE || kerning > 127)
+            kerning = LATIN_KERNING_NONE;
+         data->latin_kerning[i * j + ch] = kerning;
+      }
+   }
+
+   ALLEGRO_DEBUG("Kerning table for %d Latin glyphs.\n", j);
+}
+
+
+static int get_kerning(ALLEGRO_TTF_FONT_DATA *data, FT_Face face,
    int prev_ft_index, int ft_index)
 {
    /* Do kerning? */
-   if (!(data->flags & ALLEGRO_TTF_NO_KERNING) && prev_ft_index != -1) {
-      FT_Vector delta;
-      FT_Get_Kerning(face, prev_ft_index, ft_index,
-         FT_KERNING_DEFAULT, &delta);
-      return delta.x >> 6;
+   if (!(data->flags & ALLEGRO_TTF_NO_KERNING) && prev_ft_index != -1 &&
+         FT_HAS_KERNING(face)) {
+      if (data->latin_kerning && prev_ft_index < data->num_latin_slots &&
+            ft_index < data->num_latin_slots) {
+         int a = data->latin_slots[prev_ft_index];
+         int b = data->latin_slots[ft_index];
+         if (a && b) {
+            int kerning = data->latin_kerning[(a - 1) * data->num_latin_glyphs
+               + (b - 1)];
+            if (kerning != LATIN_KERNING_NONE)
+               return kerning;
+         }
+      }
+      return get_cached_kerning(data, face, prev_ft_index, ft_index);
    }
 
    return 0;
@@ -524,8 +1332,8 @@ static bool ttf_get_glyph_worker(ALLEGRO_FONT const *f, int prev_ft_index, int f
 
    advance += get_kerning(data, face, prev_ft_index, ft_index);
 
-   if (glyph->page_bitmap) {
-      info->bitmap = glyph->page_bitmap;
+   if (glyph->page) {
+      info->bitmap = glyph->page->bitmap;
       info->x = glyph->region.x + 1;
       info->y = glyph->region.y + 1;
       info->w = glyph->region.w - 2;
@@ -556,6 +1364,8 @@ static bool ttf_get_glyph(ALLEGRO_FONT const *f, int prev_codepoint, int codepoi
    FT_Face face = data->face;
    int prev_ft_index = (prev_codepoint == -1) ? -1 : (int)FT_Get_Char_Index(face, prev_codepoint);
    int ft_index = FT_Get_Char_Index(face, codepoint);
+   data->use_count++;
+   upload_staged_glyphs(data);
    return ttf_get_glyph_worker(f, prev_ft_index, ft_index, prev_codepoint, codepoint, glyph);
 }
 
@@ -626,6 +1436,8 @@ static int ttf_render_char(ALLEGRO_FONT const *f, ALLEGRO_COLOR color,
    int32_t ch32 = (int32_t) ch;
 
    int ft_index = FT_Get_Char_Index(face, ch32);
+   data->use_count++;
+   upload_staged_glyphs(data);
    advance = render_glyph(f, color, -1, ft_index, -1, ch, xpos, ypos);
 
    return advance;
@@ -667,6 +1479,9 @@ static int ttf_render(ALLEGRO_FONT const *f, ALLEGRO_COLOR color,
    int32_t ch;
    bool hold;
 
+   data->use_count++;
+   upload_staged_glyphs(data);
+
    hold = al_is_bitmap_drawing_held();
    al_hold_bitmap_drawing(true);
 
@@ -756,16 +1571,16 @@ static void ttf_get_text_dimensions(ALLEGRO_FONT const *f,
 static void debug_cache(ALLEGRO_FONT *f)
 {
    ALLEGRO_TTF_FONT_DATA *data = f->data;
-   _AL_VECTOR *v = &data->page_bitmaps;
+   _AL_VECTOR *v = &data->pages;
    static int j = 0;
    int i;
 
    al_init_image_addon();
 
    for (i = 0; i < (int)_al_vector_size(v); i++) {
-      ALLEGRO_BITMAP **bmp = _al_vector_ref(v, i);
+      ALLEGRO_TTF_PAGE **page = _al_vector_ref(v, i);
       ALLEGRO_USTR *u = al_ustr_newf("font%d_%d.png", j, i);
-      al_save_bitmap(al_cstr(u), *bmp);
+      al_save_bitmap(al_cstr(u), (*page)->bitmap);
       al_ustr_free(u);
    }
    j++;
@@ -778,6 +1593,7 @@ static void ttf_destroy(ALLEGRO_FONT *f)
    ALLEGRO_TTF_FONT_DATA *data = f->data;
    int i;
 
+   destroy_prefetcher(data);
    unlock_current_page(data);
 
 #ifdef DEBUG_CACHE
@@ -790,11 +1606,14 @@ static void ttf_destroy(ALLEGRO_FONT *f)
       al_free(range->glyphs);
    }
    _al_vector_free(&data->glyph_ranges);
-   for (i = _al_vector_size(&data->page_bitmaps) - 1; i >= 0; i--) {
-      ALLEGRO_BITMAP **bmp = _al_vector_ref(&data->page_bitmaps, i);
-      al_destroy_bitmap(*bmp);
+   for (i = _al_vector_size(&data->pages) - 1; i >= 0; i--) {
+      ALLEGRO_TTF_PAGE **page = _al_vector_ref(&data->pages, i);
+      destroy_page(data, *page);
    }
-   _al_vector_free(&data->page_bitmaps);
+   _al_vector_free(&data->pages);
+   al_free(data->kerning_cache);
+   al_free(data->latin_kerning);
+   al_free(data->latin_slots);
    al_free(data);
    al_free(f);
 }
@@ -853,6 +1672,10 @@ ALLEGRO_FONT *al_load_ttf_font_stretch_f(ALLEGRO_FILE *file,
       al_get_config_value(system_cfg, "ttf", "cache_text");
     const char* skip_cache_misses_str =
       al_get_config_value(system_cfg, "ttf", "skip_cache_misses");
+    const char* cache_size_str =
+      al_get_config_value(system_cfg, "ttf", "cache_size");
+    const char* latin_kerning_str =
+      al_get_config_value(system_cfg, "ttf", "latin_kerning_table");
 
     if ((h > 0 && w < 0) || (h < 0 && w > 0)) {
        ALLEGRO_ERROR("Height/width have opposite signs (w = %d, h = %d).\n", w, h);
@@ -889,6 +1712,13 @@ ALLEGRO_FONT *al_load_ttf_font_stretch_f(ALLEGRO_FILE *file,
        data->skip_cache_misses = true;
     }
 
+    if (cache_size_str) {
+       int cache_size = atoi(cache_size_str);
+       if (cache_size > 0) {
+          data->cache_size = (size_t)cache_size * 1024;
+       }
+    }
+
     memset(&args, 0, sizeof args);
     args.flags = FT_OPEN_STREAM;
     args.stream = &data->stream;
@@ -922,23 +1752,9 @@ ALLEGRO_FONT *al_load_ttf_font_stretch_f(ALLEGRO_FILE *file,
     }
     al_destroy_path(path);
 
-    if (h > 0) {
-       FT_Set_Pixel_Sizes(face, w, h);
-    }
-    else {
-       /* Set the "real dimension" of the font to be the passed size,
-        * in pixels.
-        */
-       FT_Size_RequestRec req;
-       ASSERT(w <= 0);
-       ASSERT(h <= 0);
-       req.type = FT_SIZE_REQUEST_TYPE_REAL_DIM;
-       req.width = (-w) << 6;
-       req.height = (-h) << 6;
-       req.horiResolution = 0;
-       req.vertResolution = 0;
-       FT_Request_Size(face, &req);
-    }
+    set_face_size(face, w, h);
+    data->size_w = w;
+    data->size_h = h;
 
     ALLEGRO_DEBUG("Font %s loaded with pixel size %d x %d.\n", filename,
         w, h);
@@ -950,8 +1766,13 @@ ALLEGRO_FONT *al_load_ttf_font_stretch_f(ALLEGRO_FILE *file,
     data->face = face;
     data->flags = flags;
 
+    if (latin_kerning_str && !strcmp(latin_kerning_str, "true") &&
+          !(flags & ALLEGRO_TTF_NO_KERNING)) {
+       create_latin_kerning_table(data);
+    }
+
     _al_vector_init(&data->glyph_ranges, sizeof(ALLEGRO_TTF_GLYPH_RANGE));
-    _al_vector_init(&data->page_bitmaps, sizeof(ALLEGRO_BITMAP*));
+    _al_vector_init(&data->pages, sizeof(ALLEGRO_TTF_PAGE*));
 
     if (data->skip_cache_misses) {
        cache_glyphs(data, "\0", 1);
@@ -1006,6 +1827,312 @@ ALLEGRO_FONT *al_load_ttf_font_stretch(char const *filename, int w, int h,
 }
 
 
+/* Function: al_set_ttf_cache_size
+ */
+bool al_set_ttf_cache_size(ALLEGRO_FONT *font, size_t size)
+{
+   ALLEGRO_TTF_FONT_DATA *data;
+   ASSERT(font);
+
+   if (font->vtable != &vt)
+      return false;
+
+   data = font->data;
+   data->cache_size = size;
+   return true;
+}
+
+
+/* Function: al_prefetch_ttf_glyphs
+ */
+bool al_prefetch_ttf_glyphs(ALLEGRO_FONT *font, const ALLEGRO_USTR *text)
+{
+   ALLEGRO_TTF_FONT_DATA *data;
+   int pos = 0;
+   int32_t ch;
+   ASSERT(font);
+   ASSERT(text);
+
+   if (font->vtable != &vt)
+      return false;
+
+   data = font->data;
+   if (!data->prefetcher && !create_prefetcher(data))
+      return false;
+
+   al_lock_mutex(data->prefetcher->mutex);
+   while ((ch = al_ustr_get_next(text, &pos)) >= 0)
+      queue_glyph(data, ch);
+   al_signal_cond(data->prefetcher->cond);
+   al_unlock_mutex(data->prefetcher->mutex);
+
+   return true;
+}
+
+
+/* Function: al_prefetch_ttf_glyph_range
+ */
+bool al_prefetch_ttf_glyph_range(ALLEGRO_FONT *font, int first, int last)
+{
+   ALLEGRO_TTF_FONT_DATA *data;
+   int ch;
+   ASSERT(font);
+
+   if (font->vtable != &vt)
+      return false;
+
+   data = font->data;
+   if (!data->prefetcher && !create_prefetcher(data))
+      return false;
+
+   al_lock_mutex(data->prefetcher->mutex);
+   for (ch = first; ch <= last; ch++)
+      queue_glyph(data, ch);
+   al_signal_cond(data->prefetcher->cond);
+   al_unlock_mutex(data->prefetcher->mutex);
+
+   return true;
+}
+
+
+/* Function: al_get_ttf_pending_glyphs
+ */
+int al_get_ttf_pending_glyphs(ALLEGRO_FONT const *font)
+{
+   ALLEGRO_TTF_FONT_DATA *data;
+   int pending;
+   ASSERT(font);
+
+   if (font->vtable != &vt)
+      return 0;
+
+   data = font->data;
+   if (!data->prefetcher)
+      return 0;
+
+   al_lock_mutex(data->prefetcher->mutex);
+   pending = _al_vector_size(&data->prefetcher->queue) +
+      data->prefetcher->rendering;
+   al_unlock_mutex(data->prefetcher->mutex);
+
+   return pending;
+}
+
+
+/* Function: al_get_ttf_cache_stats
+ */
+bool al_get_ttf_cache_stats(ALLEGRO_FONT const *font,
+   ALLEGRO_TTF_CACHE_STATS *stats)
+{
+   ALLEGRO_TTF_FONT_DATA *data;
+   ASSERT(font);
+   ASSERT(stats);
+
+   if (font->vtable != &vt)
+      return false;
+
+   data = font->data;
+   stats->hits = data->hits;
+   stats->misses = data->misses;
+   stats->evictions = data->evictions;
+   stats->evicted_pages = data->evicted_pages;
+   stats->pages = _al_vector_size(&data->pages);
+   stats->size = data->cache_used;
+   stats->used = data->glyph_bytes;
+   return true;
+}
+
+
+static int compare_layout_glyphs(const void *a, const void *b)
+{
+   const LAYOUT_GLYPH *ga = a;
+   const LAYOUT_GLYPH *gb = b;
+
+   if (ga->page != gb->page)
+      return ga->page < gb->page ? -1 : 1;
+   if (ga->dx != gb->dx)
+      return ga->dx < gb->dx ? -1 : 1;
+   return 0;
+}
+
+
+/* Looks up and caches all glyphs of the text, as ttf_render would draw
+ * them.
+ */
+static void build_text_layout(ALLEGRO_TTF_TEXT_LAYOUT *layout)
+{
+   ALLEGRO_FONT *f = layout->font;
+   ALLEGRO_TTF_FONT_DATA *data = f->data;
+   FT_Face face = data->face;
+   unsigned int evicted_pages;
+   int pos = 0;
+   int advance = 0;
+   int prev_ft_index = -1;
+   int32_t prev_ch = -1;
+   int32_t ch;
+
+   data->use_count++;
+   upload_staged_glyphs(data);
+   evicted_pages = data->evicted_pages;
+
+   layout->num_glyphs = 0;
+   layout->uses_fallback = false;
+
+   while ((ch = al_ustr_get_next(layout->text, &pos)) >= 0) {
+      int ft_index = FT_Get_Char_Index(face, ch);
+      ALLEGRO_TTF_GLYPH_DATA *glyph;
+      ALLEGRO_GLYPH info;
+
+      if (!get_glyph(data, ft_index, &glyph)) {
+         if (f->fallback) {
+            layout->uses_fallback = true;
+            break;
+         }
+         get_glyph(data, 0, &glyph);
+      }
+
+      if (ttf_get_glyph_worker(f, prev_ft_index, ft_index, prev_ch, ch,
+            &info)) {
+         if (info.bitmap) {
+            LAYOUT_GLYPH *g = &layout->glyphs[layout->num_glyphs++];
+            g->page = glyph->page;
+            g->sx = info.x;
+            g->sy = info.y;
+            g->sw = info.w;
+            g->sh = info.h;
+            g->dx = advance + info.offset_x + info.kerning;
+            g->dy = info.offset_y;
+         }
+         advance += info.advance;
+      }
+
+      prev_ft_index = ft_index;
+      prev_ch = ch;
+   }
+
+   if (layout->uses_fallback) {
+      layout->num_glyphs = 0;
+      layout->width = al_get_ustr_width(f, layout->text);
+   }
+   else {
+      layout->width = advance;
+   }
+
+   qsort(layout->glyphs, layout->num_glyphs, sizeof(LAYOUT_GLYPH),
+      compare_layout_glyphs);
+
+   layout->cache_changes = data->cache_changes;
+   layout->valid = evicted_pages == data->evicted_pages;
+}
+
+
+/* Function: al_create_ttf_text_layout
+ */
+ALLEGRO_TTF_TEXT_LAYOUT *al_create_ttf_text_layout(ALLEGRO_FONT *font,
+   const ALLEGRO_USTR *text)
+{
+   ALLEGRO_TTF_TEXT_LAYOUT *layout;
+   size_t length;
+   ASSERT(font);
+   ASSERT(text);
+
+   if (font->vtable != &vt)
+      return NULL;
+
+   layout = al_calloc(1, sizeof *layout);
+   if (!layout)
+      return NULL;
+
+   layout->font = font;
+   layout->text = al_ustr_dup(text);
+   length = al_ustr_length(text);
+   if (length > 0)
+      layout->glyphs = al_malloc(length * sizeof(LAYOUT_GLYPH));
+   if (!layout->text || (length > 0 && !layout->glyphs)) {
+      al_destroy_ttf_text_layout(layout);
+      return NULL;
+   }
+
+   build_text_layout(layout);
+   return layout;
+}
+
+
+/* Function: al_destroy_ttf_text_layout
+ */
+void al_destroy_ttf_text_layout(ALLEGRO_TTF_TEXT_LAYOUT *layout)
+{
+   if (!layout)
+      return;
+
+   al_ustr_free(layout->text);
+   al_free(layout->glyphs);
+   al_free(layout);
+}
+
+
+/* Function: al_get_ttf_text_layout_width
+ */
+int al_get_ttf_text_layout_width(ALLEGRO_TTF_TEXT_LAYOUT const *layout)
+{
+   ASSERT(layout);
+   return layout->width;
+}
+
+
+/* Function: al_draw_ttf_text_layout
+ */
+void al_draw_ttf_text_layout(ALLEGRO_TTF_TEXT_LAYOUT *layout,
+   ALLEGRO_COLOR color, float x, float y, int flags)
+{
+   ALLEGRO_TTF_FONT_DATA *data;
+   ALLEGRO_TTF_PAGE *page = NULL;
+   bool hold;
+   int i;
+   ASSERT(layout);
+
+   data = layout->font->data;
+
+   /* Uploading prefetched glyphs changes the cache too.  Evicting pages
+    * while relaying out flushes held drawing first, see push_new_page.
+    */
+   upload_staged_glyphs(data);
+   if (layout->cache_changes != data->cache_changes)
+      build_text_layout(layout);
+
+   if (layout->uses_fallback || !layout->valid) {
+      al_draw_ustr(layout->font, color, x, y, flags, layout->text);
+      return;
+   }
+
+   if (flags & ALLEGRO_ALIGN_CENTRE)
+      x -= layout->width / 2;
+   else if (flags & ALLEGRO_ALIGN_RIGHT)
+      x -= layout->width;
+
+   if (flags & ALLEGRO_ALIGN_INTEGER)
+      _al_align_to_integer_pixel(&x, &y);
+
+   data->use_count++;
+   data->hits += layout->num_glyphs;
+
+   hold = al_is_bitmap_drawing_held();
+   al_hold_bitmap_drawing(true);
+
+   for (i = 0; i < layout->num_glyphs; i++) {
+      LAYOUT_GLYPH *g = &layout->glyphs[i];
+      if (g->page != page) {
+         page = g->page;
+         page->last_used = data->use_count;
+      }
+      al_draw_tinted_bitmap_region(page->bitmap, color,
+         g->sx, g->sy, g->sw, g->sh, x + g->dx, y + g->dy, 0);
+   }
+
+   al_hold_bitmap_drawing(hold);
+}
+
+
 static int ttf_get_font_ranges(ALLEGRO_FONT *font, int ranges_count,
    int *ranges)
 {
@@ -1069,6 +2196,7 @@ static int ttf_get_glyph_advance(ALLEGRO_FONT const *f, int codepoint1,
    ALLEGRO_TTF_FONT_DATA *data = f->data;
    FT_Face face = data->face;
    int ft_index = FT_Get_Char_Index(face, codepoint1);
+   int ft_index1 = ft_index;
    ALLEGRO_TTF_GLYPH_DATA *glyph;
    int kerning = 0;
    int advance = 0;
@@ -1089,7 +2217,6 @@ static int ttf_get_glyph_advance(ALLEGRO_FONT const *f, int codepoint1,
    cache_glyph(data, face, ft_index, glyph, false);
 
    if (codepoint2 != ALLEGRO_NO_KERNING) {
-      int ft_index1 = FT_Get_Char_Index(face, codepoint1);
       int ft_index2 = FT_Get_Char_Index(face, codepoint2);
       kerning = get_kerning(data, face, ft_index1, ft_index2);
    }
@@ -10,6 +10,7 @@ set(ALLEGRO_SRC_FILES
     src/clipboard.c
     src/config.c
     src/convert.c
+    src/convert_simd.c
     src/cpu.c
     src/debug.c
     src/display.c
@@ -48,6 +49,7 @@ set(ALLEGRO_SRC_FILES
     src/transformations.c
     src/tri_soft.c
     src/utf8.c
+    src/workers.c
     src/misc/aatree.c
     src/misc/bstrlib.c
     src/misc/list.c
@@ -25,15 +25,41 @@ enum Mode {
    ALL,
    PLAIN_BLIT,
    SCALED_BLIT,
-   ROTATE_BLIT
+   ROTATE_BLIT,
+   TINTED_BLIT,
+   FILLED_PRIM,
+   GRADIENT_PRIM,
+   TEXTURED_PRIM,
+   CLEAR
 };
 
 static char const *names[] = {
-   "", "Plain blit", "Scaled blit", "Rotated blit"
+   "", "Plain blit", "Scaled blit", "Rotated blit", "Tinted blit",
+   "Filled prim", "Gradient prim", "Textured prim", "Clear"
 };
 
 ALLEGRO_DISPLAY *display;
 
+/* Two triangles covering a 320x200 rectangle, drawn by the software
+ * triangle rasterizer.
+ */
+static void draw_quad(ALLEGRO_BITMAP *texture, ALLEGRO_COLOR c1,
+   ALLEGRO_COLOR c2)
+{
+   ALLEGRO_VERTEX v[4];
+   int i;
+
+   for (i = 0; i < 4; i++) {
+      v[i].x = (i & 1) ? 320 : 0;
+      v[i].y = (i & 2) ? 200 : 0;
+      v[i].z = 0;
+      v[i].u = v[i].x;
+      v[i].v = v[i].y;
+      v[i].color = (i & 1) ? c2 : c1;
+   }
+   al_draw_prim(v, NULL, texture, 0, 4, ALLEGRO_PRIM_TRIANGLE_STRIP);
+}
+
 static void step(enum Mode mode, ALLEGRO_BITMAP *b2)
 {
    switch (mode) {
@@ -48,6 +74,51 @@ static void step(enum Mode mode, ALLEGRO_BITMAP *b2)
          al_draw_scaled_rotated_bitmap(b2, 10, 10, 10, 10, 2.0, 2.0,
             ALLEGRO_PI/30, 0);
          break;
+      case TINTED_BLIT:
+         al_draw_tinted_bitmap(b2, al_map_rgba_f(0.5, 0.5, 0.5, 0.5), 0, 0, 0);
+         break;
+      case FILLED_PRIM:
+         draw_quad(NULL, al_map_rgba_f(0.5, 0, 0, 0.5),
+            al_map_rgba_f(0.5, 0, 0, 0.5));
+         break;
+      case GRADIENT_PRIM:
+         draw_quad(NULL, al_map_rgba_f(0.5, 0, 0, 0.5),
+            al_map_rgba_f(0, 0, 0.5, 0.5));
+         break;
+      case TEXTURED_PRIM:
+         draw_quad(b2, al_map_rgba_f(1, 1, 1, 1), al_map_rgba_f(1, 1, 1, 1));
+         break;
+      case CLEAR:
+         al_clear_to_color(al_map_rgb(100, 150, 200));
+         break;
+   }
+}
+
+/* Number of destination pixels touched by one step, or 0 if we don't know.
+ * The untransformed blits are clipped to the target bitmap.
+ */
+static double step_pixels(enum Mode mode, ALLEGRO_BITMAP *b1,
+   ALLEGRO_BITMAP *b2)
+{
+   int w = al_get_bitmap_width(b2);
+   int h = al_get_bitmap_height(b2);
+
+   switch (mode) {
+      case PLAIN_BLIT:
+      case TINTED_BLIT:
+         if (w > al_get_bitmap_width(b1))
+            w = al_get_bitmap_width(b1);
+         if (h > al_get_bitmap_height(b1))
+            h = al_get_bitmap_height(b1);
+         return (double)w * h;
+      case FILLED_PRIM:
+      case GRADIENT_PRIM:
+      case TEXTURED_PRIM:
+         return 320 * 200;
+      case CLEAR:
+         return (double)al_get_bitmap_width(b1) * al_get_bitmap_height(b1);
+      default:
+         return 0;
    }
 }
 
@@ -116,6 +187,10 @@ static bool do_test(enum Mode mode)
    log_printf("Time = %g s, %d steps\n",
       t1 - t0, REPEAT);
    log_printf("%s: %g FPS\n", names[mode], REPEAT / (t1 - t0));
+   if (step_pixels(mode, b1, b2) > 0) {
+      log_printf("%s: %g Mpixels/s\n", names[mode],
+         step_pixels(mode, b1, b2) * REPEAT / (t1 - t0) / 1e6);
+   }
    log_printf("Done\n");
    
    al_destroy_bitmap(b1);
@@ -141,6 +216,21 @@ int main(int argc, char **argv)
          case 2:
             mode = ROTATE_BLIT;
             break;
+         case 3:
+            mode = TINTED_BLIT;
+            break;
+         case 4:
+            mode = FILLED_PRIM;
+            break;
+         case 5:
+            mode = GRADIENT_PRIM;
+            break;
+         case 6:
+            mode = TEXTURED_PRIM;
+            break;
+         case 7:
+            mode = CLEAR;
+            break;
       }
    }
 
@@ -160,7 +250,7 @@ int main(int argc, char **argv)
    }
    
    if (mode == ALL) {
-      for (mode = PLAIN_BLIT; mode <= ROTATE_BLIT; mode++) {
+      for (mode = PLAIN_BLIT; mode <= CLEAR; mode++) {
          do_test(mode);
       }
    }
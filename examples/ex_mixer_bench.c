@@ -0,0 +1,203 @@
+/*
+ *    Benchmark for mixing many sub-mixers, with and without the
+ *    parallel_mixers option.
+ *
+ *    The mixer graph is rendered by a voice of the null audio driver as
+ *    fast as possible, without any sound hardware.
+ */
+
+#define ALLEGRO_UNSTABLE
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <allegro5/allegro.h>
+#include <allegro5/allegro_audio.h>
+
+#include "common.c"
+
+#define FREQUENCY    48000
+#define SAMPLE_LEN   (FREQUENCY / 2)
+
+static int num_submixers = 4;
+static int num_instances = 32;
+static double seconds = 20.0;
+
+/* Updated by the voice thread. */
+static volatile int frames_left;
+static uint64_t hash;
+static ALLEGRO_MUTEX *done_mutex;
+static ALLEGRO_COND *done_cond;
+
+static void voice_callback(ALLEGRO_VOICE *voice, const void *buf,
+   unsigned int samples, void *data)
+{
+   const unsigned char *p = buf;
+   unsigned int n;
+   unsigned int i;
+   (void)voice;
+   (void)data;
+
+   if (frames_left <= 0)
+      return;
+
+   n = samples < (unsigned)frames_left ? samples : (unsigned)frames_left;
+   for (i = 0; i < n * 2 * sizeof(float); i++)
+      hash = (hash ^ p[i]) * 1099511628211ULL;
+
+   al_lock_mutex(done_mutex);
+   frames_left -= n;
+   if (frames_left <= 0)
+      al_signal_cond(done_cond);
+   al_unlock_mutex(done_mutex);
+}
+
+static ALLEGRO_SAMPLE *create_sample(int i)
+{
+   int16_t *buf = al_malloc(SAMPLE_LEN * 2 * sizeof(int16_t));
+   double freq = 110.0 * (1 + i % 13);
+   int j;
+
+   for (j = 0; j < SAMPLE_LEN; j++) {
+      double t = (double)j / FREQUENCY;
+      buf[2 * j] = 8000 * sin(2 * ALLEGRO_PI * freq * t);
+      buf[2 * j + 1] = 8000 * sin(2 * ALLEGRO_PI * freq * 1.5 * t);
+   }
+
+   return al_create_sample(buf, SAMPLE_LEN, FREQUENCY,
+      ALLEGRO_AUDIO_DEPTH_INT16, ALLEGRO_CHANNEL_CONF_2, true);
+}
+
+/* Renders the mixer graph and returns how long it took. */
+static double run(bool parallel, ALLEGRO_SAMPLE **samples)
+{
+   ALLEGRO_SAMPLE_INSTANCE **instances;
+   ALLEGRO_MIXER **submixers;
+   ALLEGRO_MIXER *mixer;
+   ALLEGRO_VOICE *voice;
+   double t0, t1;
+   int i, j;
+
+   al_set_config_value(al_get_system_config(), "audio", "parallel_mixers",
+      parallel ? "true" : "false");
+
+   voice = al_create_voice(FREQUENCY, ALLEGRO_AUDIO_DEPTH_FLOAT32,
+      ALLEGRO_CHANNEL_CONF_2);
+   mixer = al_create_mixer(FREQUENCY, ALLEGRO_AUDIO_DEPTH_FLOAT32,
+      ALLEGRO_CHANNEL_CONF_2);
+   if (!voice || !mixer)
+      abort_example("Could not create the voice or mixer.\n");
+   al_set_null_voice_callback(voice, voice_callback, NULL);
+
+   submixers = calloc(num_submixers, sizeof(*submixers));
+   instances = calloc(num_submixers * num_instances, sizeof(*instances));
+
+   for (i = 0; i < num_submixers; i++) {
+      submixers[i] = al_create_mixer(FREQUENCY, ALLEGRO_AUDIO_DEPTH_FLOAT32,
+         ALLEGRO_CHANNEL_CONF_2);
+      al_set_mixer_quality(submixers[i], ALLEGRO_MIXER_QUALITY_CUBIC);
+      al_set_mixer_gain(submixers[i], 1.0 / num_submixers);
+      al_attach_mixer_to_mixer(submixers[i], mixer);
+
+      for (j = 0; j < num_instances; j++) {
+         int k = i * num_instances + j;
+         ALLEGRO_SAMPLE_INSTANCE *inst = al_create_sample_instance(samples[k]);
+         al_set_sample_instance_playmode(inst, ALLEGRO_PLAYMODE_LOOP);
+         al_set_sample_instance_speed(inst, 0.5 + (k % 7) * 0.125);
+         al_set_sample_instance_gain(inst, 1.0 / num_instances);
+         al_attach_sample_instance_to_mixer(inst, submixers[i]);
+         al_play_sample_instance(inst);
+         instances[k] = inst;
+      }
+   }
+
+   hash = 14695981039346656037ULL;
+   frames_left = seconds * FREQUENCY;
+
+   t0 = al_get_time();
+   al_lock_mutex(done_mutex);
+   al_attach_mixer_to_voice(mixer, voice);
+   while (frames_left > 0)
+      al_wait_cond(done_cond, done_mutex);
+   al_unlock_mutex(done_mutex);
+   t1 = al_get_time();
+
+   al_destroy_voice(voice);
+   for (i = 0; i < num_submixers * num_instances; i++)
+      al_destroy_sample_instance(instances[i]);
+   for (i = 0; i < num_submixers; i++)
+      al_destroy_mixer(submixers[i]);
+   al_destroy_mixer(mixer);
+   free(instances);
+   free(submixers);
+
+   return t1 - t0;
+}
+
+int main(int argc, char **argv)
+{
+   ALLEGRO_CONFIG *config;
+   ALLEGRO_SAMPLE **samples;
+   double serial_time, parallel_time;
+   uint64_t serial_hash;
+   int i;
+
+   if (!al_init()) {
+      abort_example("Could not init Allegro.\n");
+   }
+
+   open_log();
+
+   if (argc > 1)
+      num_submixers = atoi(argv[1]);
+   if (argc > 2)
+      num_instances = atoi(argv[2]);
+   if (argc > 3)
+      seconds = atof(argv[3]);
+   if (num_submixers < 1 || num_instances < 1 || seconds <= 0) {
+      abort_example("Usage: %s [submixers [instances [seconds]]]\n",
+         argv[0]);
+   }
+
+   config = al_get_system_config();
+   al_set_config_value(config, "audio", "driver", "null");
+   al_set_config_value(config, "null", "speed", "0");
+
+   if (!al_install_audio()) {
+      abort_example("Could not install the null audio driver.\n");
+   }
+
+   done_mutex = al_create_mutex();
+   done_cond = al_create_cond();
+
+   samples = calloc(num_submixers * num_instances, sizeof(*samples));
+   for (i = 0; i < num_submixers * num_instances; i++)
+      samples[i] = create_sample(i);
+
+   log_printf("Mixing %g s of %d sub-mixers with %d instances each\n",
+      seconds, num_submixers, num_instances);
+
+   serial_time = run(false, samples);
+   serial_hash = hash;
+   log_printf("Serial:   %.3f s, %.1fx real time\n",
+      serial_time, seconds / serial_time);
+
+   parallel_time = run(true, samples);
+   log_printf("Parallel: %.3f s, %.1fx real time, %d threads\n",
+      parallel_time, seconds / parallel_time, al_get_cpu_count());
+
+   log_printf("Speedup:  %.2f\n", serial_time / parallel_time);
+   log_printf("Output is %s\n",
+      hash == serial_hash ? "identical" : "DIFFERENT");
+
+   for (i = 0; i < num_submixers * num_instances; i++)
+      al_destroy_sample(samples[i]);
+   free(samples);
+   al_destroy_cond(done_cond);
+   al_destroy_mutex(done_mutex);
+
+   close_log(true);
+
+   return 0;
+}
+
+/* vim: set sts=3 sw=3 et: */
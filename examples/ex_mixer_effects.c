@@ -0,0 +1,135 @@
+/*
+ *    Example program for the Allegro library.
+ *
+ *    Plays a sample in a loop while attaching mixer effects, changing their
+ *    parameters and detaching them again.
+ */
+
+#define ALLEGRO_UNSTABLE
+#include <math.h>
+#include <stdio.h>
+#include "allegro5/allegro.h"
+#include "allegro5/allegro_audio.h"
+#include "allegro5/allegro_acodec.h"
+
+#include "common.c"
+
+#define SWEEP_STEPS  40
+
+static ALLEGRO_MIXER_EFFECT *attach_effect(ALLEGRO_MIXER *mixer,
+   ALLEGRO_MIXER_EFFECT_TYPE type, const char *name)
+{
+   ALLEGRO_MIXER_EFFECT *effect = al_create_mixer_effect(type);
+   if (!effect || !al_attach_mixer_effect(mixer, effect)) {
+      abort_example("Could not attach a %s effect.\n", name);
+   }
+   log_printf("Attached a %s.\n", name);
+   return effect;
+}
+
+int main(int argc, char **argv)
+{
+   const char *filename = "data/welcome.wav";
+   ALLEGRO_VOICE *voice;
+   ALLEGRO_MIXER *mixer;
+   ALLEGRO_SAMPLE *sample_data;
+   ALLEGRO_SAMPLE_INSTANCE *sample;
+   ALLEGRO_MIXER_EFFECT *lowpass;
+   ALLEGRO_MIXER_EFFECT *delay;
+   ALLEGRO_MIXER_EFFECT *compressor;
+   int i;
+
+   if (argc > 1) {
+      filename = argv[1];
+   }
+
+   if (!al_init()) {
+      abort_example("Could not init Allegro.\n");
+   }
+
+   open_log();
+
+   al_init_acodec_addon();
+
+   if (!al_install_audio()) {
+      abort_example("Could not init sound!\n");
+   }
+
+   voice = al_create_voice(44100, ALLEGRO_AUDIO_DEPTH_INT16,
+      ALLEGRO_CHANNEL_CONF_2);
+   if (!voice) {
+      abort_example("Could not create ALLEGRO_VOICE.\n");
+   }
+
+   /* Effects need a float mixer. */
+   mixer = al_create_mixer(44100, ALLEGRO_AUDIO_DEPTH_FLOAT32,
+      ALLEGRO_CHANNEL_CONF_2);
+   if (!mixer || !al_attach_mixer_to_voice(mixer, voice)) {
+      abort_example("Could not create the mixer.\n");
+   }
+
+   sample_data = al_load_sample(filename);
+   if (!sample_data) {
+      abort_example("Could not load sample from '%s'!\n", filename);
+   }
+   sample = al_create_sample_instance(sample_data);
+   if (!sample || !al_attach_sample_instance_to_mixer(sample, mixer)) {
+      abort_example("Could not attach the sample.\n");
+   }
+   al_set_sample_instance_playmode(sample, ALLEGRO_PLAYMODE_LOOP);
+   al_play_sample_instance(sample);
+
+   log_printf("Playing without effects.\n");
+   al_rest(2.0);
+
+   /* Sweep the cutoff up while the effect is running. */
+   lowpass = attach_effect(mixer, ALLEGRO_MIXER_EFFECT_LOWPASS, "low-pass filter");
+   al_set_mixer_effect_param(lowpass, ALLEGRO_MIXER_EFFECT_Q, 4.0);
+   for (i = 0; i <= SWEEP_STEPS; i++) {
+      float freq = 200.0 * pow(80.0, (double)i / SWEEP_STEPS);
+      al_set_mixer_effect_param(lowpass, ALLEGRO_MIXER_EFFECT_FREQUENCY, freq);
+      al_rest(4.0 / SWEEP_STEPS);
+   }
+
+   delay = attach_effect(mixer, ALLEGRO_MIXER_EFFECT_DELAY, "delay");
+   al_rest(2.0);
+   log_printf("More feedback, shorter delay.\n");
+   al_set_mixer_effect_param(delay, ALLEGRO_MIXER_EFFECT_FEEDBACK, 0.7);
+   al_set_mixer_effect_param(delay, ALLEGRO_MIXER_EFFECT_TIME, 0.1);
+   al_rest(2.0);
+
+   al_detach_mixer_effect(lowpass);
+   log_printf("Detached the low-pass filter.\n");
+   compressor = attach_effect(mixer, ALLEGRO_MIXER_EFFECT_COMPRESSOR, "compressor");
+   al_set_mixer_effect_param(compressor, ALLEGRO_MIXER_EFFECT_THRESHOLD, -24.0);
+   al_set_mixer_effect_param(compressor, ALLEGRO_MIXER_EFFECT_RATIO, 10.0);
+   al_set_mixer_effect_param(compressor, ALLEGRO_MIXER_EFFECT_GAIN, 6.0);
+   al_rest(3.0);
+
+   log_printf("Time spent in the effects: delay %.1f ms, compressor %.1f ms.\n",
+      al_get_mixer_effect_time(delay) * 1000.0,
+      al_get_mixer_effect_time(compressor) * 1000.0);
+
+   al_detach_mixer_effect(delay);
+   al_detach_mixer_effect(compressor);
+   log_printf("Detached all effects.\n");
+   al_rest(2.0);
+
+   al_stop_sample_instance(sample);
+
+   al_destroy_mixer_effect(lowpass);
+   al_destroy_mixer_effect(delay);
+   al_destroy_mixer_effect(compressor);
+   al_destroy_sample_instance(sample);
+   al_destroy_sample(sample_data);
+   al_destroy_mixer(mixer);
+   al_destroy_voice(voice);
+
+   al_uninstall_audio();
+
+   close_log(true);
+
+   return 0;
+}
+
+/* vim: set sts=3 sw=3 et: */
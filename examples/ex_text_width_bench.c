@@ -0,0 +1,114 @@
+/*
+ *    Benchmark for measuring text with a TTF font, as a UI laying out the
+ *    same labels over and over does.
+ *
+ *    No display is needed, the glyphs are cached in memory bitmaps.
+ */
+
+#define ALLEGRO_UNSTABLE
+#include <stdio.h>
+#include <stdlib.h>
+#include <allegro5/allegro.h>
+#include <allegro5/allegro_font.h>
+#include <allegro5/allegro_ttf.h>
+
+#include "common.c"
+
+static const char *labels[] = {
+   "File", "Edit", "View", "Help", "Open...", "Save As...",
+   "Preferences", "Volume", "Brightness", "Apply", "Cancel", "OK",
+   "The quick brown fox jumps over the lazy dog",
+   "AVATAR Type Wave LTA Yo Te", "Kerning pairs: AV Ta WA LT Vo",
+   "Caf\xc3\xa9 cr\xc3\xa8me br\xc3\xbbl\xc3\xa9" "e, na\xc3\xafve fa\xc3\xa7" "ade",
+   "Player 1: 12,345 points", "Level 42 - The Dungeon of Doom"
+};
+
+#define NUM_LABELS   (int)(sizeof(labels) / sizeof(labels[0]))
+
+static double seconds = 2.0;
+
+/* Measures all labels over and over and returns the labels per second. */
+static double run(ALLEGRO_FONT *font, int *total)
+{
+   double t0 = al_get_time();
+   double t1;
+   long count = 0;
+   int i;
+
+   do {
+      /* The sum of one pass, which is the same for every pass. */
+      *total = 0;
+      for (i = 0; i < NUM_LABELS; i++)
+         *total += al_get_text_width(font, labels[i]);
+      count += NUM_LABELS;
+      t1 = al_get_time();
+   } while (t1 - t0 < seconds);
+
+   return count / (t1 - t0);
+}
+
+int main(int argc, char **argv)
+{
+   static const struct {
+      int flags;
+      const char *latin_table;
+      const char *name;
+   } modes[] = {
+      { 0,                      "false", "kerning" },
+      { 0,                      "true",  "latin table" },
+      { ALLEGRO_TTF_NO_KERNING, "false", "no kerning" }
+   };
+   const char *filename = "data/DejaVuSans.ttf";
+   int glyphs = 0;
+   int i;
+
+   if (argc > 1)
+      seconds = atof(argv[1]);
+   if (argc > 2)
+      filename = argv[2];
+   if (seconds <= 0) {
+      abort_example("Usage: %s [seconds [font]]\n", argv[0]);
+   }
+
+   if (!al_init()) {
+      abort_example("Could not init Allegro.\n");
+   }
+   al_init_font_addon();
+   al_init_ttf_addon();
+
+   open_log();
+
+   for (i = 0; i < NUM_LABELS; i++) {
+      ALLEGRO_USTR_INFO info;
+      glyphs += al_ustr_length(al_ref_cstr(&info, labels[i]));
+   }
+
+   log_printf("Measuring %d labels with %s for %g s each\n", NUM_LABELS,
+      filename, seconds);
+
+   for (i = 0; i < (int)(sizeof(modes) / sizeof(modes[0])); i++) {
+      ALLEGRO_FONT *font;
+      double rate;
+      int total;
+
+      al_set_config_value(al_get_system_config(), "ttf",
+         "latin_kerning_table", modes[i].latin_table);
+      font = al_load_ttf_font(filename, 20, modes[i].flags);
+
+      if (!font) {
+         abort_example("Could not load %s.\n", filename);
+      }
+
+      rate = run(font, &total);
+      log_printf("%-11s %10.0f labels/s, %.1f M glyphs/s, width sum %d\n",
+         modes[i].name, rate, rate * glyphs / NUM_LABELS / 1e6, total);
+
+      al_destroy_font(font);
+   }
+
+   close_log(true);
+
+   return 0;
+}
+
+/* vim: set sts=3 sw=3 et: */
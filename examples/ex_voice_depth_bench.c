@@ -0,0 +1,142 @@
+/*
+ *    Benchmark for converting the output of a float mixer to each voice
+ *    depth, with and without dither.
+ *
+ *    The mixer has nothing attached, so most of the time goes into applying
+ *    its gain and converting its buffer for the voice.  The voice is run by
+ *    the null audio driver as fast as possible, without any sound hardware.
+ */
+
+#define ALLEGRO_UNSTABLE
+#include <stdio.h>
+#include <stdlib.h>
+#include <allegro5/allegro.h>
+#include <allegro5/allegro_audio.h>
+
+#include "common.c"
+
+#define FREQUENCY    48000
+
+static double seconds = 200.0;
+
+/* Updated by the voice thread. */
+static volatile int frames_left;
+static ALLEGRO_MUTEX *done_mutex;
+static ALLEGRO_COND *done_cond;
+
+static void voice_callback(ALLEGRO_VOICE *voice, const void *buf,
+   unsigned int samples, void *data)
+{
+   (void)voice;
+   (void)buf;
+   (void)data;
+
+   if (frames_left <= 0)
+      return;
+
+   al_lock_mutex(done_mutex);
+   frames_left -= samples;
+   if (frames_left <= 0)
+      al_signal_cond(done_cond);
+   al_unlock_mutex(done_mutex);
+}
+
+/* Plays the mixer through a voice of the given depth and returns how long
+ * it took.
+ */
+static double run(ALLEGRO_AUDIO_DEPTH depth, bool dither)
+{
+   ALLEGRO_MIXER *mixer;
+   ALLEGRO_VOICE *voice;
+   double t0, t1;
+
+   al_set_config_value(al_get_system_config(), "audio", "dither",
+      dither ? "true" : "false");
+
+   voice = al_create_voice(FREQUENCY, depth, ALLEGRO_CHANNEL_CONF_2);
+   mixer = al_create_mixer(FREQUENCY, ALLEGRO_AUDIO_DEPTH_FLOAT32,
+      ALLEGRO_CHANNEL_CONF_2);
+   if (!voice || !mixer)
+      abort_example("Could not create the voice or mixer.\n");
+   al_set_null_voice_callback(voice, voice_callback, NULL);
+   al_set_mixer_gain(mixer, 0.5);
+
+   frames_left = seconds * FREQUENCY;
+
+   t0 = al_get_time();
+   al_lock_mutex(done_mutex);
+   al_attach_mixer_to_voice(mixer, voice);
+   while (frames_left > 0)
+      al_wait_cond(done_cond, done_mutex);
+   al_unlock_mutex(done_mutex);
+   t1 = al_get_time();
+
+   al_destroy_voice(voice);
+   al_destroy_mixer(mixer);
+
+   return t1 - t0;
+}
+
+int main(int argc, char **argv)
+{
+   static const struct {
+      ALLEGRO_AUDIO_DEPTH depth;
+      const char *name;
+   } depths[] = {
+      { ALLEGRO_AUDIO_DEPTH_INT8,    "int8"    },
+      { ALLEGRO_AUDIO_DEPTH_UINT8,   "uint8"   },
+      { ALLEGRO_AUDIO_DEPTH_INT16,   "int16"   },
+      { ALLEGRO_AUDIO_DEPTH_UINT16,  "uint16"  },
+      { ALLEGRO_AUDIO_DEPTH_INT24,   "int24"   },
+      { ALLEGRO_AUDIO_DEPTH_UINT24,  "uint24"  },
+      { ALLEGRO_AUDIO_DEPTH_FLOAT32, "float32" }
+   };
+   ALLEGRO_CONFIG *config;
+   double samples;
+   int i;
+
+   if (!al_init()) {
+      abort_example("Could not init Allegro.\n");
+   }
+
+   open_log();
+
+   if (argc > 1)
+      seconds = atof(argv[1]);
+   if (seconds <= 0) {
+      abort_example("Usage: %s [seconds]\n", argv[0]);
+   }
+
+   config = al_get_system_config();
+   al_set_config_value(config, "audio", "driver", "null");
+   al_set_config_value(config, "null", "speed", "0");
+
+   if (!al_install_audio()) {
+      abort_example("Could not install the null audio driver.\n");
+   }
+
+   done_mutex = al_create_mutex();
+   done_cond = al_create_cond();
+
+   /* Stereo. */
+   samples = seconds * FREQUENCY * 2;
+
+   log_printf("Converting %g s of stereo audio, ns per sample\n", seconds);
+   log_printf("%-8s %10s %10s\n", "depth", "plain", "dithered");
+
+   for (i = 0; i < (int)(sizeof(depths) / sizeof(depths[0])); i++) {
+      double plain = run(depths[i].depth, false);
+      double dithered = run(depths[i].depth, true);
+      log_printf("%-8s %10.2f %10.2f\n", depths[i].name,
+         plain * 1e9 / samples, dithered * 1e9 / samples);
+   }
+
+   al_destroy_cond(done_cond);
+   al_destroy_mutex(done_mutex);
+
+   close_log(true);
+
+   return 0;
+}
+
+/* vim: set sts=3 sw=3 et: */
@@ -40,6 +40,10 @@ int _al_get_least_multiple(int val, int mul);
 AL_FUNC(void *, _al_sane_realloc, (void *ptr, size_t size));
 AL_FUNC(char *, _al_sane_strncpy, (char *dest, const char *src, size_t n));
 
+/* Memory aligned to a power of two, allocated through al_malloc. */
+AL_FUNC(void *, _al_malloc_aligned, (size_t n, size_t alignment));
+AL_FUNC(void, _al_free_aligned, (void *ptr));
+
 
 #define _AL_RAND_MAX  0xFFFF
 AL_FUNC(void, _al_srand, (int seed));
@@ -1,6 +1,11 @@
 #ifndef __al_included_allegro5_aintern_atomicops_h
 #define __al_included_allegro5_aintern_atomicops_h
 
+/* _al_load_acquire and _al_store_release pass an int between two threads
+ * without a lock.  Memory accesses after the load can't be moved before it,
+ * and memory accesses before the store can't be moved after it.
+ */
+
 #if __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 1)
 
    /* gcc 4.1 and above have builtin atomic operations. */
@@ -19,6 +24,39 @@
       return __sync_sub_and_fetch(ptr, 1);
    })
 
+   #ifdef __ATOMIC_ACQUIRE
+
+   AL_INLINE_STATIC(int,
+      _al_load_acquire, (volatile int *ptr),
+   {
+      return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+   })
+
+   AL_INLINE_STATIC(void,
+      _al_store_release, (volatile int *ptr, int value),
+   {
+      __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+   })
+
+   #else
+
+   AL_INLINE_STATIC(int,
+      _al_load_acquire, (volatile int *ptr),
+   {
+      int value = *ptr;
+      __sync_synchronize();
+      return value;
+   })
+
+   AL_INLINE_STATIC(void,
+      _al_store_release, (volatile int *ptr, int value),
+   {
+      __sync_synchronize();
+      *ptr = value;
+   })
+
+   #endif
+
 #elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
 
    /* gcc, x86 or x86-64 */
@@ -49,23 +87,56 @@
       return old - 1;
    })
 
-#elif defined(_MSC_VER) && _M_IX86 >= 400
+   /* x86 doesn't reorder loads with later accesses, or stores with earlier
+    * ones, so only the compiler needs to be stopped from doing so.
+    */
+   AL_INLINE_STATIC(int,
+      _al_load_acquire, (volatile int *ptr),
+   {
+      int value = *ptr;
+      __asm__ __volatile__ ("" : : : "memory");
+      return value;
+   })
+
+   AL_INLINE_STATIC(void,
+      _al_store_release, (volatile int *ptr, int value),
+   {
+      __asm__ __volatile__ ("" : : : "memory");
+      *ptr = value;
+   })
+
+#elif defined(_MSC_VER)
 
-   /* MSVC, x86 */
+   /* MSVC */
    /* MinGW supports these too, but we already have asm code above. */
 
-   typedef LONG _AL_ATOMIC;
+   #include <intrin.h>
+
+   typedef long _AL_ATOMIC;
 
    AL_INLINE(_AL_ATOMIC,
       _al_fetch_and_add1, (volatile _AL_ATOMIC *ptr),
    {
-      return InterlockedIncrement(ptr) - 1;
+      return _InterlockedIncrement(ptr) - 1;
    })
 
    AL_INLINE(_AL_ATOMIC,
       _al_sub1_and_fetch, (volatile _AL_ATOMIC *ptr),
    {
-      return InterlockedDecrement(ptr);
+      return _InterlockedDecrement(ptr);
+   })
+
+   /* The interlocked functions are full barriers. */
+   AL_INLINE_STATIC(int,
+      _al_load_acquire, (volatile int *ptr),
+   {
+      return _InterlockedCompareExchange((volatile long *)ptr, 0, 0);
+   })
+
+   AL_INLINE_STATIC(void,
+      _al_store_release, (volatile int *ptr, int value),
+   {
+      _InterlockedExchange((volatile long *)ptr, value);
    })
 
 #elif defined(ALLEGRO_HAVE_OSATOMIC_H)
@@ -93,6 +164,21 @@
       return OSAtomicDecrement32Barrier((_AL_ATOMIC *)ptr);
    })
 
+   AL_INLINE_STATIC(int,
+      _al_load_acquire, (volatile int *ptr),
+   {
+      int value = *ptr;
+      OSMemoryBarrier();
+      return value;
+   })
+
+   AL_INLINE_STATIC(void,
+      _al_store_release, (volatile int *ptr, int value),
+   {
+      OSMemoryBarrier();
+      *ptr = value;
+   })
+
 
 #else
 
@@ -113,6 +199,18 @@
       return --(*ptr);
    })
 
+   AL_INLINE_STATIC(int,
+      _al_load_acquire, (volatile int *ptr),
+   {
+      return *ptr;
+   })
+
+   AL_INLINE_STATIC(void,
+      _al_store_release, (volatile int *ptr, int value),
+   {
+      *ptr = value;
+   })
+
 #endif
 
 #endif
@@ -67,6 +67,13 @@ struct ALLEGRO_BITMAP
     * lock_flags - flags the region was locked with
     * lock_data - the pointer to the real locked data (see above)
     * locked_region - a copy of the locked rectangle
+    * lock_buffer - memory bitmaps locked in a different format are converted
+    *    into this buffer; it is freed on unlock unless the bitmap has been
+    *    locked this way before, in which case it is kept for the next lock
+    * lock_conversions - number of such locks so far, counting up to 2 only
+    * lock_dirty_rows - one flag per row of the locked region, set by
+    *    al_mark_locked_bitmap_rows; NULL unless lock_buffer is in use
+    * lock_rows_marked - if false, all rows are written back on unlock
     */
    bool locked;
    int lock_x;
@@ -76,6 +83,11 @@ struct ALLEGRO_BITMAP
    void* lock_data;
    int lock_flags;
    ALLEGRO_LOCKED_REGION locked_region;
+   void *lock_buffer;
+   size_t lock_buffer_size;
+   int lock_conversions;
+   unsigned char *lock_dirty_rows;
+   bool lock_rows_marked;
 
    /* Transformation for this bitmap */
    ALLEGRO_TRANSFORM transform;
@@ -144,8 +156,17 @@ struct ALLEGRO_BITMAP_INTERFACE
    void (*backup_dirty_bitmap)(ALLEGRO_BITMAP *bitmap);
 };
 
+/* Memory bitmaps start at a multiple of this many bytes, and so does each of
+ * their rows, unless the graphics/memory_bitmap_alignment config key says
+ * otherwise.  One cache line keeps a row from sharing its first and last
+ * cache lines with the neighbouring rows.
+ */
+#define _AL_DEFAULT_MEMORY_BITMAP_ALIGNMENT  64
+#define _AL_MAX_MEMORY_BITMAP_ALIGNMENT      4096
+
 ALLEGRO_BITMAP *_al_create_bitmap_params(ALLEGRO_DISPLAY *current_display,
    int w, int h, int format, int flags, int depth, int samples);
+int _al_get_memory_bitmap_alignment(void);
 
 AL_FUNC(ALLEGRO_DISPLAY*, _al_get_bitmap_display, (ALLEGRO_BITMAP *bitmap));
 
@@ -153,6 +174,14 @@ extern void (*_al_convert_funcs[ALLEGRO_NUM_PIXEL_FORMATS]
    [ALLEGRO_NUM_PIXEL_FORMATS])(const void *, int, void *, int,
    int, int, int, int, int, int);
 
+typedef void (*_AL_CONVERT_FUNC)(const void *, int, void *, int,
+   int, int, int, int, int, int);
+
+_AL_CONVERT_FUNC _al_get_simd_convert_func(int src_format, int dst_format,
+   int features);
+_AL_CONVERT_FUNC _al_get_convert_func(int src_format, int dst_format,
+   int features);
+
 /* Bitmap conversion */
 void _al_convert_bitmap_data(
 	const void *src, int src_format, int src_pitch,
@@ -26,6 +26,13 @@
    (_AL_SRC_NOT_MODIFIED && \
    tint.r == 1.0f && tint.g == 1.0f && tint.b == 1.0f && tint.a == 1.0f)
 
+/* The default blender, for premultiplied alpha. */
+#define _AL_BLENDER_IS_PREMULTIPLIED_ALPHA \
+   (op == ALLEGRO_ADD && src_mode == ALLEGRO_ONE && \
+   dst_mode == ALLEGRO_INVERSE_ALPHA && \
+   op_alpha == ALLEGRO_ADD && src_alpha == ALLEGRO_ONE && \
+   dst_alpha == ALLEGRO_INVERSE_ALPHA)
+
 
 #ifndef _AL_NO_BLEND_INLINE_FUNC
 
@@ -246,6 +253,33 @@ void _al_blend_memory(ALLEGRO_COLOR *src_color, ALLEGRO_BITMAP *dest,
    int dx, int dy, ALLEGRO_COLOR *result);
 
 
+/* Integer blending for the default (premultiplied alpha) blender:
+ *
+ *    dst = min(255, src * tint + dst * (255 - src.a * tint.a) / 255)
+ *
+ * The source and destination both have 32-bit pixels with the alpha in
+ * the top byte.  The only difference between the two formats accepted by
+ * _al_is_premul_blend_format is the position of red and blue, so the source
+ * row is swizzled on the fly if required.  The division by 255 rounds down,
+ * like the float path.
+ */
+typedef struct _AL_PREMUL_BLEND
+{
+   bool swap_rb;
+   bool tinted;
+   /* Channel multipliers in destination byte order, 256 = 1.0. */
+   uint16_t tint[4];
+} _AL_PREMUL_BLEND;
+
+typedef void (*_AL_PREMUL_ROW_FUNC)(uint32_t *dst, const uint32_t *src,
+   int n, const _AL_PREMUL_BLEND *pb);
+
+bool _al_is_premul_blend_format(int format);
+void _al_init_premul_blend(_AL_PREMUL_BLEND *pb, int src_format,
+   int dst_format, ALLEGRO_COLOR tint);
+_AL_PREMUL_ROW_FUNC _al_get_premul_row_func(void);
+
+
 #ifdef __cplusplus
    }
 #endif
@@ -0,0 +1,55 @@
+#ifndef __al_included_allegro5_aintern_cpu_h
+#define __al_included_allegro5_aintern_cpu_h
+
+#ifdef __cplusplus
+   extern "C" {
+#endif
+
+
+/* Instruction set extensions that the software renderers may use.
+ * _al_get_cpu_features returns a combination of these, detected at run
+ * time and cached after the first call.
+ */
+enum {
+   _AL_CPU_SSE2  = 1 << 0,
+   _AL_CPU_SSSE3 = 1 << 1,
+   _AL_CPU_AVX2  = 1 << 2,
+   _AL_CPU_NEON  = 1 << 3
+};
+
+AL_FUNC(int, _al_get_cpu_features, (void));
+AL_FUNC(void, _al_mask_cpu_features, (int mask));
+
+
+/* _AL_SIMD_X86 is defined if the compiler lets us write SSE2/SSSE3/AVX2
+ * intrinsics in individual functions, regardless of the instruction set
+ * selected for the rest of the file.  Such functions must be marked with
+ * the matching _AL_TARGET_* attribute and only called after checking
+ * _al_get_cpu_features.
+ *
+ * _AL_SIMD_NEON is defined if NEON is part of the baseline instruction set,
+ * in which case no run time check is needed.
+ */
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__i386__) || defined(__x86_64__))
+   #define _AL_SIMD_X86
+   #define _AL_TARGET_SSE2    __attribute__((target("sse2")))
+   #define _AL_TARGET_SSSE3   __attribute__((target("ssse3")))
+   #define _AL_TARGET_AVX2    __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+   #define _AL_SIMD_X86
+   #define _AL_TARGET_SSE2
+   #define _AL_TARGET_SSSE3
+   #define _AL_TARGET_AVX2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+   #define _AL_SIMD_NEON
+#endif
+
+
+#ifdef __cplusplus
+   }
+#endif
+
+#endif
+
+/* vim: set sts=3 sw=3 et: */
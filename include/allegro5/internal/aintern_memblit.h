@@ -11,6 +11,29 @@ void _al_draw_bitmap_region_memory(ALLEGRO_BITMAP *bitmap,
    int sx, int sy, int sw, int sh, int dx, int dy, int flags);
 
 
+/* Blits to a memory bitmap made while bitmap drawing is held are recorded
+ * here, one batch per thread, and drawn when the hold is released.
+ */
+typedef struct _AL_MEMORY_DRAW _AL_MEMORY_DRAW;
+
+typedef struct _AL_MEMORY_DRAW_BATCH
+{
+   bool held;
+   ALLEGRO_BITMAP *target;
+   _AL_MEMORY_DRAW *draws;
+   ALLEGRO_BITMAP **sources;
+   int num_draws;
+   int max_draws;
+} _AL_MEMORY_DRAW_BATCH;
+
+void _al_hold_memory_bitmap_drawing(bool hold);
+bool _al_is_memory_bitmap_drawing_held(void);
+bool _al_defer_bitmap_region_memory(ALLEGRO_BITMAP *bitmap,
+   ALLEGRO_COLOR tint, int sx, int sy, int sw, int sh, int flags);
+void _al_flush_memory_bitmap_drawing(ALLEGRO_BITMAP *bitmap);
+void _al_destroy_memory_draw_batch(_AL_MEMORY_DRAW_BATCH *batch);
+
+
 #ifdef __cplusplus
    }
 #endif
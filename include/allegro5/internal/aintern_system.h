@@ -60,6 +60,8 @@ struct ALLEGRO_SYSTEM
    ALLEGRO_PATH *user_exe_path;
    int mouse_wheel_precision;
    int min_bitmap_size;
+   int memory_bitmap_alignment;
+   int bitmap_conversion_threads;   /* 0 for one per CPU */
    bool installed;
 };
 
@@ -10,6 +10,7 @@ void _al_tls_init_once(void);
 void _al_reinitialize_tls_values(void);
 
 int *_al_tls_get_dtor_owner_count(void);
+struct _AL_MEMORY_DRAW_BATCH **_al_tls_get_memory_draw_batch(void);
 
 
 #ifdef __cplusplus
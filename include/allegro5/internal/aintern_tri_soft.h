@@ -17,6 +17,11 @@ struct ALLEGRO_VERTEX {
 #endif
 
 AL_FUNC(void, _al_triangle_2d, (ALLEGRO_BITMAP* texture, ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX* v2, ALLEGRO_VERTEX* v3));
+/* Like _al_triangle_2d, but only draws the target rows in [min_y, max_y).
+ * Drawing a triangle as several row bands gives the same pixels as drawing
+ * it in one go.
+ */
+AL_FUNC(void, _al_triangle_2d_rows, (ALLEGRO_BITMAP* texture, ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX* v2, ALLEGRO_VERTEX* v3, int min_y, int max_y));
 AL_FUNC(void, _al_draw_soft_triangle, (
    ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX* v2, ALLEGRO_VERTEX* v3, uintptr_t state,
    void (*init)(uintptr_t, ALLEGRO_VERTEX*, ALLEGRO_VERTEX*, ALLEGRO_VERTEX*),
@@ -0,0 +1,35 @@
+#ifndef __al_included_allegro5_aintern_workers_h
+#define __al_included_allegro5_aintern_workers_h
+
+#ifdef __cplusplus
+   extern "C" {
+#endif
+
+void _al_init_workers(void);
+
+/* Returns how many threads _al_run_parallel may spread jobs over, including
+ * the calling thread.
+ */
+AL_FUNC(int, _al_get_num_workers, (void));
+
+/* Makes _al_run_parallel spread jobs over at least num_threads threads,
+ * including the calling thread, even if there are fewer CPUs.
+ */
+AL_FUNC(void, _al_request_workers, (int num_threads));
+
+/* Calls proc(job, arg) for each job in [0, num_jobs) and returns once all of
+ * them have finished.  The jobs are shared between the calling thread and the
+ * worker threads, which are started on first use.  If the pool is already
+ * busy with another caller's jobs, or Allegro is not installed, all jobs run
+ * on the calling thread.
+ */
+AL_FUNC(void, _al_run_parallel, (int num_jobs,
+   AL_METHOD(void, proc, (int job, void *arg)), void *arg));
+
+#ifdef __cplusplus
+   }
+#endif
+
+#endif
+
+/* vim: set sts=3 sw=3 et: */
@@ -446,13 +446,542 @@ void (*_al_convert_funcs[ALLEGRO_NUM_PIXEL_FORMATS]
 // Warning: This file was created by make_converters.py - do not edit.
 """)
 
+# SIMD converters.
+#
+# These are only generated for the common cases where all the work can be
+# done with byte shuffles or with a handful of shifts and masks per
+# component:
+#
+#   32 bit <-> 32 bit   (8 bits per component)
+#   32 bit <-> 24 bit   (8 bits per component)
+#   32 bit <-> 16 bit   (8 bits per component on the 32 bit side)
+#
+# The scalar functions in convert.c stay the reference implementation; every
+# SIMD variant must produce exactly the same output.  The left-over pixels of
+# each row are converted with the same ALLEGRO_CONVERT_* macros.
+
+def is_rgb8(info, size):
+    if not info or info.float or info.single_channel: return False
+    if info.size != size: return False
+    return all(c.size == 8 for c in info.components.values())
+
+def is_16(info):
+    if not info or info.float or info.single_channel: return False
+    return info.size in (15, 16)
+
+def byte_map(info_a, info_b):
+    """
+    For each byte of a destination pixel return the index of the source
+    byte to copy, or "ff" or "00" for a constant.  Both formats must have 8
+    bits per component.  This assumes little endian byte order.
+    """
+    r = []
+    for j in range(info_b.size // 8):
+        name = [n for n, c in info_b.components.items() if c.position == j * 8][0]
+        if name != "X" and name in info_a.components:
+            r.append(info_a.components[name].position // 8)
+        elif name == "A":
+            r.append("ff")
+        else:
+            r.append("00")
+    return r
+
+def fill_value(bmap):
+    v = 0
+    for j, k in enumerate(bmap):
+        if k == "ff": v |= 0xff << (j * 8)
+    return v
+
+def upscale_factor(size):
+    """
+    Find (k, m, shift) such that ((v * k) * m >> 16) >> shift equals
+    v * 255 // mask, using only 16 bit arithmetic.  This matches the
+    _al_rgb_scale_* tables.  If m is None the high multiply is skipped.
+    """
+    mask = (1 << size) - 1
+    exact = lambda f: all(f(v) == v * 255 // mask for v in range(mask + 1))
+    for shift in range(16):
+        for k in ((255 << shift) // mask, (255 << shift) // mask + 1):
+            if mask * k < 65536 and exact(lambda v: (v * k) >> shift):
+                return k, None, shift
+    for shift in range(8):
+        m = -(-(1 << (16 + shift)) // mask)
+        if m < 65536 and exact(lambda v: ((v * 255 * m) >> 16) >> shift):
+            return 255, m, shift
+    raise Exception("No upscale factor for %d bits" % size)
+
+def simd_name(info_a, info_b, isa):
+    return info_a.name.lower() + "_to_" + info_b.name.lower() + "_" + isa
+
+def simd_function(info_a, info_b, isa, setup, loop, step, types):
+    """
+    Wrap a SIMD loop body into a conversion function.  The body converts
+    `step` pixels starting at src_ptr + x, the remaining pixels of a row are
+    converted one at a time.
+    """
+    name = simd_name(info_a, info_b, isa)
+    macro_name = "ALLEGRO_CONVERT_" + info_a.name + "_TO_" + info_b.name
+    a_type, a_count, b_type, b_count = types
+    if a_count == 3:
+        tail = """\
+         const uint8_t *p = src_ptr + x * 3;
+         dst_ptr[x] = %(macro_name)s(p[0] | (p[1] << 8) | (p[2] << 16));""" % locals()
+    elif b_count == 3:
+        tail = """\
+         int dst_pixel = %(macro_name)s(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;""" % locals()
+    else:
+        tail = """\
+         dst_ptr[x] = %(macro_name)s(src_ptr[x]);""" % locals()
+    a_mul = " * 3" if a_count == 3 else ""
+    b_mul = " * 3" if b_count == 3 else ""
+    target = {"sse2": "_AL_TARGET_SSE2\n", "ssse3": "_AL_TARGET_SSSE3\n",
+        "avx2": "_AL_TARGET_AVX2\n", "neon": ""}[isa]
+
+    return """\
+%(target)sstatic void %(name)s(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+%(setup)s   int x, y;
+   for (y = 0; y < height; y++) {
+      const %(a_type)s *src_ptr = (const %(a_type)s *)((const char *)src + (sy + y) * src_pitch) + sx%(a_mul)s;
+      %(b_type)s *dst_ptr = (%(b_type)s *)((char *)dst + (dy + y) * dst_pitch) + dx%(b_mul)s;
+      for (x = 0; x + %(step)d <= width; x += %(step)d) {
+%(loop)s
+      }
+      for (; x < width; x++) {
+%(tail)s
+      }
+   }
+}
+""" % locals()
+
+def c_int32(v):
+    """
+    Format a 32 bit constant for _mm_set1_epi32, which takes a signed int.
+    """
+    if v >= 0x80000000: return "(int)0x%08x" % v
+    return "0x%08x" % v
+
+def c_bytes(values):
+    return ", ".join("0x80" if v in ("ff", "00") else str(v) for v in values)
+
+def sse_shuffle_32(info_a, info_b, isa):
+    bmap = byte_map(info_a, info_b)
+    mask = c_bytes([k if k in ("ff", "00") else k + i * 4
+        for i in range(4) for k in bmap])
+    fill = fill_value(bmap)
+    types = ("uint32_t", 1, "uint32_t", 1)
+    if isa == "ssse3":
+        setup = "   const __m128i shuffle = _mm_setr_epi8(%s);\n" % mask
+        if fill: setup += "   const __m128i fill = _mm_set1_epi32(%s);\n" % c_int32(fill)
+        body = "_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle)"
+        if fill: body = "_mm_or_si128(" + body + ", fill)"
+        loop = "         _mm_storeu_si128((__m128i *)(dst_ptr + x),\n            %s);" % body
+        return simd_function(info_a, info_b, isa, setup, loop, 4, types)
+    if isa == "avx2":
+        setup = "   const __m256i shuffle = _mm256_broadcastsi128_si256(\n"
+        setup += "      _mm_setr_epi8(%s));\n" % mask
+        if fill: setup += "   const __m256i fill = _mm256_set1_epi32(%s);\n" % c_int32(fill)
+        body = "_mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle)"
+        if fill: body = "_mm256_or_si256(" + body + ", fill)"
+        loop = "         _mm256_storeu_si256((__m256i *)(dst_ptr + x),\n            %s);" % body
+        return simd_function(info_a, info_b, isa, setup, loop, 8, types)
+    # Plain SSE2 has no byte shuffle, so move the bytes with shifts and masks.
+    moves = {}
+    for j, k in enumerate(bmap):
+        if k in ("ff", "00"): continue
+        shift = (j - k) * 8
+        moves[shift] = moves.get(shift, 0) | (0xff << (j * 8))
+    terms = []
+    for shift in sorted(moves):
+        if shift > 0: v = "_mm_slli_epi32(p, %d)" % shift
+        elif shift < 0: v = "_mm_srli_epi32(p, %d)" % -shift
+        else: v = "p"
+        if moves[shift] != 0xffffffff:
+            v = "_mm_and_si128(%s, _mm_set1_epi32(%s))" % (v, c_int32(moves[shift]))
+        terms.append(v)
+    if fill: terms.append("_mm_set1_epi32(%s)" % c_int32(fill))
+    expr = terms[0]
+    for t in terms[1:]:
+        expr = "_mm_or_si128(%s,\n            %s)" % (expr, t)
+    loop = "         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));\n"
+    loop += "         _mm_storeu_si128((__m128i *)(dst_ptr + x),\n            %s);" % expr
+    return simd_function(info_a, info_b, isa, "", loop, 4, types)
+
+def sse_32_to_24(info_a, info_b):
+    bmap = byte_map(info_a, info_b)
+    mask = c_bytes([bmap[j] + i * 4 for i in range(4) for j in range(3)] +
+        ["00"] * 4)
+    setup = "   const __m128i shuffle = _mm_setr_epi8(%s);\n" % mask
+    loop = """\
+         __m128i p0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle);
+         __m128i p1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 4)), shuffle);
+         __m128i p2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 8)), shuffle);
+         __m128i p3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 12)), shuffle);
+         __m128i *d = (__m128i *)(dst_ptr + x * 3);
+         _mm_storeu_si128(d + 0, _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+         _mm_storeu_si128(d + 1, _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+         _mm_storeu_si128(d + 2, _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));"""
+    return simd_function(info_a, info_b, "ssse3", setup, loop, 16,
+        ("uint32_t", 1, "uint8_t", 3))
+
+def sse_24_to_32(info_a, info_b):
+    bmap = byte_map(info_a, info_b)
+    mask = c_bytes([k if k in ("ff", "00") else k + i * 3
+        for i in range(4) for k in bmap])
+    fill = fill_value(bmap)
+    setup = "   const __m128i shuffle = _mm_setr_epi8(%s);\n" % mask
+    if fill: setup += "   const __m128i fill = _mm_set1_epi32(%s);\n" % c_int32(fill)
+    loop = """\
+         const __m128i *s = (const __m128i *)(src_ptr + x * 3);
+         __m128i s0 = _mm_loadu_si128(s + 0);
+         __m128i s1 = _mm_loadu_si128(s + 1);
+         __m128i s2 = _mm_loadu_si128(s + 2);
+         __m128i p[4];
+         int i;
+         p[0] = s0;
+         p[1] = _mm_alignr_epi8(s1, s0, 12);
+         p[2] = _mm_alignr_epi8(s2, s1, 8);
+         p[3] = _mm_srli_si128(s2, 4);
+         for (i = 0; i < 4; i++) {
+            _mm_storeu_si128((__m128i *)(dst_ptr + x + i * 4),
+               %s);
+         }""" % ("_mm_or_si128(_mm_shuffle_epi8(p[i], shuffle), fill)" if fill
+            else "_mm_shuffle_epi8(p[i], shuffle)")
+    return simd_function(info_a, info_b, "ssse3", setup, loop, 16,
+        ("uint8_t", 3, "uint32_t", 1))
+
+def pack_ops_32_to_16(info_a, info_b):
+    """
+    Return a list of (shift_right, mask, shift_left) per destination
+    component and the constant to add for a missing alpha channel.
+    """
+    ops = []
+    fill = 0
+    for name, c_b in sorted(info_b.components.items()):
+        if name == "X": continue
+        mask = (1 << c_b.size) - 1
+        if name in info_a.components:
+            c_a = info_a.components[name]
+            ops.append((c_a.position + c_a.size - c_b.size, mask, c_b.position))
+        elif name == "A":
+            fill |= mask << c_b.position
+    return ops, fill
+
+def sse_32_to_16(info_a, info_b, isa):
+    ops, fill = pack_ops_32_to_16(info_a, info_b)
+    if isa == "sse2":
+        pre, vec, step = "_mm", "__m128i", 8
+    else:
+        pre, vec, step = "_mm256", "__m256i", 16
+    si = "si128" if isa == "sse2" else "si256"
+
+    def expr(v):
+        terms = []
+        for shift_right, mask, shift_left in ops:
+            t = v
+            if shift_right: t = "%s_srli_epi32(%s, %d)" % (pre, t, shift_right)
+            t = "%s_and_%s(%s, %s_set1_epi32(0x%x))" % (pre, si, t, pre, mask)
+            if shift_left: t = "%s_slli_epi32(%s, %d)" % (pre, t, shift_left)
+            terms.append(t)
+        if fill: terms.append("%s_set1_epi32(0x%x)" % (pre, fill))
+        e = terms[0]
+        for t in terms[1:]:
+            e = "%s_or_%s(%s,\n            %s)" % (pre, si, e, t)
+        return e
+
+    loop = """\
+         %(vec)s a = %(pre)s_loadu_%(si)s((const %(vec)s *)(src_ptr + x));
+         %(vec)s b = %(pre)s_loadu_%(si)s((const %(vec)s *)(src_ptr + x + %(half)d));
+         %(vec)s p;
+         a = %(ea)s;
+         b = %(eb)s;
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = %(pre)s_srai_epi32(%(pre)s_slli_epi32(a, 16), 16);
+         b = %(pre)s_srai_epi32(%(pre)s_slli_epi32(b, 16), 16);
+         p = %(pre)s_packs_epi32(a, b);
+""" % dict(vec=vec, pre=pre, si=si, half=step // 2, ea=expr("a"), eb=expr("b"))
+    if isa == "avx2":
+        loop += "         p = _mm256_permute4x64_epi64(p, 0xd8);\n"
+    loop += "         %s_storeu_%s((%s *)(dst_ptr + x), p);" % (pre, si, vec)
+    return simd_function(info_a, info_b, isa, "", loop, step,
+        ("uint32_t", 1, "uint16_t", 1))
+
+def unpack_ops_16_to_32(info_a, info_b):
+    """
+    Return a list with one entry per destination byte: None for zero, "ff"
+    for a constant 255, or (shift, mask, k, k_shift) to extract a source
+    component and scale it up to 8 bits.
+    """
+    r = []
+    for j in range(4):
+        name = [n for n, c in info_b.components.items() if c.position == j * 8][0]
+        if name != "X" and name in info_a.components:
+            c_a = info_a.components[name]
+            k, m, k_shift = upscale_factor(c_a.size)
+            r.append((c_a.position, (1 << c_a.size) - 1, k, m, k_shift))
+        elif name == "A":
+            r.append("ff")
+        else:
+            r.append(None)
+    return r
+
+def sse_16_to_32(info_a, info_b, isa):
+    ops = unpack_ops_16_to_32(info_a, info_b)
+    if isa == "sse2":
+        pre, vec, si, step = "_mm", "__m128i", "si128", 8
+    else:
+        pre, vec, si, step = "_mm256", "__m256i", "si256", 16
+
+    def channel(op):
+        if op is None: return None
+        if op == "ff": return "%s_set1_epi16(0xff)" % pre
+        shift, mask, k, m, k_shift = op
+        t = "p"
+        if shift: t = "%s_srli_epi16(%s, %d)" % (pre, t, shift)
+        if shift + mask.bit_length() < 16:
+            t = "%s_and_%s(%s, %s_set1_epi16(0x%x))" % (pre, si, t, pre, mask)
+        if k != 1: t = "%s_mullo_epi16(%s, %s_set1_epi16(%d))" % (pre, t, pre, k)
+        if m: t = "%s_mulhi_epu16(%s, %s_set1_epi16(%d))" % (pre, t, pre, m)
+        if k_shift: t = "%s_srli_epi16(%s, %d)" % (pre, t, k_shift)
+        return t
+
+    def pair(lo, hi):
+        lo = channel(lo)
+        hi = channel(hi)
+        if hi: hi = "%s_slli_epi16(%s, 8)" % (pre, hi)
+        if lo and hi: return "%s_or_%s(%s,\n            %s)" % (pre, si, lo, hi)
+        return lo or hi or "%s_setzero_%s()" % (pre, si)
+
+    loop = """\
+         %(vec)s p = %(pre)s_loadu_%(si)s((const %(vec)s *)(src_ptr + x));
+         %(vec)s lo = %(lo)s;
+         %(vec)s hi = %(hi)s;
+         %(vec)s p0 = %(pre)s_unpacklo_epi16(lo, hi);
+         %(vec)s p1 = %(pre)s_unpackhi_epi16(lo, hi);
+""" % dict(vec=vec, pre=pre, si=si, lo=pair(ops[0], ops[1]),
+        hi=pair(ops[2], ops[3]))
+    if isa == "avx2":
+        loop += """\
+         %(pre)s_storeu_%(si)s((%(vec)s *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         %(pre)s_storeu_%(si)s((%(vec)s *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));""" % locals()
+    else:
+        loop += """\
+         %(pre)s_storeu_%(si)s((%(vec)s *)(dst_ptr + x), p0);
+         %(pre)s_storeu_%(si)s((%(vec)s *)(dst_ptr + x + 4), p1);""" % locals()
+    return simd_function(info_a, info_b, isa, "", loop, step,
+        ("uint16_t", 1, "uint32_t", 1))
+
+def neon_planes(info_a, info_b, src_planes, dst_planes):
+    bmap = byte_map(info_a, info_b)
+    lines = []
+    for j, k in enumerate(bmap):
+        if k == "ff": v = "vdupq_n_u8(0xff)"
+        elif k == "00": v = "vdupq_n_u8(0)"
+        else: v = "in.val[%d]" % k
+        lines.append("         out.val[%d] = %s;" % (j, v))
+    return "\n".join(lines)
+
+def neon_shuffle(info_a, info_b):
+    na = info_a.size // 8
+    nb = info_b.size // 8
+    a_type = "uint32_t" if na == 4 else "uint8_t"
+    b_type = "uint32_t" if nb == 4 else "uint8_t"
+    a_off = "x" if na == 4 else "x * 3"
+    b_off = "x" if nb == 4 else "x * 3"
+    loop = """\
+         uint8x16x%(na)d_t in = vld%(na)dq_u8((const uint8_t *)(src_ptr + %(a_off)s));
+         uint8x16x%(nb)d_t out;
+%(planes)s
+         vst%(nb)dq_u8((uint8_t *)(dst_ptr + %(b_off)s), out);""" % dict(
+        na=na, nb=nb, a_off=a_off, b_off=b_off,
+        planes=neon_planes(info_a, info_b, na, nb))
+    return simd_function(info_a, info_b, "neon", "", loop, 16,
+        (a_type, na if na == 3 else 1, b_type, nb if nb == 3 else 1))
+
+def neon_32_to_16(info_a, info_b):
+    terms = []
+    for name, c_b in sorted(info_b.components.items()):
+        if name == "X" or name not in info_a.components: continue
+        c_a = info_a.components[name]
+        t = "vmovl_u8(vshr_n_u8(in.val[%d], %d))" % (c_a.position // 8,
+            8 - c_b.size)
+        if c_b.position: t = "vshlq_n_u16(%s, %d)" % (t, c_b.position)
+        terms.append(t)
+    ops, fill = pack_ops_32_to_16(info_a, info_b)
+    if fill: terms.append("vdupq_n_u16(0x%x)" % fill)
+    e = terms[0]
+    for t in terms[1:]:
+        e = "vorrq_u16(%s,\n            %s)" % (e, t)
+    loop = """\
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, %s);""" % e
+    return simd_function(info_a, info_b, "neon", "", loop, 8,
+        ("uint32_t", 1, "uint16_t", 1))
+
+def neon_16_to_32(info_a, info_b):
+    ops = unpack_ops_16_to_32(info_a, info_b)
+    lines = []
+    for j, op in enumerate(ops):
+        if op is None: v = "vdup_n_u8(0)"
+        elif op == "ff": v = "vdup_n_u8(0xff)"
+        else:
+            shift, mask, k, m, k_shift = op
+            t = "p"
+            if shift: t = "vshrq_n_u16(%s, %d)" % (t, shift)
+            if shift + mask.bit_length() < 16:
+                t = "vandq_u16(%s, vdupq_n_u16(0x%x))" % (t, mask)
+            if k != 1: t = "vmulq_n_u16(%s, %d)" % (t, k)
+            if m: t = "neon_mulhi_u16(%s, %d)" % (t, m)
+            if k_shift: t = "vshrq_n_u16(%s, %d)" % (t, k_shift)
+            v = "vmovn_u16(%s)" % t
+        lines.append("         out.val[%d] = %s;" % (j, v))
+    loop = """\
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+%s
+         vst4_u8((uint8_t *)(dst_ptr + x), out);""" % "\n".join(lines)
+    return simd_function(info_a, info_b, "neon", "", loop, 8,
+        ("uint16_t", 1, "uint32_t", 1))
+
+def simd_functions(info_a, info_b):
+    """
+    Return a dictionary mapping instruction set to C function source, for
+    all the SIMD variants of this conversion.
+    """
+    r = {}
+    if is_rgb8(info_a, 32) and is_rgb8(info_b, 32):
+        r["sse2"] = sse_shuffle_32(info_a, info_b, "sse2")
+        r["ssse3"] = sse_shuffle_32(info_a, info_b, "ssse3")
+        r["avx2"] = sse_shuffle_32(info_a, info_b, "avx2")
+        r["neon"] = neon_shuffle(info_a, info_b)
+    elif is_rgb8(info_a, 32) and is_rgb8(info_b, 24):
+        r["ssse3"] = sse_32_to_24(info_a, info_b)
+        r["neon"] = neon_shuffle(info_a, info_b)
+    elif is_rgb8(info_a, 24) and is_rgb8(info_b, 32):
+        r["ssse3"] = sse_24_to_32(info_a, info_b)
+        r["neon"] = neon_shuffle(info_a, info_b)
+    elif is_rgb8(info_a, 32) and is_16(info_b):
+        r["sse2"] = sse_32_to_16(info_a, info_b, "sse2")
+        r["avx2"] = sse_32_to_16(info_a, info_b, "avx2")
+        r["neon"] = neon_32_to_16(info_a, info_b)
+    elif is_16(info_a) and is_rgb8(info_b, 32):
+        r["sse2"] = sse_16_to_32(info_a, info_b, "sse2")
+        r["avx2"] = sse_16_to_32(info_a, info_b, "avx2")
+        r["neon"] = neon_16_to_32(info_a, info_b)
+    return r
+
+def write_simd_table(f, isa, functions):
+    f.write("""\
+static void (*_al_convert_funcs_%(isa)s[ALLEGRO_NUM_PIXEL_FORMATS]
+   [ALLEGRO_NUM_PIXEL_FORMATS])(const void *, int, void *, int,
+   int, int, int, int, int, int) = {
+""" % locals())
+    for a in formats_list:
+        if not a:
+            f.write("   {NULL},\n")
+            continue
+        f.write("   {")
+        was_null = False
+        for b in formats_list:
+            if b and a != b and (a.name, b.name, isa) in functions:
+                f.write("\n      " + simd_name(a, b, isa) + ",")
+                was_null = False
+            else:
+                if not was_null: f.write("\n     ")
+                f.write(" NULL,")
+                was_null = True
+        f.write("\n   },\n")
+    f.write("};\n")
+
+def write_convert_simd_c(filename):
+    """
+    Write out the file with the SIMD conversion functions.
+    """
+    functions = {}
+    for a in formats_list:
+        for b in formats_list:
+            if b == a or not a or not b: continue
+            for isa, code in simd_functions(a, b).items():
+                functions[(a.name, b.name, isa)] = code
+
+    f = open(filename, "w")
+    f.write("""\
+// Warning: This file was created by make_converters.py - do not edit.
+#include "allegro5/allegro.h"
+#include "allegro5/internal/aintern_bitmap.h"
+#include "allegro5/internal/aintern_convert.h"
+#include "allegro5/internal/aintern_cpu.h"
+
+/* The byte shuffles below assume little endian pixel layout. */
+#ifdef ALLEGRO_LITTLE_ENDIAN
+""")
+    for isas, guard, includes in [
+            (("sse2", "ssse3", "avx2"), "_AL_SIMD_X86",
+             "#include <emmintrin.h>\n#include <tmmintrin.h>\n#include <immintrin.h>\n"),
+            (("neon",), "_AL_SIMD_NEON", """\
+#include <arm_neon.h>
+static INLINE uint16x8_t neon_mulhi_u16(uint16x8_t a, uint16_t b)
+{
+   return vcombine_u16(
+      vshrn_n_u32(vmull_n_u16(vget_low_u16(a), b), 16),
+      vshrn_n_u32(vmull_n_u16(vget_high_u16(a), b), 16));
+}
+""")]:
+        f.write("#ifdef %s\n" % guard)
+        f.write(includes)
+        for a in formats_list:
+            for b in formats_list:
+                if b == a or not a or not b: continue
+                for isa in isas:
+                    if (a.name, b.name, isa) in functions:
+                        f.write(functions[(a.name, b.name, isa)])
+        for isa in isas:
+            write_simd_table(f, isa, functions)
+        f.write("#endif\n")
+
+    f.write("""\
+#endif
+
+/* Return the fastest SIMD conversion function available with the given
+ * _AL_CPU_* features, or NULL.
+ */
+_AL_CONVERT_FUNC _al_get_simd_convert_func(int src_format, int dst_format,
+   int features)
+{
+   _AL_CONVERT_FUNC func = NULL;
+#if defined(ALLEGRO_LITTLE_ENDIAN) && defined(_AL_SIMD_X86)
+   if (!func && (features & _AL_CPU_AVX2))
+      func = _al_convert_funcs_avx2[src_format][dst_format];
+   if (!func && (features & _AL_CPU_SSSE3))
+      func = _al_convert_funcs_ssse3[src_format][dst_format];
+   if (!func && (features & _AL_CPU_SSE2))
+      func = _al_convert_funcs_sse2[src_format][dst_format];
+#elif defined(ALLEGRO_LITTLE_ENDIAN) && defined(_AL_SIMD_NEON)
+   if (features & _AL_CPU_NEON)
+      func = _al_convert_funcs_neon[src_format][dst_format];
+#else
+   (void)src_format;
+   (void)dst_format;
+   (void)features;
+#endif
+   return func;
+}
+
+// Warning: This file was created by make_converters.py - do not edit.
+""")
+
 def main(argv):
     global options
     p = optparse.OptionParser()
     p.description = """\
-When run from the toplevel A5 folder, this will re-create the convert.h and
-convert.c files containing all the low-level color conversion macros and
-functions."""
+When run from the toplevel A5 folder, this will re-create the convert.h,
+convert.c and convert_simd.c files containing all the low-level color
+conversion macros and functions."""
     options, args = p.parse_args()
 
     # Read in color.h to get the available formats.
@@ -472,6 +1001,9 @@ functions."""
     # Output a function for each possible conversion.
     write_convert_c("src/convert.c")
 
+    # Output SIMD variants of the most common conversions.
+    write_convert_simd_c("src/convert_simd.c")
+
 if __name__ == "__main__":
     main(sys.argv)
 
@@ -293,6 +293,135 @@ def make_cubic_interpolator(name, fmt):
       return samp_buf-> #{fmt} ;
    }"""))
 
+# The block interpolators below produce n consecutive output frames of float
+# samples starting from sample position pos with Bresenham error err.  They
+# switch on the sample depth once per block instead of once per frame, and
+# must only be called where none of the sample positions read would have been
+# adjusted by the per-frame interpolators above (see kcm_mixer.c).
+# Each computes exactly the same values as its per-frame counterpart.
+
+def block_header(name):
+   return interp("""\
+   static void
+      #{name}
+      (float *out,
+       const ALLEGRO_SAMPLE_INSTANCE *spl,
+       unsigned int maxc, int pos, int err,
+       int delta, int delta_error, int n)
+   {""")
+
+block_advance = """\
+         pos += delta;
+         err += delta_error;
+         if (err >= spl->step_denom) {
+            pos++;
+            err -= spl->step_denom;
+         }"""
+
+def make_point_block_interpolator(name):
+   print(block_header(name))
+   print("""\
+      int k, i;
+
+      switch (spl->spl_data.depth) {
+      """)
+
+   for depth in depths:
+      value = depth.index_f32("spl->spl_data.buffer", "i0 + i")
+      print(interp("""\
+         case #{depth.constant()}:
+            for (k = 0; k < n; k++) {
+               const int i0 = pos * (int)maxc;
+               for (i = 0; i < (int)maxc; i++) {
+                  *out++ = #{value};
+               }
+      """) + block_advance + """
+            }
+            break;
+         """)
+
+   print("""\
+      }
+   }""")
+
+def make_linear_block_interpolator(name):
+   print(block_header(name))
+   print("""\
+      /* For audio streams we lag by one sample, see above. */
+      const int lag = (spl->loop == _ALLEGRO_PLAYMODE_STREAM_ONCE ||
+         spl->loop == _ALLEGRO_PLAYMODE_STREAM_ONEDIR) ? 1 : 0;
+      int k, i;
+
+      switch (spl->spl_data.depth) {
+      """)
+
+   for depth in depths:
+      x0 = depth.index_f32("spl->spl_data.buffer", "p0 + i")
+      x1 = depth.index_f32("spl->spl_data.buffer", "p1 + i")
+      print(interp("""\
+         case #{depth.constant()}:
+            for (k = 0; k < n; k++) {
+               const float t = (float)err / spl->step_denom;
+               const int p0 = (pos - lag) * (int)maxc;
+               const int p1 = p0 + (int)maxc;
+               for (i = 0; i < (int)maxc; i++) {
+                  const float x0 = #{x0};
+                  const float x1 = #{x1};
+                  *out++ = (x0 * (1.0f - t)) + (x1 * t);
+               }
+      """) + block_advance + """
+            }
+            break;
+         """)
+
+   print("""\
+      }
+   }""")
+
+def make_cubic_block_interpolator(name):
+   print(block_header(name))
+   print("""\
+      /* For audio streams we lag by two more samples, see above. */
+      const int lag = (spl->loop == _ALLEGRO_PLAYMODE_STREAM_ONCE ||
+         spl->loop == _ALLEGRO_PLAYMODE_STREAM_ONEDIR) ? 2 : 0;
+      int k, i;
+
+      switch (spl->spl_data.depth) {
+      """)
+
+   for depth in depths:
+      value0 = depth.index_f32("spl->spl_data.buffer", "p0 + i")
+      value1 = depth.index_f32("spl->spl_data.buffer", "p1 + i")
+      value2 = depth.index_f32("spl->spl_data.buffer", "p2 + i")
+      value3 = depth.index_f32("spl->spl_data.buffer", "p3 + i")
+      print(interp("""\
+         case #{depth.constant()}:
+            for (k = 0; k < n; k++) {
+               const float t = (float)err / spl->step_denom;
+               const int p1 = (pos - lag) * (int)maxc;
+               const int p0 = p1 - (int)maxc;
+               const int p2 = p1 + (int)maxc;
+               const int p3 = p2 + (int)maxc;
+               for (i = 0; i < (int)maxc; i++) {
+                  float x0 = #{value0};
+                  float x1 = #{value1};
+                  float x2 = #{value2};
+                  float x3 = #{value3};
+                  float c0 = x1;
+                  float c1 = 0.5f * (x2 - x0);
+                  float c2 = x0 - (2.5f * x1) + (2.0f * x2) - (0.5f * x3);
+                  float c3 = (0.5f * (x3 - x0)) + (1.5f * (x1 - x2));
+                  *out++ = (((((c3 * t) + c2) * t) + c1) * t) + c0;
+               }
+      """) + block_advance + """
+            }
+            break;
+         """)
+
+   print("""\
+      }
+   }""")
+
 if __name__ == "__main__":
    print("// Warning: This file was created by make_resamplers.py - do not edit.")
    print("// vim: set ft=c:")
@@ -302,5 +431,8 @@ if __name__ == "__main__":
    make_linear_interpolator("linear_spl32", "f32")
    make_linear_interpolator("linear_spl16", "s16")
    make_cubic_interpolator("cubic_spl32", "f32")
+   make_point_block_interpolator("point_block32")
+   make_linear_block_interpolator("linear_block32")
+   make_cubic_block_interpolator("cubic_block32")
 
 # vim: set sts=3 sw=3 et:
@@ -14,7 +14,33 @@ def interp(string):
       string = string.replace('#{%s}' % item, str(eval(item, globals, locals)))
    return string
 
-def make_drawer(name):
+# Blender presets that get drawers of their own, besides the copy (opaque)
+# drawers. Each is (name, op, src_mode, dst_mode), used for both the colour
+# and the alpha channel.
+blend_presets = [
+   ("premul_alpha", "ALLEGRO_ADD", "ALLEGRO_ONE", "ALLEGRO_INVERSE_ALPHA"),
+   ("alpha", "ALLEGRO_ADD", "ALLEGRO_ALPHA", "ALLEGRO_INVERSE_ALPHA"),
+   ("add", "ALLEGRO_ADD", "ALLEGRO_ONE", "ALLEGRO_ONE"),
+]
+
+# Destination formats that get drawers of their own, with their pixel sizes.
+# Textured drawers are only specialized for textures of the same format.
+formats = [
+   ("ALLEGRO_PIXEL_FORMAT_ARGB_8888", 4),
+   ("ALLEGRO_PIXEL_FORMAT_ABGR_8888", 4),
+   ("ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE", 4),
+   ("ALLEGRO_PIXEL_FORMAT_RGB_565", 2),
+]
+
+def format_suffix(fmt):
+   return fmt.replace("ALLEGRO_PIXEL_FORMAT_", "").lower()
+
+def specialized_name(name, preset, fmt):
+   if preset:
+      return "%s_%s_%s" % (name, preset[0], format_suffix(fmt))
+   return "%s_%s" % (name, format_suffix(fmt))
+
+def make_drawer(name, preset=None, fmt=None):
    global texture, grad, solid, shade, opaque, white
    texture = "_texture_" in name
    grad = "_grad_" in name
@@ -30,7 +56,16 @@ def make_drawer(name):
    if shade and opaque:
       raise Exception("shade and opaque")
 
-   print(interp("static void #{name} (uintptr_t state, int x1, int y, int x2) {"))
+   # Specialized drawers handle a single blender preset (unless opaque) and
+   # a single format, so they don't need to look at either.
+   special = fmt is not None
+   if special:
+      assert (preset is not None) == shade
+      fname = specialized_name(name, preset, fmt)
+   else:
+      fname = name
+
+   print(interp("static void #{fname} (uintptr_t state, int x1, int y, int x2) {"))
 
    if not texture:
       if grad:
@@ -106,14 +141,15 @@ def make_drawer(name):
       """)
 
    print("{")
-   if shade:
+   if shade and not special:
       print("""\
-      int op, src_mode, dst_mode;
-      int op_alpha, src_alpha, dst_alpha;
-      ALLEGRO_COLOR const_color;
-      al_get_separate_bitmap_blender(&op, &src_mode, &dst_mode,
-         &op_alpha, &src_alpha, &dst_alpha);
-      const_color = al_get_blend_color();
+      const int op = s->blender.op;
+      const int src_mode = s->blender.src_mode;
+      const int dst_mode = s->blender.dst_mode;
+      const int op_alpha = s->blender.op_alpha;
+      const int src_alpha = s->blender.src_alpha;
+      const int dst_alpha = s->blender.dst_alpha;
+      ALLEGRO_COLOR const_color = s->blender.const_color;
       """)
 
    print("{")
@@ -122,8 +158,13 @@ def make_drawer(name):
       const int offset_x = s->texture->parent ? s->texture->xofs : 0;
       const int offset_y = s->texture->parent ? s->texture->yofs : 0;
       ALLEGRO_BITMAP* texture = s->texture->parent ? s->texture->parent : s->texture;
+      """)
+      if not special:
+         print("""\
       const int src_format = texture->locked_region.format;
       const int src_size = texture->locked_region.pixel_size;
+      """)
+      print("""\
 
       /* Ensure u in [0, s->w) and v in [0, s->h). */
       while (u < 0) u += s->w;
@@ -135,14 +176,19 @@ def make_drawer(name):
       """)
 
    print("{")
-   print("""\
+   if not special:
+      print("""\
       const int dst_format = target->locked_region.format;
+      """)
+   print("""\
       uint8_t *dst_data = (uint8_t *)target->lock_data
          + y * target->locked_region.pitch
          + x1 * target->locked_region.pixel_size;
       """)
 
-   if shade:
+   if special:
+      make_special_loop(preset, fmt)
+   elif shade:
       make_if_blender_loop(
             op='ALLEGRO_ADD',
             src_mode='ALLEGRO_ONE',
@@ -180,20 +226,21 @@ def make_drawer(name):
             )
       print("else")
 
-   if opaque and white:
-      make_loop(copy_format=True, src_size='4')
-      print("else")
-      make_loop(copy_format=True, src_size='3')
-      print("else")
-      make_loop(copy_format=True, src_size='2')
-      print("else")
-   else:
-      make_loop(
-            if_format='ALLEGRO_PIXEL_FORMAT_ARGB_8888'
-            )
-      print("else")
+   if not special:
+      if opaque and white:
+         make_loop(copy_format=True, src_size='4')
+         print("else")
+         make_loop(copy_format=True, src_size='3')
+         print("else")
+         make_loop(copy_format=True, src_size='2')
+         print("else")
+      else:
+         make_loop(
+               if_format='ALLEGRO_PIXEL_FORMAT_ARGB_8888'
+               )
+         print("else")
 
-   make_loop()
+      make_loop()
 
    print("""\
    }
@@ -202,6 +249,27 @@ def make_drawer(name):
    }
    """)
 
+def make_special_loop(preset, fmt):
+   size = str(dict(formats)[fmt])
+
+   if opaque and white:
+      make_loop(copy_format=True, fixed_format=fmt, src_size=size)
+   elif opaque:
+      make_loop(fixed_format=fmt, src_size=size)
+   else:
+      make_loop(
+            op=preset[1],
+            src_mode=preset[2],
+            src_alpha=preset[2],
+            op_alpha=preset[1],
+            dst_mode=preset[3],
+            dst_alpha=preset[3],
+            const_color='NULL',
+            fixed_format=fmt,
+            src_size=size,
+            alpha_only=True
+            )
+
 def make_if_blender_loop(
       op='op',
       src_mode='src_mode',
@@ -262,11 +330,15 @@ def make_loop(
       src_size='src_size',
       const_color='&const_color',
       if_format=None,
+      fixed_format=None,
       copy_format=False,
       alpha_only=False
       ):
 
-   if if_format:
+   if fixed_format:
+      src_format = fixed_format
+      dst_format = fixed_format
+   elif if_format:
       src_format = if_format
       dst_format = if_format
       print(interp("if (dst_format == #{dst_format}"))
@@ -472,6 +544,86 @@ def make_innermost_loop(
       }
    }""")
 
+def make_dispatch(drawers):
+   blends = ["copy"] + [p[0] for p in blend_presets]
+
+   for i, name in enumerate(blends):
+      print(interp("#define SCANLINE_BLEND_#{name.upper()} #{i}"))
+   print(interp("#define SCANLINE_NUM_BLENDS #{len(blends)}"))
+   print(interp("#define SCANLINE_NUM_FORMATS #{len(formats)}"))
+   print()
+
+   print("""\
+/* Returns the SCANLINE_BLEND_* preset that the blender matches, or -1. */
+static int get_scanline_blend(const blender_2d *b, int shade) {
+   if (!shade)
+      return SCANLINE_BLEND_COPY;
+   """)
+   for name, op, src, dst in blend_presets:
+      print(interp("""\
+      if (b->op == #{op} && b->src_mode == #{src} && b->dst_mode == #{dst} &&
+            b->op_alpha == #{op} && b->src_alpha == #{src} && b->dst_alpha == #{dst})
+         return SCANLINE_BLEND_#{name.upper()};
+      """))
+   print("""\
+   return -1;
+}
+""")
+
+   print("""\
+static int get_scanline_format(int format) {
+   switch (format) {""")
+   for i, (fmt, size) in enumerate(formats):
+      print(interp("""\
+      case #{fmt}:
+         return #{i};"""))
+   print("""\
+   }
+
+   return -1;
+}
+""")
+
+   for name in drawers:
+      print(interp("\nstatic const shader_draw #{name}_special[SCANLINE_NUM_BLENDS][SCANLINE_NUM_FORMATS] = {"))
+      for blend in blends:
+         preset = [p for p in blend_presets if p[0] == blend]
+         row = []
+         for fmt, size in formats:
+            if "_opaque" in name and blend == "copy":
+               row.append(specialized_name(name, None, fmt))
+            elif "_shade" in name and preset:
+               row.append(specialized_name(name, preset[0], fmt))
+            else:
+               row.append("NULL")
+         print("{" + ", ".join(row) + "},")
+      print("};")
+
+   print("""\
+
+/* Returns the drawer specialized for the SCANLINE_BLEND_* preset and the
+ * locked formats, or draw itself if there is none.
+ */
+static shader_draw get_scanline_drawer(shader_draw draw, int blend, int dst_format, int src_format) {
+   const int format = get_scanline_format(dst_format);
+   shader_draw special = NULL;
+
+   if (blend < 0 || format < 0)
+      return draw;
+   """)
+   for i, name in enumerate(drawers):
+      cond = interp("draw == #{name}")
+      if "_texture_" in name:
+         cond += " && src_format == dst_format"
+      print(interp("""\
+      #{'else ' if i else ''}if (#{cond})
+         special = #{name}_special[blend][format];"""))
+   print("""\
+
+   return special ? special : draw;
+}
+""")
+
 if __name__ == "__main__":
    print("""\
 // Warning: This file was created by make_scanline_drawers.py - do not edit.
@@ -483,18 +635,33 @@ if __name__ == "__main__":
 #endif
 """)
 
-   make_drawer("shader_solid_any_draw_shade")
-   make_drawer("shader_solid_any_draw_opaque")
+   drawers = [
+      "shader_solid_any_draw_shade",
+      "shader_solid_any_draw_opaque",
+
+      "shader_grad_any_draw_shade",
+      "shader_grad_any_draw_opaque",
+
+      "shader_texture_solid_any_draw_shade",
+      "shader_texture_solid_any_draw_shade_white",
+      "shader_texture_solid_any_draw_opaque",
+      "shader_texture_solid_any_draw_opaque_white",
+
+      "shader_texture_grad_any_draw_shade",
+      "shader_texture_grad_any_draw_opaque",
+   ]
 
-   make_drawer("shader_grad_any_draw_shade")
-   make_drawer("shader_grad_any_draw_opaque")
+   for name in drawers:
+      make_drawer(name)
 
-   make_drawer("shader_texture_solid_any_draw_shade")
-   make_drawer("shader_texture_solid_any_draw_shade_white")
-   make_drawer("shader_texture_solid_any_draw_opaque")
-   make_drawer("shader_texture_solid_any_draw_opaque_white")
+   for name in drawers:
+      for fmt, size in formats:
+         if "_opaque" in name:
+            make_drawer(name, None, fmt)
+         else:
+            for preset in blend_presets:
+               make_drawer(name, preset, fmt)
 
-   make_drawer("shader_texture_grad_any_draw_shade")
-   make_drawer("shader_texture_grad_any_draw_opaque")
+   make_dispatch(drawers)
 
 # vim: set sts=3 sw=3 et:
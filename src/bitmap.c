@@ -23,20 +23,37 @@
 #include "allegro5/allegro.h"
 #include "allegro5/internal/aintern.h"
 #include "allegro5/internal/aintern_bitmap.h"
+#include "allegro5/internal/aintern_cpu.h"
 #include "allegro5/internal/aintern_display.h"
+#include "allegro5/internal/aintern_memblit.h"
 #include "allegro5/internal/aintern_pixels.h"
 #include "allegro5/internal/aintern_shader.h"
 #include "allegro5/internal/aintern_system.h"
+#include "allegro5/internal/aintern_workers.h"
 
 ALLEGRO_DEBUG_CHANNEL("bitmap")
 
 
+/* Returns the alignment of memory bitmap rows, in bytes, as read from the
+ * graphics/memory_bitmap_alignment config key by al_install_system.
+ */
+int _al_get_memory_bitmap_alignment(void)
+{
+   ALLEGRO_SYSTEM *system = al_get_system_driver();
+
+   if (!system)
+      return _AL_DEFAULT_MEMORY_BITMAP_ALIGNMENT;
+   return system->memory_bitmap_alignment;
+}
+
+
 /* Creates a memory bitmap.
  */
 static ALLEGRO_BITMAP *create_memory_bitmap(ALLEGRO_DISPLAY *current_display,
    int w, int h, int format, int flags)
 {
    ALLEGRO_BITMAP *bitmap;
+   int alignment;
    int pitch;
 
    if (_al_pixel_format_is_video_only(format)) {
@@ -48,7 +65,8 @@ static ALLEGRO_BITMAP *create_memory_bitmap(ALLEGRO_DISPLAY *current_display,
 
    bitmap = al_calloc(1, sizeof *bitmap);
 
-   pitch = w * al_get_pixel_size(format);
+   alignment = _al_get_memory_bitmap_alignment();
+   pitch = _al_get_least_multiple(w * al_get_pixel_size(format), alignment);
 
    bitmap->vt = NULL;
    bitmap->_format = format;
@@ -73,7 +91,7 @@ static ALLEGRO_BITMAP *create_memory_bitmap(ALLEGRO_DISPLAY *current_display,
    al_orthographic_transform(&bitmap->proj_transform, 0, 0, -1.0, w, h, 1.0);
    bitmap->parent = NULL;
    bitmap->xofs = bitmap->yofs = 0;
-   bitmap->memory = al_malloc(pitch * h);
+   bitmap->memory = _al_malloc_aligned((size_t)pitch * h, alignment);
    bitmap->use_bitmap_blender = false;
    bitmap->blender.blend_color = al_map_rgba(0, 0, 0, 0);
    
@@ -87,8 +105,8 @@ static void destroy_memory_bitmap(ALLEGRO_BITMAP *bmp)
 {
    _al_unregister_convert_bitmap(bmp);
 
-   if (bmp->memory)
-      al_free(bmp->memory);
+   _al_free_aligned(bmp->lock_buffer);
+   _al_free_aligned(bmp->memory);
    al_free(bmp);
 }
 
@@ -208,6 +226,9 @@ void al_destroy_bitmap(ALLEGRO_BITMAP *bitmap)
       return;
    }
 
+   /* Draw any deferred blits from or to the bitmap while it still exists. */
+   _al_flush_memory_bitmap_drawing(bitmap);
+
    /* As a convenience, implicitly untarget the bitmap on the calling thread
     * before it is destroyed, but maintain the current display.
     */
@@ -752,6 +773,13 @@ void _al_copy_bitmap_data(
    src_ptr += sy * src_pitch + sx * block_size;
    dst_ptr += dy * dst_pitch + dx * block_size;
 
+   /* Rows without padding in between are copied all at once. */
+   if ((size_t)src_pitch == (size_t)width * block_size &&
+         dst_pitch == src_pitch) {
+      memcpy(dst_ptr, src_ptr, (size_t)height * src_pitch);
+      return;
+   }
+
    for (y = 0; y < height; y++) {
       memcpy(dst_ptr, src_ptr, width * block_size);
       src_ptr += src_pitch;
@@ -759,11 +787,84 @@ void _al_copy_bitmap_data(
    }
 }
 
+/* Returns the function converting from src_format to dst_format.  SIMD
+ * variants are preferred if they only need instruction sets contained in
+ * features, a combination of _AL_CPU_* flags.  With features = 0 this is
+ * always the scalar reference implementation.
+ */
+_AL_CONVERT_FUNC _al_get_convert_func(int src_format, int dst_format,
+   int features)
+{
+   _AL_CONVERT_FUNC func;
+
+   func = _al_get_simd_convert_func(src_format, dst_format, features);
+   if (func)
+      return func;
+   return _al_convert_funcs[src_format][dst_format];
+}
+
+/* Conversions are only split into bands of at least this many pixels, so
+ * that small bitmaps don't pay for waking up the worker threads.
+ */
+#define MIN_CONVERT_BAND_PIXELS  (256 * 256)
+
+typedef struct CONVERT_BANDS {
+   _AL_CONVERT_FUNC func;
+   const void *src;
+   int src_pitch;
+   void *dst;
+   int dst_pitch;
+   int sx, sy, dx, dy, width, height;
+   int num_bands;
+} CONVERT_BANDS;
+
+
+static void convert_band(int band, void *arg)
+{
+   CONVERT_BANDS *c = arg;
+   int y1 = c->height * band / c->num_bands;
+   int y2 = c->height * (band + 1) / c->num_bands;
+
+   c->func(c->src, c->src_pitch, c->dst, c->dst_pitch,
+      c->sx, c->sy + y1, c->dx, c->dy + y1, c->width, y2 - y1);
+}
+
+
+/* Returns how many row bands a conversion should be split into, as allowed
+ * by the graphics/bitmap_conversion_threads config key.
+ */
+static int get_num_convert_bands(int width, int height)
+{
+   ALLEGRO_SYSTEM *system = al_get_system_driver();
+   int64_t pixels = (int64_t)width * height;
+   int n;
+
+   if (pixels < 2 * MIN_CONVERT_BAND_PIXELS || !system)
+      return 1;
+
+   n = system->bitmap_conversion_threads;
+   if (n == 1)
+      return 1;
+   if (n == 0)
+      n = _al_get_num_workers();
+   else
+      n = _ALLEGRO_MIN(n, _al_get_num_workers());
+
+   if (n > pixels / MIN_CONVERT_BAND_PIXELS)
+      n = pixels / MIN_CONVERT_BAND_PIXELS;
+   if (n > height)
+      n = height;
+   return _ALLEGRO_MAX(n, 1);
+}
+
+
 void _al_convert_bitmap_data(
    const void *src, int src_format, int src_pitch,
    void *dst, int dst_format, int dst_pitch,
    int sx, int sy, int dx, int dy, int width, int height)
 {
+   _AL_CONVERT_FUNC func;
+   int num_bands;
    ASSERT(src);
    ASSERT(dst);
    ASSERT(_al_pixel_format_is_real(dst_format));
@@ -780,8 +881,43 @@ void _al_convert_bitmap_data(
    ASSERT(!_al_pixel_format_is_video_only(src_format));
    ASSERT(!_al_pixel_format_is_video_only(dst_format));
 
-   (_al_convert_funcs[src_format][dst_format])(src, src_pitch,
-      dst, dst_pitch, sx, sy, dx, dy, width, height);
+   func = _al_get_convert_func(src_format, dst_format, _al_get_cpu_features());
+
+   num_bands = get_num_convert_bands(width, height);
+   if (num_bands > 1) {
+      CONVERT_BANDS c;
+      c.func = func;
+      c.src = src;
+      c.src_pitch = src_pitch;
+      c.dst = dst;
+      c.dst_pitch = dst_pitch;
+      c.sx = sx;
+      c.sy = sy;
+      c.dx = dx;
+      c.dy = dy;
+      c.width = width;
+      c.height = height;
+      c.num_bands = num_bands;
+      _al_run_parallel(num_bands, convert_band, &c);
+      return;
+   }
+
+   /* Rows without padding in between are converted as one long row, so the
+    * SIMD converters have a single tail to deal with instead of one per row.
+    * The converters take an int width, so this is only done while the pixel
+    * count fits.
+    */
+   if (sx == 0 && dx == 0 &&
+         (size_t)src_pitch == (size_t)width * al_get_pixel_size(src_format) &&
+         (size_t)dst_pitch == (size_t)width * al_get_pixel_size(dst_format)) {
+      size_t pixels = (size_t)width * height;
+      if (pixels <= INT_MAX) {
+         width = (int)pixels;
+         height = 1;
+      }
+   }
+
+   func(src, src_pitch, dst, dst_pitch, sx, sy, dx, dy, width, height);
 }
 
 
@@ -33,10 +33,13 @@ static void _bitmap_drawer(ALLEGRO_BITMAP *bitmap, ALLEGRO_COLOR tint,
    ASSERT(!(flags & (ALLEGRO_FLIP_HORIZONTAL | ALLEGRO_FLIP_VERTICAL)));
    ASSERT(bitmap != dest && bitmap != dest->parent);
 
-   /* If destination is memory, do a memory blit */
+   /* If destination is memory, do a memory blit, or record it for later if
+    * the drawing is held.
+    */
    if (al_get_bitmap_flags(dest) & ALLEGRO_MEMORY_BITMAP ||
        _al_pixel_format_is_compressed(al_get_bitmap_format(dest))) {
-      _al_draw_bitmap_region_memory(bitmap, tint, sx, sy, sw, sh, 0, 0, flags);
+      if (!_al_defer_bitmap_region_memory(bitmap, tint, sx, sy, sw, sh, flags))
+         _al_draw_bitmap_region_memory(bitmap, tint, sx, sy, sw, sh, 0, 0, flags);
    }
    else {
       /* if source is memory or incompatible */
@@ -14,12 +14,86 @@
  */
 
 
+#include <string.h>
+
 #include "allegro5/allegro.h"
 #include "allegro5/internal/aintern.h"
 #include "allegro5/internal/aintern_bitmap.h"
+#include "allegro5/internal/aintern_memblit.h"
 #include "allegro5/internal/aintern_pixels.h"
 
 
+/* Makes sure the lock buffer of a memory bitmap holds at least size bytes,
+ * aligned like the rows of memory bitmaps.  A kept buffer is only ever
+ * grown, so locking the same region every frame does not allocate.
+ */
+static bool reserve_lock_buffer(ALLEGRO_BITMAP *bitmap, size_t size,
+   int alignment)
+{
+   if (size <= bitmap->lock_buffer_size &&
+         ((uintptr_t)bitmap->lock_buffer & (alignment - 1)) == 0)
+      return true;
+
+   _al_free_aligned(bitmap->lock_buffer);
+   bitmap->lock_buffer = _al_malloc_aligned(size, alignment);
+   if (!bitmap->lock_buffer) {
+      bitmap->lock_buffer_size = 0;
+      return false;
+   }
+   bitmap->lock_buffer_size = size;
+   return true;
+}
+
+
+/* Frees the lock buffer after the first format-converting lock of a bitmap.
+ * Most bitmaps are only locked like this once, by the image loaders and
+ * savers, and should not carry a second copy of their pixels around.
+ */
+static void release_lock_buffer(ALLEGRO_BITMAP *bitmap)
+{
+   if (bitmap->lock_conversions < 2) {
+      _al_free_aligned(bitmap->lock_buffer);
+      bitmap->lock_buffer = NULL;
+      bitmap->lock_buffer_size = 0;
+   }
+}
+
+
+/* Converts the lock buffer back into the memory bitmap.  If the user marked
+ * any rows with al_mark_locked_bitmap_rows, only runs of marked rows are
+ * converted.
+ */
+static void write_back_lock_buffer(ALLEGRO_BITMAP *bitmap, int bitmap_format)
+{
+   ALLEGRO_LOCKED_REGION *lr = &bitmap->locked_region;
+   unsigned char *dirty = bitmap->lock_dirty_rows;
+   int y1, y2;
+
+   if (!bitmap->lock_rows_marked) {
+      _al_convert_bitmap_data(
+         lr->data, lr->format, lr->pitch,
+         bitmap->memory, bitmap_format, bitmap->pitch,
+         0, 0, bitmap->lock_x, bitmap->lock_y, bitmap->lock_w, bitmap->lock_h);
+      return;
+   }
+
+   y1 = 0;
+   while (y1 < bitmap->lock_h) {
+      if (!dirty[y1]) {
+         y1++;
+         continue;
+      }
+      for (y2 = y1 + 1; y2 < bitmap->lock_h && dirty[y2]; y2++)
+         ;
+      _al_convert_bitmap_data(
+         lr->data, lr->format, lr->pitch,
+         bitmap->memory, bitmap_format, bitmap->pitch,
+         0, y1, bitmap->lock_x, bitmap->lock_y + y1, bitmap->lock_w, y2 - y1);
+      y1 = y2;
+   }
+}
+
+
 /* Function: al_lock_bitmap_region
  */
 ALLEGRO_LOCKED_REGION *al_lock_bitmap_region(ALLEGRO_BITMAP *bitmap,
@@ -41,6 +115,9 @@ ALLEGRO_LOCKED_REGION *al_lock_bitmap_region(ALLEGRO_BITMAP *bitmap,
       ASSERT(al_get_pixel_block_height(format) == 1);
    }
 
+   /* Deferred blits involving the bitmap must land before it is accessed. */
+   _al_flush_memory_bitmap_drawing(bitmap);
+
    /* For sub-bitmaps */
    if (bitmap->parent) {
       x += bitmap->xofs;
@@ -68,6 +145,8 @@ ALLEGRO_LOCKED_REGION *al_lock_bitmap_region(ALLEGRO_BITMAP *bitmap,
    bitmap->lock_w = wc;
    bitmap->lock_h = hc;
    bitmap->lock_flags = flags;
+   bitmap->lock_dirty_rows = NULL;
+   bitmap->lock_rows_marked = false;
 
    if (flags == ALLEGRO_LOCK_WRITEONLY &&
        (xc != x || yc != y || wc != width || hc != height)) {
@@ -91,8 +170,20 @@ ALLEGRO_LOCKED_REGION *al_lock_bitmap_region(ALLEGRO_BITMAP *bitmap,
          bitmap->locked_region.pixel_size = al_get_pixel_size(bitmap_format);
       }
       else {
-         bitmap->locked_region.pitch = al_get_pixel_size(f) * wc;
-         bitmap->locked_region.data = al_malloc(bitmap->locked_region.pitch*hc);
+         int alignment = _al_get_memory_bitmap_alignment();
+         int pitch = _al_get_least_multiple(al_get_pixel_size(f) * wc,
+            alignment);
+         if (!reserve_lock_buffer(bitmap, (size_t)pitch * hc + hc,
+               alignment)) {
+            return NULL;
+         }
+         if (bitmap->lock_conversions < 2)
+            bitmap->lock_conversions++;
+         bitmap->lock_dirty_rows = (unsigned char *)bitmap->lock_buffer
+            + (size_t)pitch * hc;
+         memset(bitmap->lock_dirty_rows, 0, hc);
+         bitmap->locked_region.pitch = pitch;
+         bitmap->locked_region.data = bitmap->lock_buffer;
          bitmap->locked_region.format = f;
          bitmap->locked_region.pixel_size = al_get_pixel_size(f);
          if (!(bitmap->lock_flags & ALLEGRO_LOCK_WRITEONLY)) {
@@ -149,19 +240,46 @@ void al_unlock_bitmap(ALLEGRO_BITMAP *bitmap)
    else {
       if (bitmap->locked_region.format != 0 && bitmap->locked_region.format != bitmap_format) {
          if (!(bitmap->lock_flags & ALLEGRO_LOCK_READONLY)) {
-            _al_convert_bitmap_data(
-               bitmap->locked_region.data, bitmap->locked_region.format, bitmap->locked_region.pitch,
-               bitmap->memory, bitmap_format, bitmap->pitch,
-               0, 0, bitmap->lock_x, bitmap->lock_y, bitmap->lock_w, bitmap->lock_h);
+            write_back_lock_buffer(bitmap, bitmap_format);
          }
-         al_free(bitmap->locked_region.data);
+         release_lock_buffer(bitmap);
       }
    }
 
+   bitmap->lock_dirty_rows = NULL;
    bitmap->locked = false;
 }
 
 
+/* Function: al_mark_locked_bitmap_rows
+ */
+void al_mark_locked_bitmap_rows(ALLEGRO_BITMAP *bitmap, int y, int height)
+{
+   /* For sub-bitmaps */
+   if (bitmap->parent) {
+      bitmap = bitmap->parent;
+   }
+
+   ASSERT(bitmap->locked);
+
+   /* Only format-converting locks of memory bitmaps track rows. */
+   if (!bitmap->lock_dirty_rows)
+      return;
+
+   if (y < 0) {
+      height += y;
+      y = 0;
+   }
+   if (height > bitmap->lock_h - y)
+      height = bitmap->lock_h - y;
+   if (height <= 0)
+      return;
+
+   memset(bitmap->lock_dirty_rows + y, 1, height);
+   bitmap->lock_rows_marked = true;
+}
+
+
 /* Function: al_is_bitmap_locked
  */
 bool al_is_bitmap_locked(ALLEGRO_BITMAP *bitmap)
@@ -208,6 +326,8 @@ ALLEGRO_LOCKED_REGION *al_lock_bitmap_region_blocked(ALLEGRO_BITMAP *bitmap,
    ASSERT(_al_pixel_format_is_compressed(bitmap_format));
    ASSERT(!(bitmap_flags & ALLEGRO_MEMORY_BITMAP));
 
+   _al_flush_memory_bitmap_drawing(bitmap);
+
    /* For sub-bitmaps */
    if (bitmap->parent) {
       if (bitmap->xofs % block_width != 0 ||
@@ -19,9 +19,17 @@
 #include "allegro5/internal/aintern.h"
 #include "allegro5/internal/aintern_bitmap.h"
 #include "allegro5/internal/aintern_blend.h"
+#include "allegro5/internal/aintern_cpu.h"
 #include "allegro5/internal/aintern_display.h"
 #include <string.h>
 
+#if defined(_AL_SIMD_X86)
+   #include <emmintrin.h>
+   #include <immintrin.h>
+#elif defined(_AL_SIMD_NEON) && defined(ALLEGRO_LITTLE_ENDIAN)
+   #include <arm_neon.h>
+#endif
+
 void _al_blend_memory(ALLEGRO_COLOR *scol,
    ALLEGRO_BITMAP *dest,
    int dx, int dy, ALLEGRO_COLOR *result)
@@ -40,3 +48,272 @@ void _al_blend_memory(ALLEGRO_COLOR *scol,
                     &constcol, result);
    (void) _al_blend_alpha_inline; // silence compiler
 }
+
+
+
+/* Internal function: _al_is_premul_blend_format
+ */
+bool _al_is_premul_blend_format(int format)
+{
+   return format == ALLEGRO_PIXEL_FORMAT_ARGB_8888 ||
+      format == ALLEGRO_PIXEL_FORMAT_ABGR_8888;
+}
+
+
+
+/* Internal function: _al_init_premul_blend
+ */
+void _al_init_premul_blend(_AL_PREMUL_BLEND *pb, int src_format,
+   int dst_format, ALLEGRO_COLOR tint)
+{
+   ASSERT(_al_is_premul_blend_format(src_format));
+   ASSERT(_al_is_premul_blend_format(dst_format));
+
+   pb->swap_rb = (src_format != dst_format);
+   pb->tint[3] = (uint16_t)(tint.a * 256 + 0.5f);
+   pb->tint[1] = (uint16_t)(tint.g * 256 + 0.5f);
+   if (dst_format == ALLEGRO_PIXEL_FORMAT_ARGB_8888) {
+      pb->tint[2] = (uint16_t)(tint.r * 256 + 0.5f);
+      pb->tint[0] = (uint16_t)(tint.b * 256 + 0.5f);
+   }
+   else {
+      pb->tint[2] = (uint16_t)(tint.b * 256 + 0.5f);
+      pb->tint[0] = (uint16_t)(tint.r * 256 + 0.5f);
+   }
+   pb->tinted = (pb->tint[0] != 256 || pb->tint[1] != 256 ||
+      pb->tint[2] != 256 || pb->tint[3] != 256);
+}
+
+
+
+static INLINE uint32_t swap_rb(uint32_t p)
+{
+   return (p & 0xFF00FF00) | ((p >> 16) & 0xFF) | ((p & 0xFF) << 16);
+}
+
+
+static void blend_premul_row_c(uint32_t *dst, const uint32_t *src, int n,
+   const _AL_PREMUL_BLEND *pb)
+{
+   int i, c;
+
+   for (i = 0; i < n; i++) {
+      uint32_t s = src[i];
+      uint32_t d = dst[i];
+      uint32_t out = 0;
+      unsigned ia;
+
+      if (pb->swap_rb)
+         s = swap_rb(s);
+      if (pb->tinted) {
+         uint32_t t = 0;
+         for (c = 0; c < 4; c++)
+            t |= ((((s >> (c * 8)) & 0xFF) * pb->tint[c]) >> 8) << (c * 8);
+         s = t;
+      }
+
+      ia = 255 - (s >> 24);
+      for (c = 0; c < 32; c += 8) {
+         unsigned x = ((d >> c) & 0xFF) * ia;
+         unsigned r = ((s >> c) & 0xFF) + ((x + 1 + (x >> 8)) >> 8);
+         out |= _ALLEGRO_MIN(r, 255) << c;
+      }
+      dst[i] = out;
+   }
+}
+
+
+#if defined(_AL_SIMD_X86)
+
+/* x / 255 rounded down, exact for 0 <= x <= 255 * 255. */
+#define DIV255_EPU16(x, one) \
+   _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, one), _mm_srli_epi16(x, 8)), 8)
+#define DIV255_EPU16_256(x, one) \
+   _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(x, one), \
+      _mm256_srli_epi16(x, 8)), 8)
+
+_AL_TARGET_SSE2
+static void blend_premul_row_sse2(uint32_t *dst, const uint32_t *src, int n,
+   const _AL_PREMUL_BLEND *pb)
+{
+   const __m128i zero = _mm_setzero_si128();
+   const __m128i one = _mm_set1_epi16(1);
+   const __m128i ff = _mm_set1_epi16(255);
+   const __m128i ag_mask = _mm_set1_epi32(0xFF00FF00);
+   const __m128i rb_mask = _mm_set1_epi32(0x00FF00FF);
+   const __m128i tint = _mm_set_epi16(
+      pb->tint[3], pb->tint[2], pb->tint[1], pb->tint[0],
+      pb->tint[3], pb->tint[2], pb->tint[1], pb->tint[0]);
+   int i;
+
+   for (i = 0; i + 4 <= n; i += 4) {
+      __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+      __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+      __m128i slo, shi, dlo, dhi, alo, ahi;
+
+      if (pb->swap_rb) {
+         __m128i rb = _mm_and_si128(s, rb_mask);
+         s = _mm_or_si128(_mm_and_si128(s, ag_mask),
+            _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16)));
+      }
+
+      slo = _mm_unpacklo_epi8(s, zero);
+      shi = _mm_unpackhi_epi8(s, zero);
+      if (pb->tinted) {
+         slo = _mm_srli_epi16(_mm_mullo_epi16(slo, tint), 8);
+         shi = _mm_srli_epi16(_mm_mullo_epi16(shi, tint), 8);
+      }
+
+      alo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(slo, 0xFF), 0xFF);
+      ahi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(shi, 0xFF), 0xFF);
+      dlo = _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_sub_epi16(ff, alo));
+      dhi = _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_sub_epi16(ff, ahi));
+      dlo = DIV255_EPU16(dlo, one);
+      dhi = DIV255_EPU16(dhi, one);
+
+      _mm_storeu_si128((__m128i *)(dst + i),
+         _mm_adds_epu8(_mm_packus_epi16(slo, shi), _mm_packus_epi16(dlo, dhi)));
+   }
+
+   blend_premul_row_c(dst + i, src + i, n - i, pb);
+}
+
+
+_AL_TARGET_AVX2
+static void blend_premul_row_avx2(uint32_t *dst, const uint32_t *src, int n,
+   const _AL_PREMUL_BLEND *pb)
+{
+   const __m256i zero = _mm256_setzero_si256();
+   const __m256i one = _mm256_set1_epi16(1);
+   const __m256i ff = _mm256_set1_epi16(255);
+   const __m256i ag_mask = _mm256_set1_epi32(0xFF00FF00);
+   const __m256i rb_mask = _mm256_set1_epi32(0x00FF00FF);
+   const __m256i tint = _mm256_set_epi16(
+      pb->tint[3], pb->tint[2], pb->tint[1], pb->tint[0],
+      pb->tint[3], pb->tint[2], pb->tint[1], pb->tint[0],
+      pb->tint[3], pb->tint[2], pb->tint[1], pb->tint[0],
+      pb->tint[3], pb->tint[2], pb->tint[1], pb->tint[0]);
+   int i;
+
+   /* Unpack and pack both work within 128-bit lanes, so the pixel order
+    * comes out the same as it went in.
+    */
+   for (i = 0; i + 8 <= n; i += 8) {
+      __m256i s = _mm256_loadu_si256((const __m256i *)(src + i));
+      __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+      __m256i slo, shi, dlo, dhi, alo, ahi;
+
+      if (pb->swap_rb) {
+         __m256i rb = _mm256_and_si256(s, rb_mask);
+         s = _mm256_or_si256(_mm256_and_si256(s, ag_mask),
+            _mm256_or_si256(_mm256_slli_epi32(rb, 16),
+               _mm256_srli_epi32(rb, 16)));
+      }
+
+      slo = _mm256_unpacklo_epi8(s, zero);
+      shi = _mm256_unpackhi_epi8(s, zero);
+      if (pb->tinted) {
+         slo = _mm256_srli_epi16(_mm256_mullo_epi16(slo, tint), 8);
+         shi = _mm256_srli_epi16(_mm256_mullo_epi16(shi, tint), 8);
+      }
+
+      alo = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(slo, 0xFF), 0xFF);
+      ahi = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(shi, 0xFF), 0xFF);
+      dlo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero),
+         _mm256_sub_epi16(ff, alo));
+      dhi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero),
+         _mm256_sub_epi16(ff, ahi));
+      dlo = DIV255_EPU16_256(dlo, one);
+      dhi = DIV255_EPU16_256(dhi, one);
+
+      _mm256_storeu_si256((__m256i *)(dst + i),
+         _mm256_adds_epu8(_mm256_packus_epi16(slo, shi),
+            _mm256_packus_epi16(dlo, dhi)));
+   }
+
+   /* GCC doesn't always do this before a tail call, and running SSE code
+    * with the upper halves of the registers dirty is very slow.
+    */
+   _mm256_zeroupper();
+   blend_premul_row_sse2(dst + i, src + i, n - i, pb);
+}
+
+#undef DIV255_EPU16
+#undef DIV255_EPU16_256
+
+#elif defined(_AL_SIMD_NEON) && defined(ALLEGRO_LITTLE_ENDIAN)
+
+/* x / 255 rounded down, exact for 0 <= x <= 255 * 255. */
+#define DIV255_U16(x, one) \
+   vshrq_n_u16(vaddq_u16(vaddq_u16(x, one), vshrq_n_u16(x, 8)), 8)
+
+static void blend_premul_row_neon(uint32_t *dst, const uint32_t *src, int n,
+   const _AL_PREMUL_BLEND *pb)
+{
+   const uint16x8_t one = vdupq_n_u16(1);
+   const uint32x4_t ag_mask = vdupq_n_u32(0xFF00FF00);
+   const uint32x4_t rb_mask = vdupq_n_u32(0x00FF00FF);
+   const uint16_t tint_array[8] = {
+      pb->tint[0], pb->tint[1], pb->tint[2], pb->tint[3],
+      pb->tint[0], pb->tint[1], pb->tint[2], pb->tint[3]
+   };
+   const uint16x8_t tint = vld1q_u16(tint_array);
+   int i;
+
+   for (i = 0; i + 4 <= n; i += 4) {
+      uint32x4_t s32 = vld1q_u32(src + i);
+      uint8x16_t d = vreinterpretq_u8_u32(vld1q_u32(dst + i));
+      uint8x16_t s, ia;
+      uint16x8_t dlo, dhi;
+
+      if (pb->swap_rb) {
+         uint32x4_t rb = vandq_u32(s32, rb_mask);
+         s32 = vorrq_u32(vandq_u32(s32, ag_mask),
+            vorrq_u32(vshlq_n_u32(rb, 16), vshrq_n_u32(rb, 16)));
+      }
+      s = vreinterpretq_u8_u32(s32);
+
+      if (pb->tinted) {
+         uint16x8_t slo = vmovl_u8(vget_low_u8(s));
+         uint16x8_t shi = vmovl_u8(vget_high_u8(s));
+         slo = vshrq_n_u16(vmulq_u16(slo, tint), 8);
+         shi = vshrq_n_u16(vmulq_u16(shi, tint), 8);
+         s = vcombine_u8(vmovn_u16(slo), vmovn_u16(shi));
+      }
+
+      /* Broadcast the alpha byte of each pixel and invert it. */
+      ia = vmvnq_u8(vreinterpretq_u8_u32(vmulq_n_u32(
+         vshrq_n_u32(vreinterpretq_u32_u8(s), 24), 0x01010101)));
+
+      dlo = vmull_u8(vget_low_u8(d), vget_low_u8(ia));
+      dhi = vmull_u8(vget_high_u8(d), vget_high_u8(ia));
+      dlo = DIV255_U16(dlo, one);
+      dhi = DIV255_U16(dhi, one);
+
+      vst1q_u32(dst + i, vreinterpretq_u32_u8(vqaddq_u8(s,
+         vcombine_u8(vmovn_u16(dlo), vmovn_u16(dhi)))));
+   }
+
+   blend_premul_row_c(dst + i, src + i, n - i, pb);
+}
+
+#undef DIV255_U16
+
+#endif
+
+
+/* Internal function: _al_get_premul_row_func
+ */
+_AL_PREMUL_ROW_FUNC _al_get_premul_row_func(void)
+{
+#if defined(_AL_SIMD_X86)
+   int features = _al_get_cpu_features();
+   if (features & _AL_CPU_AVX2)
+      return blend_premul_row_avx2;
+   if (features & _AL_CPU_SSE2)
+      return blend_premul_row_sse2;
+#elif defined(_AL_SIMD_NEON) && defined(ALLEGRO_LITTLE_ENDIAN)
+   return blend_premul_row_neon;
+#endif
+   return blend_premul_row_c;
+}
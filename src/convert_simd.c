@@ -0,0 +1,14689 @@
+// Warning: This file was created by make_converters.py - do not edit.
+#include "allegro5/allegro.h"
+#include "allegro5/internal/aintern_bitmap.h"
+#include "allegro5/internal/aintern_convert.h"
+#include "allegro5/internal/aintern_cpu.h"
+
+/* The byte shuffles below assume little endian pixel layout. */
+#ifdef ALLEGRO_LITTLE_ENDIAN
+#ifdef _AL_SIMD_X86
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <immintrin.h>
+_AL_TARGET_SSE2
+static void argb_8888_to_rgba_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 24), _mm_set1_epi32(0x000000ff)),
+            _mm_and_si128(_mm_slli_epi32(p, 8), _mm_set1_epi32((int)0xffffff00))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void argb_8888_to_rgba_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void argb_8888_to_rgba_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14));
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void argb_8888_to_argb_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 28), _mm_set1_epi32(0xf)), 12),
+            _mm_and_si128(_mm_srli_epi32(a, 4), _mm_set1_epi32(0xf))),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 12), _mm_set1_epi32(0xf)), 4)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 20), _mm_set1_epi32(0xf)), 8));
+         b = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 28), _mm_set1_epi32(0xf)), 12),
+            _mm_and_si128(_mm_srli_epi32(b, 4), _mm_set1_epi32(0xf))),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 12), _mm_set1_epi32(0xf)), 4)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 20), _mm_set1_epi32(0xf)), 8));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void argb_8888_to_argb_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 28), _mm256_set1_epi32(0xf)), 12),
+            _mm256_and_si256(_mm256_srli_epi32(a, 4), _mm256_set1_epi32(0xf))),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 12), _mm256_set1_epi32(0xf)), 4)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 20), _mm256_set1_epi32(0xf)), 8));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 28), _mm256_set1_epi32(0xf)), 12),
+            _mm256_and_si256(_mm256_srli_epi32(b, 4), _mm256_set1_epi32(0xf))),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 12), _mm256_set1_epi32(0xf)), 4)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 20), _mm256_set1_epi32(0xf)), 8));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void argb_8888_to_rgb_888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 0x80, 0x80, 0x80, 0x80);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m128i p0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle);
+         __m128i p1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 4)), shuffle);
+         __m128i p2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 8)), shuffle);
+         __m128i p3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 12)), shuffle);
+         __m128i *d = (__m128i *)(dst_ptr + x * 3);
+         _mm_storeu_si128(d + 0, _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+         _mm_storeu_si128(d + 1, _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+         _mm_storeu_si128(d + 2, _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_ARGB_8888_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void argb_8888_to_rgb_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(a, 3), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 10), _mm_set1_epi32(0x3f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)), 11));
+         b = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(b, 3), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 10), _mm_set1_epi32(0x3f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)), 11));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void argb_8888_to_rgb_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(a, 3), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 10), _mm256_set1_epi32(0x3f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)), 11));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(b, 3), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 10), _mm256_set1_epi32(0x3f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)), 11));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void argb_8888_to_rgb_555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(a, 3), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)), 10));
+         b = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(b, 3), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)), 10));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void argb_8888_to_rgb_555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(a, 3), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)), 10));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(b, 3), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)), 10));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void argb_8888_to_rgba_5551_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(a, 31), _mm_set1_epi32(0x1)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 3), _mm_set1_epi32(0x1f)), 1)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f)), 6)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)), 11));
+         b = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(b, 31), _mm_set1_epi32(0x1)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 3), _mm_set1_epi32(0x1f)), 1)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f)), 6)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)), 11));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void argb_8888_to_rgba_5551_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(a, 31), _mm256_set1_epi32(0x1)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 3), _mm256_set1_epi32(0x1f)), 1)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f)), 6)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)), 11));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(b, 31), _mm256_set1_epi32(0x1)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 3), _mm256_set1_epi32(0x1f)), 1)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f)), 6)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)), 11));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void argb_8888_to_argb_1555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 31), _mm_set1_epi32(0x1)), 15),
+            _mm_and_si128(_mm_srli_epi32(a, 3), _mm_set1_epi32(0x1f))),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)), 10));
+         b = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 31), _mm_set1_epi32(0x1)), 15),
+            _mm_and_si128(_mm_srli_epi32(b, 3), _mm_set1_epi32(0x1f))),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)), 10));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void argb_8888_to_argb_1555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 31), _mm256_set1_epi32(0x1)), 15),
+            _mm256_and_si256(_mm256_srli_epi32(a, 3), _mm256_set1_epi32(0x1f))),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)), 10));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 31), _mm256_set1_epi32(0x1)), 15),
+            _mm256_and_si256(_mm256_srli_epi32(b, 3), _mm256_set1_epi32(0x1f))),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)), 10));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void argb_8888_to_abgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 16), _mm_set1_epi32(0x000000ff)),
+            _mm_and_si128(p, _mm_set1_epi32((int)0xff00ff00))),
+            _mm_and_si128(_mm_slli_epi32(p, 16), _mm_set1_epi32(0x00ff0000))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void argb_8888_to_abgr_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void argb_8888_to_abgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15));
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void argb_8888_to_xbgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 16), _mm_set1_epi32(0x000000ff)),
+            _mm_and_si128(p, _mm_set1_epi32(0x0000ff00))),
+            _mm_and_si128(_mm_slli_epi32(p, 16), _mm_set1_epi32(0x00ff0000))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void argb_8888_to_xbgr_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 0x80, 6, 5, 4, 0x80, 10, 9, 8, 0x80, 14, 13, 12, 0x80);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void argb_8888_to_xbgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(2, 1, 0, 0x80, 6, 5, 4, 0x80, 10, 9, 8, 0x80, 14, 13, 12, 0x80));
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void argb_8888_to_bgr_888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, 0x80, 0x80, 0x80, 0x80);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m128i p0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle);
+         __m128i p1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 4)), shuffle);
+         __m128i p2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 8)), shuffle);
+         __m128i p3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 12)), shuffle);
+         __m128i *d = (__m128i *)(dst_ptr + x * 3);
+         _mm_storeu_si128(d + 0, _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+         _mm_storeu_si128(d + 1, _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+         _mm_storeu_si128(d + 2, _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_ARGB_8888_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void argb_8888_to_bgr_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 3), _mm_set1_epi32(0x1f)), 11),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 10), _mm_set1_epi32(0x3f)), 5)),
+            _mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)));
+         b = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 3), _mm_set1_epi32(0x1f)), 11),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 10), _mm_set1_epi32(0x3f)), 5)),
+            _mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void argb_8888_to_bgr_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 3), _mm256_set1_epi32(0x1f)), 11),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 10), _mm256_set1_epi32(0x3f)), 5)),
+            _mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 3), _mm256_set1_epi32(0x1f)), 11),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 10), _mm256_set1_epi32(0x3f)), 5)),
+            _mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void argb_8888_to_bgr_555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 3), _mm_set1_epi32(0x1f)), 10),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f)), 5)),
+            _mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)));
+         b = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 3), _mm_set1_epi32(0x1f)), 10),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f)), 5)),
+            _mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void argb_8888_to_bgr_555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 3), _mm256_set1_epi32(0x1f)), 10),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 3), _mm256_set1_epi32(0x1f)), 10),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void argb_8888_to_rgbx_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_and_si128(_mm_slli_epi32(p, 8), _mm_set1_epi32((int)0xffffff00)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void argb_8888_to_rgbx_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(0x80, 0, 1, 2, 0x80, 4, 5, 6, 0x80, 8, 9, 10, 0x80, 12, 13, 14);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void argb_8888_to_rgbx_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(0x80, 0, 1, 2, 0x80, 4, 5, 6, 0x80, 8, 9, 10, 0x80, 12, 13, 14));
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void argb_8888_to_xrgb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_and_si128(p, _mm_set1_epi32(0x00ffffff)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void argb_8888_to_xrgb_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(0, 1, 2, 0x80, 4, 5, 6, 0x80, 8, 9, 10, 0x80, 12, 13, 14, 0x80);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void argb_8888_to_xrgb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(0, 1, 2, 0x80, 4, 5, 6, 0x80, 8, 9, 10, 0x80, 12, 13, 14, 0x80));
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void argb_8888_to_abgr_8888_le_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 16), _mm_set1_epi32(0x000000ff)),
+            _mm_and_si128(p, _mm_set1_epi32((int)0xff00ff00))),
+            _mm_and_si128(_mm_slli_epi32(p, 16), _mm_set1_epi32(0x00ff0000))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void argb_8888_to_abgr_8888_le_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void argb_8888_to_abgr_8888_le_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15));
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void argb_8888_to_rgba_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(a, 28), _mm_set1_epi32(0xf)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 4), _mm_set1_epi32(0xf)), 4)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 12), _mm_set1_epi32(0xf)), 8)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 20), _mm_set1_epi32(0xf)), 12));
+         b = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(b, 28), _mm_set1_epi32(0xf)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 4), _mm_set1_epi32(0xf)), 4)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 12), _mm_set1_epi32(0xf)), 8)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 20), _mm_set1_epi32(0xf)), 12));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void argb_8888_to_rgba_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(a, 28), _mm256_set1_epi32(0xf)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 4), _mm256_set1_epi32(0xf)), 4)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 12), _mm256_set1_epi32(0xf)), 8)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 20), _mm256_set1_epi32(0xf)), 12));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(b, 28), _mm256_set1_epi32(0xf)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 4), _mm256_set1_epi32(0xf)), 4)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 12), _mm256_set1_epi32(0xf)), 8)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 20), _mm256_set1_epi32(0xf)), 12));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgba_8888_to_argb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 8), _mm_set1_epi32(0x00ffffff)),
+            _mm_and_si128(_mm_slli_epi32(p, 24), _mm_set1_epi32((int)0xff000000))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void rgba_8888_to_argb_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgba_8888_to_argb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12));
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgba_8888_to_argb_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 4), _mm_set1_epi32(0xf)), 12),
+            _mm_and_si128(_mm_srli_epi32(a, 12), _mm_set1_epi32(0xf))),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 20), _mm_set1_epi32(0xf)), 4)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 28), _mm_set1_epi32(0xf)), 8));
+         b = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 4), _mm_set1_epi32(0xf)), 12),
+            _mm_and_si128(_mm_srli_epi32(b, 12), _mm_set1_epi32(0xf))),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 20), _mm_set1_epi32(0xf)), 4)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 28), _mm_set1_epi32(0xf)), 8));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgba_8888_to_argb_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 4), _mm256_set1_epi32(0xf)), 12),
+            _mm256_and_si256(_mm256_srli_epi32(a, 12), _mm256_set1_epi32(0xf))),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 20), _mm256_set1_epi32(0xf)), 4)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 28), _mm256_set1_epi32(0xf)), 8));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 4), _mm256_set1_epi32(0xf)), 12),
+            _mm256_and_si256(_mm256_srli_epi32(b, 12), _mm256_set1_epi32(0xf))),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 20), _mm256_set1_epi32(0xf)), 4)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 28), _mm256_set1_epi32(0xf)), 8));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void rgba_8888_to_rgb_888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(1, 2, 3, 5, 6, 7, 9, 10, 11, 13, 14, 15, 0x80, 0x80, 0x80, 0x80);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m128i p0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle);
+         __m128i p1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 4)), shuffle);
+         __m128i p2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 8)), shuffle);
+         __m128i p3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 12)), shuffle);
+         __m128i *d = (__m128i *)(dst_ptr + x * 3);
+         _mm_storeu_si128(d + 0, _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+         _mm_storeu_si128(d + 1, _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+         _mm_storeu_si128(d + 2, _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_RGBA_8888_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgba_8888_to_rgb_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 18), _mm_set1_epi32(0x3f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 27), _mm_set1_epi32(0x1f)), 11));
+         b = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 18), _mm_set1_epi32(0x3f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 27), _mm_set1_epi32(0x1f)), 11));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgba_8888_to_rgb_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 18), _mm256_set1_epi32(0x3f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 27), _mm256_set1_epi32(0x1f)), 11));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 18), _mm256_set1_epi32(0x3f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 27), _mm256_set1_epi32(0x1f)), 11));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgba_8888_to_rgb_555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 27), _mm_set1_epi32(0x1f)), 10));
+         b = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 27), _mm_set1_epi32(0x1f)), 10));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgba_8888_to_rgb_555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 27), _mm256_set1_epi32(0x1f)), 10));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 27), _mm256_set1_epi32(0x1f)), 10));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgba_8888_to_rgba_5551_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(a, 7), _mm_set1_epi32(0x1)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f)), 1)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)), 6)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 27), _mm_set1_epi32(0x1f)), 11));
+         b = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(b, 7), _mm_set1_epi32(0x1)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f)), 1)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)), 6)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 27), _mm_set1_epi32(0x1f)), 11));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgba_8888_to_rgba_5551_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(a, 7), _mm256_set1_epi32(0x1)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f)), 1)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)), 6)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 27), _mm256_set1_epi32(0x1f)), 11));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(b, 7), _mm256_set1_epi32(0x1)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f)), 1)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)), 6)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 27), _mm256_set1_epi32(0x1f)), 11));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgba_8888_to_argb_1555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 7), _mm_set1_epi32(0x1)), 15),
+            _mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f))),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 27), _mm_set1_epi32(0x1f)), 10));
+         b = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 7), _mm_set1_epi32(0x1)), 15),
+            _mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f))),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 27), _mm_set1_epi32(0x1f)), 10));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgba_8888_to_argb_1555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 7), _mm256_set1_epi32(0x1)), 15),
+            _mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f))),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 27), _mm256_set1_epi32(0x1f)), 10));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 7), _mm256_set1_epi32(0x1)), 15),
+            _mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f))),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 27), _mm256_set1_epi32(0x1f)), 10));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgba_8888_to_abgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 24), _mm_set1_epi32(0x000000ff)),
+            _mm_and_si128(_mm_srli_epi32(p, 8), _mm_set1_epi32(0x0000ff00))),
+            _mm_and_si128(_mm_slli_epi32(p, 8), _mm_set1_epi32(0x00ff0000))),
+            _mm_and_si128(_mm_slli_epi32(p, 24), _mm_set1_epi32((int)0xff000000))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void rgba_8888_to_abgr_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgba_8888_to_abgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12));
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgba_8888_to_xbgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 24), _mm_set1_epi32(0x000000ff)),
+            _mm_and_si128(_mm_srli_epi32(p, 8), _mm_set1_epi32(0x0000ff00))),
+            _mm_and_si128(_mm_slli_epi32(p, 8), _mm_set1_epi32(0x00ff0000))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void rgba_8888_to_xbgr_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(3, 2, 1, 0x80, 7, 6, 5, 0x80, 11, 10, 9, 0x80, 15, 14, 13, 0x80);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgba_8888_to_xbgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(3, 2, 1, 0x80, 7, 6, 5, 0x80, 11, 10, 9, 0x80, 15, 14, 13, 0x80));
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void rgba_8888_to_bgr_888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(3, 2, 1, 7, 6, 5, 11, 10, 9, 15, 14, 13, 0x80, 0x80, 0x80, 0x80);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m128i p0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle);
+         __m128i p1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 4)), shuffle);
+         __m128i p2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 8)), shuffle);
+         __m128i p3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 12)), shuffle);
+         __m128i *d = (__m128i *)(dst_ptr + x * 3);
+         _mm_storeu_si128(d + 0, _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+         _mm_storeu_si128(d + 1, _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+         _mm_storeu_si128(d + 2, _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_RGBA_8888_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgba_8888_to_bgr_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f)), 11),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 18), _mm_set1_epi32(0x3f)), 5)),
+            _mm_and_si128(_mm_srli_epi32(a, 27), _mm_set1_epi32(0x1f)));
+         b = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f)), 11),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 18), _mm_set1_epi32(0x3f)), 5)),
+            _mm_and_si128(_mm_srli_epi32(b, 27), _mm_set1_epi32(0x1f)));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgba_8888_to_bgr_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f)), 11),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 18), _mm256_set1_epi32(0x3f)), 5)),
+            _mm256_and_si256(_mm256_srli_epi32(a, 27), _mm256_set1_epi32(0x1f)));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f)), 11),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 18), _mm256_set1_epi32(0x3f)), 5)),
+            _mm256_and_si256(_mm256_srli_epi32(b, 27), _mm256_set1_epi32(0x1f)));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgba_8888_to_bgr_555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f)), 10),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)), 5)),
+            _mm_and_si128(_mm_srli_epi32(a, 27), _mm_set1_epi32(0x1f)));
+         b = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f)), 10),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)), 5)),
+            _mm_and_si128(_mm_srli_epi32(b, 27), _mm_set1_epi32(0x1f)));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgba_8888_to_bgr_555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f)), 10),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_and_si256(_mm256_srli_epi32(a, 27), _mm256_set1_epi32(0x1f)));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f)), 10),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_and_si256(_mm256_srli_epi32(b, 27), _mm256_set1_epi32(0x1f)));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgba_8888_to_rgbx_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_and_si128(p, _mm_set1_epi32((int)0xffffff00)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void rgba_8888_to_rgbx_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(0x80, 1, 2, 3, 0x80, 5, 6, 7, 0x80, 9, 10, 11, 0x80, 13, 14, 15);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgba_8888_to_rgbx_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(0x80, 1, 2, 3, 0x80, 5, 6, 7, 0x80, 9, 10, 11, 0x80, 13, 14, 15));
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgba_8888_to_xrgb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_and_si128(_mm_srli_epi32(p, 8), _mm_set1_epi32(0x00ffffff)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void rgba_8888_to_xrgb_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(1, 2, 3, 0x80, 5, 6, 7, 0x80, 9, 10, 11, 0x80, 13, 14, 15, 0x80);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgba_8888_to_xrgb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(1, 2, 3, 0x80, 5, 6, 7, 0x80, 9, 10, 11, 0x80, 13, 14, 15, 0x80));
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgba_8888_to_abgr_8888_le_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 24), _mm_set1_epi32(0x000000ff)),
+            _mm_and_si128(_mm_srli_epi32(p, 8), _mm_set1_epi32(0x0000ff00))),
+            _mm_and_si128(_mm_slli_epi32(p, 8), _mm_set1_epi32(0x00ff0000))),
+            _mm_and_si128(_mm_slli_epi32(p, 24), _mm_set1_epi32((int)0xff000000))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void rgba_8888_to_abgr_8888_le_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgba_8888_to_abgr_8888_le_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12));
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgba_8888_to_rgba_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(a, 4), _mm_set1_epi32(0xf)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 12), _mm_set1_epi32(0xf)), 4)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 20), _mm_set1_epi32(0xf)), 8)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 28), _mm_set1_epi32(0xf)), 12));
+         b = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(b, 4), _mm_set1_epi32(0xf)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 12), _mm_set1_epi32(0xf)), 4)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 20), _mm_set1_epi32(0xf)), 8)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 28), _mm_set1_epi32(0xf)), 12));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgba_8888_to_rgba_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(a, 4), _mm256_set1_epi32(0xf)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 12), _mm256_set1_epi32(0xf)), 4)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 20), _mm256_set1_epi32(0xf)), 8)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 28), _mm256_set1_epi32(0xf)), 12));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(b, 4), _mm256_set1_epi32(0xf)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 12), _mm256_set1_epi32(0xf)), 4)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 20), _mm256_set1_epi32(0xf)), 8)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 28), _mm256_set1_epi32(0xf)), 12));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void argb_4444_to_argb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0xf)), _mm_set1_epi16(17)),
+            _mm_slli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 4), _mm_set1_epi16(0xf)), _mm_set1_epi16(17)), 8));
+         __m128i hi = _mm_or_si128(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 8), _mm_set1_epi16(0xf)), _mm_set1_epi16(17)),
+            _mm_slli_epi16(_mm_mullo_epi16(_mm_srli_epi16(p, 12), _mm_set1_epi16(17)), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_4444_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void argb_4444_to_argb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)),
+            _mm256_slli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 4), _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)), 8));
+         __m256i hi = _mm256_or_si256(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 8), _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)),
+            _mm256_slli_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(p, 12), _mm256_set1_epi16(17)), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_4444_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void argb_4444_to_rgba_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_mullo_epi16(_mm_srli_epi16(p, 12), _mm_set1_epi16(17)),
+            _mm_slli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0xf)), _mm_set1_epi16(17)), 8));
+         __m128i hi = _mm_or_si128(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 4), _mm_set1_epi16(0xf)), _mm_set1_epi16(17)),
+            _mm_slli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 8), _mm_set1_epi16(0xf)), _mm_set1_epi16(17)), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_4444_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void argb_4444_to_rgba_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_mullo_epi16(_mm256_srli_epi16(p, 12), _mm256_set1_epi16(17)),
+            _mm256_slli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)), 8));
+         __m256i hi = _mm256_or_si256(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 4), _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)),
+            _mm256_slli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 8), _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_4444_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void argb_4444_to_abgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 8), _mm_set1_epi16(0xf)), _mm_set1_epi16(17)),
+            _mm_slli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 4), _mm_set1_epi16(0xf)), _mm_set1_epi16(17)), 8));
+         __m128i hi = _mm_or_si128(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0xf)), _mm_set1_epi16(17)),
+            _mm_slli_epi16(_mm_mullo_epi16(_mm_srli_epi16(p, 12), _mm_set1_epi16(17)), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_4444_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void argb_4444_to_abgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 8), _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)),
+            _mm256_slli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 4), _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)), 8));
+         __m256i hi = _mm256_or_si256(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)),
+            _mm256_slli_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(p, 12), _mm256_set1_epi16(17)), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_4444_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void argb_4444_to_xbgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 8), _mm_set1_epi16(0xf)), _mm_set1_epi16(17)),
+            _mm_slli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 4), _mm_set1_epi16(0xf)), _mm_set1_epi16(17)), 8));
+         __m128i hi = _mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0xf)), _mm_set1_epi16(17));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_4444_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void argb_4444_to_xbgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 8), _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)),
+            _mm256_slli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 4), _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)), 8));
+         __m256i hi = _mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_4444_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void argb_4444_to_rgbx_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_slli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0xf)), _mm_set1_epi16(17)), 8);
+         __m128i hi = _mm_or_si128(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 4), _mm_set1_epi16(0xf)), _mm_set1_epi16(17)),
+            _mm_slli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 8), _mm_set1_epi16(0xf)), _mm_set1_epi16(17)), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_4444_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void argb_4444_to_rgbx_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_slli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)), 8);
+         __m256i hi = _mm256_or_si256(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 4), _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)),
+            _mm256_slli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 8), _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_4444_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void argb_4444_to_xrgb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0xf)), _mm_set1_epi16(17)),
+            _mm_slli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 4), _mm_set1_epi16(0xf)), _mm_set1_epi16(17)), 8));
+         __m128i hi = _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 8), _mm_set1_epi16(0xf)), _mm_set1_epi16(17));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_4444_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void argb_4444_to_xrgb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)),
+            _mm256_slli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 4), _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)), 8));
+         __m256i hi = _mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 8), _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_4444_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void argb_4444_to_abgr_8888_le_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 8), _mm_set1_epi16(0xf)), _mm_set1_epi16(17)),
+            _mm_slli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 4), _mm_set1_epi16(0xf)), _mm_set1_epi16(17)), 8));
+         __m128i hi = _mm_or_si128(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0xf)), _mm_set1_epi16(17)),
+            _mm_slli_epi16(_mm_mullo_epi16(_mm_srli_epi16(p, 12), _mm_set1_epi16(17)), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_4444_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void argb_4444_to_abgr_8888_le_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 8), _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)),
+            _mm256_slli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 4), _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)), 8));
+         __m256i hi = _mm256_or_si256(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)),
+            _mm256_slli_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(p, 12), _mm256_set1_epi16(17)), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_4444_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void rgb_888_to_argb_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(0, 1, 2, 0x80, 3, 4, 5, 0x80, 6, 7, 8, 0x80, 9, 10, 11, 0x80);
+   const __m128i fill = _mm_set1_epi32((int)0xff000000);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint8_t *src_ptr = (const uint8_t *)((const char *)src + (sy + y) * src_pitch) + sx * 3;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         const __m128i *s = (const __m128i *)(src_ptr + x * 3);
+         __m128i s0 = _mm_loadu_si128(s + 0);
+         __m128i s1 = _mm_loadu_si128(s + 1);
+         __m128i s2 = _mm_loadu_si128(s + 2);
+         __m128i p[4];
+         int i;
+         p[0] = s0;
+         p[1] = _mm_alignr_epi8(s1, s0, 12);
+         p[2] = _mm_alignr_epi8(s2, s1, 8);
+         p[3] = _mm_srli_si128(s2, 4);
+         for (i = 0; i < 4; i++) {
+            _mm_storeu_si128((__m128i *)(dst_ptr + x + i * 4),
+               _mm_or_si128(_mm_shuffle_epi8(p[i], shuffle), fill));
+         }
+      }
+      for (; x < width; x++) {
+         const uint8_t *p = src_ptr + x * 3;
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_888_TO_ARGB_8888(p[0] | (p[1] << 8) | (p[2] << 16));
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void rgb_888_to_rgba_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(0x80, 0, 1, 2, 0x80, 3, 4, 5, 0x80, 6, 7, 8, 0x80, 9, 10, 11);
+   const __m128i fill = _mm_set1_epi32(0x000000ff);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint8_t *src_ptr = (const uint8_t *)((const char *)src + (sy + y) * src_pitch) + sx * 3;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         const __m128i *s = (const __m128i *)(src_ptr + x * 3);
+         __m128i s0 = _mm_loadu_si128(s + 0);
+         __m128i s1 = _mm_loadu_si128(s + 1);
+         __m128i s2 = _mm_loadu_si128(s + 2);
+         __m128i p[4];
+         int i;
+         p[0] = s0;
+         p[1] = _mm_alignr_epi8(s1, s0, 12);
+         p[2] = _mm_alignr_epi8(s2, s1, 8);
+         p[3] = _mm_srli_si128(s2, 4);
+         for (i = 0; i < 4; i++) {
+            _mm_storeu_si128((__m128i *)(dst_ptr + x + i * 4),
+               _mm_or_si128(_mm_shuffle_epi8(p[i], shuffle), fill));
+         }
+      }
+      for (; x < width; x++) {
+         const uint8_t *p = src_ptr + x * 3;
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_888_TO_RGBA_8888(p[0] | (p[1] << 8) | (p[2] << 16));
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void rgb_888_to_abgr_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 0x80, 5, 4, 3, 0x80, 8, 7, 6, 0x80, 11, 10, 9, 0x80);
+   const __m128i fill = _mm_set1_epi32((int)0xff000000);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint8_t *src_ptr = (const uint8_t *)((const char *)src + (sy + y) * src_pitch) + sx * 3;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         const __m128i *s = (const __m128i *)(src_ptr + x * 3);
+         __m128i s0 = _mm_loadu_si128(s + 0);
+         __m128i s1 = _mm_loadu_si128(s + 1);
+         __m128i s2 = _mm_loadu_si128(s + 2);
+         __m128i p[4];
+         int i;
+         p[0] = s0;
+         p[1] = _mm_alignr_epi8(s1, s0, 12);
+         p[2] = _mm_alignr_epi8(s2, s1, 8);
+         p[3] = _mm_srli_si128(s2, 4);
+         for (i = 0; i < 4; i++) {
+            _mm_storeu_si128((__m128i *)(dst_ptr + x + i * 4),
+               _mm_or_si128(_mm_shuffle_epi8(p[i], shuffle), fill));
+         }
+      }
+      for (; x < width; x++) {
+         const uint8_t *p = src_ptr + x * 3;
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_888_TO_ABGR_8888(p[0] | (p[1] << 8) | (p[2] << 16));
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void rgb_888_to_xbgr_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 0x80, 5, 4, 3, 0x80, 8, 7, 6, 0x80, 11, 10, 9, 0x80);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint8_t *src_ptr = (const uint8_t *)((const char *)src + (sy + y) * src_pitch) + sx * 3;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         const __m128i *s = (const __m128i *)(src_ptr + x * 3);
+         __m128i s0 = _mm_loadu_si128(s + 0);
+         __m128i s1 = _mm_loadu_si128(s + 1);
+         __m128i s2 = _mm_loadu_si128(s + 2);
+         __m128i p[4];
+         int i;
+         p[0] = s0;
+         p[1] = _mm_alignr_epi8(s1, s0, 12);
+         p[2] = _mm_alignr_epi8(s2, s1, 8);
+         p[3] = _mm_srli_si128(s2, 4);
+         for (i = 0; i < 4; i++) {
+            _mm_storeu_si128((__m128i *)(dst_ptr + x + i * 4),
+               _mm_shuffle_epi8(p[i], shuffle));
+         }
+      }
+      for (; x < width; x++) {
+         const uint8_t *p = src_ptr + x * 3;
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_888_TO_XBGR_8888(p[0] | (p[1] << 8) | (p[2] << 16));
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void rgb_888_to_rgbx_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(0x80, 0, 1, 2, 0x80, 3, 4, 5, 0x80, 6, 7, 8, 0x80, 9, 10, 11);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint8_t *src_ptr = (const uint8_t *)((const char *)src + (sy + y) * src_pitch) + sx * 3;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         const __m128i *s = (const __m128i *)(src_ptr + x * 3);
+         __m128i s0 = _mm_loadu_si128(s + 0);
+         __m128i s1 = _mm_loadu_si128(s + 1);
+         __m128i s2 = _mm_loadu_si128(s + 2);
+         __m128i p[4];
+         int i;
+         p[0] = s0;
+         p[1] = _mm_alignr_epi8(s1, s0, 12);
+         p[2] = _mm_alignr_epi8(s2, s1, 8);
+         p[3] = _mm_srli_si128(s2, 4);
+         for (i = 0; i < 4; i++) {
+            _mm_storeu_si128((__m128i *)(dst_ptr + x + i * 4),
+               _mm_shuffle_epi8(p[i], shuffle));
+         }
+      }
+      for (; x < width; x++) {
+         const uint8_t *p = src_ptr + x * 3;
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_888_TO_RGBX_8888(p[0] | (p[1] << 8) | (p[2] << 16));
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void rgb_888_to_xrgb_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(0, 1, 2, 0x80, 3, 4, 5, 0x80, 6, 7, 8, 0x80, 9, 10, 11, 0x80);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint8_t *src_ptr = (const uint8_t *)((const char *)src + (sy + y) * src_pitch) + sx * 3;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         const __m128i *s = (const __m128i *)(src_ptr + x * 3);
+         __m128i s0 = _mm_loadu_si128(s + 0);
+         __m128i s1 = _mm_loadu_si128(s + 1);
+         __m128i s2 = _mm_loadu_si128(s + 2);
+         __m128i p[4];
+         int i;
+         p[0] = s0;
+         p[1] = _mm_alignr_epi8(s1, s0, 12);
+         p[2] = _mm_alignr_epi8(s2, s1, 8);
+         p[3] = _mm_srli_si128(s2, 4);
+         for (i = 0; i < 4; i++) {
+            _mm_storeu_si128((__m128i *)(dst_ptr + x + i * 4),
+               _mm_shuffle_epi8(p[i], shuffle));
+         }
+      }
+      for (; x < width; x++) {
+         const uint8_t *p = src_ptr + x * 3;
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_888_TO_XRGB_8888(p[0] | (p[1] << 8) | (p[2] << 16));
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void rgb_888_to_abgr_8888_le_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 0x80, 5, 4, 3, 0x80, 8, 7, 6, 0x80, 11, 10, 9, 0x80);
+   const __m128i fill = _mm_set1_epi32((int)0xff000000);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint8_t *src_ptr = (const uint8_t *)((const char *)src + (sy + y) * src_pitch) + sx * 3;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         const __m128i *s = (const __m128i *)(src_ptr + x * 3);
+         __m128i s0 = _mm_loadu_si128(s + 0);
+         __m128i s1 = _mm_loadu_si128(s + 1);
+         __m128i s2 = _mm_loadu_si128(s + 2);
+         __m128i p[4];
+         int i;
+         p[0] = s0;
+         p[1] = _mm_alignr_epi8(s1, s0, 12);
+         p[2] = _mm_alignr_epi8(s2, s1, 8);
+         p[3] = _mm_srli_si128(s2, 4);
+         for (i = 0; i < 4; i++) {
+            _mm_storeu_si128((__m128i *)(dst_ptr + x + i * 4),
+               _mm_or_si128(_mm_shuffle_epi8(p[i], shuffle), fill));
+         }
+      }
+      for (; x < width; x++) {
+         const uint8_t *p = src_ptr + x * 3;
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_888_TO_ABGR_8888_LE(p[0] | (p[1] << 8) | (p[2] << 16));
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgb_565_to_argb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mulhi_epu16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x3f)), _mm_set1_epi16(255)), _mm_set1_epi16(8323)), 3), 8));
+         __m128i hi = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_srli_epi16(p, 11), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_set1_epi16(0xff), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_565_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgb_565_to_argb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x3f)), _mm256_set1_epi16(255)), _mm256_set1_epi16(8323)), 3), 8));
+         __m256i hi = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(p, 11), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_set1_epi16(0xff), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_565_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgb_565_to_rgba_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_set1_epi16(0xff),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i hi = _mm_or_si128(_mm_srli_epi16(_mm_mulhi_epu16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x3f)), _mm_set1_epi16(255)), _mm_set1_epi16(8323)), 3),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_srli_epi16(p, 11), _mm_set1_epi16(1053)), 7), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_565_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgb_565_to_rgba_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_set1_epi16(0xff),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i hi = _mm256_or_si256(_mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x3f)), _mm256_set1_epi16(255)), _mm256_set1_epi16(8323)), 3),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(p, 11), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_565_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgb_565_to_abgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_srli_epi16(p, 11), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mulhi_epu16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x3f)), _mm_set1_epi16(255)), _mm_set1_epi16(8323)), 3), 8));
+         __m128i hi = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_set1_epi16(0xff), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_565_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgb_565_to_abgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(p, 11), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x3f)), _mm256_set1_epi16(255)), _mm256_set1_epi16(8323)), 3), 8));
+         __m256i hi = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_set1_epi16(0xff), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_565_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgb_565_to_xbgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_srli_epi16(p, 11), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mulhi_epu16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x3f)), _mm_set1_epi16(255)), _mm_set1_epi16(8323)), 3), 8));
+         __m128i hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7);
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_565_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgb_565_to_xbgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(p, 11), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x3f)), _mm256_set1_epi16(255)), _mm256_set1_epi16(8323)), 3), 8));
+         __m256i hi = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7);
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_565_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgb_565_to_rgbx_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8);
+         __m128i hi = _mm_or_si128(_mm_srli_epi16(_mm_mulhi_epu16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x3f)), _mm_set1_epi16(255)), _mm_set1_epi16(8323)), 3),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_srli_epi16(p, 11), _mm_set1_epi16(1053)), 7), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_565_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgb_565_to_rgbx_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8);
+         __m256i hi = _mm256_or_si256(_mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x3f)), _mm256_set1_epi16(255)), _mm256_set1_epi16(8323)), 3),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(p, 11), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_565_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgb_565_to_xrgb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mulhi_epu16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x3f)), _mm_set1_epi16(255)), _mm_set1_epi16(8323)), 3), 8));
+         __m128i hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_srli_epi16(p, 11), _mm_set1_epi16(1053)), 7);
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_565_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgb_565_to_xrgb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x3f)), _mm256_set1_epi16(255)), _mm256_set1_epi16(8323)), 3), 8));
+         __m256i hi = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(p, 11), _mm256_set1_epi16(1053)), 7);
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_565_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgb_565_to_abgr_8888_le_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_srli_epi16(p, 11), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mulhi_epu16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x3f)), _mm_set1_epi16(255)), _mm_set1_epi16(8323)), 3), 8));
+         __m128i hi = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_set1_epi16(0xff), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_565_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgb_565_to_abgr_8888_le_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(p, 11), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x3f)), _mm256_set1_epi16(255)), _mm256_set1_epi16(8323)), 3), 8));
+         __m256i hi = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_set1_epi16(0xff), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_565_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgb_555_to_argb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i hi = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 10), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_set1_epi16(0xff), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_555_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgb_555_to_argb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i hi = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 10), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_set1_epi16(0xff), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_555_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgb_555_to_rgba_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_set1_epi16(0xff),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i hi = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 10), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_555_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgb_555_to_rgba_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_set1_epi16(0xff),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i hi = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 10), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_555_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgb_555_to_abgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 10), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i hi = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_set1_epi16(0xff), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_555_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgb_555_to_abgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 10), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i hi = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_set1_epi16(0xff), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_555_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgb_555_to_xbgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 10), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7);
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_555_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgb_555_to_xbgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 10), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i hi = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7);
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_555_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgb_555_to_rgbx_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8);
+         __m128i hi = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 10), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_555_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgb_555_to_rgbx_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8);
+         __m256i hi = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 10), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_555_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgb_555_to_xrgb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 10), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7);
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_555_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgb_555_to_xrgb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i hi = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 10), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7);
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_555_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgb_555_to_abgr_8888_le_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 10), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i hi = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_set1_epi16(0xff), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_555_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgb_555_to_abgr_8888_le_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 10), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i hi = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_set1_epi16(0xff), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_555_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgba_5551_to_argb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 1), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 6), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i hi = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_srli_epi16(p, 11), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1)), _mm_set1_epi16(255)), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_5551_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgba_5551_to_argb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 1), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 6), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i hi = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(p, 11), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1)), _mm256_set1_epi16(255)), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_5551_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgba_5551_to_rgba_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1)), _mm_set1_epi16(255)),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 1), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i hi = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 6), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_srli_epi16(p, 11), _mm_set1_epi16(1053)), 7), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_5551_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgba_5551_to_rgba_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1)), _mm256_set1_epi16(255)),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 1), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i hi = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 6), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(p, 11), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_5551_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgba_5551_to_abgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_srli_epi16(p, 11), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 6), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i hi = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 1), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1)), _mm_set1_epi16(255)), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_5551_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgba_5551_to_abgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(p, 11), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 6), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i hi = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 1), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1)), _mm256_set1_epi16(255)), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_5551_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgba_5551_to_xbgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_srli_epi16(p, 11), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 6), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 1), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7);
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_5551_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgba_5551_to_xbgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(p, 11), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 6), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i hi = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 1), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7);
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_5551_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgba_5551_to_rgbx_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 1), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8);
+         __m128i hi = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 6), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_srli_epi16(p, 11), _mm_set1_epi16(1053)), 7), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_5551_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgba_5551_to_rgbx_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 1), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8);
+         __m256i hi = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 6), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(p, 11), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_5551_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgba_5551_to_xrgb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 1), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 6), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_srli_epi16(p, 11), _mm_set1_epi16(1053)), 7);
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_5551_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgba_5551_to_xrgb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 1), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 6), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i hi = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(p, 11), _mm256_set1_epi16(1053)), 7);
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_5551_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgba_5551_to_abgr_8888_le_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_srli_epi16(p, 11), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 6), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i hi = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 1), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1)), _mm_set1_epi16(255)), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_5551_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgba_5551_to_abgr_8888_le_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(p, 11), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 6), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i hi = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 1), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1)), _mm256_set1_epi16(255)), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_5551_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void argb_1555_to_argb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i hi = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 10), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_mullo_epi16(_mm_srli_epi16(p, 15), _mm_set1_epi16(255)), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_1555_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void argb_1555_to_argb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i hi = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 10), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(p, 15), _mm256_set1_epi16(255)), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_1555_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void argb_1555_to_rgba_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_mullo_epi16(_mm_srli_epi16(p, 15), _mm_set1_epi16(255)),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i hi = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 10), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_1555_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void argb_1555_to_rgba_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_mullo_epi16(_mm256_srli_epi16(p, 15), _mm256_set1_epi16(255)),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i hi = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 10), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_1555_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void argb_1555_to_abgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 10), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i hi = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_mullo_epi16(_mm_srli_epi16(p, 15), _mm_set1_epi16(255)), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_1555_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void argb_1555_to_abgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 10), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i hi = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(p, 15), _mm256_set1_epi16(255)), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_1555_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void argb_1555_to_xbgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 10), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7);
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_1555_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void argb_1555_to_xbgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 10), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i hi = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7);
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_1555_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void argb_1555_to_rgbx_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8);
+         __m128i hi = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 10), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_1555_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void argb_1555_to_rgbx_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8);
+         __m256i hi = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 10), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_1555_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void argb_1555_to_xrgb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 10), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7);
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_1555_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void argb_1555_to_xrgb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i hi = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 10), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7);
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_1555_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void argb_1555_to_abgr_8888_le_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 10), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i hi = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_mullo_epi16(_mm_srli_epi16(p, 15), _mm_set1_epi16(255)), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_1555_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void argb_1555_to_abgr_8888_le_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 10), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i hi = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(p, 15), _mm256_set1_epi16(255)), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_1555_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void abgr_8888_to_argb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 16), _mm_set1_epi32(0x000000ff)),
+            _mm_and_si128(p, _mm_set1_epi32((int)0xff00ff00))),
+            _mm_and_si128(_mm_slli_epi32(p, 16), _mm_set1_epi32(0x00ff0000))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void abgr_8888_to_argb_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void abgr_8888_to_argb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15));
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void abgr_8888_to_rgba_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 24), _mm_set1_epi32(0x000000ff)),
+            _mm_and_si128(_mm_srli_epi32(p, 8), _mm_set1_epi32(0x0000ff00))),
+            _mm_and_si128(_mm_slli_epi32(p, 8), _mm_set1_epi32(0x00ff0000))),
+            _mm_and_si128(_mm_slli_epi32(p, 24), _mm_set1_epi32((int)0xff000000))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void abgr_8888_to_rgba_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void abgr_8888_to_rgba_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12));
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void abgr_8888_to_argb_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 28), _mm_set1_epi32(0xf)), 12),
+            _mm_and_si128(_mm_srli_epi32(a, 20), _mm_set1_epi32(0xf))),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 12), _mm_set1_epi32(0xf)), 4)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 4), _mm_set1_epi32(0xf)), 8));
+         b = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 28), _mm_set1_epi32(0xf)), 12),
+            _mm_and_si128(_mm_srli_epi32(b, 20), _mm_set1_epi32(0xf))),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 12), _mm_set1_epi32(0xf)), 4)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 4), _mm_set1_epi32(0xf)), 8));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void abgr_8888_to_argb_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 28), _mm256_set1_epi32(0xf)), 12),
+            _mm256_and_si256(_mm256_srli_epi32(a, 20), _mm256_set1_epi32(0xf))),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 12), _mm256_set1_epi32(0xf)), 4)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 4), _mm256_set1_epi32(0xf)), 8));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 28), _mm256_set1_epi32(0xf)), 12),
+            _mm256_and_si256(_mm256_srli_epi32(b, 20), _mm256_set1_epi32(0xf))),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 12), _mm256_set1_epi32(0xf)), 4)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 4), _mm256_set1_epi32(0xf)), 8));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void abgr_8888_to_rgb_888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, 0x80, 0x80, 0x80, 0x80);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m128i p0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle);
+         __m128i p1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 4)), shuffle);
+         __m128i p2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 8)), shuffle);
+         __m128i p3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 12)), shuffle);
+         __m128i *d = (__m128i *)(dst_ptr + x * 3);
+         _mm_storeu_si128(d + 0, _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+         _mm_storeu_si128(d + 1, _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+         _mm_storeu_si128(d + 2, _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_ABGR_8888_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void abgr_8888_to_rgb_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 10), _mm_set1_epi32(0x3f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 3), _mm_set1_epi32(0x1f)), 11));
+         b = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 10), _mm_set1_epi32(0x3f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 3), _mm_set1_epi32(0x1f)), 11));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void abgr_8888_to_rgb_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 10), _mm256_set1_epi32(0x3f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 3), _mm256_set1_epi32(0x1f)), 11));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 10), _mm256_set1_epi32(0x3f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 3), _mm256_set1_epi32(0x1f)), 11));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void abgr_8888_to_rgb_555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 3), _mm_set1_epi32(0x1f)), 10));
+         b = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 3), _mm_set1_epi32(0x1f)), 10));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void abgr_8888_to_rgb_555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 3), _mm256_set1_epi32(0x1f)), 10));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 3), _mm256_set1_epi32(0x1f)), 10));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void abgr_8888_to_rgba_5551_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(a, 31), _mm_set1_epi32(0x1)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)), 1)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f)), 6)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 3), _mm_set1_epi32(0x1f)), 11));
+         b = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(b, 31), _mm_set1_epi32(0x1)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)), 1)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f)), 6)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 3), _mm_set1_epi32(0x1f)), 11));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void abgr_8888_to_rgba_5551_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(a, 31), _mm256_set1_epi32(0x1)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)), 1)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f)), 6)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 3), _mm256_set1_epi32(0x1f)), 11));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(b, 31), _mm256_set1_epi32(0x1)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)), 1)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f)), 6)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 3), _mm256_set1_epi32(0x1f)), 11));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void abgr_8888_to_argb_1555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 31), _mm_set1_epi32(0x1)), 15),
+            _mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f))),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 3), _mm_set1_epi32(0x1f)), 10));
+         b = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 31), _mm_set1_epi32(0x1)), 15),
+            _mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f))),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 3), _mm_set1_epi32(0x1f)), 10));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void abgr_8888_to_argb_1555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 31), _mm256_set1_epi32(0x1)), 15),
+            _mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f))),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 3), _mm256_set1_epi32(0x1f)), 10));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 31), _mm256_set1_epi32(0x1)), 15),
+            _mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f))),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 3), _mm256_set1_epi32(0x1f)), 10));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void abgr_8888_to_xbgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_and_si128(p, _mm_set1_epi32(0x00ffffff)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void abgr_8888_to_xbgr_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(0, 1, 2, 0x80, 4, 5, 6, 0x80, 8, 9, 10, 0x80, 12, 13, 14, 0x80);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void abgr_8888_to_xbgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(0, 1, 2, 0x80, 4, 5, 6, 0x80, 8, 9, 10, 0x80, 12, 13, 14, 0x80));
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void abgr_8888_to_bgr_888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 0x80, 0x80, 0x80, 0x80);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m128i p0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle);
+         __m128i p1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 4)), shuffle);
+         __m128i p2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 8)), shuffle);
+         __m128i p3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 12)), shuffle);
+         __m128i *d = (__m128i *)(dst_ptr + x * 3);
+         _mm_storeu_si128(d + 0, _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+         _mm_storeu_si128(d + 1, _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+         _mm_storeu_si128(d + 2, _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_ABGR_8888_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void abgr_8888_to_bgr_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)), 11),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 10), _mm_set1_epi32(0x3f)), 5)),
+            _mm_and_si128(_mm_srli_epi32(a, 3), _mm_set1_epi32(0x1f)));
+         b = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)), 11),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 10), _mm_set1_epi32(0x3f)), 5)),
+            _mm_and_si128(_mm_srli_epi32(b, 3), _mm_set1_epi32(0x1f)));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void abgr_8888_to_bgr_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)), 11),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 10), _mm256_set1_epi32(0x3f)), 5)),
+            _mm256_and_si256(_mm256_srli_epi32(a, 3), _mm256_set1_epi32(0x1f)));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)), 11),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 10), _mm256_set1_epi32(0x3f)), 5)),
+            _mm256_and_si256(_mm256_srli_epi32(b, 3), _mm256_set1_epi32(0x1f)));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void abgr_8888_to_bgr_555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)), 10),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f)), 5)),
+            _mm_and_si128(_mm_srli_epi32(a, 3), _mm_set1_epi32(0x1f)));
+         b = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)), 10),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f)), 5)),
+            _mm_and_si128(_mm_srli_epi32(b, 3), _mm_set1_epi32(0x1f)));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void abgr_8888_to_bgr_555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)), 10),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_and_si256(_mm256_srli_epi32(a, 3), _mm256_set1_epi32(0x1f)));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)), 10),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_and_si256(_mm256_srli_epi32(b, 3), _mm256_set1_epi32(0x1f)));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void abgr_8888_to_rgbx_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 8), _mm_set1_epi32(0x0000ff00)),
+            _mm_and_si128(_mm_slli_epi32(p, 8), _mm_set1_epi32(0x00ff0000))),
+            _mm_and_si128(_mm_slli_epi32(p, 24), _mm_set1_epi32((int)0xff000000))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void abgr_8888_to_rgbx_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(0x80, 2, 1, 0, 0x80, 6, 5, 4, 0x80, 10, 9, 8, 0x80, 14, 13, 12);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void abgr_8888_to_rgbx_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(0x80, 2, 1, 0, 0x80, 6, 5, 4, 0x80, 10, 9, 8, 0x80, 14, 13, 12));
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void abgr_8888_to_xrgb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 16), _mm_set1_epi32(0x000000ff)),
+            _mm_and_si128(p, _mm_set1_epi32(0x0000ff00))),
+            _mm_and_si128(_mm_slli_epi32(p, 16), _mm_set1_epi32(0x00ff0000))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void abgr_8888_to_xrgb_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 0x80, 6, 5, 4, 0x80, 10, 9, 8, 0x80, 14, 13, 12, 0x80);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void abgr_8888_to_xrgb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(2, 1, 0, 0x80, 6, 5, 4, 0x80, 10, 9, 8, 0x80, 14, 13, 12, 0x80));
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void abgr_8888_to_abgr_8888_le_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void abgr_8888_to_abgr_8888_le_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void abgr_8888_to_abgr_8888_le_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void abgr_8888_to_rgba_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(a, 28), _mm_set1_epi32(0xf)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 20), _mm_set1_epi32(0xf)), 4)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 12), _mm_set1_epi32(0xf)), 8)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 4), _mm_set1_epi32(0xf)), 12));
+         b = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(b, 28), _mm_set1_epi32(0xf)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 20), _mm_set1_epi32(0xf)), 4)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 12), _mm_set1_epi32(0xf)), 8)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 4), _mm_set1_epi32(0xf)), 12));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void abgr_8888_to_rgba_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(a, 28), _mm256_set1_epi32(0xf)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 20), _mm256_set1_epi32(0xf)), 4)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 12), _mm256_set1_epi32(0xf)), 8)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 4), _mm256_set1_epi32(0xf)), 12));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(b, 28), _mm256_set1_epi32(0xf)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 20), _mm256_set1_epi32(0xf)), 4)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 12), _mm256_set1_epi32(0xf)), 8)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 4), _mm256_set1_epi32(0xf)), 12));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void xbgr_8888_to_argb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 16), _mm_set1_epi32(0x000000ff)),
+            _mm_and_si128(p, _mm_set1_epi32(0x0000ff00))),
+            _mm_and_si128(_mm_slli_epi32(p, 16), _mm_set1_epi32(0x00ff0000))),
+            _mm_set1_epi32((int)0xff000000)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void xbgr_8888_to_argb_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 0x80, 6, 5, 4, 0x80, 10, 9, 8, 0x80, 14, 13, 12, 0x80);
+   const __m128i fill = _mm_set1_epi32((int)0xff000000);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle), fill));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void xbgr_8888_to_argb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(2, 1, 0, 0x80, 6, 5, 4, 0x80, 10, 9, 8, 0x80, 14, 13, 12, 0x80));
+   const __m256i fill = _mm256_set1_epi32((int)0xff000000);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_or_si256(_mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle), fill));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void xbgr_8888_to_rgba_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 8), _mm_set1_epi32(0x0000ff00)),
+            _mm_and_si128(_mm_slli_epi32(p, 8), _mm_set1_epi32(0x00ff0000))),
+            _mm_and_si128(_mm_slli_epi32(p, 24), _mm_set1_epi32((int)0xff000000))),
+            _mm_set1_epi32(0x000000ff)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void xbgr_8888_to_rgba_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(0x80, 2, 1, 0, 0x80, 6, 5, 4, 0x80, 10, 9, 8, 0x80, 14, 13, 12);
+   const __m128i fill = _mm_set1_epi32(0x000000ff);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle), fill));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void xbgr_8888_to_rgba_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(0x80, 2, 1, 0, 0x80, 6, 5, 4, 0x80, 10, 9, 8, 0x80, 14, 13, 12));
+   const __m256i fill = _mm256_set1_epi32(0x000000ff);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_or_si256(_mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle), fill));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void xbgr_8888_to_argb_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(a, 20), _mm_set1_epi32(0xf)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 12), _mm_set1_epi32(0xf)), 4)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 4), _mm_set1_epi32(0xf)), 8)),
+            _mm_set1_epi32(0xf000));
+         b = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(b, 20), _mm_set1_epi32(0xf)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 12), _mm_set1_epi32(0xf)), 4)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 4), _mm_set1_epi32(0xf)), 8)),
+            _mm_set1_epi32(0xf000));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void xbgr_8888_to_argb_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(a, 20), _mm256_set1_epi32(0xf)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 12), _mm256_set1_epi32(0xf)), 4)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 4), _mm256_set1_epi32(0xf)), 8)),
+            _mm256_set1_epi32(0xf000));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(b, 20), _mm256_set1_epi32(0xf)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 12), _mm256_set1_epi32(0xf)), 4)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 4), _mm256_set1_epi32(0xf)), 8)),
+            _mm256_set1_epi32(0xf000));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void xbgr_8888_to_rgb_888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, 0x80, 0x80, 0x80, 0x80);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m128i p0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle);
+         __m128i p1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 4)), shuffle);
+         __m128i p2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 8)), shuffle);
+         __m128i p3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 12)), shuffle);
+         __m128i *d = (__m128i *)(dst_ptr + x * 3);
+         _mm_storeu_si128(d + 0, _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+         _mm_storeu_si128(d + 1, _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+         _mm_storeu_si128(d + 2, _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_XBGR_8888_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void xbgr_8888_to_rgb_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 10), _mm_set1_epi32(0x3f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 3), _mm_set1_epi32(0x1f)), 11));
+         b = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 10), _mm_set1_epi32(0x3f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 3), _mm_set1_epi32(0x1f)), 11));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void xbgr_8888_to_rgb_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 10), _mm256_set1_epi32(0x3f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 3), _mm256_set1_epi32(0x1f)), 11));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 10), _mm256_set1_epi32(0x3f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 3), _mm256_set1_epi32(0x1f)), 11));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void xbgr_8888_to_rgb_555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 3), _mm_set1_epi32(0x1f)), 10));
+         b = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 3), _mm_set1_epi32(0x1f)), 10));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void xbgr_8888_to_rgb_555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 3), _mm256_set1_epi32(0x1f)), 10));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 3), _mm256_set1_epi32(0x1f)), 10));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void xbgr_8888_to_rgba_5551_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)), 1),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f)), 6)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 3), _mm_set1_epi32(0x1f)), 11)),
+            _mm_set1_epi32(0x1));
+         b = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)), 1),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f)), 6)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 3), _mm_set1_epi32(0x1f)), 11)),
+            _mm_set1_epi32(0x1));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void xbgr_8888_to_rgba_5551_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)), 1),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f)), 6)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 3), _mm256_set1_epi32(0x1f)), 11)),
+            _mm256_set1_epi32(0x1));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)), 1),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f)), 6)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 3), _mm256_set1_epi32(0x1f)), 11)),
+            _mm256_set1_epi32(0x1));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void xbgr_8888_to_argb_1555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 3), _mm_set1_epi32(0x1f)), 10)),
+            _mm_set1_epi32(0x8000));
+         b = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 3), _mm_set1_epi32(0x1f)), 10)),
+            _mm_set1_epi32(0x8000));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void xbgr_8888_to_argb_1555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 3), _mm256_set1_epi32(0x1f)), 10)),
+            _mm256_set1_epi32(0x8000));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 3), _mm256_set1_epi32(0x1f)), 10)),
+            _mm256_set1_epi32(0x8000));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void xbgr_8888_to_abgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_and_si128(p, _mm_set1_epi32(0x00ffffff)),
+            _mm_set1_epi32((int)0xff000000)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void xbgr_8888_to_abgr_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(0, 1, 2, 0x80, 4, 5, 6, 0x80, 8, 9, 10, 0x80, 12, 13, 14, 0x80);
+   const __m128i fill = _mm_set1_epi32((int)0xff000000);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle), fill));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void xbgr_8888_to_abgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(0, 1, 2, 0x80, 4, 5, 6, 0x80, 8, 9, 10, 0x80, 12, 13, 14, 0x80));
+   const __m256i fill = _mm256_set1_epi32((int)0xff000000);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_or_si256(_mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle), fill));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void xbgr_8888_to_bgr_888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 0x80, 0x80, 0x80, 0x80);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m128i p0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle);
+         __m128i p1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 4)), shuffle);
+         __m128i p2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 8)), shuffle);
+         __m128i p3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 12)), shuffle);
+         __m128i *d = (__m128i *)(dst_ptr + x * 3);
+         _mm_storeu_si128(d + 0, _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+         _mm_storeu_si128(d + 1, _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+         _mm_storeu_si128(d + 2, _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_XBGR_8888_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void xbgr_8888_to_bgr_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)), 11),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 10), _mm_set1_epi32(0x3f)), 5)),
+            _mm_and_si128(_mm_srli_epi32(a, 3), _mm_set1_epi32(0x1f)));
+         b = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)), 11),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 10), _mm_set1_epi32(0x3f)), 5)),
+            _mm_and_si128(_mm_srli_epi32(b, 3), _mm_set1_epi32(0x1f)));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void xbgr_8888_to_bgr_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)), 11),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 10), _mm256_set1_epi32(0x3f)), 5)),
+            _mm256_and_si256(_mm256_srli_epi32(a, 3), _mm256_set1_epi32(0x1f)));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)), 11),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 10), _mm256_set1_epi32(0x3f)), 5)),
+            _mm256_and_si256(_mm256_srli_epi32(b, 3), _mm256_set1_epi32(0x1f)));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void xbgr_8888_to_bgr_555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)), 10),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f)), 5)),
+            _mm_and_si128(_mm_srli_epi32(a, 3), _mm_set1_epi32(0x1f)));
+         b = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)), 10),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f)), 5)),
+            _mm_and_si128(_mm_srli_epi32(b, 3), _mm_set1_epi32(0x1f)));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void xbgr_8888_to_bgr_555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)), 10),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_and_si256(_mm256_srli_epi32(a, 3), _mm256_set1_epi32(0x1f)));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)), 10),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_and_si256(_mm256_srli_epi32(b, 3), _mm256_set1_epi32(0x1f)));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void xbgr_8888_to_rgbx_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 8), _mm_set1_epi32(0x0000ff00)),
+            _mm_and_si128(_mm_slli_epi32(p, 8), _mm_set1_epi32(0x00ff0000))),
+            _mm_and_si128(_mm_slli_epi32(p, 24), _mm_set1_epi32((int)0xff000000))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void xbgr_8888_to_rgbx_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(0x80, 2, 1, 0, 0x80, 6, 5, 4, 0x80, 10, 9, 8, 0x80, 14, 13, 12);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void xbgr_8888_to_rgbx_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(0x80, 2, 1, 0, 0x80, 6, 5, 4, 0x80, 10, 9, 8, 0x80, 14, 13, 12));
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void xbgr_8888_to_xrgb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 16), _mm_set1_epi32(0x000000ff)),
+            _mm_and_si128(p, _mm_set1_epi32(0x0000ff00))),
+            _mm_and_si128(_mm_slli_epi32(p, 16), _mm_set1_epi32(0x00ff0000))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void xbgr_8888_to_xrgb_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 0x80, 6, 5, 4, 0x80, 10, 9, 8, 0x80, 14, 13, 12, 0x80);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void xbgr_8888_to_xrgb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(2, 1, 0, 0x80, 6, 5, 4, 0x80, 10, 9, 8, 0x80, 14, 13, 12, 0x80));
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void xbgr_8888_to_abgr_8888_le_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_and_si128(p, _mm_set1_epi32(0x00ffffff)),
+            _mm_set1_epi32((int)0xff000000)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void xbgr_8888_to_abgr_8888_le_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(0, 1, 2, 0x80, 4, 5, 6, 0x80, 8, 9, 10, 0x80, 12, 13, 14, 0x80);
+   const __m128i fill = _mm_set1_epi32((int)0xff000000);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle), fill));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void xbgr_8888_to_abgr_8888_le_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(0, 1, 2, 0x80, 4, 5, 6, 0x80, 8, 9, 10, 0x80, 12, 13, 14, 0x80));
+   const __m256i fill = _mm256_set1_epi32((int)0xff000000);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_or_si256(_mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle), fill));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void xbgr_8888_to_rgba_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 20), _mm_set1_epi32(0xf)), 4),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 12), _mm_set1_epi32(0xf)), 8)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 4), _mm_set1_epi32(0xf)), 12)),
+            _mm_set1_epi32(0xf));
+         b = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 20), _mm_set1_epi32(0xf)), 4),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 12), _mm_set1_epi32(0xf)), 8)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 4), _mm_set1_epi32(0xf)), 12)),
+            _mm_set1_epi32(0xf));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void xbgr_8888_to_rgba_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 20), _mm256_set1_epi32(0xf)), 4),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 12), _mm256_set1_epi32(0xf)), 8)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 4), _mm256_set1_epi32(0xf)), 12)),
+            _mm256_set1_epi32(0xf));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 20), _mm256_set1_epi32(0xf)), 4),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 12), _mm256_set1_epi32(0xf)), 8)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 4), _mm256_set1_epi32(0xf)), 12)),
+            _mm256_set1_epi32(0xf));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void bgr_888_to_argb_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 0x80, 5, 4, 3, 0x80, 8, 7, 6, 0x80, 11, 10, 9, 0x80);
+   const __m128i fill = _mm_set1_epi32((int)0xff000000);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint8_t *src_ptr = (const uint8_t *)((const char *)src + (sy + y) * src_pitch) + sx * 3;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         const __m128i *s = (const __m128i *)(src_ptr + x * 3);
+         __m128i s0 = _mm_loadu_si128(s + 0);
+         __m128i s1 = _mm_loadu_si128(s + 1);
+         __m128i s2 = _mm_loadu_si128(s + 2);
+         __m128i p[4];
+         int i;
+         p[0] = s0;
+         p[1] = _mm_alignr_epi8(s1, s0, 12);
+         p[2] = _mm_alignr_epi8(s2, s1, 8);
+         p[3] = _mm_srli_si128(s2, 4);
+         for (i = 0; i < 4; i++) {
+            _mm_storeu_si128((__m128i *)(dst_ptr + x + i * 4),
+               _mm_or_si128(_mm_shuffle_epi8(p[i], shuffle), fill));
+         }
+      }
+      for (; x < width; x++) {
+         const uint8_t *p = src_ptr + x * 3;
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_888_TO_ARGB_8888(p[0] | (p[1] << 8) | (p[2] << 16));
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void bgr_888_to_rgba_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(0x80, 2, 1, 0, 0x80, 5, 4, 3, 0x80, 8, 7, 6, 0x80, 11, 10, 9);
+   const __m128i fill = _mm_set1_epi32(0x000000ff);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint8_t *src_ptr = (const uint8_t *)((const char *)src + (sy + y) * src_pitch) + sx * 3;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         const __m128i *s = (const __m128i *)(src_ptr + x * 3);
+         __m128i s0 = _mm_loadu_si128(s + 0);
+         __m128i s1 = _mm_loadu_si128(s + 1);
+         __m128i s2 = _mm_loadu_si128(s + 2);
+         __m128i p[4];
+         int i;
+         p[0] = s0;
+         p[1] = _mm_alignr_epi8(s1, s0, 12);
+         p[2] = _mm_alignr_epi8(s2, s1, 8);
+         p[3] = _mm_srli_si128(s2, 4);
+         for (i = 0; i < 4; i++) {
+            _mm_storeu_si128((__m128i *)(dst_ptr + x + i * 4),
+               _mm_or_si128(_mm_shuffle_epi8(p[i], shuffle), fill));
+         }
+      }
+      for (; x < width; x++) {
+         const uint8_t *p = src_ptr + x * 3;
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_888_TO_RGBA_8888(p[0] | (p[1] << 8) | (p[2] << 16));
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void bgr_888_to_abgr_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(0, 1, 2, 0x80, 3, 4, 5, 0x80, 6, 7, 8, 0x80, 9, 10, 11, 0x80);
+   const __m128i fill = _mm_set1_epi32((int)0xff000000);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint8_t *src_ptr = (const uint8_t *)((const char *)src + (sy + y) * src_pitch) + sx * 3;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         const __m128i *s = (const __m128i *)(src_ptr + x * 3);
+         __m128i s0 = _mm_loadu_si128(s + 0);
+         __m128i s1 = _mm_loadu_si128(s + 1);
+         __m128i s2 = _mm_loadu_si128(s + 2);
+         __m128i p[4];
+         int i;
+         p[0] = s0;
+         p[1] = _mm_alignr_epi8(s1, s0, 12);
+         p[2] = _mm_alignr_epi8(s2, s1, 8);
+         p[3] = _mm_srli_si128(s2, 4);
+         for (i = 0; i < 4; i++) {
+            _mm_storeu_si128((__m128i *)(dst_ptr + x + i * 4),
+               _mm_or_si128(_mm_shuffle_epi8(p[i], shuffle), fill));
+         }
+      }
+      for (; x < width; x++) {
+         const uint8_t *p = src_ptr + x * 3;
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_888_TO_ABGR_8888(p[0] | (p[1] << 8) | (p[2] << 16));
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void bgr_888_to_xbgr_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(0, 1, 2, 0x80, 3, 4, 5, 0x80, 6, 7, 8, 0x80, 9, 10, 11, 0x80);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint8_t *src_ptr = (const uint8_t *)((const char *)src + (sy + y) * src_pitch) + sx * 3;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         const __m128i *s = (const __m128i *)(src_ptr + x * 3);
+         __m128i s0 = _mm_loadu_si128(s + 0);
+         __m128i s1 = _mm_loadu_si128(s + 1);
+         __m128i s2 = _mm_loadu_si128(s + 2);
+         __m128i p[4];
+         int i;
+         p[0] = s0;
+         p[1] = _mm_alignr_epi8(s1, s0, 12);
+         p[2] = _mm_alignr_epi8(s2, s1, 8);
+         p[3] = _mm_srli_si128(s2, 4);
+         for (i = 0; i < 4; i++) {
+            _mm_storeu_si128((__m128i *)(dst_ptr + x + i * 4),
+               _mm_shuffle_epi8(p[i], shuffle));
+         }
+      }
+      for (; x < width; x++) {
+         const uint8_t *p = src_ptr + x * 3;
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_888_TO_XBGR_8888(p[0] | (p[1] << 8) | (p[2] << 16));
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void bgr_888_to_rgbx_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(0x80, 2, 1, 0, 0x80, 5, 4, 3, 0x80, 8, 7, 6, 0x80, 11, 10, 9);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint8_t *src_ptr = (const uint8_t *)((const char *)src + (sy + y) * src_pitch) + sx * 3;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         const __m128i *s = (const __m128i *)(src_ptr + x * 3);
+         __m128i s0 = _mm_loadu_si128(s + 0);
+         __m128i s1 = _mm_loadu_si128(s + 1);
+         __m128i s2 = _mm_loadu_si128(s + 2);
+         __m128i p[4];
+         int i;
+         p[0] = s0;
+         p[1] = _mm_alignr_epi8(s1, s0, 12);
+         p[2] = _mm_alignr_epi8(s2, s1, 8);
+         p[3] = _mm_srli_si128(s2, 4);
+         for (i = 0; i < 4; i++) {
+            _mm_storeu_si128((__m128i *)(dst_ptr + x + i * 4),
+               _mm_shuffle_epi8(p[i], shuffle));
+         }
+      }
+      for (; x < width; x++) {
+         const uint8_t *p = src_ptr + x * 3;
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_888_TO_RGBX_8888(p[0] | (p[1] << 8) | (p[2] << 16));
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void bgr_888_to_xrgb_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 0x80, 5, 4, 3, 0x80, 8, 7, 6, 0x80, 11, 10, 9, 0x80);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint8_t *src_ptr = (const uint8_t *)((const char *)src + (sy + y) * src_pitch) + sx * 3;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         const __m128i *s = (const __m128i *)(src_ptr + x * 3);
+         __m128i s0 = _mm_loadu_si128(s + 0);
+         __m128i s1 = _mm_loadu_si128(s + 1);
+         __m128i s2 = _mm_loadu_si128(s + 2);
+         __m128i p[4];
+         int i;
+         p[0] = s0;
+         p[1] = _mm_alignr_epi8(s1, s0, 12);
+         p[2] = _mm_alignr_epi8(s2, s1, 8);
+         p[3] = _mm_srli_si128(s2, 4);
+         for (i = 0; i < 4; i++) {
+            _mm_storeu_si128((__m128i *)(dst_ptr + x + i * 4),
+               _mm_shuffle_epi8(p[i], shuffle));
+         }
+      }
+      for (; x < width; x++) {
+         const uint8_t *p = src_ptr + x * 3;
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_888_TO_XRGB_8888(p[0] | (p[1] << 8) | (p[2] << 16));
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void bgr_888_to_abgr_8888_le_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(0, 1, 2, 0x80, 3, 4, 5, 0x80, 6, 7, 8, 0x80, 9, 10, 11, 0x80);
+   const __m128i fill = _mm_set1_epi32((int)0xff000000);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint8_t *src_ptr = (const uint8_t *)((const char *)src + (sy + y) * src_pitch) + sx * 3;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         const __m128i *s = (const __m128i *)(src_ptr + x * 3);
+         __m128i s0 = _mm_loadu_si128(s + 0);
+         __m128i s1 = _mm_loadu_si128(s + 1);
+         __m128i s2 = _mm_loadu_si128(s + 2);
+         __m128i p[4];
+         int i;
+         p[0] = s0;
+         p[1] = _mm_alignr_epi8(s1, s0, 12);
+         p[2] = _mm_alignr_epi8(s2, s1, 8);
+         p[3] = _mm_srli_si128(s2, 4);
+         for (i = 0; i < 4; i++) {
+            _mm_storeu_si128((__m128i *)(dst_ptr + x + i * 4),
+               _mm_or_si128(_mm_shuffle_epi8(p[i], shuffle), fill));
+         }
+      }
+      for (; x < width; x++) {
+         const uint8_t *p = src_ptr + x * 3;
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_888_TO_ABGR_8888_LE(p[0] | (p[1] << 8) | (p[2] << 16));
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void bgr_565_to_argb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_srli_epi16(p, 11), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mulhi_epu16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x3f)), _mm_set1_epi16(255)), _mm_set1_epi16(8323)), 3), 8));
+         __m128i hi = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_set1_epi16(0xff), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_565_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void bgr_565_to_argb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(p, 11), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x3f)), _mm256_set1_epi16(255)), _mm256_set1_epi16(8323)), 3), 8));
+         __m256i hi = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_set1_epi16(0xff), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_565_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void bgr_565_to_rgba_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_set1_epi16(0xff),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_srli_epi16(p, 11), _mm_set1_epi16(1053)), 7), 8));
+         __m128i hi = _mm_or_si128(_mm_srli_epi16(_mm_mulhi_epu16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x3f)), _mm_set1_epi16(255)), _mm_set1_epi16(8323)), 3),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_565_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void bgr_565_to_rgba_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_set1_epi16(0xff),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(p, 11), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i hi = _mm256_or_si256(_mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x3f)), _mm256_set1_epi16(255)), _mm256_set1_epi16(8323)), 3),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_565_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void bgr_565_to_abgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mulhi_epu16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x3f)), _mm_set1_epi16(255)), _mm_set1_epi16(8323)), 3), 8));
+         __m128i hi = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_srli_epi16(p, 11), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_set1_epi16(0xff), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_565_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void bgr_565_to_abgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x3f)), _mm256_set1_epi16(255)), _mm256_set1_epi16(8323)), 3), 8));
+         __m256i hi = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(p, 11), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_set1_epi16(0xff), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_565_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void bgr_565_to_xbgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mulhi_epu16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x3f)), _mm_set1_epi16(255)), _mm_set1_epi16(8323)), 3), 8));
+         __m128i hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_srli_epi16(p, 11), _mm_set1_epi16(1053)), 7);
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_565_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void bgr_565_to_xbgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x3f)), _mm256_set1_epi16(255)), _mm256_set1_epi16(8323)), 3), 8));
+         __m256i hi = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(p, 11), _mm256_set1_epi16(1053)), 7);
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_565_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void bgr_565_to_rgbx_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_srli_epi16(p, 11), _mm_set1_epi16(1053)), 7), 8);
+         __m128i hi = _mm_or_si128(_mm_srli_epi16(_mm_mulhi_epu16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x3f)), _mm_set1_epi16(255)), _mm_set1_epi16(8323)), 3),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_565_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void bgr_565_to_rgbx_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(p, 11), _mm256_set1_epi16(1053)), 7), 8);
+         __m256i hi = _mm256_or_si256(_mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x3f)), _mm256_set1_epi16(255)), _mm256_set1_epi16(8323)), 3),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_565_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void bgr_565_to_xrgb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_srli_epi16(p, 11), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mulhi_epu16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x3f)), _mm_set1_epi16(255)), _mm_set1_epi16(8323)), 3), 8));
+         __m128i hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7);
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_565_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void bgr_565_to_xrgb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(p, 11), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x3f)), _mm256_set1_epi16(255)), _mm256_set1_epi16(8323)), 3), 8));
+         __m256i hi = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7);
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_565_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void bgr_565_to_abgr_8888_le_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mulhi_epu16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x3f)), _mm_set1_epi16(255)), _mm_set1_epi16(8323)), 3), 8));
+         __m128i hi = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_srli_epi16(p, 11), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_set1_epi16(0xff), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_565_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void bgr_565_to_abgr_8888_le_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x3f)), _mm256_set1_epi16(255)), _mm256_set1_epi16(8323)), 3), 8));
+         __m256i hi = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(p, 11), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_set1_epi16(0xff), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_565_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void bgr_555_to_argb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 10), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i hi = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_set1_epi16(0xff), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_555_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void bgr_555_to_argb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 10), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i hi = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_set1_epi16(0xff), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_555_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void bgr_555_to_rgba_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_set1_epi16(0xff),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 10), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i hi = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_555_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void bgr_555_to_rgba_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_set1_epi16(0xff),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 10), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i hi = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_555_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void bgr_555_to_abgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i hi = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 10), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_set1_epi16(0xff), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_555_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void bgr_555_to_abgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i hi = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 10), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_set1_epi16(0xff), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_555_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void bgr_555_to_xbgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 10), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7);
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_555_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void bgr_555_to_xbgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i hi = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 10), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7);
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_555_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void bgr_555_to_rgbx_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 10), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8);
+         __m128i hi = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_555_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void bgr_555_to_rgbx_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 10), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8);
+         __m256i hi = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_555_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void bgr_555_to_xrgb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 10), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7);
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_555_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void bgr_555_to_xrgb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 10), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i hi = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7);
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_555_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void bgr_555_to_abgr_8888_le_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7), 8));
+         __m128i hi = _mm_or_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 10), _mm_set1_epi16(0x1f)), _mm_set1_epi16(1053)), 7),
+            _mm_slli_epi16(_mm_set1_epi16(0xff), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_555_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void bgr_555_to_abgr_8888_le_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7), 8));
+         __m256i hi = _mm256_or_si256(_mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 10), _mm256_set1_epi16(0x1f)), _mm256_set1_epi16(1053)), 7),
+            _mm256_slli_epi16(_mm256_set1_epi16(0xff), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_555_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgbx_8888_to_argb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 8), _mm_set1_epi32(0x00ffffff)),
+            _mm_set1_epi32((int)0xff000000)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void rgbx_8888_to_argb_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(1, 2, 3, 0x80, 5, 6, 7, 0x80, 9, 10, 11, 0x80, 13, 14, 15, 0x80);
+   const __m128i fill = _mm_set1_epi32((int)0xff000000);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle), fill));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgbx_8888_to_argb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(1, 2, 3, 0x80, 5, 6, 7, 0x80, 9, 10, 11, 0x80, 13, 14, 15, 0x80));
+   const __m256i fill = _mm256_set1_epi32((int)0xff000000);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_or_si256(_mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle), fill));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgbx_8888_to_rgba_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_and_si128(p, _mm_set1_epi32((int)0xffffff00)),
+            _mm_set1_epi32(0x000000ff)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void rgbx_8888_to_rgba_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(0x80, 1, 2, 3, 0x80, 5, 6, 7, 0x80, 9, 10, 11, 0x80, 13, 14, 15);
+   const __m128i fill = _mm_set1_epi32(0x000000ff);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle), fill));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgbx_8888_to_rgba_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(0x80, 1, 2, 3, 0x80, 5, 6, 7, 0x80, 9, 10, 11, 0x80, 13, 14, 15));
+   const __m256i fill = _mm256_set1_epi32(0x000000ff);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_or_si256(_mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle), fill));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgbx_8888_to_argb_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(a, 12), _mm_set1_epi32(0xf)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 20), _mm_set1_epi32(0xf)), 4)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 28), _mm_set1_epi32(0xf)), 8)),
+            _mm_set1_epi32(0xf000));
+         b = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(b, 12), _mm_set1_epi32(0xf)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 20), _mm_set1_epi32(0xf)), 4)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 28), _mm_set1_epi32(0xf)), 8)),
+            _mm_set1_epi32(0xf000));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgbx_8888_to_argb_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(a, 12), _mm256_set1_epi32(0xf)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 20), _mm256_set1_epi32(0xf)), 4)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 28), _mm256_set1_epi32(0xf)), 8)),
+            _mm256_set1_epi32(0xf000));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(b, 12), _mm256_set1_epi32(0xf)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 20), _mm256_set1_epi32(0xf)), 4)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 28), _mm256_set1_epi32(0xf)), 8)),
+            _mm256_set1_epi32(0xf000));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void rgbx_8888_to_rgb_888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(1, 2, 3, 5, 6, 7, 9, 10, 11, 13, 14, 15, 0x80, 0x80, 0x80, 0x80);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m128i p0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle);
+         __m128i p1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 4)), shuffle);
+         __m128i p2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 8)), shuffle);
+         __m128i p3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 12)), shuffle);
+         __m128i *d = (__m128i *)(dst_ptr + x * 3);
+         _mm_storeu_si128(d + 0, _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+         _mm_storeu_si128(d + 1, _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+         _mm_storeu_si128(d + 2, _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_RGBX_8888_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgbx_8888_to_rgb_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 18), _mm_set1_epi32(0x3f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 27), _mm_set1_epi32(0x1f)), 11));
+         b = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 18), _mm_set1_epi32(0x3f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 27), _mm_set1_epi32(0x1f)), 11));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgbx_8888_to_rgb_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 18), _mm256_set1_epi32(0x3f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 27), _mm256_set1_epi32(0x1f)), 11));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 18), _mm256_set1_epi32(0x3f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 27), _mm256_set1_epi32(0x1f)), 11));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgbx_8888_to_rgb_555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 27), _mm_set1_epi32(0x1f)), 10));
+         b = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 27), _mm_set1_epi32(0x1f)), 10));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgbx_8888_to_rgb_555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 27), _mm256_set1_epi32(0x1f)), 10));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 27), _mm256_set1_epi32(0x1f)), 10));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgbx_8888_to_rgba_5551_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f)), 1),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)), 6)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 27), _mm_set1_epi32(0x1f)), 11)),
+            _mm_set1_epi32(0x1));
+         b = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f)), 1),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)), 6)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 27), _mm_set1_epi32(0x1f)), 11)),
+            _mm_set1_epi32(0x1));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgbx_8888_to_rgba_5551_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f)), 1),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)), 6)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 27), _mm256_set1_epi32(0x1f)), 11)),
+            _mm256_set1_epi32(0x1));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f)), 1),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)), 6)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 27), _mm256_set1_epi32(0x1f)), 11)),
+            _mm256_set1_epi32(0x1));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgbx_8888_to_argb_1555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 27), _mm_set1_epi32(0x1f)), 10)),
+            _mm_set1_epi32(0x8000));
+         b = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 27), _mm_set1_epi32(0x1f)), 10)),
+            _mm_set1_epi32(0x8000));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgbx_8888_to_argb_1555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 27), _mm256_set1_epi32(0x1f)), 10)),
+            _mm256_set1_epi32(0x8000));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 27), _mm256_set1_epi32(0x1f)), 10)),
+            _mm256_set1_epi32(0x8000));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgbx_8888_to_abgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 24), _mm_set1_epi32(0x000000ff)),
+            _mm_and_si128(_mm_srli_epi32(p, 8), _mm_set1_epi32(0x0000ff00))),
+            _mm_and_si128(_mm_slli_epi32(p, 8), _mm_set1_epi32(0x00ff0000))),
+            _mm_set1_epi32((int)0xff000000)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void rgbx_8888_to_abgr_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(3, 2, 1, 0x80, 7, 6, 5, 0x80, 11, 10, 9, 0x80, 15, 14, 13, 0x80);
+   const __m128i fill = _mm_set1_epi32((int)0xff000000);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle), fill));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgbx_8888_to_abgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(3, 2, 1, 0x80, 7, 6, 5, 0x80, 11, 10, 9, 0x80, 15, 14, 13, 0x80));
+   const __m256i fill = _mm256_set1_epi32((int)0xff000000);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_or_si256(_mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle), fill));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgbx_8888_to_xbgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 24), _mm_set1_epi32(0x000000ff)),
+            _mm_and_si128(_mm_srli_epi32(p, 8), _mm_set1_epi32(0x0000ff00))),
+            _mm_and_si128(_mm_slli_epi32(p, 8), _mm_set1_epi32(0x00ff0000))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void rgbx_8888_to_xbgr_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(3, 2, 1, 0x80, 7, 6, 5, 0x80, 11, 10, 9, 0x80, 15, 14, 13, 0x80);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgbx_8888_to_xbgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(3, 2, 1, 0x80, 7, 6, 5, 0x80, 11, 10, 9, 0x80, 15, 14, 13, 0x80));
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void rgbx_8888_to_bgr_888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(3, 2, 1, 7, 6, 5, 11, 10, 9, 15, 14, 13, 0x80, 0x80, 0x80, 0x80);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m128i p0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle);
+         __m128i p1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 4)), shuffle);
+         __m128i p2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 8)), shuffle);
+         __m128i p3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 12)), shuffle);
+         __m128i *d = (__m128i *)(dst_ptr + x * 3);
+         _mm_storeu_si128(d + 0, _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+         _mm_storeu_si128(d + 1, _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+         _mm_storeu_si128(d + 2, _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_RGBX_8888_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgbx_8888_to_bgr_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f)), 11),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 18), _mm_set1_epi32(0x3f)), 5)),
+            _mm_and_si128(_mm_srli_epi32(a, 27), _mm_set1_epi32(0x1f)));
+         b = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f)), 11),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 18), _mm_set1_epi32(0x3f)), 5)),
+            _mm_and_si128(_mm_srli_epi32(b, 27), _mm_set1_epi32(0x1f)));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgbx_8888_to_bgr_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f)), 11),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 18), _mm256_set1_epi32(0x3f)), 5)),
+            _mm256_and_si256(_mm256_srli_epi32(a, 27), _mm256_set1_epi32(0x1f)));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f)), 11),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 18), _mm256_set1_epi32(0x3f)), 5)),
+            _mm256_and_si256(_mm256_srli_epi32(b, 27), _mm256_set1_epi32(0x1f)));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgbx_8888_to_bgr_555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f)), 10),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)), 5)),
+            _mm_and_si128(_mm_srli_epi32(a, 27), _mm_set1_epi32(0x1f)));
+         b = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f)), 10),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)), 5)),
+            _mm_and_si128(_mm_srli_epi32(b, 27), _mm_set1_epi32(0x1f)));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgbx_8888_to_bgr_555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f)), 10),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_and_si256(_mm256_srli_epi32(a, 27), _mm256_set1_epi32(0x1f)));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f)), 10),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_and_si256(_mm256_srli_epi32(b, 27), _mm256_set1_epi32(0x1f)));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgbx_8888_to_xrgb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_and_si128(_mm_srli_epi32(p, 8), _mm_set1_epi32(0x00ffffff)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void rgbx_8888_to_xrgb_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(1, 2, 3, 0x80, 5, 6, 7, 0x80, 9, 10, 11, 0x80, 13, 14, 15, 0x80);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgbx_8888_to_xrgb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(1, 2, 3, 0x80, 5, 6, 7, 0x80, 9, 10, 11, 0x80, 13, 14, 15, 0x80));
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgbx_8888_to_abgr_8888_le_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 24), _mm_set1_epi32(0x000000ff)),
+            _mm_and_si128(_mm_srli_epi32(p, 8), _mm_set1_epi32(0x0000ff00))),
+            _mm_and_si128(_mm_slli_epi32(p, 8), _mm_set1_epi32(0x00ff0000))),
+            _mm_set1_epi32((int)0xff000000)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void rgbx_8888_to_abgr_8888_le_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(3, 2, 1, 0x80, 7, 6, 5, 0x80, 11, 10, 9, 0x80, 15, 14, 13, 0x80);
+   const __m128i fill = _mm_set1_epi32((int)0xff000000);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle), fill));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgbx_8888_to_abgr_8888_le_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(3, 2, 1, 0x80, 7, 6, 5, 0x80, 11, 10, 9, 0x80, 15, 14, 13, 0x80));
+   const __m256i fill = _mm256_set1_epi32((int)0xff000000);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_or_si256(_mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle), fill));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgbx_8888_to_rgba_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 12), _mm_set1_epi32(0xf)), 4),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 20), _mm_set1_epi32(0xf)), 8)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 28), _mm_set1_epi32(0xf)), 12)),
+            _mm_set1_epi32(0xf));
+         b = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 12), _mm_set1_epi32(0xf)), 4),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 20), _mm_set1_epi32(0xf)), 8)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 28), _mm_set1_epi32(0xf)), 12)),
+            _mm_set1_epi32(0xf));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgbx_8888_to_rgba_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 12), _mm256_set1_epi32(0xf)), 4),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 20), _mm256_set1_epi32(0xf)), 8)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 28), _mm256_set1_epi32(0xf)), 12)),
+            _mm256_set1_epi32(0xf));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 12), _mm256_set1_epi32(0xf)), 4),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 20), _mm256_set1_epi32(0xf)), 8)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 28), _mm256_set1_epi32(0xf)), 12)),
+            _mm256_set1_epi32(0xf));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void xrgb_8888_to_argb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_and_si128(p, _mm_set1_epi32(0x00ffffff)),
+            _mm_set1_epi32((int)0xff000000)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void xrgb_8888_to_argb_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(0, 1, 2, 0x80, 4, 5, 6, 0x80, 8, 9, 10, 0x80, 12, 13, 14, 0x80);
+   const __m128i fill = _mm_set1_epi32((int)0xff000000);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle), fill));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void xrgb_8888_to_argb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(0, 1, 2, 0x80, 4, 5, 6, 0x80, 8, 9, 10, 0x80, 12, 13, 14, 0x80));
+   const __m256i fill = _mm256_set1_epi32((int)0xff000000);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_or_si256(_mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle), fill));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void xrgb_8888_to_rgba_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_and_si128(_mm_slli_epi32(p, 8), _mm_set1_epi32((int)0xffffff00)),
+            _mm_set1_epi32(0x000000ff)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void xrgb_8888_to_rgba_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(0x80, 0, 1, 2, 0x80, 4, 5, 6, 0x80, 8, 9, 10, 0x80, 12, 13, 14);
+   const __m128i fill = _mm_set1_epi32(0x000000ff);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle), fill));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void xrgb_8888_to_rgba_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(0x80, 0, 1, 2, 0x80, 4, 5, 6, 0x80, 8, 9, 10, 0x80, 12, 13, 14));
+   const __m256i fill = _mm256_set1_epi32(0x000000ff);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_or_si256(_mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle), fill));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void xrgb_8888_to_argb_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(a, 4), _mm_set1_epi32(0xf)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 12), _mm_set1_epi32(0xf)), 4)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 20), _mm_set1_epi32(0xf)), 8)),
+            _mm_set1_epi32(0xf000));
+         b = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(b, 4), _mm_set1_epi32(0xf)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 12), _mm_set1_epi32(0xf)), 4)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 20), _mm_set1_epi32(0xf)), 8)),
+            _mm_set1_epi32(0xf000));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void xrgb_8888_to_argb_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(a, 4), _mm256_set1_epi32(0xf)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 12), _mm256_set1_epi32(0xf)), 4)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 20), _mm256_set1_epi32(0xf)), 8)),
+            _mm256_set1_epi32(0xf000));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(b, 4), _mm256_set1_epi32(0xf)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 12), _mm256_set1_epi32(0xf)), 4)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 20), _mm256_set1_epi32(0xf)), 8)),
+            _mm256_set1_epi32(0xf000));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void xrgb_8888_to_rgb_888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 0x80, 0x80, 0x80, 0x80);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m128i p0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle);
+         __m128i p1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 4)), shuffle);
+         __m128i p2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 8)), shuffle);
+         __m128i p3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 12)), shuffle);
+         __m128i *d = (__m128i *)(dst_ptr + x * 3);
+         _mm_storeu_si128(d + 0, _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+         _mm_storeu_si128(d + 1, _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+         _mm_storeu_si128(d + 2, _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_XRGB_8888_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void xrgb_8888_to_rgb_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(a, 3), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 10), _mm_set1_epi32(0x3f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)), 11));
+         b = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(b, 3), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 10), _mm_set1_epi32(0x3f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)), 11));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void xrgb_8888_to_rgb_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(a, 3), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 10), _mm256_set1_epi32(0x3f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)), 11));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(b, 3), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 10), _mm256_set1_epi32(0x3f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)), 11));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void xrgb_8888_to_rgb_555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(a, 3), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)), 10));
+         b = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(b, 3), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)), 10));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void xrgb_8888_to_rgb_555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(a, 3), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)), 10));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(b, 3), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)), 10));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void xrgb_8888_to_rgba_5551_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 3), _mm_set1_epi32(0x1f)), 1),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f)), 6)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)), 11)),
+            _mm_set1_epi32(0x1));
+         b = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 3), _mm_set1_epi32(0x1f)), 1),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f)), 6)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)), 11)),
+            _mm_set1_epi32(0x1));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void xrgb_8888_to_rgba_5551_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 3), _mm256_set1_epi32(0x1f)), 1),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f)), 6)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)), 11)),
+            _mm256_set1_epi32(0x1));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 3), _mm256_set1_epi32(0x1f)), 1),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f)), 6)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)), 11)),
+            _mm256_set1_epi32(0x1));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void xrgb_8888_to_argb_1555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(a, 3), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)), 10)),
+            _mm_set1_epi32(0x8000));
+         b = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(b, 3), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)), 10)),
+            _mm_set1_epi32(0x8000));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void xrgb_8888_to_argb_1555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(a, 3), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)), 10)),
+            _mm256_set1_epi32(0x8000));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(b, 3), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)), 10)),
+            _mm256_set1_epi32(0x8000));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void xrgb_8888_to_abgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 16), _mm_set1_epi32(0x000000ff)),
+            _mm_and_si128(p, _mm_set1_epi32(0x0000ff00))),
+            _mm_and_si128(_mm_slli_epi32(p, 16), _mm_set1_epi32(0x00ff0000))),
+            _mm_set1_epi32((int)0xff000000)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void xrgb_8888_to_abgr_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 0x80, 6, 5, 4, 0x80, 10, 9, 8, 0x80, 14, 13, 12, 0x80);
+   const __m128i fill = _mm_set1_epi32((int)0xff000000);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle), fill));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void xrgb_8888_to_abgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(2, 1, 0, 0x80, 6, 5, 4, 0x80, 10, 9, 8, 0x80, 14, 13, 12, 0x80));
+   const __m256i fill = _mm256_set1_epi32((int)0xff000000);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_or_si256(_mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle), fill));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void xrgb_8888_to_xbgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 16), _mm_set1_epi32(0x000000ff)),
+            _mm_and_si128(p, _mm_set1_epi32(0x0000ff00))),
+            _mm_and_si128(_mm_slli_epi32(p, 16), _mm_set1_epi32(0x00ff0000))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void xrgb_8888_to_xbgr_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 0x80, 6, 5, 4, 0x80, 10, 9, 8, 0x80, 14, 13, 12, 0x80);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void xrgb_8888_to_xbgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(2, 1, 0, 0x80, 6, 5, 4, 0x80, 10, 9, 8, 0x80, 14, 13, 12, 0x80));
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void xrgb_8888_to_bgr_888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, 0x80, 0x80, 0x80, 0x80);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m128i p0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle);
+         __m128i p1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 4)), shuffle);
+         __m128i p2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 8)), shuffle);
+         __m128i p3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 12)), shuffle);
+         __m128i *d = (__m128i *)(dst_ptr + x * 3);
+         _mm_storeu_si128(d + 0, _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+         _mm_storeu_si128(d + 1, _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+         _mm_storeu_si128(d + 2, _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_XRGB_8888_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void xrgb_8888_to_bgr_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 3), _mm_set1_epi32(0x1f)), 11),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 10), _mm_set1_epi32(0x3f)), 5)),
+            _mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)));
+         b = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 3), _mm_set1_epi32(0x1f)), 11),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 10), _mm_set1_epi32(0x3f)), 5)),
+            _mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void xrgb_8888_to_bgr_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 3), _mm256_set1_epi32(0x1f)), 11),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 10), _mm256_set1_epi32(0x3f)), 5)),
+            _mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 3), _mm256_set1_epi32(0x1f)), 11),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 10), _mm256_set1_epi32(0x3f)), 5)),
+            _mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void xrgb_8888_to_bgr_555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 3), _mm_set1_epi32(0x1f)), 10),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f)), 5)),
+            _mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)));
+         b = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 3), _mm_set1_epi32(0x1f)), 10),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f)), 5)),
+            _mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void xrgb_8888_to_bgr_555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 3), _mm256_set1_epi32(0x1f)), 10),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 3), _mm256_set1_epi32(0x1f)), 10),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void xrgb_8888_to_rgbx_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_and_si128(_mm_slli_epi32(p, 8), _mm_set1_epi32((int)0xffffff00)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void xrgb_8888_to_rgbx_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(0x80, 0, 1, 2, 0x80, 4, 5, 6, 0x80, 8, 9, 10, 0x80, 12, 13, 14);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void xrgb_8888_to_rgbx_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(0x80, 0, 1, 2, 0x80, 4, 5, 6, 0x80, 8, 9, 10, 0x80, 12, 13, 14));
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void xrgb_8888_to_abgr_8888_le_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 16), _mm_set1_epi32(0x000000ff)),
+            _mm_and_si128(p, _mm_set1_epi32(0x0000ff00))),
+            _mm_and_si128(_mm_slli_epi32(p, 16), _mm_set1_epi32(0x00ff0000))),
+            _mm_set1_epi32((int)0xff000000)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void xrgb_8888_to_abgr_8888_le_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 0x80, 6, 5, 4, 0x80, 10, 9, 8, 0x80, 14, 13, 12, 0x80);
+   const __m128i fill = _mm_set1_epi32((int)0xff000000);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle), fill));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void xrgb_8888_to_abgr_8888_le_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(2, 1, 0, 0x80, 6, 5, 4, 0x80, 10, 9, 8, 0x80, 14, 13, 12, 0x80));
+   const __m256i fill = _mm256_set1_epi32((int)0xff000000);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_or_si256(_mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle), fill));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void xrgb_8888_to_rgba_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 4), _mm_set1_epi32(0xf)), 4),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 12), _mm_set1_epi32(0xf)), 8)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 20), _mm_set1_epi32(0xf)), 12)),
+            _mm_set1_epi32(0xf));
+         b = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 4), _mm_set1_epi32(0xf)), 4),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 12), _mm_set1_epi32(0xf)), 8)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 20), _mm_set1_epi32(0xf)), 12)),
+            _mm_set1_epi32(0xf));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void xrgb_8888_to_rgba_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 4), _mm256_set1_epi32(0xf)), 4),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 12), _mm256_set1_epi32(0xf)), 8)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 20), _mm256_set1_epi32(0xf)), 12)),
+            _mm256_set1_epi32(0xf));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 4), _mm256_set1_epi32(0xf)), 4),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 12), _mm256_set1_epi32(0xf)), 8)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 20), _mm256_set1_epi32(0xf)), 12)),
+            _mm256_set1_epi32(0xf));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void abgr_8888_le_to_argb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 16), _mm_set1_epi32(0x000000ff)),
+            _mm_and_si128(p, _mm_set1_epi32((int)0xff00ff00))),
+            _mm_and_si128(_mm_slli_epi32(p, 16), _mm_set1_epi32(0x00ff0000))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void abgr_8888_le_to_argb_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void abgr_8888_le_to_argb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15));
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void abgr_8888_le_to_rgba_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 24), _mm_set1_epi32(0x000000ff)),
+            _mm_and_si128(_mm_srli_epi32(p, 8), _mm_set1_epi32(0x0000ff00))),
+            _mm_and_si128(_mm_slli_epi32(p, 8), _mm_set1_epi32(0x00ff0000))),
+            _mm_and_si128(_mm_slli_epi32(p, 24), _mm_set1_epi32((int)0xff000000))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void abgr_8888_le_to_rgba_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void abgr_8888_le_to_rgba_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12));
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void abgr_8888_le_to_argb_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 28), _mm_set1_epi32(0xf)), 12),
+            _mm_and_si128(_mm_srli_epi32(a, 20), _mm_set1_epi32(0xf))),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 12), _mm_set1_epi32(0xf)), 4)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 4), _mm_set1_epi32(0xf)), 8));
+         b = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 28), _mm_set1_epi32(0xf)), 12),
+            _mm_and_si128(_mm_srli_epi32(b, 20), _mm_set1_epi32(0xf))),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 12), _mm_set1_epi32(0xf)), 4)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 4), _mm_set1_epi32(0xf)), 8));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void abgr_8888_le_to_argb_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 28), _mm256_set1_epi32(0xf)), 12),
+            _mm256_and_si256(_mm256_srli_epi32(a, 20), _mm256_set1_epi32(0xf))),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 12), _mm256_set1_epi32(0xf)), 4)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 4), _mm256_set1_epi32(0xf)), 8));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 28), _mm256_set1_epi32(0xf)), 12),
+            _mm256_and_si256(_mm256_srli_epi32(b, 20), _mm256_set1_epi32(0xf))),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 12), _mm256_set1_epi32(0xf)), 4)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 4), _mm256_set1_epi32(0xf)), 8));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void abgr_8888_le_to_rgb_888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, 0x80, 0x80, 0x80, 0x80);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m128i p0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle);
+         __m128i p1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 4)), shuffle);
+         __m128i p2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 8)), shuffle);
+         __m128i p3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 12)), shuffle);
+         __m128i *d = (__m128i *)(dst_ptr + x * 3);
+         _mm_storeu_si128(d + 0, _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+         _mm_storeu_si128(d + 1, _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+         _mm_storeu_si128(d + 2, _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void abgr_8888_le_to_rgb_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 10), _mm_set1_epi32(0x3f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 3), _mm_set1_epi32(0x1f)), 11));
+         b = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 10), _mm_set1_epi32(0x3f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 3), _mm_set1_epi32(0x1f)), 11));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void abgr_8888_le_to_rgb_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 10), _mm256_set1_epi32(0x3f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 3), _mm256_set1_epi32(0x1f)), 11));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 10), _mm256_set1_epi32(0x3f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 3), _mm256_set1_epi32(0x1f)), 11));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void abgr_8888_le_to_rgb_555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 3), _mm_set1_epi32(0x1f)), 10));
+         b = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 3), _mm_set1_epi32(0x1f)), 10));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void abgr_8888_le_to_rgb_555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 3), _mm256_set1_epi32(0x1f)), 10));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 3), _mm256_set1_epi32(0x1f)), 10));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void abgr_8888_le_to_rgba_5551_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(a, 31), _mm_set1_epi32(0x1)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)), 1)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f)), 6)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 3), _mm_set1_epi32(0x1f)), 11));
+         b = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(b, 31), _mm_set1_epi32(0x1)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)), 1)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f)), 6)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 3), _mm_set1_epi32(0x1f)), 11));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void abgr_8888_le_to_rgba_5551_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(a, 31), _mm256_set1_epi32(0x1)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)), 1)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f)), 6)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 3), _mm256_set1_epi32(0x1f)), 11));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(b, 31), _mm256_set1_epi32(0x1)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)), 1)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f)), 6)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 3), _mm256_set1_epi32(0x1f)), 11));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void abgr_8888_le_to_argb_1555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 31), _mm_set1_epi32(0x1)), 15),
+            _mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f))),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 3), _mm_set1_epi32(0x1f)), 10));
+         b = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 31), _mm_set1_epi32(0x1)), 15),
+            _mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f))),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f)), 5)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 3), _mm_set1_epi32(0x1f)), 10));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void abgr_8888_le_to_argb_1555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 31), _mm256_set1_epi32(0x1)), 15),
+            _mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f))),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 3), _mm256_set1_epi32(0x1f)), 10));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 31), _mm256_set1_epi32(0x1)), 15),
+            _mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f))),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 3), _mm256_set1_epi32(0x1f)), 10));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void abgr_8888_le_to_abgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void abgr_8888_le_to_abgr_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void abgr_8888_le_to_abgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void abgr_8888_le_to_xbgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_and_si128(p, _mm_set1_epi32(0x00ffffff)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void abgr_8888_le_to_xbgr_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(0, 1, 2, 0x80, 4, 5, 6, 0x80, 8, 9, 10, 0x80, 12, 13, 14, 0x80);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void abgr_8888_le_to_xbgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(0, 1, 2, 0x80, 4, 5, 6, 0x80, 8, 9, 10, 0x80, 12, 13, 14, 0x80));
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void abgr_8888_le_to_bgr_888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 0x80, 0x80, 0x80, 0x80);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m128i p0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle);
+         __m128i p1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 4)), shuffle);
+         __m128i p2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 8)), shuffle);
+         __m128i p3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x + 12)), shuffle);
+         __m128i *d = (__m128i *)(dst_ptr + x * 3);
+         _mm_storeu_si128(d + 0, _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+         _mm_storeu_si128(d + 1, _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+         _mm_storeu_si128(d + 2, _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_ABGR_8888_LE_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void abgr_8888_le_to_bgr_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)), 11),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 10), _mm_set1_epi32(0x3f)), 5)),
+            _mm_and_si128(_mm_srli_epi32(a, 3), _mm_set1_epi32(0x1f)));
+         b = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)), 11),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 10), _mm_set1_epi32(0x3f)), 5)),
+            _mm_and_si128(_mm_srli_epi32(b, 3), _mm_set1_epi32(0x1f)));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void abgr_8888_le_to_bgr_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)), 11),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 10), _mm256_set1_epi32(0x3f)), 5)),
+            _mm256_and_si256(_mm256_srli_epi32(a, 3), _mm256_set1_epi32(0x1f)));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)), 11),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 10), _mm256_set1_epi32(0x3f)), 5)),
+            _mm256_and_si256(_mm256_srli_epi32(b, 3), _mm256_set1_epi32(0x1f)));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void abgr_8888_le_to_bgr_555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 19), _mm_set1_epi32(0x1f)), 10),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 11), _mm_set1_epi32(0x1f)), 5)),
+            _mm_and_si128(_mm_srli_epi32(a, 3), _mm_set1_epi32(0x1f)));
+         b = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 19), _mm_set1_epi32(0x1f)), 10),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 11), _mm_set1_epi32(0x1f)), 5)),
+            _mm_and_si128(_mm_srli_epi32(b, 3), _mm_set1_epi32(0x1f)));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void abgr_8888_le_to_bgr_555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 19), _mm256_set1_epi32(0x1f)), 10),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 11), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_and_si256(_mm256_srli_epi32(a, 3), _mm256_set1_epi32(0x1f)));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 19), _mm256_set1_epi32(0x1f)), 10),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 11), _mm256_set1_epi32(0x1f)), 5)),
+            _mm256_and_si256(_mm256_srli_epi32(b, 3), _mm256_set1_epi32(0x1f)));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void abgr_8888_le_to_rgbx_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 8), _mm_set1_epi32(0x0000ff00)),
+            _mm_and_si128(_mm_slli_epi32(p, 8), _mm_set1_epi32(0x00ff0000))),
+            _mm_and_si128(_mm_slli_epi32(p, 24), _mm_set1_epi32((int)0xff000000))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void abgr_8888_le_to_rgbx_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(0x80, 2, 1, 0, 0x80, 6, 5, 4, 0x80, 10, 9, 8, 0x80, 14, 13, 12);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void abgr_8888_le_to_rgbx_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(0x80, 2, 1, 0, 0x80, 6, 5, 4, 0x80, 10, 9, 8, 0x80, 14, 13, 12));
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void abgr_8888_le_to_xrgb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 16), _mm_set1_epi32(0x000000ff)),
+            _mm_and_si128(p, _mm_set1_epi32(0x0000ff00))),
+            _mm_and_si128(_mm_slli_epi32(p, 16), _mm_set1_epi32(0x00ff0000))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSSE3
+static void abgr_8888_le_to_xrgb_8888_ssse3(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 0x80, 6, 5, 4, 0x80, 10, 9, 8, 0x80, 14, 13, 12, 0x80);
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 4 <= width; x += 4) {
+         _mm_storeu_si128((__m128i *)(dst_ptr + x),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void abgr_8888_le_to_xrgb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(2, 1, 0, 0x80, 6, 5, 4, 0x80, 10, 9, 8, 0x80, 14, 13, 12, 0x80));
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x),
+            _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src_ptr + x)), shuffle));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void abgr_8888_le_to_rgba_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i a = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i b = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i p;
+         a = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(a, 28), _mm_set1_epi32(0xf)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 20), _mm_set1_epi32(0xf)), 4)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 12), _mm_set1_epi32(0xf)), 8)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(a, 4), _mm_set1_epi32(0xf)), 12));
+         b = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(b, 28), _mm_set1_epi32(0xf)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 20), _mm_set1_epi32(0xf)), 4)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 12), _mm_set1_epi32(0xf)), 8)),
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(b, 4), _mm_set1_epi32(0xf)), 12));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+         b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+         p = _mm_packs_epi32(a, b);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void abgr_8888_le_to_rgba_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i a = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i b = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i p;
+         a = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(a, 28), _mm256_set1_epi32(0xf)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 20), _mm256_set1_epi32(0xf)), 4)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 12), _mm256_set1_epi32(0xf)), 8)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 4), _mm256_set1_epi32(0xf)), 12));
+         b = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(b, 28), _mm256_set1_epi32(0xf)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 20), _mm256_set1_epi32(0xf)), 4)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 12), _mm256_set1_epi32(0xf)), 8)),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 4), _mm256_set1_epi32(0xf)), 12));
+         /* Sign extend so the saturating pack keeps the low 16 bits. */
+         a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+         b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+         p = _mm256_packs_epi32(a, b);
+         p = _mm256_permute4x64_epi64(p, 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), p);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgba_4444_to_argb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 4), _mm_set1_epi16(0xf)), _mm_set1_epi16(17)),
+            _mm_slli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 8), _mm_set1_epi16(0xf)), _mm_set1_epi16(17)), 8));
+         __m128i hi = _mm_or_si128(_mm_mullo_epi16(_mm_srli_epi16(p, 12), _mm_set1_epi16(17)),
+            _mm_slli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0xf)), _mm_set1_epi16(17)), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_4444_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgba_4444_to_argb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 4), _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)),
+            _mm256_slli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 8), _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)), 8));
+         __m256i hi = _mm256_or_si256(_mm256_mullo_epi16(_mm256_srli_epi16(p, 12), _mm256_set1_epi16(17)),
+            _mm256_slli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_4444_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgba_4444_to_rgba_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0xf)), _mm_set1_epi16(17)),
+            _mm_slli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 4), _mm_set1_epi16(0xf)), _mm_set1_epi16(17)), 8));
+         __m128i hi = _mm_or_si128(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 8), _mm_set1_epi16(0xf)), _mm_set1_epi16(17)),
+            _mm_slli_epi16(_mm_mullo_epi16(_mm_srli_epi16(p, 12), _mm_set1_epi16(17)), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_4444_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgba_4444_to_rgba_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)),
+            _mm256_slli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 4), _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)), 8));
+         __m256i hi = _mm256_or_si256(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 8), _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)),
+            _mm256_slli_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(p, 12), _mm256_set1_epi16(17)), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_4444_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgba_4444_to_abgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_mullo_epi16(_mm_srli_epi16(p, 12), _mm_set1_epi16(17)),
+            _mm_slli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 8), _mm_set1_epi16(0xf)), _mm_set1_epi16(17)), 8));
+         __m128i hi = _mm_or_si128(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 4), _mm_set1_epi16(0xf)), _mm_set1_epi16(17)),
+            _mm_slli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0xf)), _mm_set1_epi16(17)), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_4444_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgba_4444_to_abgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_mullo_epi16(_mm256_srli_epi16(p, 12), _mm256_set1_epi16(17)),
+            _mm256_slli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 8), _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)), 8));
+         __m256i hi = _mm256_or_si256(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 4), _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)),
+            _mm256_slli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_4444_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgba_4444_to_xbgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_mullo_epi16(_mm_srli_epi16(p, 12), _mm_set1_epi16(17)),
+            _mm_slli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 8), _mm_set1_epi16(0xf)), _mm_set1_epi16(17)), 8));
+         __m128i hi = _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 4), _mm_set1_epi16(0xf)), _mm_set1_epi16(17));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_4444_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgba_4444_to_xbgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_mullo_epi16(_mm256_srli_epi16(p, 12), _mm256_set1_epi16(17)),
+            _mm256_slli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 8), _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)), 8));
+         __m256i hi = _mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 4), _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_4444_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgba_4444_to_rgbx_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_slli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 4), _mm_set1_epi16(0xf)), _mm_set1_epi16(17)), 8);
+         __m128i hi = _mm_or_si128(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 8), _mm_set1_epi16(0xf)), _mm_set1_epi16(17)),
+            _mm_slli_epi16(_mm_mullo_epi16(_mm_srli_epi16(p, 12), _mm_set1_epi16(17)), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_4444_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgba_4444_to_rgbx_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_slli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 4), _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)), 8);
+         __m256i hi = _mm256_or_si256(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 8), _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)),
+            _mm256_slli_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(p, 12), _mm256_set1_epi16(17)), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_4444_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgba_4444_to_xrgb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 4), _mm_set1_epi16(0xf)), _mm_set1_epi16(17)),
+            _mm_slli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 8), _mm_set1_epi16(0xf)), _mm_set1_epi16(17)), 8));
+         __m128i hi = _mm_mullo_epi16(_mm_srli_epi16(p, 12), _mm_set1_epi16(17));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_4444_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgba_4444_to_xrgb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 4), _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)),
+            _mm256_slli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 8), _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)), 8));
+         __m256i hi = _mm256_mullo_epi16(_mm256_srli_epi16(p, 12), _mm256_set1_epi16(17));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_4444_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_SSE2
+static void rgba_4444_to_abgr_8888_le_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         __m128i p = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i lo = _mm_or_si128(_mm_mullo_epi16(_mm_srli_epi16(p, 12), _mm_set1_epi16(17)),
+            _mm_slli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 8), _mm_set1_epi16(0xf)), _mm_set1_epi16(17)), 8));
+         __m128i hi = _mm_or_si128(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 4), _mm_set1_epi16(0xf)), _mm_set1_epi16(17)),
+            _mm_slli_epi16(_mm_mullo_epi16(_mm_and_si128(p, _mm_set1_epi16(0xf)), _mm_set1_epi16(17)), 8));
+         __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+         __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), p0);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x + 4), p1);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_4444_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+_AL_TARGET_AVX2
+static void rgba_4444_to_abgr_8888_le_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         __m256i p = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i lo = _mm256_or_si256(_mm256_mullo_epi16(_mm256_srli_epi16(p, 12), _mm256_set1_epi16(17)),
+            _mm256_slli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 8), _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)), 8));
+         __m256i hi = _mm256_or_si256(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 4), _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)),
+            _mm256_slli_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, _mm256_set1_epi16(0xf)), _mm256_set1_epi16(17)), 8));
+         __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+         __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), _mm256_permute2x128_si256(p0, p1, 0x20));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x + 8), _mm256_permute2x128_si256(p0, p1, 0x31));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_4444_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static void (*_al_convert_funcs_sse2[ALLEGRO_NUM_PIXEL_FORMATS]
+   [ALLEGRO_NUM_PIXEL_FORMATS])(const void *, int, void *, int,
+   int, int, int, int, int, int) = {
+   {NULL},
+   {NULL},
+   {NULL},
+   {NULL},
+   {NULL},
+   {NULL},
+   {NULL},
+   {NULL},
+   {NULL},
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      argb_8888_to_rgba_8888_sse2,
+      argb_8888_to_argb_4444_sse2,
+      NULL,
+      argb_8888_to_rgb_565_sse2,
+      argb_8888_to_rgb_555_sse2,
+      argb_8888_to_rgba_5551_sse2,
+      argb_8888_to_argb_1555_sse2,
+      argb_8888_to_abgr_8888_sse2,
+      argb_8888_to_xbgr_8888_sse2,
+      NULL,
+      argb_8888_to_bgr_565_sse2,
+      argb_8888_to_bgr_555_sse2,
+      argb_8888_to_rgbx_8888_sse2,
+      argb_8888_to_xrgb_8888_sse2,
+      NULL,
+      argb_8888_to_abgr_8888_le_sse2,
+      argb_8888_to_rgba_4444_sse2,
+      NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      rgba_8888_to_argb_8888_sse2,
+      NULL,
+      rgba_8888_to_argb_4444_sse2,
+      NULL,
+      rgba_8888_to_rgb_565_sse2,
+      rgba_8888_to_rgb_555_sse2,
+      rgba_8888_to_rgba_5551_sse2,
+      rgba_8888_to_argb_1555_sse2,
+      rgba_8888_to_abgr_8888_sse2,
+      rgba_8888_to_xbgr_8888_sse2,
+      NULL,
+      rgba_8888_to_bgr_565_sse2,
+      rgba_8888_to_bgr_555_sse2,
+      rgba_8888_to_rgbx_8888_sse2,
+      rgba_8888_to_xrgb_8888_sse2,
+      NULL,
+      rgba_8888_to_abgr_8888_le_sse2,
+      rgba_8888_to_rgba_4444_sse2,
+      NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      argb_4444_to_argb_8888_sse2,
+      argb_4444_to_rgba_8888_sse2,
+      NULL, NULL, NULL, NULL, NULL, NULL,
+      argb_4444_to_abgr_8888_sse2,
+      argb_4444_to_xbgr_8888_sse2,
+      NULL, NULL, NULL,
+      argb_4444_to_rgbx_8888_sse2,
+      argb_4444_to_xrgb_8888_sse2,
+      NULL,
+      argb_4444_to_abgr_8888_le_sse2,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      rgb_565_to_argb_8888_sse2,
+      rgb_565_to_rgba_8888_sse2,
+      NULL, NULL, NULL, NULL, NULL, NULL,
+      rgb_565_to_abgr_8888_sse2,
+      rgb_565_to_xbgr_8888_sse2,
+      NULL, NULL, NULL,
+      rgb_565_to_rgbx_8888_sse2,
+      rgb_565_to_xrgb_8888_sse2,
+      NULL,
+      rgb_565_to_abgr_8888_le_sse2,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      rgb_555_to_argb_8888_sse2,
+      rgb_555_to_rgba_8888_sse2,
+      NULL, NULL, NULL, NULL, NULL, NULL,
+      rgb_555_to_abgr_8888_sse2,
+      rgb_555_to_xbgr_8888_sse2,
+      NULL, NULL, NULL,
+      rgb_555_to_rgbx_8888_sse2,
+      rgb_555_to_xrgb_8888_sse2,
+      NULL,
+      rgb_555_to_abgr_8888_le_sse2,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      rgba_5551_to_argb_8888_sse2,
+      rgba_5551_to_rgba_8888_sse2,
+      NULL, NULL, NULL, NULL, NULL, NULL,
+      rgba_5551_to_abgr_8888_sse2,
+      rgba_5551_to_xbgr_8888_sse2,
+      NULL, NULL, NULL,
+      rgba_5551_to_rgbx_8888_sse2,
+      rgba_5551_to_xrgb_8888_sse2,
+      NULL,
+      rgba_5551_to_abgr_8888_le_sse2,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      argb_1555_to_argb_8888_sse2,
+      argb_1555_to_rgba_8888_sse2,
+      NULL, NULL, NULL, NULL, NULL, NULL,
+      argb_1555_to_abgr_8888_sse2,
+      argb_1555_to_xbgr_8888_sse2,
+      NULL, NULL, NULL,
+      argb_1555_to_rgbx_8888_sse2,
+      argb_1555_to_xrgb_8888_sse2,
+      NULL,
+      argb_1555_to_abgr_8888_le_sse2,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      abgr_8888_to_argb_8888_sse2,
+      abgr_8888_to_rgba_8888_sse2,
+      abgr_8888_to_argb_4444_sse2,
+      NULL,
+      abgr_8888_to_rgb_565_sse2,
+      abgr_8888_to_rgb_555_sse2,
+      abgr_8888_to_rgba_5551_sse2,
+      abgr_8888_to_argb_1555_sse2,
+      NULL,
+      abgr_8888_to_xbgr_8888_sse2,
+      NULL,
+      abgr_8888_to_bgr_565_sse2,
+      abgr_8888_to_bgr_555_sse2,
+      abgr_8888_to_rgbx_8888_sse2,
+      abgr_8888_to_xrgb_8888_sse2,
+      NULL,
+      abgr_8888_to_abgr_8888_le_sse2,
+      abgr_8888_to_rgba_4444_sse2,
+      NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      xbgr_8888_to_argb_8888_sse2,
+      xbgr_8888_to_rgba_8888_sse2,
+      xbgr_8888_to_argb_4444_sse2,
+      NULL,
+      xbgr_8888_to_rgb_565_sse2,
+      xbgr_8888_to_rgb_555_sse2,
+      xbgr_8888_to_rgba_5551_sse2,
+      xbgr_8888_to_argb_1555_sse2,
+      xbgr_8888_to_abgr_8888_sse2,
+      NULL, NULL,
+      xbgr_8888_to_bgr_565_sse2,
+      xbgr_8888_to_bgr_555_sse2,
+      xbgr_8888_to_rgbx_8888_sse2,
+      xbgr_8888_to_xrgb_8888_sse2,
+      NULL,
+      xbgr_8888_to_abgr_8888_le_sse2,
+      xbgr_8888_to_rgba_4444_sse2,
+      NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      bgr_565_to_argb_8888_sse2,
+      bgr_565_to_rgba_8888_sse2,
+      NULL, NULL, NULL, NULL, NULL, NULL,
+      bgr_565_to_abgr_8888_sse2,
+      bgr_565_to_xbgr_8888_sse2,
+      NULL, NULL, NULL,
+      bgr_565_to_rgbx_8888_sse2,
+      bgr_565_to_xrgb_8888_sse2,
+      NULL,
+      bgr_565_to_abgr_8888_le_sse2,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      bgr_555_to_argb_8888_sse2,
+      bgr_555_to_rgba_8888_sse2,
+      NULL, NULL, NULL, NULL, NULL, NULL,
+      bgr_555_to_abgr_8888_sse2,
+      bgr_555_to_xbgr_8888_sse2,
+      NULL, NULL, NULL,
+      bgr_555_to_rgbx_8888_sse2,
+      bgr_555_to_xrgb_8888_sse2,
+      NULL,
+      bgr_555_to_abgr_8888_le_sse2,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      rgbx_8888_to_argb_8888_sse2,
+      rgbx_8888_to_rgba_8888_sse2,
+      rgbx_8888_to_argb_4444_sse2,
+      NULL,
+      rgbx_8888_to_rgb_565_sse2,
+      rgbx_8888_to_rgb_555_sse2,
+      rgbx_8888_to_rgba_5551_sse2,
+      rgbx_8888_to_argb_1555_sse2,
+      rgbx_8888_to_abgr_8888_sse2,
+      rgbx_8888_to_xbgr_8888_sse2,
+      NULL,
+      rgbx_8888_to_bgr_565_sse2,
+      rgbx_8888_to_bgr_555_sse2,
+      NULL,
+      rgbx_8888_to_xrgb_8888_sse2,
+      NULL,
+      rgbx_8888_to_abgr_8888_le_sse2,
+      rgbx_8888_to_rgba_4444_sse2,
+      NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      xrgb_8888_to_argb_8888_sse2,
+      xrgb_8888_to_rgba_8888_sse2,
+      xrgb_8888_to_argb_4444_sse2,
+      NULL,
+      xrgb_8888_to_rgb_565_sse2,
+      xrgb_8888_to_rgb_555_sse2,
+      xrgb_8888_to_rgba_5551_sse2,
+      xrgb_8888_to_argb_1555_sse2,
+      xrgb_8888_to_abgr_8888_sse2,
+      xrgb_8888_to_xbgr_8888_sse2,
+      NULL,
+      xrgb_8888_to_bgr_565_sse2,
+      xrgb_8888_to_bgr_555_sse2,
+      xrgb_8888_to_rgbx_8888_sse2,
+      NULL, NULL,
+      xrgb_8888_to_abgr_8888_le_sse2,
+      xrgb_8888_to_rgba_4444_sse2,
+      NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      abgr_8888_le_to_argb_8888_sse2,
+      abgr_8888_le_to_rgba_8888_sse2,
+      abgr_8888_le_to_argb_4444_sse2,
+      NULL,
+      abgr_8888_le_to_rgb_565_sse2,
+      abgr_8888_le_to_rgb_555_sse2,
+      abgr_8888_le_to_rgba_5551_sse2,
+      abgr_8888_le_to_argb_1555_sse2,
+      abgr_8888_le_to_abgr_8888_sse2,
+      abgr_8888_le_to_xbgr_8888_sse2,
+      NULL,
+      abgr_8888_le_to_bgr_565_sse2,
+      abgr_8888_le_to_bgr_555_sse2,
+      abgr_8888_le_to_rgbx_8888_sse2,
+      abgr_8888_le_to_xrgb_8888_sse2,
+      NULL, NULL,
+      abgr_8888_le_to_rgba_4444_sse2,
+      NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      rgba_4444_to_argb_8888_sse2,
+      rgba_4444_to_rgba_8888_sse2,
+      NULL, NULL, NULL, NULL, NULL, NULL,
+      rgba_4444_to_abgr_8888_sse2,
+      rgba_4444_to_xbgr_8888_sse2,
+      NULL, NULL, NULL,
+      rgba_4444_to_rgbx_8888_sse2,
+      rgba_4444_to_xrgb_8888_sse2,
+      NULL,
+      rgba_4444_to_abgr_8888_le_sse2,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+   },
+   {NULL},
+   {NULL},
+   {NULL},
+};
+static void (*_al_convert_funcs_ssse3[ALLEGRO_NUM_PIXEL_FORMATS]
+   [ALLEGRO_NUM_PIXEL_FORMATS])(const void *, int, void *, int,
+   int, int, int, int, int, int) = {
+   {NULL},
+   {NULL},
+   {NULL},
+   {NULL},
+   {NULL},
+   {NULL},
+   {NULL},
+   {NULL},
+   {NULL},
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      argb_8888_to_rgba_8888_ssse3,
+      NULL,
+      argb_8888_to_rgb_888_ssse3,
+      NULL, NULL, NULL, NULL,
+      argb_8888_to_abgr_8888_ssse3,
+      argb_8888_to_xbgr_8888_ssse3,
+      argb_8888_to_bgr_888_ssse3,
+      NULL, NULL,
+      argb_8888_to_rgbx_8888_ssse3,
+      argb_8888_to_xrgb_8888_ssse3,
+      NULL,
+      argb_8888_to_abgr_8888_le_ssse3,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      rgba_8888_to_argb_8888_ssse3,
+      NULL, NULL,
+      rgba_8888_to_rgb_888_ssse3,
+      NULL, NULL, NULL, NULL,
+      rgba_8888_to_abgr_8888_ssse3,
+      rgba_8888_to_xbgr_8888_ssse3,
+      rgba_8888_to_bgr_888_ssse3,
+      NULL, NULL,
+      rgba_8888_to_rgbx_8888_ssse3,
+      rgba_8888_to_xrgb_8888_ssse3,
+      NULL,
+      rgba_8888_to_abgr_8888_le_ssse3,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      rgb_888_to_argb_8888_ssse3,
+      rgb_888_to_rgba_8888_ssse3,
+      NULL, NULL, NULL, NULL, NULL, NULL,
+      rgb_888_to_abgr_8888_ssse3,
+      rgb_888_to_xbgr_8888_ssse3,
+      NULL, NULL, NULL,
+      rgb_888_to_rgbx_8888_ssse3,
+      rgb_888_to_xrgb_8888_ssse3,
+      NULL,
+      rgb_888_to_abgr_8888_le_ssse3,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      abgr_8888_to_argb_8888_ssse3,
+      abgr_8888_to_rgba_8888_ssse3,
+      NULL,
+      abgr_8888_to_rgb_888_ssse3,
+      NULL, NULL, NULL, NULL, NULL,
+      abgr_8888_to_xbgr_8888_ssse3,
+      abgr_8888_to_bgr_888_ssse3,
+      NULL, NULL,
+      abgr_8888_to_rgbx_8888_ssse3,
+      abgr_8888_to_xrgb_8888_ssse3,
+      NULL,
+      abgr_8888_to_abgr_8888_le_ssse3,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      xbgr_8888_to_argb_8888_ssse3,
+      xbgr_8888_to_rgba_8888_ssse3,
+      NULL,
+      xbgr_8888_to_rgb_888_ssse3,
+      NULL, NULL, NULL, NULL,
+      xbgr_8888_to_abgr_8888_ssse3,
+      NULL,
+      xbgr_8888_to_bgr_888_ssse3,
+      NULL, NULL,
+      xbgr_8888_to_rgbx_8888_ssse3,
+      xbgr_8888_to_xrgb_8888_ssse3,
+      NULL,
+      xbgr_8888_to_abgr_8888_le_ssse3,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      bgr_888_to_argb_8888_ssse3,
+      bgr_888_to_rgba_8888_ssse3,
+      NULL, NULL, NULL, NULL, NULL, NULL,
+      bgr_888_to_abgr_8888_ssse3,
+      bgr_888_to_xbgr_8888_ssse3,
+      NULL, NULL, NULL,
+      bgr_888_to_rgbx_8888_ssse3,
+      bgr_888_to_xrgb_8888_ssse3,
+      NULL,
+      bgr_888_to_abgr_8888_le_ssse3,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      rgbx_8888_to_argb_8888_ssse3,
+      rgbx_8888_to_rgba_8888_ssse3,
+      NULL,
+      rgbx_8888_to_rgb_888_ssse3,
+      NULL, NULL, NULL, NULL,
+      rgbx_8888_to_abgr_8888_ssse3,
+      rgbx_8888_to_xbgr_8888_ssse3,
+      rgbx_8888_to_bgr_888_ssse3,
+      NULL, NULL, NULL,
+      rgbx_8888_to_xrgb_8888_ssse3,
+      NULL,
+      rgbx_8888_to_abgr_8888_le_ssse3,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      xrgb_8888_to_argb_8888_ssse3,
+      xrgb_8888_to_rgba_8888_ssse3,
+      NULL,
+      xrgb_8888_to_rgb_888_ssse3,
+      NULL, NULL, NULL, NULL,
+      xrgb_8888_to_abgr_8888_ssse3,
+      xrgb_8888_to_xbgr_8888_ssse3,
+      xrgb_8888_to_bgr_888_ssse3,
+      NULL, NULL,
+      xrgb_8888_to_rgbx_8888_ssse3,
+      NULL, NULL,
+      xrgb_8888_to_abgr_8888_le_ssse3,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      abgr_8888_le_to_argb_8888_ssse3,
+      abgr_8888_le_to_rgba_8888_ssse3,
+      NULL,
+      abgr_8888_le_to_rgb_888_ssse3,
+      NULL, NULL, NULL, NULL,
+      abgr_8888_le_to_abgr_8888_ssse3,
+      abgr_8888_le_to_xbgr_8888_ssse3,
+      abgr_8888_le_to_bgr_888_ssse3,
+      NULL, NULL,
+      abgr_8888_le_to_rgbx_8888_ssse3,
+      abgr_8888_le_to_xrgb_8888_ssse3,
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+   },
+   {NULL},
+   {NULL},
+   {NULL},
+};
+static void (*_al_convert_funcs_avx2[ALLEGRO_NUM_PIXEL_FORMATS]
+   [ALLEGRO_NUM_PIXEL_FORMATS])(const void *, int, void *, int,
+   int, int, int, int, int, int) = {
+   {NULL},
+   {NULL},
+   {NULL},
+   {NULL},
+   {NULL},
+   {NULL},
+   {NULL},
+   {NULL},
+   {NULL},
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      argb_8888_to_rgba_8888_avx2,
+      argb_8888_to_argb_4444_avx2,
+      NULL,
+      argb_8888_to_rgb_565_avx2,
+      argb_8888_to_rgb_555_avx2,
+      argb_8888_to_rgba_5551_avx2,
+      argb_8888_to_argb_1555_avx2,
+      argb_8888_to_abgr_8888_avx2,
+      argb_8888_to_xbgr_8888_avx2,
+      NULL,
+      argb_8888_to_bgr_565_avx2,
+      argb_8888_to_bgr_555_avx2,
+      argb_8888_to_rgbx_8888_avx2,
+      argb_8888_to_xrgb_8888_avx2,
+      NULL,
+      argb_8888_to_abgr_8888_le_avx2,
+      argb_8888_to_rgba_4444_avx2,
+      NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      rgba_8888_to_argb_8888_avx2,
+      NULL,
+      rgba_8888_to_argb_4444_avx2,
+      NULL,
+      rgba_8888_to_rgb_565_avx2,
+      rgba_8888_to_rgb_555_avx2,
+      rgba_8888_to_rgba_5551_avx2,
+      rgba_8888_to_argb_1555_avx2,
+      rgba_8888_to_abgr_8888_avx2,
+      rgba_8888_to_xbgr_8888_avx2,
+      NULL,
+      rgba_8888_to_bgr_565_avx2,
+      rgba_8888_to_bgr_555_avx2,
+      rgba_8888_to_rgbx_8888_avx2,
+      rgba_8888_to_xrgb_8888_avx2,
+      NULL,
+      rgba_8888_to_abgr_8888_le_avx2,
+      rgba_8888_to_rgba_4444_avx2,
+      NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      argb_4444_to_argb_8888_avx2,
+      argb_4444_to_rgba_8888_avx2,
+      NULL, NULL, NULL, NULL, NULL, NULL,
+      argb_4444_to_abgr_8888_avx2,
+      argb_4444_to_xbgr_8888_avx2,
+      NULL, NULL, NULL,
+      argb_4444_to_rgbx_8888_avx2,
+      argb_4444_to_xrgb_8888_avx2,
+      NULL,
+      argb_4444_to_abgr_8888_le_avx2,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      rgb_565_to_argb_8888_avx2,
+      rgb_565_to_rgba_8888_avx2,
+      NULL, NULL, NULL, NULL, NULL, NULL,
+      rgb_565_to_abgr_8888_avx2,
+      rgb_565_to_xbgr_8888_avx2,
+      NULL, NULL, NULL,
+      rgb_565_to_rgbx_8888_avx2,
+      rgb_565_to_xrgb_8888_avx2,
+      NULL,
+      rgb_565_to_abgr_8888_le_avx2,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      rgb_555_to_argb_8888_avx2,
+      rgb_555_to_rgba_8888_avx2,
+      NULL, NULL, NULL, NULL, NULL, NULL,
+      rgb_555_to_abgr_8888_avx2,
+      rgb_555_to_xbgr_8888_avx2,
+      NULL, NULL, NULL,
+      rgb_555_to_rgbx_8888_avx2,
+      rgb_555_to_xrgb_8888_avx2,
+      NULL,
+      rgb_555_to_abgr_8888_le_avx2,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      rgba_5551_to_argb_8888_avx2,
+      rgba_5551_to_rgba_8888_avx2,
+      NULL, NULL, NULL, NULL, NULL, NULL,
+      rgba_5551_to_abgr_8888_avx2,
+      rgba_5551_to_xbgr_8888_avx2,
+      NULL, NULL, NULL,
+      rgba_5551_to_rgbx_8888_avx2,
+      rgba_5551_to_xrgb_8888_avx2,
+      NULL,
+      rgba_5551_to_abgr_8888_le_avx2,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      argb_1555_to_argb_8888_avx2,
+      argb_1555_to_rgba_8888_avx2,
+      NULL, NULL, NULL, NULL, NULL, NULL,
+      argb_1555_to_abgr_8888_avx2,
+      argb_1555_to_xbgr_8888_avx2,
+      NULL, NULL, NULL,
+      argb_1555_to_rgbx_8888_avx2,
+      argb_1555_to_xrgb_8888_avx2,
+      NULL,
+      argb_1555_to_abgr_8888_le_avx2,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      abgr_8888_to_argb_8888_avx2,
+      abgr_8888_to_rgba_8888_avx2,
+      abgr_8888_to_argb_4444_avx2,
+      NULL,
+      abgr_8888_to_rgb_565_avx2,
+      abgr_8888_to_rgb_555_avx2,
+      abgr_8888_to_rgba_5551_avx2,
+      abgr_8888_to_argb_1555_avx2,
+      NULL,
+      abgr_8888_to_xbgr_8888_avx2,
+      NULL,
+      abgr_8888_to_bgr_565_avx2,
+      abgr_8888_to_bgr_555_avx2,
+      abgr_8888_to_rgbx_8888_avx2,
+      abgr_8888_to_xrgb_8888_avx2,
+      NULL,
+      abgr_8888_to_abgr_8888_le_avx2,
+      abgr_8888_to_rgba_4444_avx2,
+      NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      xbgr_8888_to_argb_8888_avx2,
+      xbgr_8888_to_rgba_8888_avx2,
+      xbgr_8888_to_argb_4444_avx2,
+      NULL,
+      xbgr_8888_to_rgb_565_avx2,
+      xbgr_8888_to_rgb_555_avx2,
+      xbgr_8888_to_rgba_5551_avx2,
+      xbgr_8888_to_argb_1555_avx2,
+      xbgr_8888_to_abgr_8888_avx2,
+      NULL, NULL,
+      xbgr_8888_to_bgr_565_avx2,
+      xbgr_8888_to_bgr_555_avx2,
+      xbgr_8888_to_rgbx_8888_avx2,
+      xbgr_8888_to_xrgb_8888_avx2,
+      NULL,
+      xbgr_8888_to_abgr_8888_le_avx2,
+      xbgr_8888_to_rgba_4444_avx2,
+      NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      bgr_565_to_argb_8888_avx2,
+      bgr_565_to_rgba_8888_avx2,
+      NULL, NULL, NULL, NULL, NULL, NULL,
+      bgr_565_to_abgr_8888_avx2,
+      bgr_565_to_xbgr_8888_avx2,
+      NULL, NULL, NULL,
+      bgr_565_to_rgbx_8888_avx2,
+      bgr_565_to_xrgb_8888_avx2,
+      NULL,
+      bgr_565_to_abgr_8888_le_avx2,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      bgr_555_to_argb_8888_avx2,
+      bgr_555_to_rgba_8888_avx2,
+      NULL, NULL, NULL, NULL, NULL, NULL,
+      bgr_555_to_abgr_8888_avx2,
+      bgr_555_to_xbgr_8888_avx2,
+      NULL, NULL, NULL,
+      bgr_555_to_rgbx_8888_avx2,
+      bgr_555_to_xrgb_8888_avx2,
+      NULL,
+      bgr_555_to_abgr_8888_le_avx2,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      rgbx_8888_to_argb_8888_avx2,
+      rgbx_8888_to_rgba_8888_avx2,
+      rgbx_8888_to_argb_4444_avx2,
+      NULL,
+      rgbx_8888_to_rgb_565_avx2,
+      rgbx_8888_to_rgb_555_avx2,
+      rgbx_8888_to_rgba_5551_avx2,
+      rgbx_8888_to_argb_1555_avx2,
+      rgbx_8888_to_abgr_8888_avx2,
+      rgbx_8888_to_xbgr_8888_avx2,
+      NULL,
+      rgbx_8888_to_bgr_565_avx2,
+      rgbx_8888_to_bgr_555_avx2,
+      NULL,
+      rgbx_8888_to_xrgb_8888_avx2,
+      NULL,
+      rgbx_8888_to_abgr_8888_le_avx2,
+      rgbx_8888_to_rgba_4444_avx2,
+      NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      xrgb_8888_to_argb_8888_avx2,
+      xrgb_8888_to_rgba_8888_avx2,
+      xrgb_8888_to_argb_4444_avx2,
+      NULL,
+      xrgb_8888_to_rgb_565_avx2,
+      xrgb_8888_to_rgb_555_avx2,
+      xrgb_8888_to_rgba_5551_avx2,
+      xrgb_8888_to_argb_1555_avx2,
+      xrgb_8888_to_abgr_8888_avx2,
+      xrgb_8888_to_xbgr_8888_avx2,
+      NULL,
+      xrgb_8888_to_bgr_565_avx2,
+      xrgb_8888_to_bgr_555_avx2,
+      xrgb_8888_to_rgbx_8888_avx2,
+      NULL, NULL,
+      xrgb_8888_to_abgr_8888_le_avx2,
+      xrgb_8888_to_rgba_4444_avx2,
+      NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      abgr_8888_le_to_argb_8888_avx2,
+      abgr_8888_le_to_rgba_8888_avx2,
+      abgr_8888_le_to_argb_4444_avx2,
+      NULL,
+      abgr_8888_le_to_rgb_565_avx2,
+      abgr_8888_le_to_rgb_555_avx2,
+      abgr_8888_le_to_rgba_5551_avx2,
+      abgr_8888_le_to_argb_1555_avx2,
+      abgr_8888_le_to_abgr_8888_avx2,
+      abgr_8888_le_to_xbgr_8888_avx2,
+      NULL,
+      abgr_8888_le_to_bgr_565_avx2,
+      abgr_8888_le_to_bgr_555_avx2,
+      abgr_8888_le_to_rgbx_8888_avx2,
+      abgr_8888_le_to_xrgb_8888_avx2,
+      NULL, NULL,
+      abgr_8888_le_to_rgba_4444_avx2,
+      NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      rgba_4444_to_argb_8888_avx2,
+      rgba_4444_to_rgba_8888_avx2,
+      NULL, NULL, NULL, NULL, NULL, NULL,
+      rgba_4444_to_abgr_8888_avx2,
+      rgba_4444_to_xbgr_8888_avx2,
+      NULL, NULL, NULL,
+      rgba_4444_to_rgbx_8888_avx2,
+      rgba_4444_to_xrgb_8888_avx2,
+      NULL,
+      rgba_4444_to_abgr_8888_le_avx2,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+   },
+   {NULL},
+   {NULL},
+   {NULL},
+};
+#endif
+#ifdef _AL_SIMD_NEON
+#include <arm_neon.h>
+static INLINE uint16x8_t neon_mulhi_u16(uint16x8_t a, uint16_t b)
+{
+   return vcombine_u16(
+      vshrn_n_u32(vmull_n_u16(vget_low_u16(a), b), 16),
+      vshrn_n_u32(vmull_n_u16(vget_high_u16(a), b), 16));
+}
+static void argb_8888_to_rgba_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[3];
+         out.val[1] = in.val[0];
+         out.val[2] = in.val[1];
+         out.val[3] = in.val[2];
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_argb_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[3], 4)), 12),
+            vmovl_u8(vshr_n_u8(in.val[0], 4))),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 4)), 4)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 4)), 8)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_rgb_888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x3_t out;
+         out.val[0] = in.val[0];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[2];
+         vst3q_u8((uint8_t *)(dst_ptr + x * 3), out);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_ARGB_8888_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void argb_8888_to_rgb_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vmovl_u8(vshr_n_u8(in.val[0], 3)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 2)), 5)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)), 11)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_rgb_555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vmovl_u8(vshr_n_u8(in.val[0], 3)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)), 5)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)), 10)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_rgba_5551_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vorrq_u16(vmovl_u8(vshr_n_u8(in.val[3], 7)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[0], 3)), 1)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)), 6)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)), 11)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_argb_1555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[3], 7)), 15),
+            vmovl_u8(vshr_n_u8(in.val[0], 3))),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)), 5)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)), 10)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_abgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[2];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[0];
+         out.val[3] = in.val[3];
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_xbgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[2];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[0];
+         out.val[3] = vdupq_n_u8(0);
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_bgr_888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x3_t out;
+         out.val[0] = in.val[2];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[0];
+         vst3q_u8((uint8_t *)(dst_ptr + x * 3), out);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_ARGB_8888_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void argb_8888_to_bgr_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[0], 3)), 11),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 2)), 5)),
+            vmovl_u8(vshr_n_u8(in.val[2], 3))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_bgr_555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[0], 3)), 10),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)), 5)),
+            vmovl_u8(vshr_n_u8(in.val[2], 3))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_rgbx_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = vdupq_n_u8(0);
+         out.val[1] = in.val[0];
+         out.val[2] = in.val[1];
+         out.val[3] = in.val[2];
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_xrgb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[0];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[2];
+         out.val[3] = vdupq_n_u8(0);
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_abgr_8888_le_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[2];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[0];
+         out.val[3] = in.val[3];
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_rgba_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vorrq_u16(vmovl_u8(vshr_n_u8(in.val[3], 4)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[0], 4)), 4)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 4)), 8)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 4)), 12)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_argb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[1];
+         out.val[1] = in.val[2];
+         out.val[2] = in.val[3];
+         out.val[3] = in.val[0];
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_argb_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[0], 4)), 12),
+            vmovl_u8(vshr_n_u8(in.val[1], 4))),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 4)), 4)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[3], 4)), 8)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_rgb_888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x3_t out;
+         out.val[0] = in.val[1];
+         out.val[1] = in.val[2];
+         out.val[2] = in.val[3];
+         vst3q_u8((uint8_t *)(dst_ptr + x * 3), out);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_RGBA_8888_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void rgba_8888_to_rgb_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 2)), 5)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[3], 3)), 11)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_rgb_555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)), 5)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[3], 3)), 10)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_rgba_5551_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vorrq_u16(vmovl_u8(vshr_n_u8(in.val[0], 7)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)), 1)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)), 6)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[3], 3)), 11)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_argb_1555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[0], 7)), 15),
+            vmovl_u8(vshr_n_u8(in.val[1], 3))),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)), 5)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[3], 3)), 10)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_abgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[3];
+         out.val[1] = in.val[2];
+         out.val[2] = in.val[1];
+         out.val[3] = in.val[0];
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_xbgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[3];
+         out.val[1] = in.val[2];
+         out.val[2] = in.val[1];
+         out.val[3] = vdupq_n_u8(0);
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_bgr_888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x3_t out;
+         out.val[0] = in.val[3];
+         out.val[1] = in.val[2];
+         out.val[2] = in.val[1];
+         vst3q_u8((uint8_t *)(dst_ptr + x * 3), out);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_RGBA_8888_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void rgba_8888_to_bgr_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)), 11),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 2)), 5)),
+            vmovl_u8(vshr_n_u8(in.val[3], 3))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_bgr_555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)), 10),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)), 5)),
+            vmovl_u8(vshr_n_u8(in.val[3], 3))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_rgbx_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = vdupq_n_u8(0);
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[2];
+         out.val[3] = in.val[3];
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_xrgb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[1];
+         out.val[1] = in.val[2];
+         out.val[2] = in.val[3];
+         out.val[3] = vdupq_n_u8(0);
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_abgr_8888_le_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[3];
+         out.val[1] = in.val[2];
+         out.val[2] = in.val[1];
+         out.val[3] = in.val[0];
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_rgba_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vorrq_u16(vmovl_u8(vshr_n_u8(in.val[0], 4)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 4)), 4)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 4)), 8)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[3], 4)), 12)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+static void argb_4444_to_argb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0xf)), 17));
+         out.val[1] = vmovn_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 4), vdupq_n_u16(0xf)), 17));
+         out.val[2] = vmovn_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 8), vdupq_n_u16(0xf)), 17));
+         out.val[3] = vmovn_u16(vmulq_n_u16(vshrq_n_u16(p, 12), 17));
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_4444_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void argb_4444_to_rgba_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vmulq_n_u16(vshrq_n_u16(p, 12), 17));
+         out.val[1] = vmovn_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0xf)), 17));
+         out.val[2] = vmovn_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 4), vdupq_n_u16(0xf)), 17));
+         out.val[3] = vmovn_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 8), vdupq_n_u16(0xf)), 17));
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_4444_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static void argb_4444_to_abgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 8), vdupq_n_u16(0xf)), 17));
+         out.val[1] = vmovn_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 4), vdupq_n_u16(0xf)), 17));
+         out.val[2] = vmovn_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0xf)), 17));
+         out.val[3] = vmovn_u16(vmulq_n_u16(vshrq_n_u16(p, 12), 17));
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_4444_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void argb_4444_to_xbgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 8), vdupq_n_u16(0xf)), 17));
+         out.val[1] = vmovn_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 4), vdupq_n_u16(0xf)), 17));
+         out.val[2] = vmovn_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0xf)), 17));
+         out.val[3] = vdup_n_u8(0);
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_4444_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void argb_4444_to_rgbx_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vdup_n_u8(0);
+         out.val[1] = vmovn_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0xf)), 17));
+         out.val[2] = vmovn_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 4), vdupq_n_u16(0xf)), 17));
+         out.val[3] = vmovn_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 8), vdupq_n_u16(0xf)), 17));
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_4444_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static void argb_4444_to_xrgb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0xf)), 17));
+         out.val[1] = vmovn_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 4), vdupq_n_u16(0xf)), 17));
+         out.val[2] = vmovn_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 8), vdupq_n_u16(0xf)), 17));
+         out.val[3] = vdup_n_u8(0);
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_4444_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void argb_4444_to_abgr_8888_le_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 8), vdupq_n_u16(0xf)), 17));
+         out.val[1] = vmovn_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 4), vdupq_n_u16(0xf)), 17));
+         out.val[2] = vmovn_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0xf)), 17));
+         out.val[3] = vmovn_u16(vmulq_n_u16(vshrq_n_u16(p, 12), 17));
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_4444_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static void rgb_888_to_argb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint8_t *src_ptr = (const uint8_t *)((const char *)src + (sy + y) * src_pitch) + sx * 3;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x3_t in = vld3q_u8((const uint8_t *)(src_ptr + x * 3));
+         uint8x16x4_t out;
+         out.val[0] = in.val[0];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[2];
+         out.val[3] = vdupq_n_u8(0xff);
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         const uint8_t *p = src_ptr + x * 3;
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_888_TO_ARGB_8888(p[0] | (p[1] << 8) | (p[2] << 16));
+      }
+   }
+}
+static void rgb_888_to_rgba_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint8_t *src_ptr = (const uint8_t *)((const char *)src + (sy + y) * src_pitch) + sx * 3;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x3_t in = vld3q_u8((const uint8_t *)(src_ptr + x * 3));
+         uint8x16x4_t out;
+         out.val[0] = vdupq_n_u8(0xff);
+         out.val[1] = in.val[0];
+         out.val[2] = in.val[1];
+         out.val[3] = in.val[2];
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         const uint8_t *p = src_ptr + x * 3;
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_888_TO_RGBA_8888(p[0] | (p[1] << 8) | (p[2] << 16));
+      }
+   }
+}
+static void rgb_888_to_abgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint8_t *src_ptr = (const uint8_t *)((const char *)src + (sy + y) * src_pitch) + sx * 3;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x3_t in = vld3q_u8((const uint8_t *)(src_ptr + x * 3));
+         uint8x16x4_t out;
+         out.val[0] = in.val[2];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[0];
+         out.val[3] = vdupq_n_u8(0xff);
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         const uint8_t *p = src_ptr + x * 3;
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_888_TO_ABGR_8888(p[0] | (p[1] << 8) | (p[2] << 16));
+      }
+   }
+}
+static void rgb_888_to_xbgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint8_t *src_ptr = (const uint8_t *)((const char *)src + (sy + y) * src_pitch) + sx * 3;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x3_t in = vld3q_u8((const uint8_t *)(src_ptr + x * 3));
+         uint8x16x4_t out;
+         out.val[0] = in.val[2];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[0];
+         out.val[3] = vdupq_n_u8(0);
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         const uint8_t *p = src_ptr + x * 3;
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_888_TO_XBGR_8888(p[0] | (p[1] << 8) | (p[2] << 16));
+      }
+   }
+}
+static void rgb_888_to_rgbx_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint8_t *src_ptr = (const uint8_t *)((const char *)src + (sy + y) * src_pitch) + sx * 3;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x3_t in = vld3q_u8((const uint8_t *)(src_ptr + x * 3));
+         uint8x16x4_t out;
+         out.val[0] = vdupq_n_u8(0);
+         out.val[1] = in.val[0];
+         out.val[2] = in.val[1];
+         out.val[3] = in.val[2];
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         const uint8_t *p = src_ptr + x * 3;
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_888_TO_RGBX_8888(p[0] | (p[1] << 8) | (p[2] << 16));
+      }
+   }
+}
+static void rgb_888_to_xrgb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint8_t *src_ptr = (const uint8_t *)((const char *)src + (sy + y) * src_pitch) + sx * 3;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x3_t in = vld3q_u8((const uint8_t *)(src_ptr + x * 3));
+         uint8x16x4_t out;
+         out.val[0] = in.val[0];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[2];
+         out.val[3] = vdupq_n_u8(0);
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         const uint8_t *p = src_ptr + x * 3;
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_888_TO_XRGB_8888(p[0] | (p[1] << 8) | (p[2] << 16));
+      }
+   }
+}
+static void rgb_888_to_abgr_8888_le_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint8_t *src_ptr = (const uint8_t *)((const char *)src + (sy + y) * src_pitch) + sx * 3;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x3_t in = vld3q_u8((const uint8_t *)(src_ptr + x * 3));
+         uint8x16x4_t out;
+         out.val[0] = in.val[2];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[0];
+         out.val[3] = vdupq_n_u8(0xff);
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         const uint8_t *p = src_ptr + x * 3;
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_888_TO_ABGR_8888_LE(p[0] | (p[1] << 8) | (p[2] << 16));
+      }
+   }
+}
+static void rgb_565_to_argb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[1] = vmovn_u16(vshrq_n_u16(neon_mulhi_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x3f)), 255), 8323), 3));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vshrq_n_u16(p, 11), 1053), 7));
+         out.val[3] = vdup_n_u8(0xff);
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_565_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgb_565_to_rgba_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vdup_n_u8(0xff);
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(neon_mulhi_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x3f)), 255), 8323), 3));
+         out.val[3] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vshrq_n_u16(p, 11), 1053), 7));
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_565_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgb_565_to_abgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vshrq_n_u16(p, 11), 1053), 7));
+         out.val[1] = vmovn_u16(vshrq_n_u16(neon_mulhi_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x3f)), 255), 8323), 3));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[3] = vdup_n_u8(0xff);
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_565_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgb_565_to_xbgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vshrq_n_u16(p, 11), 1053), 7));
+         out.val[1] = vmovn_u16(vshrq_n_u16(neon_mulhi_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x3f)), 255), 8323), 3));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[3] = vdup_n_u8(0);
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_565_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgb_565_to_rgbx_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vdup_n_u8(0);
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(neon_mulhi_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x3f)), 255), 8323), 3));
+         out.val[3] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vshrq_n_u16(p, 11), 1053), 7));
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_565_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgb_565_to_xrgb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[1] = vmovn_u16(vshrq_n_u16(neon_mulhi_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x3f)), 255), 8323), 3));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vshrq_n_u16(p, 11), 1053), 7));
+         out.val[3] = vdup_n_u8(0);
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_565_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgb_565_to_abgr_8888_le_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vshrq_n_u16(p, 11), 1053), 7));
+         out.val[1] = vmovn_u16(vshrq_n_u16(neon_mulhi_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x3f)), 255), 8323), 3));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[3] = vdup_n_u8(0xff);
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_565_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static void rgb_555_to_argb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 10), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[3] = vdup_n_u8(0xff);
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_555_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgb_555_to_rgba_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vdup_n_u8(0xff);
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[3] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 10), vdupq_n_u16(0x1f)), 1053), 7));
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_555_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgb_555_to_abgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 10), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[3] = vdup_n_u8(0xff);
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_555_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgb_555_to_xbgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 10), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[3] = vdup_n_u8(0);
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_555_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgb_555_to_rgbx_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vdup_n_u8(0);
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[3] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 10), vdupq_n_u16(0x1f)), 1053), 7));
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_555_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgb_555_to_xrgb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 10), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[3] = vdup_n_u8(0);
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_555_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgb_555_to_abgr_8888_le_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 10), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[3] = vdup_n_u8(0xff);
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGB_555_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static void rgba_5551_to_argb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 1), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 6), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vshrq_n_u16(p, 11), 1053), 7));
+         out.val[3] = vmovn_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1)), 255));
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_5551_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgba_5551_to_rgba_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1)), 255));
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 1), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 6), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[3] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vshrq_n_u16(p, 11), 1053), 7));
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_5551_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgba_5551_to_abgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vshrq_n_u16(p, 11), 1053), 7));
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 6), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 1), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[3] = vmovn_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1)), 255));
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_5551_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgba_5551_to_xbgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vshrq_n_u16(p, 11), 1053), 7));
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 6), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 1), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[3] = vdup_n_u8(0);
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_5551_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgba_5551_to_rgbx_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vdup_n_u8(0);
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 1), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 6), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[3] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vshrq_n_u16(p, 11), 1053), 7));
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_5551_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgba_5551_to_xrgb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 1), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 6), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vshrq_n_u16(p, 11), 1053), 7));
+         out.val[3] = vdup_n_u8(0);
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_5551_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgba_5551_to_abgr_8888_le_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vshrq_n_u16(p, 11), 1053), 7));
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 6), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 1), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[3] = vmovn_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1)), 255));
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_5551_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static void argb_1555_to_argb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 10), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[3] = vmovn_u16(vmulq_n_u16(vshrq_n_u16(p, 15), 255));
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_1555_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void argb_1555_to_rgba_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vmulq_n_u16(vshrq_n_u16(p, 15), 255));
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[3] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 10), vdupq_n_u16(0x1f)), 1053), 7));
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_1555_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static void argb_1555_to_abgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 10), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[3] = vmovn_u16(vmulq_n_u16(vshrq_n_u16(p, 15), 255));
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_1555_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void argb_1555_to_xbgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 10), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[3] = vdup_n_u8(0);
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_1555_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void argb_1555_to_rgbx_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vdup_n_u8(0);
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[3] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 10), vdupq_n_u16(0x1f)), 1053), 7));
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_1555_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static void argb_1555_to_xrgb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 10), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[3] = vdup_n_u8(0);
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_1555_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void argb_1555_to_abgr_8888_le_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 10), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[3] = vmovn_u16(vmulq_n_u16(vshrq_n_u16(p, 15), 255));
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_1555_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_argb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[2];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[0];
+         out.val[3] = in.val[3];
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_rgba_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[3];
+         out.val[1] = in.val[2];
+         out.val[2] = in.val[1];
+         out.val[3] = in.val[0];
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_argb_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[3], 4)), 12),
+            vmovl_u8(vshr_n_u8(in.val[2], 4))),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 4)), 4)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[0], 4)), 8)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_rgb_888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x3_t out;
+         out.val[0] = in.val[2];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[0];
+         vst3q_u8((uint8_t *)(dst_ptr + x * 3), out);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_ABGR_8888_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void abgr_8888_to_rgb_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 2)), 5)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[0], 3)), 11)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_rgb_555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)), 5)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[0], 3)), 10)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_rgba_5551_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vorrq_u16(vmovl_u8(vshr_n_u8(in.val[3], 7)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)), 1)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)), 6)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[0], 3)), 11)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_argb_1555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[3], 7)), 15),
+            vmovl_u8(vshr_n_u8(in.val[2], 3))),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)), 5)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[0], 3)), 10)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_xbgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[0];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[2];
+         out.val[3] = vdupq_n_u8(0);
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_bgr_888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x3_t out;
+         out.val[0] = in.val[0];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[2];
+         vst3q_u8((uint8_t *)(dst_ptr + x * 3), out);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_ABGR_8888_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void abgr_8888_to_bgr_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)), 11),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 2)), 5)),
+            vmovl_u8(vshr_n_u8(in.val[0], 3))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_bgr_555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)), 10),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)), 5)),
+            vmovl_u8(vshr_n_u8(in.val[0], 3))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_rgbx_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = vdupq_n_u8(0);
+         out.val[1] = in.val[2];
+         out.val[2] = in.val[1];
+         out.val[3] = in.val[0];
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_xrgb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[2];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[0];
+         out.val[3] = vdupq_n_u8(0);
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_abgr_8888_le_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[0];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[2];
+         out.val[3] = in.val[3];
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_rgba_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vorrq_u16(vmovl_u8(vshr_n_u8(in.val[3], 4)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 4)), 4)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 4)), 8)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[0], 4)), 12)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_argb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[2];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[0];
+         out.val[3] = vdupq_n_u8(0xff);
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_rgba_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = vdupq_n_u8(0xff);
+         out.val[1] = in.val[2];
+         out.val[2] = in.val[1];
+         out.val[3] = in.val[0];
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_argb_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vorrq_u16(vmovl_u8(vshr_n_u8(in.val[2], 4)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 4)), 4)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[0], 4)), 8)),
+            vdupq_n_u16(0xf000)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_rgb_888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x3_t out;
+         out.val[0] = in.val[2];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[0];
+         vst3q_u8((uint8_t *)(dst_ptr + x * 3), out);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_XBGR_8888_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void xbgr_8888_to_rgb_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 2)), 5)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[0], 3)), 11)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_rgb_555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)), 5)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[0], 3)), 10)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_rgba_5551_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)), 1),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)), 6)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[0], 3)), 11)),
+            vdupq_n_u16(0x1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_argb_1555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vorrq_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)), 5)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[0], 3)), 10)),
+            vdupq_n_u16(0x8000)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_abgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[0];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[2];
+         out.val[3] = vdupq_n_u8(0xff);
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_bgr_888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x3_t out;
+         out.val[0] = in.val[0];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[2];
+         vst3q_u8((uint8_t *)(dst_ptr + x * 3), out);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_XBGR_8888_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void xbgr_8888_to_bgr_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)), 11),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 2)), 5)),
+            vmovl_u8(vshr_n_u8(in.val[0], 3))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_bgr_555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)), 10),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)), 5)),
+            vmovl_u8(vshr_n_u8(in.val[0], 3))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_rgbx_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = vdupq_n_u8(0);
+         out.val[1] = in.val[2];
+         out.val[2] = in.val[1];
+         out.val[3] = in.val[0];
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_xrgb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[2];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[0];
+         out.val[3] = vdupq_n_u8(0);
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_abgr_8888_le_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[0];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[2];
+         out.val[3] = vdupq_n_u8(0xff);
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_rgba_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 4)), 4),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 4)), 8)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[0], 4)), 12)),
+            vdupq_n_u16(0xf)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+static void bgr_888_to_argb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint8_t *src_ptr = (const uint8_t *)((const char *)src + (sy + y) * src_pitch) + sx * 3;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x3_t in = vld3q_u8((const uint8_t *)(src_ptr + x * 3));
+         uint8x16x4_t out;
+         out.val[0] = in.val[2];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[0];
+         out.val[3] = vdupq_n_u8(0xff);
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         const uint8_t *p = src_ptr + x * 3;
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_888_TO_ARGB_8888(p[0] | (p[1] << 8) | (p[2] << 16));
+      }
+   }
+}
+static void bgr_888_to_rgba_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint8_t *src_ptr = (const uint8_t *)((const char *)src + (sy + y) * src_pitch) + sx * 3;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x3_t in = vld3q_u8((const uint8_t *)(src_ptr + x * 3));
+         uint8x16x4_t out;
+         out.val[0] = vdupq_n_u8(0xff);
+         out.val[1] = in.val[2];
+         out.val[2] = in.val[1];
+         out.val[3] = in.val[0];
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         const uint8_t *p = src_ptr + x * 3;
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_888_TO_RGBA_8888(p[0] | (p[1] << 8) | (p[2] << 16));
+      }
+   }
+}
+static void bgr_888_to_abgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint8_t *src_ptr = (const uint8_t *)((const char *)src + (sy + y) * src_pitch) + sx * 3;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x3_t in = vld3q_u8((const uint8_t *)(src_ptr + x * 3));
+         uint8x16x4_t out;
+         out.val[0] = in.val[0];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[2];
+         out.val[3] = vdupq_n_u8(0xff);
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         const uint8_t *p = src_ptr + x * 3;
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_888_TO_ABGR_8888(p[0] | (p[1] << 8) | (p[2] << 16));
+      }
+   }
+}
+static void bgr_888_to_xbgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint8_t *src_ptr = (const uint8_t *)((const char *)src + (sy + y) * src_pitch) + sx * 3;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x3_t in = vld3q_u8((const uint8_t *)(src_ptr + x * 3));
+         uint8x16x4_t out;
+         out.val[0] = in.val[0];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[2];
+         out.val[3] = vdupq_n_u8(0);
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         const uint8_t *p = src_ptr + x * 3;
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_888_TO_XBGR_8888(p[0] | (p[1] << 8) | (p[2] << 16));
+      }
+   }
+}
+static void bgr_888_to_rgbx_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint8_t *src_ptr = (const uint8_t *)((const char *)src + (sy + y) * src_pitch) + sx * 3;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x3_t in = vld3q_u8((const uint8_t *)(src_ptr + x * 3));
+         uint8x16x4_t out;
+         out.val[0] = vdupq_n_u8(0);
+         out.val[1] = in.val[2];
+         out.val[2] = in.val[1];
+         out.val[3] = in.val[0];
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         const uint8_t *p = src_ptr + x * 3;
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_888_TO_RGBX_8888(p[0] | (p[1] << 8) | (p[2] << 16));
+      }
+   }
+}
+static void bgr_888_to_xrgb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint8_t *src_ptr = (const uint8_t *)((const char *)src + (sy + y) * src_pitch) + sx * 3;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x3_t in = vld3q_u8((const uint8_t *)(src_ptr + x * 3));
+         uint8x16x4_t out;
+         out.val[0] = in.val[2];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[0];
+         out.val[3] = vdupq_n_u8(0);
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         const uint8_t *p = src_ptr + x * 3;
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_888_TO_XRGB_8888(p[0] | (p[1] << 8) | (p[2] << 16));
+      }
+   }
+}
+static void bgr_888_to_abgr_8888_le_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint8_t *src_ptr = (const uint8_t *)((const char *)src + (sy + y) * src_pitch) + sx * 3;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x3_t in = vld3q_u8((const uint8_t *)(src_ptr + x * 3));
+         uint8x16x4_t out;
+         out.val[0] = in.val[0];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[2];
+         out.val[3] = vdupq_n_u8(0xff);
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         const uint8_t *p = src_ptr + x * 3;
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_888_TO_ABGR_8888_LE(p[0] | (p[1] << 8) | (p[2] << 16));
+      }
+   }
+}
+static void bgr_565_to_argb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vshrq_n_u16(p, 11), 1053), 7));
+         out.val[1] = vmovn_u16(vshrq_n_u16(neon_mulhi_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x3f)), 255), 8323), 3));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[3] = vdup_n_u8(0xff);
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_565_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void bgr_565_to_rgba_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vdup_n_u8(0xff);
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vshrq_n_u16(p, 11), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(neon_mulhi_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x3f)), 255), 8323), 3));
+         out.val[3] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_565_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static void bgr_565_to_abgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[1] = vmovn_u16(vshrq_n_u16(neon_mulhi_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x3f)), 255), 8323), 3));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vshrq_n_u16(p, 11), 1053), 7));
+         out.val[3] = vdup_n_u8(0xff);
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_565_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void bgr_565_to_xbgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[1] = vmovn_u16(vshrq_n_u16(neon_mulhi_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x3f)), 255), 8323), 3));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vshrq_n_u16(p, 11), 1053), 7));
+         out.val[3] = vdup_n_u8(0);
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_565_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void bgr_565_to_rgbx_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vdup_n_u8(0);
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vshrq_n_u16(p, 11), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(neon_mulhi_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x3f)), 255), 8323), 3));
+         out.val[3] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_565_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static void bgr_565_to_xrgb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vshrq_n_u16(p, 11), 1053), 7));
+         out.val[1] = vmovn_u16(vshrq_n_u16(neon_mulhi_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x3f)), 255), 8323), 3));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[3] = vdup_n_u8(0);
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_565_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void bgr_565_to_abgr_8888_le_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[1] = vmovn_u16(vshrq_n_u16(neon_mulhi_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x3f)), 255), 8323), 3));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vshrq_n_u16(p, 11), 1053), 7));
+         out.val[3] = vdup_n_u8(0xff);
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_565_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static void bgr_555_to_argb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 10), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[3] = vdup_n_u8(0xff);
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_555_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void bgr_555_to_rgba_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vdup_n_u8(0xff);
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 10), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[3] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_555_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static void bgr_555_to_abgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 10), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[3] = vdup_n_u8(0xff);
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_555_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void bgr_555_to_xbgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 10), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[3] = vdup_n_u8(0);
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_555_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void bgr_555_to_rgbx_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vdup_n_u8(0);
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 10), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[3] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_555_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static void bgr_555_to_xrgb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 10), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[3] = vdup_n_u8(0);
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_555_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void bgr_555_to_abgr_8888_le_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[1] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[2] = vmovn_u16(vshrq_n_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 10), vdupq_n_u16(0x1f)), 1053), 7));
+         out.val[3] = vdup_n_u8(0xff);
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_BGR_555_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_argb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[1];
+         out.val[1] = in.val[2];
+         out.val[2] = in.val[3];
+         out.val[3] = vdupq_n_u8(0xff);
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_rgba_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = vdupq_n_u8(0xff);
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[2];
+         out.val[3] = in.val[3];
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_argb_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vorrq_u16(vmovl_u8(vshr_n_u8(in.val[1], 4)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 4)), 4)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[3], 4)), 8)),
+            vdupq_n_u16(0xf000)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_rgb_888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x3_t out;
+         out.val[0] = in.val[1];
+         out.val[1] = in.val[2];
+         out.val[2] = in.val[3];
+         vst3q_u8((uint8_t *)(dst_ptr + x * 3), out);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_RGBX_8888_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void rgbx_8888_to_rgb_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 2)), 5)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[3], 3)), 11)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_rgb_555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)), 5)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[3], 3)), 10)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_rgba_5551_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)), 1),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)), 6)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[3], 3)), 11)),
+            vdupq_n_u16(0x1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_argb_1555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vorrq_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)), 5)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[3], 3)), 10)),
+            vdupq_n_u16(0x8000)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_abgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[3];
+         out.val[1] = in.val[2];
+         out.val[2] = in.val[1];
+         out.val[3] = vdupq_n_u8(0xff);
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_xbgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[3];
+         out.val[1] = in.val[2];
+         out.val[2] = in.val[1];
+         out.val[3] = vdupq_n_u8(0);
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_bgr_888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x3_t out;
+         out.val[0] = in.val[3];
+         out.val[1] = in.val[2];
+         out.val[2] = in.val[1];
+         vst3q_u8((uint8_t *)(dst_ptr + x * 3), out);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_RGBX_8888_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void rgbx_8888_to_bgr_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)), 11),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 2)), 5)),
+            vmovl_u8(vshr_n_u8(in.val[3], 3))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_bgr_555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)), 10),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)), 5)),
+            vmovl_u8(vshr_n_u8(in.val[3], 3))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_xrgb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[1];
+         out.val[1] = in.val[2];
+         out.val[2] = in.val[3];
+         out.val[3] = vdupq_n_u8(0);
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_abgr_8888_le_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[3];
+         out.val[1] = in.val[2];
+         out.val[2] = in.val[1];
+         out.val[3] = vdupq_n_u8(0xff);
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_rgba_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 4)), 4),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 4)), 8)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[3], 4)), 12)),
+            vdupq_n_u16(0xf)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_argb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[0];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[2];
+         out.val[3] = vdupq_n_u8(0xff);
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_rgba_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = vdupq_n_u8(0xff);
+         out.val[1] = in.val[0];
+         out.val[2] = in.val[1];
+         out.val[3] = in.val[2];
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_argb_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vorrq_u16(vmovl_u8(vshr_n_u8(in.val[0], 4)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 4)), 4)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 4)), 8)),
+            vdupq_n_u16(0xf000)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_rgb_888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x3_t out;
+         out.val[0] = in.val[0];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[2];
+         vst3q_u8((uint8_t *)(dst_ptr + x * 3), out);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_XRGB_8888_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void xrgb_8888_to_rgb_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vmovl_u8(vshr_n_u8(in.val[0], 3)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 2)), 5)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)), 11)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_rgb_555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vmovl_u8(vshr_n_u8(in.val[0], 3)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)), 5)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)), 10)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_rgba_5551_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[0], 3)), 1),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)), 6)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)), 11)),
+            vdupq_n_u16(0x1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_argb_1555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vorrq_u16(vmovl_u8(vshr_n_u8(in.val[0], 3)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)), 5)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)), 10)),
+            vdupq_n_u16(0x8000)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_abgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[2];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[0];
+         out.val[3] = vdupq_n_u8(0xff);
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_xbgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[2];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[0];
+         out.val[3] = vdupq_n_u8(0);
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_bgr_888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x3_t out;
+         out.val[0] = in.val[2];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[0];
+         vst3q_u8((uint8_t *)(dst_ptr + x * 3), out);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_XRGB_8888_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void xrgb_8888_to_bgr_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[0], 3)), 11),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 2)), 5)),
+            vmovl_u8(vshr_n_u8(in.val[2], 3))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_bgr_555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[0], 3)), 10),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)), 5)),
+            vmovl_u8(vshr_n_u8(in.val[2], 3))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_rgbx_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = vdupq_n_u8(0);
+         out.val[1] = in.val[0];
+         out.val[2] = in.val[1];
+         out.val[3] = in.val[2];
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_abgr_8888_le_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[2];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[0];
+         out.val[3] = vdupq_n_u8(0xff);
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_rgba_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[0], 4)), 4),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 4)), 8)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 4)), 12)),
+            vdupq_n_u16(0xf)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_argb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[2];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[0];
+         out.val[3] = in.val[3];
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_rgba_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[3];
+         out.val[1] = in.val[2];
+         out.val[2] = in.val[1];
+         out.val[3] = in.val[0];
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_argb_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[3], 4)), 12),
+            vmovl_u8(vshr_n_u8(in.val[2], 4))),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 4)), 4)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[0], 4)), 8)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_rgb_888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x3_t out;
+         out.val[0] = in.val[2];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[0];
+         vst3q_u8((uint8_t *)(dst_ptr + x * 3), out);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void abgr_8888_le_to_rgb_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 2)), 5)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[0], 3)), 11)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_rgb_555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)), 5)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[0], 3)), 10)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_rgba_5551_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vorrq_u16(vmovl_u8(vshr_n_u8(in.val[3], 7)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)), 1)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)), 6)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[0], 3)), 11)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_argb_1555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[3], 7)), 15),
+            vmovl_u8(vshr_n_u8(in.val[2], 3))),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)), 5)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[0], 3)), 10)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_abgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[0];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[2];
+         out.val[3] = in.val[3];
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_xbgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[0];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[2];
+         out.val[3] = vdupq_n_u8(0);
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_bgr_888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x3_t out;
+         out.val[0] = in.val[0];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[2];
+         vst3q_u8((uint8_t *)(dst_ptr + x * 3), out);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_ABGR_8888_LE_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void abgr_8888_le_to_bgr_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)), 11),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 2)), 5)),
+            vmovl_u8(vshr_n_u8(in.val[0], 3))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_bgr_555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 3)), 10),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 3)), 5)),
+            vmovl_u8(vshr_n_u8(in.val[0], 3))));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_rgbx_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = vdupq_n_u8(0);
+         out.val[1] = in.val[2];
+         out.val[2] = in.val[1];
+         out.val[3] = in.val[0];
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_xrgb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 16 <= width; x += 16) {
+         uint8x16x4_t in = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x4_t out;
+         out.val[0] = in.val[2];
+         out.val[1] = in.val[1];
+         out.val[2] = in.val[0];
+         out.val[3] = vdupq_n_u8(0);
+         vst4q_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_rgba_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint8x8x4_t in = vld4_u8((const uint8_t *)(src_ptr + x));
+         vst1q_u16(dst_ptr + x, vorrq_u16(vorrq_u16(vorrq_u16(vmovl_u8(vshr_n_u8(in.val[3], 4)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[2], 4)), 4)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[1], 4)), 8)),
+            vshlq_n_u16(vmovl_u8(vshr_n_u8(in.val[0], 4)), 12)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+static void rgba_4444_to_argb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 4), vdupq_n_u16(0xf)), 17));
+         out.val[1] = vmovn_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 8), vdupq_n_u16(0xf)), 17));
+         out.val[2] = vmovn_u16(vmulq_n_u16(vshrq_n_u16(p, 12), 17));
+         out.val[3] = vmovn_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0xf)), 17));
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_4444_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgba_4444_to_rgba_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0xf)), 17));
+         out.val[1] = vmovn_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 4), vdupq_n_u16(0xf)), 17));
+         out.val[2] = vmovn_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 8), vdupq_n_u16(0xf)), 17));
+         out.val[3] = vmovn_u16(vmulq_n_u16(vshrq_n_u16(p, 12), 17));
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_4444_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgba_4444_to_abgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vmulq_n_u16(vshrq_n_u16(p, 12), 17));
+         out.val[1] = vmovn_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 8), vdupq_n_u16(0xf)), 17));
+         out.val[2] = vmovn_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 4), vdupq_n_u16(0xf)), 17));
+         out.val[3] = vmovn_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0xf)), 17));
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_4444_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgba_4444_to_xbgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vmulq_n_u16(vshrq_n_u16(p, 12), 17));
+         out.val[1] = vmovn_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 8), vdupq_n_u16(0xf)), 17));
+         out.val[2] = vmovn_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 4), vdupq_n_u16(0xf)), 17));
+         out.val[3] = vdup_n_u8(0);
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_4444_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgba_4444_to_rgbx_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vdup_n_u8(0);
+         out.val[1] = vmovn_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 4), vdupq_n_u16(0xf)), 17));
+         out.val[2] = vmovn_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 8), vdupq_n_u16(0xf)), 17));
+         out.val[3] = vmovn_u16(vmulq_n_u16(vshrq_n_u16(p, 12), 17));
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_4444_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgba_4444_to_xrgb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 4), vdupq_n_u16(0xf)), 17));
+         out.val[1] = vmovn_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 8), vdupq_n_u16(0xf)), 17));
+         out.val[2] = vmovn_u16(vmulq_n_u16(vshrq_n_u16(p, 12), 17));
+         out.val[3] = vdup_n_u8(0);
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_4444_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgba_4444_to_abgr_8888_le_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int x, y;
+   for (y = 0; y < height; y++) {
+      const uint16_t *src_ptr = (const uint16_t *)((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)((char *)dst + (dy + y) * dst_pitch) + dx;
+      for (x = 0; x + 8 <= width; x += 8) {
+         uint16x8_t p = vld1q_u16(src_ptr + x);
+         uint8x8x4_t out;
+         out.val[0] = vmovn_u16(vmulq_n_u16(vshrq_n_u16(p, 12), 17));
+         out.val[1] = vmovn_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 8), vdupq_n_u16(0xf)), 17));
+         out.val[2] = vmovn_u16(vmulq_n_u16(vandq_u16(vshrq_n_u16(p, 4), vdupq_n_u16(0xf)), 17));
+         out.val[3] = vmovn_u16(vmulq_n_u16(vandq_u16(p, vdupq_n_u16(0xf)), 17));
+         vst4_u8((uint8_t *)(dst_ptr + x), out);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_4444_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static void (*_al_convert_funcs_neon[ALLEGRO_NUM_PIXEL_FORMATS]
+   [ALLEGRO_NUM_PIXEL_FORMATS])(const void *, int, void *, int,
+   int, int, int, int, int, int) = {
+   {NULL},
+   {NULL},
+   {NULL},
+   {NULL},
+   {NULL},
+   {NULL},
+   {NULL},
+   {NULL},
+   {NULL},
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      argb_8888_to_rgba_8888_neon,
+      argb_8888_to_argb_4444_neon,
+      argb_8888_to_rgb_888_neon,
+      argb_8888_to_rgb_565_neon,
+      argb_8888_to_rgb_555_neon,
+      argb_8888_to_rgba_5551_neon,
+      argb_8888_to_argb_1555_neon,
+      argb_8888_to_abgr_8888_neon,
+      argb_8888_to_xbgr_8888_neon,
+      argb_8888_to_bgr_888_neon,
+      argb_8888_to_bgr_565_neon,
+      argb_8888_to_bgr_555_neon,
+      argb_8888_to_rgbx_8888_neon,
+      argb_8888_to_xrgb_8888_neon,
+      NULL,
+      argb_8888_to_abgr_8888_le_neon,
+      argb_8888_to_rgba_4444_neon,
+      NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      rgba_8888_to_argb_8888_neon,
+      NULL,
+      rgba_8888_to_argb_4444_neon,
+      rgba_8888_to_rgb_888_neon,
+      rgba_8888_to_rgb_565_neon,
+      rgba_8888_to_rgb_555_neon,
+      rgba_8888_to_rgba_5551_neon,
+      rgba_8888_to_argb_1555_neon,
+      rgba_8888_to_abgr_8888_neon,
+      rgba_8888_to_xbgr_8888_neon,
+      rgba_8888_to_bgr_888_neon,
+      rgba_8888_to_bgr_565_neon,
+      rgba_8888_to_bgr_555_neon,
+      rgba_8888_to_rgbx_8888_neon,
+      rgba_8888_to_xrgb_8888_neon,
+      NULL,
+      rgba_8888_to_abgr_8888_le_neon,
+      rgba_8888_to_rgba_4444_neon,
+      NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      argb_4444_to_argb_8888_neon,
+      argb_4444_to_rgba_8888_neon,
+      NULL, NULL, NULL, NULL, NULL, NULL,
+      argb_4444_to_abgr_8888_neon,
+      argb_4444_to_xbgr_8888_neon,
+      NULL, NULL, NULL,
+      argb_4444_to_rgbx_8888_neon,
+      argb_4444_to_xrgb_8888_neon,
+      NULL,
+      argb_4444_to_abgr_8888_le_neon,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      rgb_888_to_argb_8888_neon,
+      rgb_888_to_rgba_8888_neon,
+      NULL, NULL, NULL, NULL, NULL, NULL,
+      rgb_888_to_abgr_8888_neon,
+      rgb_888_to_xbgr_8888_neon,
+      NULL, NULL, NULL,
+      rgb_888_to_rgbx_8888_neon,
+      rgb_888_to_xrgb_8888_neon,
+      NULL,
+      rgb_888_to_abgr_8888_le_neon,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      rgb_565_to_argb_8888_neon,
+      rgb_565_to_rgba_8888_neon,
+      NULL, NULL, NULL, NULL, NULL, NULL,
+      rgb_565_to_abgr_8888_neon,
+      rgb_565_to_xbgr_8888_neon,
+      NULL, NULL, NULL,
+      rgb_565_to_rgbx_8888_neon,
+      rgb_565_to_xrgb_8888_neon,
+      NULL,
+      rgb_565_to_abgr_8888_le_neon,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      rgb_555_to_argb_8888_neon,
+      rgb_555_to_rgba_8888_neon,
+      NULL, NULL, NULL, NULL, NULL, NULL,
+      rgb_555_to_abgr_8888_neon,
+      rgb_555_to_xbgr_8888_neon,
+      NULL, NULL, NULL,
+      rgb_555_to_rgbx_8888_neon,
+      rgb_555_to_xrgb_8888_neon,
+      NULL,
+      rgb_555_to_abgr_8888_le_neon,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      rgba_5551_to_argb_8888_neon,
+      rgba_5551_to_rgba_8888_neon,
+      NULL, NULL, NULL, NULL, NULL, NULL,
+      rgba_5551_to_abgr_8888_neon,
+      rgba_5551_to_xbgr_8888_neon,
+      NULL, NULL, NULL,
+      rgba_5551_to_rgbx_8888_neon,
+      rgba_5551_to_xrgb_8888_neon,
+      NULL,
+      rgba_5551_to_abgr_8888_le_neon,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      argb_1555_to_argb_8888_neon,
+      argb_1555_to_rgba_8888_neon,
+      NULL, NULL, NULL, NULL, NULL, NULL,
+      argb_1555_to_abgr_8888_neon,
+      argb_1555_to_xbgr_8888_neon,
+      NULL, NULL, NULL,
+      argb_1555_to_rgbx_8888_neon,
+      argb_1555_to_xrgb_8888_neon,
+      NULL,
+      argb_1555_to_abgr_8888_le_neon,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      abgr_8888_to_argb_8888_neon,
+      abgr_8888_to_rgba_8888_neon,
+      abgr_8888_to_argb_4444_neon,
+      abgr_8888_to_rgb_888_neon,
+      abgr_8888_to_rgb_565_neon,
+      abgr_8888_to_rgb_555_neon,
+      abgr_8888_to_rgba_5551_neon,
+      abgr_8888_to_argb_1555_neon,
+      NULL,
+      abgr_8888_to_xbgr_8888_neon,
+      abgr_8888_to_bgr_888_neon,
+      abgr_8888_to_bgr_565_neon,
+      abgr_8888_to_bgr_555_neon,
+      abgr_8888_to_rgbx_8888_neon,
+      abgr_8888_to_xrgb_8888_neon,
+      NULL,
+      abgr_8888_to_abgr_8888_le_neon,
+      abgr_8888_to_rgba_4444_neon,
+      NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      xbgr_8888_to_argb_8888_neon,
+      xbgr_8888_to_rgba_8888_neon,
+      xbgr_8888_to_argb_4444_neon,
+      xbgr_8888_to_rgb_888_neon,
+      xbgr_8888_to_rgb_565_neon,
+      xbgr_8888_to_rgb_555_neon,
+      xbgr_8888_to_rgba_5551_neon,
+      xbgr_8888_to_argb_1555_neon,
+      xbgr_8888_to_abgr_8888_neon,
+      NULL,
+      xbgr_8888_to_bgr_888_neon,
+      xbgr_8888_to_bgr_565_neon,
+      xbgr_8888_to_bgr_555_neon,
+      xbgr_8888_to_rgbx_8888_neon,
+      xbgr_8888_to_xrgb_8888_neon,
+      NULL,
+      xbgr_8888_to_abgr_8888_le_neon,
+      xbgr_8888_to_rgba_4444_neon,
+      NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      bgr_888_to_argb_8888_neon,
+      bgr_888_to_rgba_8888_neon,
+      NULL, NULL, NULL, NULL, NULL, NULL,
+      bgr_888_to_abgr_8888_neon,
+      bgr_888_to_xbgr_8888_neon,
+      NULL, NULL, NULL,
+      bgr_888_to_rgbx_8888_neon,
+      bgr_888_to_xrgb_8888_neon,
+      NULL,
+      bgr_888_to_abgr_8888_le_neon,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      bgr_565_to_argb_8888_neon,
+      bgr_565_to_rgba_8888_neon,
+      NULL, NULL, NULL, NULL, NULL, NULL,
+      bgr_565_to_abgr_8888_neon,
+      bgr_565_to_xbgr_8888_neon,
+      NULL, NULL, NULL,
+      bgr_565_to_rgbx_8888_neon,
+      bgr_565_to_xrgb_8888_neon,
+      NULL,
+      bgr_565_to_abgr_8888_le_neon,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      bgr_555_to_argb_8888_neon,
+      bgr_555_to_rgba_8888_neon,
+      NULL, NULL, NULL, NULL, NULL, NULL,
+      bgr_555_to_abgr_8888_neon,
+      bgr_555_to_xbgr_8888_neon,
+      NULL, NULL, NULL,
+      bgr_555_to_rgbx_8888_neon,
+      bgr_555_to_xrgb_8888_neon,
+      NULL,
+      bgr_555_to_abgr_8888_le_neon,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      rgbx_8888_to_argb_8888_neon,
+      rgbx_8888_to_rgba_8888_neon,
+      rgbx_8888_to_argb_4444_neon,
+      rgbx_8888_to_rgb_888_neon,
+      rgbx_8888_to_rgb_565_neon,
+      rgbx_8888_to_rgb_555_neon,
+      rgbx_8888_to_rgba_5551_neon,
+      rgbx_8888_to_argb_1555_neon,
+      rgbx_8888_to_abgr_8888_neon,
+      rgbx_8888_to_xbgr_8888_neon,
+      rgbx_8888_to_bgr_888_neon,
+      rgbx_8888_to_bgr_565_neon,
+      rgbx_8888_to_bgr_555_neon,
+      NULL,
+      rgbx_8888_to_xrgb_8888_neon,
+      NULL,
+      rgbx_8888_to_abgr_8888_le_neon,
+      rgbx_8888_to_rgba_4444_neon,
+      NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      xrgb_8888_to_argb_8888_neon,
+      xrgb_8888_to_rgba_8888_neon,
+      xrgb_8888_to_argb_4444_neon,
+      xrgb_8888_to_rgb_888_neon,
+      xrgb_8888_to_rgb_565_neon,
+      xrgb_8888_to_rgb_555_neon,
+      xrgb_8888_to_rgba_5551_neon,
+      xrgb_8888_to_argb_1555_neon,
+      xrgb_8888_to_abgr_8888_neon,
+      xrgb_8888_to_xbgr_8888_neon,
+      xrgb_8888_to_bgr_888_neon,
+      xrgb_8888_to_bgr_565_neon,
+      xrgb_8888_to_bgr_555_neon,
+      xrgb_8888_to_rgbx_8888_neon,
+      NULL, NULL,
+      xrgb_8888_to_abgr_8888_le_neon,
+      xrgb_8888_to_rgba_4444_neon,
+      NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      abgr_8888_le_to_argb_8888_neon,
+      abgr_8888_le_to_rgba_8888_neon,
+      abgr_8888_le_to_argb_4444_neon,
+      abgr_8888_le_to_rgb_888_neon,
+      abgr_8888_le_to_rgb_565_neon,
+      abgr_8888_le_to_rgb_555_neon,
+      abgr_8888_le_to_rgba_5551_neon,
+      abgr_8888_le_to_argb_1555_neon,
+      abgr_8888_le_to_abgr_8888_neon,
+      abgr_8888_le_to_xbgr_8888_neon,
+      abgr_8888_le_to_bgr_888_neon,
+      abgr_8888_le_to_bgr_565_neon,
+      abgr_8888_le_to_bgr_555_neon,
+      abgr_8888_le_to_rgbx_8888_neon,
+      abgr_8888_le_to_xrgb_8888_neon,
+      NULL, NULL,
+      abgr_8888_le_to_rgba_4444_neon,
+      NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      rgba_4444_to_argb_8888_neon,
+      rgba_4444_to_rgba_8888_neon,
+      NULL, NULL, NULL, NULL, NULL, NULL,
+      rgba_4444_to_abgr_8888_neon,
+      rgba_4444_to_xbgr_8888_neon,
+      NULL, NULL, NULL,
+      rgba_4444_to_rgbx_8888_neon,
+      rgba_4444_to_xrgb_8888_neon,
+      NULL,
+      rgba_4444_to_abgr_8888_le_neon,
+      NULL, NULL, NULL, NULL, NULL,
+   },
+   {
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+   },
+   {NULL},
+   {NULL},
+   {NULL},
+};
+#endif
+#endif
+
+/* Return the fastest SIMD conversion function available with the given
+ * _AL_CPU_* features, or NULL.
+ */
+_AL_CONVERT_FUNC _al_get_simd_convert_func(int src_format, int dst_format,
+   int features)
+{
+   _AL_CONVERT_FUNC func = NULL;
+#if defined(ALLEGRO_LITTLE_ENDIAN) && defined(_AL_SIMD_X86)
+   if (!func && (features & _AL_CPU_AVX2))
+      func = _al_convert_funcs_avx2[src_format][dst_format];
+   if (!func && (features & _AL_CPU_SSSE3))
+      func = _al_convert_funcs_ssse3[src_format][dst_format];
+   if (!func && (features & _AL_CPU_SSE2))
+      func = _al_convert_funcs_sse2[src_format][dst_format];
+#elif defined(ALLEGRO_LITTLE_ENDIAN) && defined(_AL_SIMD_NEON)
+   if (features & _AL_CPU_NEON)
+      func = _al_convert_funcs_neon[src_format][dst_format];
+#else
+   (void)src_format;
+   (void)dst_format;
+   (void)features;
+#endif
+   return func;
+}
+
+// Warning: This file was created by make_converters.py - do not edit.
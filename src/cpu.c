@@ -18,6 +18,7 @@
 #include "allegro5/allegro.h"
 #include "allegro5/cpu.h"
 #include "allegro5/internal/aintern.h"
+#include "allegro5/internal/aintern_cpu.h"
 
 /* 
 * The CPU and pysical memory detection functions below use 
@@ -37,6 +38,11 @@
 #include <sys/sysctl.h>
 #endif
 
+#if defined(_MSC_VER) && defined(_AL_SIMD_X86)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
 #ifdef ALLEGRO_WINDOWS
 #ifndef WINVER
 #define WINVER 0x0500
@@ -107,5 +113,70 @@ int al_get_ram_size(void)
 }
 
 
+static int features_mask = ~0;
+
+
+/* Internal function: _al_get_cpu_features
+ *  Returns the set of _AL_CPU_* flags supported by the processor we are
+ *  running on.  The result is computed once; concurrent first calls just
+ *  compute the same value twice.
+ */
+int _al_get_cpu_features(void)
+{
+   static int features = -1;
+   int f = 0;
+
+   if (features >= 0)
+      return features & features_mask;
+
+#if defined(_AL_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+   __builtin_cpu_init();
+   if (__builtin_cpu_supports("sse2"))
+      f |= _AL_CPU_SSE2;
+   if (__builtin_cpu_supports("ssse3"))
+      f |= _AL_CPU_SSSE3;
+   if (__builtin_cpu_supports("avx2"))
+      f |= _AL_CPU_AVX2;
+#elif defined(_AL_SIMD_X86) && defined(_MSC_VER)
+   {
+      int info[4];
+      __cpuid(info, 0);
+      if (info[0] >= 1) {
+         __cpuid(info, 1);
+         if (info[3] & (1 << 26))
+            f |= _AL_CPU_SSE2;
+         if (info[2] & (1 << 9))
+            f |= _AL_CPU_SSSE3;
+         /* AVX2 also needs the OS to save the YMM registers (OSXSAVE). */
+         if ((info[2] & (1 << 27)) && (_xgetbv(0) & 6) == 6) {
+            __cpuid(info, 0);
+            if (info[0] >= 7) {
+               __cpuidex(info, 7, 0);
+               if (info[1] & (1 << 5))
+                  f |= _AL_CPU_AVX2;
+            }
+         }
+      }
+   }
+#elif defined(_AL_SIMD_NEON)
+   f |= _AL_CPU_NEON;
+#endif
+
+   features = f;
+   return features & features_mask;
+}
+
+
+/* Internal function: _al_mask_cpu_features
+ *  Makes _al_get_cpu_features leave out the flags not in mask, so that tests
+ *  can compare the SIMD code with the plain C code.  Code which has already
+ *  picked its functions keeps them.
+ */
+void _al_mask_cpu_features(int mask)
+{
+   features_mask = mask;
+}
+
+
 /* vi: set ts=4 sw=4 expandtab: */
       
@@ -26,6 +26,7 @@
 #include "allegro5/internal/aintern.h"
 #include "allegro5/internal/aintern_bitmap.h"
 #include "allegro5/internal/aintern_display.h"
+#include "allegro5/internal/aintern_memblit.h"
 #include "allegro5/internal/aintern_shader.h"
 #include "allegro5/internal/aintern_system.h"
 
@@ -496,6 +497,11 @@ void al_hold_bitmap_drawing(bool hold)
 {
    ALLEGRO_DISPLAY *current_display = al_get_current_display();
 
+   /* Blits to memory bitmaps are batched separately, and also without a
+    * current display.
+    */
+   _al_hold_memory_bitmap_drawing(hold);
+
    if (current_display) {
       if (hold && !current_display->cache_enabled) {
          /*
@@ -535,7 +541,7 @@ bool al_is_bitmap_drawing_held(void)
    if (current_display)
       return current_display->cache_enabled;
    else
-      return false;
+      return _al_is_memory_bitmap_drawing_held();
 }
 
 void _al_add_display_invalidated_callback(ALLEGRO_DISPLAY* display, void (*display_invalidated)(ALLEGRO_DISPLAY*))
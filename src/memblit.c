@@ -19,9 +19,12 @@
 #include "allegro5/internal/aintern_blend.h"
 #include "allegro5/internal/aintern_convert.h"
 #include "allegro5/internal/aintern_memblit.h"
+#include "allegro5/internal/aintern_tls.h"
 #include "allegro5/internal/aintern_transform.h"
 #include "allegro5/internal/aintern_tri_soft.h"
 #include <math.h>
+#include <stdlib.h>
+#include <string.h>
 
 #define MIN _ALLEGRO_MIN
 #define MAX _ALLEGRO_MAX
@@ -33,6 +36,25 @@ static void _al_draw_transformed_scaled_bitmap_memory(
 static void _al_draw_bitmap_region_memory_fast(ALLEGRO_BITMAP *bitmap,
    int sx, int sy, int sw, int sh,
    int dx, int dy, int flags);
+static bool can_blend_premul_fast(ALLEGRO_BITMAP *src, ALLEGRO_COLOR tint);
+static void _al_draw_bitmap_region_memory_premul(ALLEGRO_BITMAP *bitmap,
+   ALLEGRO_COLOR tint, int sx, int sy, int sw, int sh, int dx, int dy);
+
+
+/* A blit recorded while drawing to a memory bitmap is held. */
+struct _AL_MEMORY_DRAW
+{
+   ALLEGRO_BITMAP *bitmap;
+   ALLEGRO_COLOR tint;
+   int sx, sy, sw, sh;
+   int flags;
+   ALLEGRO_TRANSFORM transform;
+};
+
+/* Text drawing holds and releases the drawing for every string, so the
+ * storage of batches up to this size is kept around.
+ */
+#define MAX_KEPT_DRAWS  1024
 
 
 /* The CLIPPER macro takes pre-clipped coordinates for both the source
@@ -130,6 +152,43 @@ static void _al_draw_bitmap_region_memory_fast(ALLEGRO_BITMAP *bitmap,
 }
 
 
+/* Locks a region of a parent bitmap for blitting.  If the bitmap is locked
+ * already, e.g. while deferred drawing is flushed, the region is taken from
+ * the existing lock instead, provided it covers the region.  *unlock is set
+ * if the caller has to unlock the bitmap afterwards.
+ */
+static ALLEGRO_LOCKED_REGION *lock_blit_region(ALLEGRO_BITMAP *bitmap,
+   int x, int y, int w, int h, int flags, ALLEGRO_LOCKED_REGION *tmp,
+   bool *unlock)
+{
+   ALLEGRO_LOCKED_REGION *lr = &bitmap->locked_region;
+   ASSERT(bitmap->parent == NULL);
+
+   *unlock = false;
+
+   if (!bitmap->locked) {
+      lr = al_lock_bitmap_region(bitmap, x, y, w, h,
+         ALLEGRO_PIXEL_FORMAT_ANY, flags);
+      *unlock = (lr != NULL);
+      return lr;
+   }
+
+   if (x < bitmap->lock_x || y < bitmap->lock_y ||
+         x + w > bitmap->lock_x + bitmap->lock_w ||
+         y + h > bitmap->lock_y + bitmap->lock_h ||
+         !_al_pixel_format_is_real(lr->format) ||
+         ((bitmap->lock_flags & ALLEGRO_LOCK_READONLY) &&
+            flags != ALLEGRO_LOCK_READONLY)) {
+      return NULL;
+   }
+
+   *tmp = *lr;
+   tmp->data = (char *)lr->data + (y - bitmap->lock_y) * lr->pitch +
+      (x - bitmap->lock_x) * lr->pixel_size;
+   return tmp;
+}
+
+
 void _al_draw_bitmap_region_memory(ALLEGRO_BITMAP *src,
    ALLEGRO_COLOR tint,
    int sx, int sy, int sw, int sh,
@@ -152,6 +211,20 @@ void _al_draw_bitmap_region_memory(ALLEGRO_BITMAP *src,
       return;
    }
 
+   /* Translated blits with the default blender are by far the most common
+    * case, e.g. sprites and glyphs.  Blend those with integer arithmetic
+    * instead of going through the triangle rasterizer.
+    */
+   if (_AL_BLENDER_IS_PREMULTIPLIED_ALPHA && flags == 0 &&
+      _al_transform_is_translation(al_get_current_transform(), &xtrans, &ytrans) &&
+      xtrans == (int)xtrans && ytrans == (int)ytrans &&
+      can_blend_premul_fast(src, tint))
+   {
+      _al_draw_bitmap_region_memory_premul(src, tint, sx, sy, sw, sh,
+         dx + (int)xtrans, dy + (int)ytrans);
+      return;
+   }
+
    /* We used to have special cases for translation/scaling only, but the
     * general version received much more optimisation and ended up being
     * faster.
@@ -169,6 +242,7 @@ static void _al_draw_transformed_bitmap_memory(ALLEGRO_BITMAP *src,
    float xsf[4], ysf[4];
    int tl = 0, tr = 1, bl = 3, br = 2;
    int tmp;
+   bool unlock = false;
    ALLEGRO_VERTEX v[4];
 
    ASSERT(_al_pixel_format_is_real(al_get_bitmap_format(src)));
@@ -236,12 +310,18 @@ static void _al_draw_transformed_bitmap_memory(ALLEGRO_BITMAP *src,
    v[bl].v = sy + sh;
    v[bl].color = tint;
 
-   al_lock_bitmap(src, ALLEGRO_PIXEL_FORMAT_ANY, ALLEGRO_LOCK_READONLY);
+   /* The source may be locked already while deferred drawing is flushed. */
+   if (!al_is_bitmap_locked(src)) {
+      if (!al_lock_bitmap(src, ALLEGRO_PIXEL_FORMAT_ANY, ALLEGRO_LOCK_READONLY))
+         return;
+      unlock = true;
+   }
 
    _al_triangle_2d(src, &v[tl], &v[tr], &v[br]);
    _al_triangle_2d(src, &v[tl], &v[br], &v[bl]);
 
-   al_unlock_bitmap(src);
+   if (unlock)
+      al_unlock_bitmap(src);
 }
 
 
@@ -264,8 +344,9 @@ static void _al_draw_bitmap_region_memory_fast(ALLEGRO_BITMAP *bitmap,
    int sx, int sy, int sw, int sh,
    int dx, int dy, int flags)
 {
-   ALLEGRO_LOCKED_REGION *src_region;
-   ALLEGRO_LOCKED_REGION *dst_region;
+   ALLEGRO_LOCKED_REGION *src_region, src_tmp;
+   ALLEGRO_LOCKED_REGION *dst_region, dst_tmp;
+   bool src_unlock, dst_unlock;
    ALLEGRO_BITMAP *dest = al_get_target_bitmap();
    int dw = sw, dh = sh;
 
@@ -281,14 +362,15 @@ static void _al_draw_bitmap_region_memory_fast(ALLEGRO_BITMAP *bitmap,
 
    CLIPPER(bitmap, sx, sy, sw, sh, dest, dx, dy, dw, dh, 1, 1, flags)
 
-   if (!(src_region = al_lock_bitmap_region(bitmap, sx, sy, sw, sh,
-         ALLEGRO_PIXEL_FORMAT_ANY, ALLEGRO_LOCK_READONLY))) {
+   if (!(src_region = lock_blit_region(bitmap, sx, sy, sw, sh,
+         ALLEGRO_LOCK_READONLY, &src_tmp, &src_unlock))) {
       return;
    }
 
-   if (!(dst_region = al_lock_bitmap_region(dest, dx, dy, sw, sh,
-         ALLEGRO_PIXEL_FORMAT_ANY, ALLEGRO_LOCK_WRITEONLY))) {
-      al_unlock_bitmap(bitmap);
+   if (!(dst_region = lock_blit_region(dest, dx, dy, sw, sh,
+         ALLEGRO_LOCK_WRITEONLY, &dst_tmp, &dst_unlock))) {
+      if (src_unlock)
+         al_unlock_bitmap(bitmap);
       return;
    }
 
@@ -298,8 +380,305 @@ static void _al_draw_bitmap_region_memory_fast(ALLEGRO_BITMAP *bitmap,
       dst_region->data, dst_region->format, dst_region->pitch,
       0, 0, 0, 0, sw, sh);
 
-   al_unlock_bitmap(bitmap);
-   al_unlock_bitmap(dest);
+   if (src_unlock)
+      al_unlock_bitmap(bitmap);
+   if (dst_unlock)
+      al_unlock_bitmap(dest);
+}
+
+
+
+static bool can_blend_premul_fast(ALLEGRO_BITMAP *src, ALLEGRO_COLOR tint)
+{
+   ALLEGRO_BITMAP *dest = al_get_target_bitmap();
+   ALLEGRO_BITMAP *dest_root = dest->parent ? dest->parent : dest;
+
+   if (src == dest_root)
+      return false;
+   if (!_al_is_premul_blend_format(al_get_bitmap_format(src)) ||
+         !_al_is_premul_blend_format(al_get_bitmap_format(dest)))
+      return false;
+   return tint.r >= 0 && tint.r <= 1 && tint.g >= 0 && tint.g <= 1 &&
+      tint.b >= 0 && tint.b <= 1 && tint.a >= 0 && tint.a <= 1;
+}
+
+
+static void _al_draw_bitmap_region_memory_premul(ALLEGRO_BITMAP *bitmap,
+   ALLEGRO_COLOR tint, int sx, int sy, int sw, int sh, int dx, int dy)
+{
+   ALLEGRO_LOCKED_REGION *src_region, src_tmp;
+   ALLEGRO_LOCKED_REGION *dst_region, dst_tmp;
+   bool src_unlock, dst_unlock;
+   ALLEGRO_BITMAP *dest = al_get_target_bitmap();
+   _AL_PREMUL_ROW_FUNC blend_row;
+   _AL_PREMUL_BLEND pb;
+   int dw = sw, dh = sh;
+   int y;
+
+   ASSERT(bitmap->parent == NULL);
+
+   CLIPPER(bitmap, sx, sy, sw, sh, dest, dx, dy, dw, dh, 1, 1, 0)
+
+   if (!(src_region = lock_blit_region(bitmap, sx, sy, sw, sh,
+         ALLEGRO_LOCK_READONLY, &src_tmp, &src_unlock))) {
+      return;
+   }
+
+   if (!(dst_region = lock_blit_region(dest, dx, dy, sw, sh,
+         ALLEGRO_LOCK_READWRITE, &dst_tmp, &dst_unlock))) {
+      if (src_unlock)
+         al_unlock_bitmap(bitmap);
+      return;
+   }
+
+   _al_init_premul_blend(&pb, src_region->format, dst_region->format, tint);
+   blend_row = _al_get_premul_row_func();
+
+   for (y = 0; y < sh; y++) {
+      blend_row(
+         (uint32_t *)((char *)dst_region->data + y * dst_region->pitch),
+         (const uint32_t *)((const char *)src_region->data + y * src_region->pitch),
+         sw, &pb);
+   }
+
+   if (src_unlock)
+      al_unlock_bitmap(bitmap);
+   if (dst_unlock)
+      al_unlock_bitmap(dest);
+}
+
+
+
+static _AL_MEMORY_DRAW_BATCH *get_memory_draw_batch(bool create)
+{
+   _AL_MEMORY_DRAW_BATCH **batch = _al_tls_get_memory_draw_batch();
+
+   if (!batch)
+      return NULL;
+   if (!*batch && create)
+      *batch = al_calloc(1, sizeof(**batch));
+   return *batch;
+}
+
+
+
+static bool grow_memory_draw_batch(_AL_MEMORY_DRAW_BATCH *batch)
+{
+   int max_draws = batch->max_draws ? batch->max_draws * 2 : 64;
+   _AL_MEMORY_DRAW *draws;
+   ALLEGRO_BITMAP **sources;
+
+   draws = al_realloc(batch->draws, max_draws * sizeof(*draws));
+   if (!draws)
+      return false;
+   batch->draws = draws;
+
+   sources = al_realloc(batch->sources, max_draws * sizeof(*sources));
+   if (!sources)
+      return false;
+   batch->sources = sources;
+
+   batch->max_draws = max_draws;
+   return true;
+}
+
+
+
+static int compare_bitmaps(const void *a, const void *b)
+{
+   uintptr_t x = (uintptr_t)*(ALLEGRO_BITMAP * const *)a;
+   uintptr_t y = (uintptr_t)*(ALLEGRO_BITMAP * const *)b;
+   return (x > y) - (x < y);
+}
+
+
+
+static void flush_memory_draw_batch(_AL_MEMORY_DRAW_BATCH *batch)
+{
+   ALLEGRO_BITMAP *target = batch->target;
+   ALLEGRO_BITMAP *prev = NULL;
+   ALLEGRO_TRANSFORM backup;
+   int num_draws = batch->num_draws;
+   int num_locked = 0;
+   bool unlock_target = false;
+   int i;
+
+   if (num_draws == 0)
+      return;
+
+   /* Locking the bitmaps below must not flush the batch again. */
+   batch->num_draws = 0;
+
+   ASSERT(target == al_get_target_bitmap());
+   if (target->parent)
+      target = target->parent;
+
+   /* Lock the target and every source once for the whole batch, instead of
+    * once per blit.  The sources are sorted to find each of them once, but
+    * the blits keep their order since overlapping blended blits depend on
+    * it.  Bitmaps which are locked already are used as they are.
+    */
+   if (!target->locked) {
+      unlock_target = al_lock_bitmap(target, ALLEGRO_PIXEL_FORMAT_ANY,
+         ALLEGRO_LOCK_READWRITE) != NULL;
+   }
+
+   qsort(batch->sources, num_draws, sizeof(*batch->sources), compare_bitmaps);
+   for (i = 0; i < num_draws; i++) {
+      ALLEGRO_BITMAP *src = batch->sources[i];
+      if (src == prev)
+         continue;
+      prev = src;
+      if (!src->locked && al_lock_bitmap(src, ALLEGRO_PIXEL_FORMAT_ANY,
+            ALLEGRO_LOCK_READONLY)) {
+         batch->sources[num_locked++] = src;
+      }
+   }
+
+   al_copy_transform(&backup, al_get_current_transform());
+   for (i = 0; i < num_draws; i++) {
+      _AL_MEMORY_DRAW *draw = &batch->draws[i];
+      if (i == 0 || memcmp(&draw->transform, &draw[-1].transform,
+            sizeof(draw->transform)) != 0) {
+         al_use_transform(&draw->transform);
+      }
+      _al_draw_bitmap_region_memory(draw->bitmap, draw->tint,
+         draw->sx, draw->sy, draw->sw, draw->sh, 0, 0, draw->flags);
+   }
+   al_use_transform(&backup);
+
+   for (i = 0; i < num_locked; i++)
+      al_unlock_bitmap(batch->sources[i]);
+   if (unlock_target)
+      al_unlock_bitmap(target);
+}
+
+
+
+/* Records a blit of a parent bitmap to the target if drawing is held and
+ * the target is a memory bitmap.  Returns false if the blit should be done
+ * right away instead.
+ */
+bool _al_defer_bitmap_region_memory(ALLEGRO_BITMAP *bitmap,
+   ALLEGRO_COLOR tint, int sx, int sy, int sw, int sh, int flags)
+{
+   _AL_MEMORY_DRAW_BATCH *batch = get_memory_draw_batch(false);
+   ALLEGRO_BITMAP *target;
+   _AL_MEMORY_DRAW *draw;
+
+   ASSERT(bitmap->parent == NULL);
+
+   if (!batch || !batch->held)
+      return false;
+
+   target = al_get_target_bitmap();
+   if (!(al_get_bitmap_flags(target) & ALLEGRO_MEMORY_BITMAP) ||
+         !_al_pixel_format_is_real(al_get_bitmap_format(target)))
+      return false;
+
+   if (batch->target != target) {
+      flush_memory_draw_batch(batch);
+      batch->target = target;
+   }
+
+   if (batch->num_draws == batch->max_draws &&
+         !grow_memory_draw_batch(batch))
+      return false;
+
+   draw = &batch->draws[batch->num_draws];
+   draw->bitmap = bitmap;
+   draw->tint = tint;
+   draw->sx = sx;
+   draw->sy = sy;
+   draw->sw = sw;
+   draw->sh = sh;
+   draw->flags = flags;
+   al_copy_transform(&draw->transform, al_get_current_transform());
+   batch->sources[batch->num_draws] = bitmap;
+   batch->num_draws++;
+
+   return true;
+}
+
+
+
+/* Draws the deferred blits of the calling thread if they involve the given
+ * bitmap, either as source or as target, or unconditionally if it is NULL.
+ */
+void _al_flush_memory_bitmap_drawing(ALLEGRO_BITMAP *bitmap)
+{
+   _AL_MEMORY_DRAW_BATCH *batch = get_memory_draw_batch(false);
+   int i;
+
+   if (!batch || batch->num_draws == 0)
+      return;
+
+   if (bitmap) {
+      ALLEGRO_BITMAP *target = batch->target;
+
+      if (bitmap->parent)
+         bitmap = bitmap->parent;
+      if (target->parent)
+         target = target->parent;
+
+      if (bitmap != target) {
+         for (i = 0; i < batch->num_draws; i++) {
+            if (batch->sources[i] == bitmap)
+               break;
+         }
+         if (i == batch->num_draws)
+            return;
+      }
+   }
+
+   flush_memory_draw_batch(batch);
+}
+
+
+
+void _al_hold_memory_bitmap_drawing(bool hold)
+{
+   _AL_MEMORY_DRAW_BATCH *batch = get_memory_draw_batch(hold);
+
+   if (!batch)
+      return;
+
+   batch->held = hold;
+
+   if (!hold) {
+      flush_memory_draw_batch(batch);
+      if (batch->max_draws > MAX_KEPT_DRAWS) {
+         al_free(batch->draws);
+         al_free(batch->sources);
+         batch->draws = NULL;
+         batch->sources = NULL;
+         batch->max_draws = 0;
+      }
+   }
+}
+
+
+
+bool _al_is_memory_bitmap_drawing_held(void)
+{
+   _AL_MEMORY_DRAW_BATCH *batch = get_memory_draw_batch(false);
+
+   return batch && batch->held;
+}
+
+
+
+/* Frees a thread's batch when its thread local storage goes away.  Draws
+ * still pending are dropped.
+ */
+void _al_destroy_memory_draw_batch(_AL_MEMORY_DRAW_BATCH *batch)
+{
+   if (!batch)
+      return;
+
+   al_free(batch->draws);
+   al_free(batch->sources);
+   al_free(batch);
 }
 
 
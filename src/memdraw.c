@@ -19,20 +19,17 @@
 #include "allegro5/allegro.h"
 #include "allegro5/internal/aintern_bitmap.h"
 #include "allegro5/internal/aintern_blend.h"
+#include "allegro5/internal/aintern_cpu.h"
 #include "allegro5/internal/aintern_memdraw.h"
 #include "allegro5/internal/aintern_pixels.h"
+#include <string.h>
 
-/* generic versions of the video memory access helpers */
-/* FIXME: why do we need macros for this? */
-#define bmp_write16(addr, c)        (*((uint16_t *)(addr)) = (c))
-#define bmp_write32(addr, c)        (*((uint32_t *)(addr)) = (c))
-
-#define bmp_read16(addr)            (*((uint16_t *)(addr)))
-#define bmp_read32(addr)            (*((uint32_t *)(addr)))
-
-typedef struct {
-   float x[4];
-} float4;
+#if defined(_AL_SIMD_X86)
+   #include <emmintrin.h>
+   #include <immintrin.h>
+#elif defined(_AL_SIMD_NEON)
+   #include <arm_neon.h>
+#endif
 
 
 void _al_draw_pixel_memory(ALLEGRO_BITMAP *bitmap, float x, float y,
@@ -51,11 +48,116 @@ void _al_draw_pixel_memory(ALLEGRO_BITMAP *bitmap, float x, float y,
 }
 
 
+/* The packed clear color repeated over this many bytes.  It is a multiple
+ * of every pixel size (1, 2, 3, 4 and 16 bytes) and of the widest store, so
+ * any row can be filled with whole copies of it followed by a prefix.
+ */
+#define CLEAR_PATTERN_SIZE 96
+
+typedef void (*FILL_ROW_FUNC)(unsigned char *dst, const unsigned char *pattern,
+   size_t size);
+
+
+static void fill_row_c(unsigned char *dst, const unsigned char *pattern,
+   size_t size)
+{
+   while (size >= 48) {
+      memcpy(dst, pattern, 48);
+      dst += 48;
+      size -= 48;
+   }
+   memcpy(dst, pattern, size);
+}
+
+
+#if defined(_AL_SIMD_X86)
+
+_AL_TARGET_SSE2
+static void fill_row_sse2(unsigned char *dst, const unsigned char *pattern,
+   size_t size)
+{
+   const __m128i p0 = _mm_loadu_si128((const __m128i *)pattern);
+   const __m128i p1 = _mm_loadu_si128((const __m128i *)(pattern + 16));
+   const __m128i p2 = _mm_loadu_si128((const __m128i *)(pattern + 32));
+
+   while (size >= 48) {
+      _mm_storeu_si128((__m128i *)dst, p0);
+      _mm_storeu_si128((__m128i *)(dst + 16), p1);
+      _mm_storeu_si128((__m128i *)(dst + 32), p2);
+      dst += 48;
+      size -= 48;
+   }
+   memcpy(dst, pattern, size);
+}
+
+
+_AL_TARGET_AVX2
+static void fill_row_avx2(unsigned char *dst, const unsigned char *pattern,
+   size_t size)
+{
+   const __m256i p0 = _mm256_loadu_si256((const __m256i *)pattern);
+   const __m256i p1 = _mm256_loadu_si256((const __m256i *)(pattern + 32));
+   const __m256i p2 = _mm256_loadu_si256((const __m256i *)(pattern + 64));
+
+   while (size >= 96) {
+      _mm256_storeu_si256((__m256i *)dst, p0);
+      _mm256_storeu_si256((__m256i *)(dst + 32), p1);
+      _mm256_storeu_si256((__m256i *)(dst + 64), p2);
+      dst += 96;
+      size -= 96;
+   }
+
+   /* Leave AVX state before the SSE tail, as in blend_premul_row_avx2. */
+   _mm256_zeroupper();
+   fill_row_sse2(dst, pattern, size);
+}
+
+#elif defined(_AL_SIMD_NEON)
+
+static void fill_row_neon(unsigned char *dst, const unsigned char *pattern,
+   size_t size)
+{
+   const uint8x16_t p0 = vld1q_u8(pattern);
+   const uint8x16_t p1 = vld1q_u8(pattern + 16);
+   const uint8x16_t p2 = vld1q_u8(pattern + 32);
+
+   while (size >= 48) {
+      vst1q_u8(dst, p0);
+      vst1q_u8(dst + 16, p1);
+      vst1q_u8(dst + 32, p2);
+      dst += 48;
+      size -= 48;
+   }
+   memcpy(dst, pattern, size);
+}
+
+#endif
+
+
+static FILL_ROW_FUNC get_fill_row_func(void)
+{
+#if defined(_AL_SIMD_X86)
+   int features = _al_get_cpu_features();
+   if (features & _AL_CPU_AVX2)
+      return fill_row_avx2;
+   if (features & _AL_CPU_SSE2)
+      return fill_row_sse2;
+#elif defined(_AL_SIMD_NEON)
+   return fill_row_neon;
+#endif
+   return fill_row_c;
+}
+
+
 void _al_clear_bitmap_by_locking(ALLEGRO_BITMAP *bitmap, ALLEGRO_COLOR *color)
 {
    ALLEGRO_LOCKED_REGION *lr;
+   unsigned char pattern[CLEAR_PATTERN_SIZE];
    int x1, y1, w, h;
-   int x, y;
+   int y, i;
+   int pixel_size;
+   size_t row_size;
+   bool uniform;
    unsigned char *line_ptr;
 
    /* This function is not just used on memory bitmaps, but also on OpenGL
@@ -81,79 +183,42 @@ void _al_clear_bitmap_by_locking(ALLEGRO_BITMAP *bitmap, ALLEGRO_COLOR *color)
    /* Write a single pixel so we can get the raw value. */
    _al_put_pixel(bitmap, x1, y1, *color);
 
-   /* Fill in the region. */
-   line_ptr = lr->data;
-   switch (lr->pixel_size) {
-      case 2: {
-         int pixel_value = bmp_read16(line_ptr);
-         for (y = y1; y < y1 + h; y++) {
-            if (pixel_value == 0) {    /* fast path */
-               memset(line_ptr, 0, 2 * w);
-            }
-            else {
-               uint16_t *data = (uint16_t *)line_ptr;
-               for (x = 0; x < w; x++) {
-                  bmp_write16(data, pixel_value);
-                  data++;
-               }
-            }
-            line_ptr += lr->pitch;
-         }
-         break;
-      }
+   pixel_size = lr->pixel_size;
+   ASSERT(pixel_size > 0 && CLEAR_PATTERN_SIZE % pixel_size == 0);
+   for (i = 0; i < CLEAR_PATTERN_SIZE; i += pixel_size)
+      memcpy(pattern + i, lr->data, pixel_size);
 
-      case 3: {
-         int pixel_value = _AL_READ3BYTES(line_ptr);
-         for (y = y1; y < y1 + h; y++) {
-            unsigned char *data = (unsigned char *)line_ptr;
-            if (pixel_value == 0) {    /* fast path */
-               memset(data, 0, 3 * w);
-            }
-            else {
-               for (x = 0; x < w; x++) {
-                  _AL_WRITE3BYTES(data, pixel_value);
-                  data += 3;
-               }
-            }
-            line_ptr += lr->pitch;
-         }
+   /* Colors like transparent black or opaque white are the same byte
+    * repeated, which memset handles best.
+    */
+   uniform = true;
+   for (i = 1; i < pixel_size; i++) {
+      if (pattern[i] != pattern[0]) {
+         uniform = false;
          break;
       }
+   }
 
-      case 4: {
-         int pixel_value = bmp_read32(line_ptr);
-         for (y = y1; y < y1 + h; y++) {
-            uint32_t *data = (uint32_t *)line_ptr;
-            /* Special casing pixel_value == 0 doesn't seem to make any
-             * difference to speed, so don't bother.
-             */
-            for (x = 0; x < w; x++) {
-               bmp_write32(data, pixel_value);
-               data++;
-            }
-            line_ptr += lr->pitch;
-         }
-         break;
-      }
+   /* Clearing whole rows of a bitmap without padding is a single fill. */
+   row_size = (size_t)w * pixel_size;
+   if (lr->pitch > 0 && (size_t)lr->pitch == row_size) {
+      row_size *= h;
+      h = 1;
+   }
 
-      case sizeof(float4): {
-         float4 *data = (float4 *)line_ptr;
-         float4 pixel_value = *data;
-
-         for (y = y1; y < y1 + h; y++) {
-            data = (float4 *)line_ptr;
-            for (x = 0; x < w; x++) {
-               *data = pixel_value;
-               data++;
-            }
-            line_ptr += lr->pitch;
-         }
-         break;
+   line_ptr = lr->data;
+   if (uniform) {
+      for (y = 0; y < h; y++) {
+         memset(line_ptr, pattern[0], row_size);
+         line_ptr += lr->pitch;
+      }
+   }
+   else {
+      FILL_ROW_FUNC fill_row = get_fill_row_func();
+      for (y = 0; y < h; y++) {
+         fill_row(line_ptr, pattern, row_size);
+         line_ptr += lr->pitch;
       }
-
-      default:
-        ASSERT(false);
-        break;
    }
 
    al_unlock_bitmap(bitmap);
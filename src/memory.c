@@ -17,6 +17,7 @@
 
 
 #include "allegro5/allegro.h"
+#include "allegro5/internal/aintern.h"
 
 
 /* globals */
@@ -84,4 +85,40 @@ void *al_calloc_with_context(size_t count, size_t n,
 }
 
 
+
+/* Internal function: _al_malloc_aligned
+ *  Allocates n bytes starting at a multiple of alignment, which must be a
+ *  power of two.  The memory must be freed with _al_free_aligned.
+ */
+void *_al_malloc_aligned(size_t n, size_t alignment)
+{
+   char *block;
+   char *ptr;
+
+   ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+   if (alignment < sizeof(void *))
+      alignment = sizeof(void *);
+
+   /* The pointer to free is stored just before the aligned memory. */
+   block = al_malloc(n + alignment - 1 + sizeof(void *));
+   if (!block)
+      return NULL;
+   ptr = (char *)(((uintptr_t)block + sizeof(void *) + alignment - 1) &
+      ~(uintptr_t)(alignment - 1));
+   ((void **)ptr)[-1] = block;
+   return ptr;
+}
+
+
+
+/* Internal function: _al_free_aligned
+ */
+void _al_free_aligned(void *ptr)
+{
+   if (ptr)
+      al_free(((void **)ptr)[-1]);
+}
+
+
 /* vim: set ts=8 sts=3 sw=3 et: */
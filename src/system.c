@@ -35,6 +35,7 @@
 #include "allegro5/internal/aintern_timer.h"
 #include "allegro5/internal/aintern_tls.h"
 #include "allegro5/internal/aintern_vector.h"
+#include "allegro5/internal/aintern_workers.h"
 
 ALLEGRO_DEBUG_CHANNEL("system")
 
@@ -171,6 +172,47 @@ static void read_allegro_cfg(void)
 
 
 
+/* Reads the alignment of memory bitmap rows once, as the config may not be
+ * queried while bitmaps are created or locked: looking up a key can change
+ * al_get_errno, which the image loaders check after locking.
+ */
+static int read_memory_bitmap_alignment(void)
+{
+   const char *value;
+   int alignment;
+
+   value = al_get_config_value(al_get_system_config(), "graphics",
+      "memory_bitmap_alignment");
+   if (!value)
+      return _AL_DEFAULT_MEMORY_BITMAP_ALIGNMENT;
+
+   alignment = atoi(value);
+   if (alignment < 1 || alignment > _AL_MAX_MEMORY_BITMAP_ALIGNMENT ||
+         (alignment & (alignment - 1)) != 0) {
+      ALLEGRO_WARN("Invalid memory_bitmap_alignment: %s\n", value);
+      return _AL_DEFAULT_MEMORY_BITMAP_ALIGNMENT;
+   }
+   return alignment;
+}
+
+
+
+/* Likewise, reads how many threads may convert a bitmap, or 0 for "auto". */
+static int read_bitmap_conversion_threads(void)
+{
+   const char *value;
+
+   value = al_get_config_value(al_get_system_config(), "graphics",
+      "bitmap_conversion_threads");
+   if (!value)
+      return 1;
+   if (!_al_stricmp(value, "auto"))
+      return 0;
+   return _ALLEGRO_MAX(atoi(value), 1);
+}
+
+
+
 /*
  * Can a binary with version a use a library with version b?
  *
@@ -267,6 +309,9 @@ bool al_install_system(int version, int (*atexit_ptr)(void (*)(void)))
    const char *min_bitmap_size = al_get_config_value(
       al_get_system_config(), "graphics", "min_bitmap_size");
    active_sysdrv->min_bitmap_size = min_bitmap_size ? atoi(min_bitmap_size) : 16;
+   active_sysdrv->memory_bitmap_alignment = read_memory_bitmap_alignment();
+   active_sysdrv->bitmap_conversion_threads =
+      read_bitmap_conversion_threads();
 
    ALLEGRO_INFO("Allegro version: %s\n", ALLEGRO_VERSION_STR);
 
@@ -286,6 +331,8 @@ bool al_install_system(int version, int (*atexit_ptr)(void (*)(void)))
 
    _al_init_timers();
 
+   _al_init_workers();
+
 #ifdef ALLEGRO_CFG_SHADER_GLSL
    _al_glsl_init_shaders();
 #endif
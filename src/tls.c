@@ -42,6 +42,7 @@
 #include "allegro5/internal/aintern_display.h"
 #include "allegro5/internal/aintern_file.h"
 #include "allegro5/internal/aintern_fshook.h"
+#include "allegro5/internal/aintern_memblit.h"
 #include "allegro5/internal/aintern_shader.h"
 #include "allegro5/internal/aintern_tls.h"
 
@@ -107,6 +108,9 @@ typedef struct thread_local_state {
 
    /* Destructor ownership count */
    int dtor_owner_count;
+
+   /* Blits deferred while drawing to a memory bitmap is held */
+   struct _AL_MEMORY_DRAW_BATCH *memory_draw_batch;
 } thread_local_state;
 
 
@@ -151,6 +155,14 @@ static void initialize_tls_values(thread_local_state *tls)
    _al_fill_display_settings(&tls->new_display_settings);
 }
 
+
+/* Frees what initialize_tls_values and later calls allocated. */
+static void destroy_tls_values(thread_local_state *tls)
+{
+   _al_destroy_memory_draw_batch(tls->memory_draw_batch);
+   tls->memory_draw_batch = NULL;
+}
+
 // FIXME: The TLS implementation below only works for dynamic linking
 // right now - instead of using DllMain we should simply initialize
 // on first request.
@@ -173,6 +185,7 @@ void _al_reinitialize_tls_values(void)
    thread_local_state *tls;
    if ((tls = tls_get()) == NULL)
       return;
+   destroy_tls_values(tls);
    initialize_tls_values(tls);
 }
 
@@ -412,6 +425,9 @@ void al_set_target_bitmap(ALLEGRO_BITMAP *bitmap)
 
    ASSERT(!al_is_bitmap_drawing_held());
 
+   /* Deferred blits go to the target they were made with. */
+   _al_flush_memory_bitmap_drawing(NULL);
+
    if (bitmap) {
       if (bitmap->parent) {
          bitmap->parent->dirty = true;
@@ -973,4 +989,14 @@ int *_al_tls_get_dtor_owner_count(void)
 }
 
 
+struct _AL_MEMORY_DRAW_BATCH **_al_tls_get_memory_draw_batch(void)
+{
+   thread_local_state *tls;
+
+   if ((tls = tls_get()) == NULL)
+      return NULL;
+   return &tls->memory_draw_batch;
+}
+
+
 /* vim: set sts=3 sw=3 et: */
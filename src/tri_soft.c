@@ -23,7 +23,9 @@
 #include "allegro5/internal/aintern_blend.h"
 #include "allegro5/internal/aintern_pixels.h"
 #include "allegro5/internal/aintern_tri_soft.h"
+#include <limits.h>
 #include <math.h>
+#include <string.h>
 
 ALLEGRO_DEBUG_CHANNEL("tri_soft")
 
@@ -35,9 +37,19 @@ typedef void (*shader_init)(uintptr_t, ALLEGRO_VERTEX*, ALLEGRO_VERTEX*, ALLEGRO
 typedef void (*shader_first)(uintptr_t, int, int, int, int);
 typedef void (*shader_step)(uintptr_t, int);
 
+/*
+The blender is looked up once per triangle, rather than for every scanline
+*/
+typedef struct {
+   int op, src_mode, dst_mode;
+   int op_alpha, src_alpha, dst_alpha;
+   ALLEGRO_COLOR const_color;
+} blender_2d;
+
 typedef struct {
    ALLEGRO_BITMAP *target;
    ALLEGRO_COLOR cur_color;
+   blender_2d blender;
 } state_solid_any_2d;
 
 static void shader_solid_any_init(uintptr_t state, ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX* v2, ALLEGRO_VERTEX* v3)
@@ -208,6 +220,7 @@ static void shader_grad_any_step(uintptr_t state, int minor)
 typedef struct {
    ALLEGRO_BITMAP *target;
    ALLEGRO_COLOR cur_color;
+   blender_2d blender;
 
    float du_dx, du_dy, u_const;
    float dv_dx, dv_dy, v_const;
@@ -408,9 +421,289 @@ static void shader_texture_grad_any_step(uintptr_t state, int minor)
 #include "scanline_drawers.inc"
 
 
-static void triangle_stepper(uintptr_t state,
+/*=========================== Span Shaders ===================================*/
+
+/*
+These handle the common cases of software rendering with whole spans at a
+time, instead of converting every pixel to floating point and back:
+
+- Solid colored, unblended triangles into any 32-bit format are filled with
+  a packed pixel.
+- Textured triangles using the default (premultiplied alpha) blender or no
+  blending at all, with an ARGB_8888 or ABGR_8888 texture and target. Texels
+  are fetched into a small buffer, exactly like the generated drawers do, and
+  each chunk is then blended with the integer routines from blenders.c.
+
+The locked formats are only known once the target is locked, so init checks
+them and the drawers fall back to the generic drawer if they don't match.
+*/
+
+#define SPAN_CHUNK 128
+
+typedef struct {
+   state_solid_any_2d solid;
+
+   shader_draw fallback;
+   bool use_fallback;
+   uint32_t pixel;
+} state_solid_fill_2d;
+
+static void shader_solid_fill_init(uintptr_t state, ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX* v2, ALLEGRO_VERTEX* v3)
+{
+   state_solid_fill_2d* s = (state_solid_fill_2d*)state;
+   ALLEGRO_BITMAP *target;
+   int format;
+
+   shader_solid_any_init(state, v1, v2, v3);
+
+   target = s->solid.target->parent ? s->solid.target->parent : s->solid.target;
+   format = target->locked_region.format;
+
+   s->use_fallback = (al_get_pixel_size(format) != 4 ||
+      _al_pixel_format_is_video_only(format));
+   if (!s->use_fallback) {
+      /* Large enough for any format, to keep the compiler happy. */
+      uint8_t packed[16];
+      uint8_t *data = packed;
+      _AL_INLINE_PUT_PIXEL(format, data, s->solid.cur_color, false);
+      memcpy(&s->pixel, packed, sizeof(s->pixel));
+   }
+}
+
+static void shader_solid_fill_draw(uintptr_t state, int x1, int y, int x2)
+{
+   state_solid_fill_2d* s = (state_solid_fill_2d*)state;
+   ALLEGRO_BITMAP *target = s->solid.target;
+   const uint32_t pixel = s->pixel;
+   uint32_t *dst;
+
+   if (s->use_fallback) {
+      s->fallback(state, x1, y, x2);
+      return;
+   }
+
+   /* Same clipping as the generated drawers. */
+   if (target->parent) {
+      x1 += target->xofs;
+      x2 += target->xofs;
+      y += target->yofs;
+      target = target->parent;
+   }
+
+   x1 -= target->lock_x;
+   x2 -= target->lock_x;
+   y -= target->lock_y;
+   y--;
+
+   if (y < 0 || y >= target->lock_h)
+      return;
+   if (x1 < 0)
+      x1 = 0;
+   if (x2 > target->lock_w - 1)
+      x2 = target->lock_w - 1;
+
+   dst = (uint32_t *)((uint8_t *)target->lock_data + y * target->locked_region.pitch) + x1;
+   for (; x1 <= x2; x1++)
+      *dst++ = pixel;
+}
+
+/*----------------------------------------------------------------------------*/
+
+typedef struct {
+   state_texture_solid_any_2d solid;
+
+   shader_draw fallback;
+   bool use_fallback;
+   bool opaque;
+   _AL_PREMUL_BLEND pb;
+   _AL_PREMUL_ROW_FUNC blend_row;
+} state_texture_span_2d;
+
+static void shader_texture_span_init(uintptr_t state, ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX* v2, ALLEGRO_VERTEX* v3)
+{
+   state_texture_span_2d* s = (state_texture_span_2d*)state;
+   ALLEGRO_BITMAP *target, *texture;
+
+   shader_texture_solid_any_init(state, v1, v2, v3);
+
+   target = s->solid.target->parent ? s->solid.target->parent : s->solid.target;
+   texture = s->solid.texture->parent ? s->solid.texture->parent : s->solid.texture;
+
+   s->use_fallback = !_al_is_premul_blend_format(target->locked_region.format) ||
+      !_al_is_premul_blend_format(texture->locked_region.format);
+   if (!s->use_fallback) {
+      _al_init_premul_blend(&s->pb, texture->locked_region.format,
+         target->locked_region.format, s->solid.cur_color);
+      s->blend_row = _al_get_premul_row_func();
+   }
+}
+
+/*
+Applies the red/blue swap and tint of an unblended span in place
+*/
+static void swizzle_span_row(uint32_t *row, int n, const _AL_PREMUL_BLEND *pb)
+{
+   int i, c;
+
+   for (i = 0; i < n; i++) {
+      uint32_t p = row[i];
+      if (pb->swap_rb)
+         p = (p & 0xFF00FF00) | ((p >> 16) & 0xFF) | ((p & 0xFF) << 16);
+      if (pb->tinted) {
+         uint32_t t = 0;
+         for (c = 0; c < 4; c++)
+            t |= ((((p >> (c * 8)) & 0xFF) * pb->tint[c]) >> 8) << (c * 8);
+         p = t;
+      }
+      row[i] = p;
+   }
+}
+
+static void shader_texture_span_draw(uintptr_t state, int x1, int y, int x2)
+{
+   state_texture_span_2d* ss = (state_texture_span_2d*)state;
+   state_texture_solid_any_2d* s = &ss->solid;
+   ALLEGRO_BITMAP *target = s->target;
+   float u = s->u;
+   float v = s->v;
+
+   if (ss->use_fallback) {
+      ss->fallback(state, x1, y, x2);
+      return;
+   }
+
+   /* Same clipping and texture coordinate setup as the generated drawers,
+    * so the same texels get picked.
+    */
+   if (target->parent) {
+      x1 += target->xofs;
+      x2 += target->xofs;
+      y += target->yofs;
+      target = target->parent;
+   }
+
+   x1 -= target->lock_x;
+   x2 -= target->lock_x;
+   y -= target->lock_y;
+   y--;
+
+   if (y < 0 || y >= target->lock_h)
+      return;
+
+   if (x1 < 0) {
+      u += s->du_dx * -x1;
+      v += s->dv_dx * -x1;
+      x1 = 0;
+   }
+
+   if (x2 > target->lock_w - 1)
+      x2 = target->lock_w - 1;
+
+   {
+      const int offset_x = s->texture->parent ? s->texture->xofs : 0;
+      const int offset_y = s->texture->parent ? s->texture->yofs : 0;
+      ALLEGRO_BITMAP* texture = s->texture->parent ? s->texture->parent : s->texture;
+      const uint8_t *lock_data = texture->locked_region.data;
+      const int src_pitch = texture->locked_region.pitch;
+      const int uu_ofs = offset_x - texture->lock_x;
+      const int vv_ofs = offset_y - texture->lock_y;
+      const al_fixed du_dx = al_ftofix(s->du_dx);
+      const al_fixed dv_dx = al_ftofix(s->dv_dx);
+      const al_fixed w = al_ftofix(s->w);
+      const al_fixed h = al_ftofix(s->h);
+      uint32_t *dst = (uint32_t *)((uint8_t *)target->lock_data + y * target->locked_region.pitch) + x1;
+      uint32_t buffer[SPAN_CHUNK];
+      al_fixed uu, vv;
+      int64_t last_uu, last_vv;
+      int wraps;
+
+      /* Ensure u in [0, s->w) and v in [0, s->h). */
+      while (u < 0)
+         u += s->w;
+      while (v < 0)
+         v += s->h;
+      u = fmodf(u, s->w);
+      v = fmodf(v, s->h);
+
+      uu = al_ftofix(u);
+      vv = al_ftofix(v);
+
+      /*
+      Fixed point stepping is exact, so if the coordinates of the first and
+      last pixel are in range, none of the pixels in between wrap around and
+      the checks can be left out of the loop without picking other texels
+      */
+      last_uu = uu + (int64_t)du_dx * (x2 - x1);
+      last_vv = vv + (int64_t)dv_dx * (x2 - x1);
+      wraps = MIN(uu, last_uu) < 0 || MAX(uu, last_uu) >= w ||
+         MIN(vv, last_vv) < 0 || MAX(vv, last_vv) >= h;
+
+      while (x1 <= x2) {
+         const int n = MIN(x2 - x1 + 1, SPAN_CHUNK);
+         /* Unblended spans are fetched straight into the target. */
+         uint32_t *texels = ss->opaque ? dst : buffer;
+         int i;
+
+         if (!wraps && dv_dx == 0) {
+            const uint32_t *row = (const uint32_t *)(lock_data + ((vv >> 16) + vv_ofs) * src_pitch) + uu_ofs;
+            for (i = 0; i < n; i++) {
+               texels[i] = row[uu >> 16];
+               uu += du_dx;
+            }
+         } else if (!wraps) {
+            for (i = 0; i < n; i++) {
+               const int src_x = (uu >> 16) + uu_ofs;
+               const int src_y = (vv >> 16) + vv_ofs;
+               texels[i] = *(const uint32_t *)(lock_data + src_y * src_pitch + src_x * 4);
+               uu += du_dx;
+               vv += dv_dx;
+            }
+         } else {
+            for (i = 0; i < n; i++) {
+               const int src_x = (uu >> 16) + uu_ofs;
+               const int src_y = (vv >> 16) + vv_ofs;
+               texels[i] = *(const uint32_t *)(lock_data + src_y * src_pitch + src_x * 4);
+
+               uu += du_dx;
+               vv += dv_dx;
+
+               if (_AL_EXPECT_FAIL(uu < 0))
+                  uu += w;
+               else if (_AL_EXPECT_FAIL(uu >= w))
+                  uu -= w;
+
+               if (_AL_EXPECT_FAIL(vv < 0))
+                  vv += h;
+               else if (_AL_EXPECT_FAIL(vv >= h))
+                  vv -= h;
+            }
+         }
+
+         if (!ss->opaque)
+            ss->blend_row(dst, buffer, n, &ss->pb);
+         else if (ss->pb.swap_rb || ss->pb.tinted)
+            swizzle_span_row(dst, n, &ss->pb);
+
+         dst += n;
+         x1 += n;
+      }
+   }
+}
+
+
+/*
+This is inlined into its callers, so that the shader calls are direct when
+the shaders are known at compile time.
+
+Only the target rows in [min_y, max_y) are drawn. The rows above min_y are
+still stepped through, so that the shaders end up in exactly the same state
+as when the whole triangle is drawn. The draw callback is passed y + 1 for
+row y.
+*/
+static _AL_ALWAYS_INLINE void triangle_stepper(uintptr_t state,
    shader_init init, shader_first first, shader_step step, shader_draw draw,
-   ALLEGRO_VERTEX* vtx1, ALLEGRO_VERTEX* vtx2, ALLEGRO_VERTEX* vtx3)
+   ALLEGRO_VERTEX* vtx1, ALLEGRO_VERTEX* vtx2, ALLEGRO_VERTEX* vtx3,
+   int min_y, int max_y)
 {
    float Coords[6] = {vtx1->x - 0.5f, vtx1->y + 0.5f, vtx2->x - 0.5f, vtx2->y + 0.5f, vtx3->x - 0.5f, vtx3->y + 0.5f};
    float *V1 = Coords, *V2 = &Coords[2], *V3 = &Coords[4], *s;
@@ -461,7 +754,12 @@ static void triangle_stepper(uintptr_t state,
    mid_y = ceilf(V2[1]);
    end_y = ceilf(V3[1]);
 
-   if (cur_y == end_y)
+   if (end_y - 1 > max_y)
+      end_y = max_y + 1;
+   if (mid_y > end_y)
+      mid_y = end_y;
+
+   if (cur_y >= end_y || end_y <= min_y + 1)
       return;
 
    /*
@@ -554,7 +852,7 @@ static void triangle_stepper(uintptr_t state,
 
          first(state, left_x, cur_y, left_step, left_step - 1);
 
-         if (right_x >= left_x) {
+         if (right_x >= left_x && cur_y > min_y) {
             draw(state, left_x, cur_y, right_x);
          }
 
@@ -590,7 +888,7 @@ static void triangle_stepper(uintptr_t state,
             right_x -= 1;
          }
 
-         if (right_x >= left_x) {
+         if (right_x >= left_x && cur_y > min_y) {
             draw(state, left_x, cur_y, right_x);
          }
 
@@ -644,7 +942,7 @@ static void triangle_stepper(uintptr_t state,
 
          first(state, left_x, cur_y, left_step, left_step - 1);
 
-         if (right_x >= left_x) {
+         if (right_x >= left_x && cur_y > min_y) {
             draw(state, left_x, cur_y, right_x);
          }
 
@@ -672,7 +970,7 @@ static void triangle_stepper(uintptr_t state,
             right_x -= 1;
          }
 
-         if (right_x >= left_x) {
+         if (right_x >= left_x && cur_y > min_y) {
             draw(state, left_x, cur_y, right_x);
          }
 
@@ -683,17 +981,166 @@ static void triangle_stepper(uintptr_t state,
    }
 }
 
+static int bitmap_region_is_locked(ALLEGRO_BITMAP* bmp, int x1, int y1, int w, int h)
+{
+   ASSERT(bmp);
+
+   /* Sub-bitmaps are locked through their parent. */
+   if (bmp->parent) {
+      x1 += bmp->xofs;
+      y1 += bmp->yofs;
+      bmp = bmp->parent;
+   }
+   if (!al_is_bitmap_locked(bmp))
+      return 0;
+   if (x1 + w > bmp->lock_x && y1 + h > bmp->lock_y && x1 < bmp->lock_x + bmp->lock_w && y1 < bmp->lock_y + bmp->lock_h)
+      return 1;
+   return 0;
+}
+
+/*
+Locks the region of the target that the triangle may touch, unless it is
+locked already. Returns 0 if there is nothing to draw.
+*/
+static int lock_triangle_region(ALLEGRO_VERTEX* vtx1, ALLEGRO_VERTEX* vtx2, ALLEGRO_VERTEX* vtx3, int *need_unlock)
+{
+   ALLEGRO_BITMAP *target = al_get_target_bitmap();
+   ALLEGRO_BITMAP *root = target->parent ? target->parent : target;
+   int min_x, max_x, min_y, max_y;
+   int clip_min_x, clip_min_y, clip_max_x, clip_max_y;
+
+   *need_unlock = 0;
+
+   al_get_clipping_rectangle(&clip_min_x, &clip_min_y, &clip_max_x, &clip_max_y);
+   clip_max_x += clip_min_x;
+   clip_max_y += clip_min_y;
+
+   /*
+   TODO: Need to clip them first, make a copy of the vertices first then
+   */
+
+   /*
+   Lock the region we are drawing to. We are choosing the minimum and maximum
+   possible pixels touched from the formula (easily verified by following the
+   above algorithm.
+   */
+
+   min_x = (int)floorf(MIN(vtx1->x, MIN(vtx2->x, vtx3->x))) - 1;
+   min_y = (int)floorf(MIN(vtx1->y, MIN(vtx2->y, vtx3->y))) - 1;
+   max_x = (int)ceilf(MAX(vtx1->x, MAX(vtx2->x, vtx3->x))) + 1;
+   max_y = (int)ceilf(MAX(vtx1->y, MAX(vtx2->y, vtx3->y))) + 1;
+
+   /*
+   TODO: This bit is temporary, the min max's will be guaranteed to be within the bitmap
+   once clipping is implemented
+   */
+   if (min_x >= clip_max_x || min_y >= clip_max_y)
+      return 0;
+   if (max_x >= clip_max_x)
+      max_x = clip_max_x;
+   if (max_y >= clip_max_y)
+      max_y = clip_max_y;
+
+   if (max_x < clip_min_x || max_y < clip_min_y)
+      return 0;
+   if (min_x < clip_min_x)
+      min_x = clip_min_x;
+   if (min_y < clip_min_y)
+      min_y = clip_min_y;
+
+   if (al_is_bitmap_locked(root)) {
+      if (!bitmap_region_is_locked(target, min_x, min_y, max_x - min_x, max_y - min_y) ||
+          _al_pixel_format_is_video_only(root->locked_region.format))
+         return 0;
+   } else {
+      if (!al_lock_bitmap_region(target, min_x, min_y, max_x - min_x, max_y - min_y, ALLEGRO_PIXEL_FORMAT_ANY, 0))
+         return 0;
+      *need_unlock = 1;
+   }
+
+   return 1;
+}
+
+void _al_draw_soft_triangle(
+   ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX* v2, ALLEGRO_VERTEX* v3, uintptr_t state,
+   void (*init)(uintptr_t, ALLEGRO_VERTEX*, ALLEGRO_VERTEX*, ALLEGRO_VERTEX*),
+   void (*first)(uintptr_t, int, int, int, int),
+   void (*step)(uintptr_t, int),
+   void (*draw)(uintptr_t, int, int, int))
+{
+   int need_unlock;
+
+   if (!lock_triangle_region(v1, v2, v3, &need_unlock))
+      return;
+
+   triangle_stepper(state, init, first, step, draw, v1, v2, v3, INT_MIN, INT_MAX);
+
+   if (need_unlock)
+      al_unlock_bitmap(al_get_target_bitmap());
+}
+
+/*
+The following expect the triangle's region of the target to be locked
+already
+*/
+static void draw_triangle_rows(
+   ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX* v2, ALLEGRO_VERTEX* v3, uintptr_t state,
+   shader_init init, shader_first first, shader_step step, shader_draw draw,
+   int min_y, int max_y)
+{
+   triangle_stepper(state, init, first, step, draw, v1, v2, v3, min_y, max_y);
+}
+
+static void draw_solid_fill_triangle(ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX* v2, ALLEGRO_VERTEX* v3, state_solid_fill_2d* state, int min_y, int max_y)
+{
+   triangle_stepper((uintptr_t)state, shader_solid_fill_init, shader_solid_any_first, shader_solid_any_step, shader_solid_fill_draw, v1, v2, v3, min_y, max_y);
+}
+
+static void draw_texture_span_triangle(ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX* v2, ALLEGRO_VERTEX* v3, state_texture_span_2d* state, int min_y, int max_y)
+{
+   triangle_stepper((uintptr_t)state, shader_texture_span_init, shader_texture_solid_any_first, shader_texture_solid_any_step, shader_texture_span_draw, v1, v2, v3, min_y, max_y);
+}
+
+/*
+The span shaders for textures can't handle drawing a bitmap onto itself,
+because they fetch a chunk of texels before writing any of them, and only
+handle tints that can be expressed as 8-bit multipliers
+*/
+static int can_draw_texture_spans(ALLEGRO_BITMAP* texture, ALLEGRO_COLOR tint)
+{
+   ALLEGRO_BITMAP *target = al_get_target_bitmap();
+
+   if (target->parent)
+      target = target->parent;
+   if (texture->parent)
+      texture = texture->parent;
+   if (texture == target)
+      return 0;
+
+   return tint.r >= 0 && tint.r <= 1 && tint.g >= 0 && tint.g <= 1 &&
+      tint.b >= 0 && tint.b <= 1 && tint.a >= 0 && tint.a <= 1;
+}
+
 /*
 This one will check to see what exactly we need to draw...
-I.e. this will call all of the actual renderers and set the appropriate callbacks
+I.e. this will call all of the actual renderers and set the appropriate callbacks.
+The drawers are specialized for the blender and the locked formats here, once
+per triangle, so that they don't have to check them for every scanline
 */
-void _al_triangle_2d(ALLEGRO_BITMAP* texture, ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX* v2, ALLEGRO_VERTEX* v3)
+static void triangle_2d(ALLEGRO_BITMAP* texture, ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX* v2, ALLEGRO_VERTEX* v3, int min_y, int max_y)
 {
    int shade = 1;
    int grad = 1;
    int op, src_mode, dst_mode, op_alpha, src_alpha, dst_alpha;
+   int need_unlock;
+   int blend, dst_format, src_format;
+   blender_2d blender;
+   ALLEGRO_BITMAP *target;
    ALLEGRO_COLOR v1c, v2c, v3c;
 
+   if (!lock_triangle_region(v1, v2, v3, &need_unlock))
+      return;
+
    v1c = v1->color;
    v2c = v2->color;
    v3c = v3->color;
@@ -704,6 +1151,25 @@ void _al_triangle_2d(ALLEGRO_BITMAP* texture, ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX
       shade = 0;
    }
 
+   blender.op = op;
+   blender.src_mode = src_mode;
+   blender.dst_mode = dst_mode;
+   blender.op_alpha = op_alpha;
+   blender.src_alpha = src_alpha;
+   blender.dst_alpha = dst_alpha;
+   blender.const_color = al_get_blend_color();
+
+   target = al_get_target_bitmap();
+   target = target->parent ? target->parent : target;
+   blend = get_scanline_blend(&blender, shade);
+   dst_format = target->locked_region.format;
+   src_format = -1;
+   if (texture) {
+      ALLEGRO_BITMAP *root = texture->parent ? texture->parent : texture;
+      if (al_is_bitmap_locked(root))
+         src_format = root->locked_region.format;
+   }
+
    if ((v1c.r == v2c.r && v2c.r == v3c.r) &&
          (v1c.g == v2c.g && v2c.g == v3c.g) &&
          (v1c.b == v2c.b && v2c.b == v3c.b) &&
@@ -714,135 +1180,94 @@ void _al_triangle_2d(ALLEGRO_BITMAP* texture, ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX
    if (texture) {
       if (grad) {
          state_texture_grad_any_2d state;
+         shader_draw draw;
          state.solid.texture = texture;
+         state.solid.blender = blender;
 
          if (shade) {
-            _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_texture_grad_any_init, shader_texture_grad_any_first, shader_texture_grad_any_step, shader_texture_grad_any_draw_shade);
+            draw = shader_texture_grad_any_draw_shade;
          } else {
-            _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_texture_grad_any_init, shader_texture_grad_any_first, shader_texture_grad_any_step, shader_texture_grad_any_draw_opaque);
+            draw = shader_texture_grad_any_draw_opaque;
          }
+         draw = get_scanline_drawer(draw, blend, dst_format, src_format);
+         draw_triangle_rows(v1, v2, v3, (uintptr_t)&state, shader_texture_grad_any_init, shader_texture_grad_any_first, shader_texture_grad_any_step, draw, min_y, max_y);
       } else {
          int white = 0;
-         state_texture_solid_any_2d state;
+         shader_draw draw;
 
          if (v1c.r == 1 && v1c.g == 1 && v1c.b == 1 && v1c.a == 1) {
             white = 1;
          }
-         state.texture = texture;
          if (shade) {
             if (white) {
-               _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_texture_solid_any_init, shader_texture_solid_any_first, shader_texture_solid_any_step, shader_texture_solid_any_draw_shade_white);
+               draw = shader_texture_solid_any_draw_shade_white;
             } else {
-               _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_texture_solid_any_init, shader_texture_solid_any_first, shader_texture_solid_any_step, shader_texture_solid_any_draw_shade);
+               draw = shader_texture_solid_any_draw_shade;
             }
          } else {
             if (white) {
-               _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_texture_solid_any_init, shader_texture_solid_any_first, shader_texture_solid_any_step, shader_texture_solid_any_draw_opaque_white);
+               draw = shader_texture_solid_any_draw_opaque_white;
             } else {
-               _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_texture_solid_any_init, shader_texture_solid_any_first, shader_texture_solid_any_step, shader_texture_solid_any_draw_opaque);
+               draw = shader_texture_solid_any_draw_opaque;
             }
          }
+         draw = get_scanline_drawer(draw, blend, dst_format, src_format);
+
+         if ((!shade || _AL_BLENDER_IS_PREMULTIPLIED_ALPHA) && can_draw_texture_spans(texture, v1c)) {
+            state_texture_span_2d state;
+            state.solid.texture = texture;
+            state.solid.blender = blender;
+            state.fallback = draw;
+            state.opaque = !shade;
+            draw_texture_span_triangle(v1, v2, v3, &state, min_y, max_y);
+         } else {
+            state_texture_solid_any_2d state;
+            state.texture = texture;
+            state.blender = blender;
+            draw_triangle_rows(v1, v2, v3, (uintptr_t)&state, shader_texture_solid_any_init, shader_texture_solid_any_first, shader_texture_solid_any_step, draw, min_y, max_y);
+         }
       }
    } else {
       if (grad) {
          state_grad_any_2d state;
+         shader_draw draw;
+         state.solid.blender = blender;
+
          if (shade) {
-            _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_grad_any_init, shader_grad_any_first, shader_grad_any_step, shader_grad_any_draw_shade);
+            draw = shader_grad_any_draw_shade;
          } else {
-            _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_grad_any_init, shader_grad_any_first, shader_grad_any_step, shader_grad_any_draw_opaque);
+            draw = shader_grad_any_draw_opaque;
          }
+         draw = get_scanline_drawer(draw, blend, dst_format, src_format);
+         draw_triangle_rows(v1, v2, v3, (uintptr_t)&state, shader_grad_any_init, shader_grad_any_first, shader_grad_any_step, draw, min_y, max_y);
       } else {
-         state_solid_any_2d state;
          if (shade) {
-            _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_solid_any_init, shader_solid_any_first, shader_solid_any_step, shader_solid_any_draw_shade);
+            state_solid_any_2d state;
+            shader_draw draw;
+            state.blender = blender;
+            draw = get_scanline_drawer(shader_solid_any_draw_shade, blend, dst_format, src_format);
+            draw_triangle_rows(v1, v2, v3, (uintptr_t)&state, shader_solid_any_init, shader_solid_any_first, shader_solid_any_step, draw, min_y, max_y);
          } else {
-            _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_solid_any_init, shader_solid_any_first, shader_solid_any_step, shader_solid_any_draw_opaque);
+            state_solid_fill_2d state;
+            state.solid.blender = blender;
+            state.fallback = get_scanline_drawer(shader_solid_any_draw_opaque, blend, dst_format, src_format);
+            draw_solid_fill_triangle(v1, v2, v3, &state, min_y, max_y);
          }
       }
    }
+
+   if (need_unlock)
+      al_unlock_bitmap(al_get_target_bitmap());
 }
 
-static int bitmap_region_is_locked(ALLEGRO_BITMAP* bmp, int x1, int y1, int w, int h)
+void _al_triangle_2d(ALLEGRO_BITMAP* texture, ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX* v2, ALLEGRO_VERTEX* v3)
 {
-   ASSERT(bmp);
-
-   if (!al_is_bitmap_locked(bmp))
-      return 0;
-   if (x1 + w > bmp->lock_x && y1 + h > bmp->lock_y && x1 < bmp->lock_x + bmp->lock_w && y1 < bmp->lock_y + bmp->lock_h)
-      return 1;
-   return 0;
+   triangle_2d(texture, v1, v2, v3, INT_MIN, INT_MAX);
 }
 
-void _al_draw_soft_triangle(
-   ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX* v2, ALLEGRO_VERTEX* v3, uintptr_t state,
-   void (*init)(uintptr_t, ALLEGRO_VERTEX*, ALLEGRO_VERTEX*, ALLEGRO_VERTEX*),
-   void (*first)(uintptr_t, int, int, int, int),
-   void (*step)(uintptr_t, int),
-   void (*draw)(uintptr_t, int, int, int))
+void _al_triangle_2d_rows(ALLEGRO_BITMAP* texture, ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX* v2, ALLEGRO_VERTEX* v3, int min_y, int max_y)
 {
-   /*
-   ALLEGRO_VERTEX copy_v1, copy_v2; <- may be needed for clipping later on
-   */
-   ALLEGRO_VERTEX* vtx1 = v1;
-   ALLEGRO_VERTEX* vtx2 = v2;
-   ALLEGRO_VERTEX* vtx3 = v3;
-   ALLEGRO_BITMAP *target = al_get_target_bitmap();
-   int need_unlock = 0;
-   ALLEGRO_LOCKED_REGION *lr;
-   int min_x, max_x, min_y, max_y;
-   int clip_min_x, clip_min_y, clip_max_x, clip_max_y;
-
-   al_get_clipping_rectangle(&clip_min_x, &clip_min_y, &clip_max_x, &clip_max_y);
-   clip_max_x += clip_min_x;
-   clip_max_y += clip_min_y;
-
-   /*
-   TODO: Need to clip them first, make a copy of the vertices first then
-   */
-
-   /*
-   Lock the region we are drawing to. We are choosing the minimum and maximum
-   possible pixels touched from the formula (easily verified by following the
-   above algorithm.
-   */
-
-   min_x = (int)floorf(MIN(vtx1->x, MIN(vtx2->x, vtx3->x))) - 1;
-   min_y = (int)floorf(MIN(vtx1->y, MIN(vtx2->y, vtx3->y))) - 1;
-   max_x = (int)ceilf(MAX(vtx1->x, MAX(vtx2->x, vtx3->x))) + 1;
-   max_y = (int)ceilf(MAX(vtx1->y, MAX(vtx2->y, vtx3->y))) + 1;
-
-   /*
-   TODO: This bit is temporary, the min max's will be guaranteed to be within the bitmap
-   once clipping is implemented
-   */
-   if (min_x >= clip_max_x || min_y >= clip_max_y)
-      return;
-   if (max_x >= clip_max_x)
-      max_x = clip_max_x;
-   if (max_y >= clip_max_y)
-      max_y = clip_max_y;
-
-   if (max_x < clip_min_x || max_y < clip_min_y)
-      return;
-   if (min_x < clip_min_x)
-      min_x = clip_min_x;
-   if (min_y < clip_min_y)
-      min_y = clip_min_y;
-
-   if (al_is_bitmap_locked(target)) {
-      if (!bitmap_region_is_locked(target, min_x, min_y, max_x - min_x, max_y - min_y) ||
-          _al_pixel_format_is_video_only(target->locked_region.format))
-         return;
-   } else {
-      if (!(lr = al_lock_bitmap_region(target, min_x, min_y, max_x - min_x, max_y - min_y, ALLEGRO_PIXEL_FORMAT_ANY, 0)))
-         return;
-      need_unlock = 1;
-   }
-
-   triangle_stepper(state, init, first, step, draw, v1, v2, v3);
-
-   if (need_unlock)
-      al_unlock_bitmap(target);
+   triangle_2d(texture, v1, v2, v3, min_y, max_y);
 }
 
 /* vim: set sts=3 sw=3 et: */
@@ -0,0 +1,256 @@
+/*         ______   ___    ___
+ *        /\  _  \ /\_ \  /\_ \
+ *        \ \ \L\ \\//\ \ \//\ \      __     __   _ __   ___
+ *         \ \  __ \ \ \ \  \ \ \   /'__`\ /'_ `\/\`'__\/ __`\
+ *          \ \ \/\ \ \_\ \_ \_\ \_/\  __//\ \L\ \ \ \//\ \L\ \
+ *           \ \_\ \_\/\____\/\____\ \____\ \____ \ \_\\ \____/
+ *            \/_/\/_/\/____/\/____/\/____/\/___L\ \/_/ \/___/
+ *                                           /\____/
+ *                                           \_/__/
+ *
+ *      Internal worker thread pool.
+ *
+ *      See readme.txt for copyright information.
+ */
+
+
+#include "allegro5/allegro.h"
+#include "allegro5/internal/aintern.h"
+#include "allegro5/internal/aintern_exitfunc.h"
+#include "allegro5/internal/aintern_thread.h"
+#include "allegro5/internal/aintern_workers.h"
+
+ALLEGRO_DEBUG_CHANNEL("workers")
+
+
+#define MAX_WORKER_THREADS 63
+
+
+static ALLEGRO_MUTEX *workers_mutex = NULL;
+static ALLEGRO_COND *job_cond = NULL;
+static ALLEGRO_COND *done_cond = NULL;
+static _AL_THREAD *worker_threads = NULL;
+static int num_worker_threads = -1;    /* -1 until the threads are started */
+static int requested_worker_threads = 0;
+static bool destroy_workers = false;
+
+/* The job currently being run, protected by workers_mutex. */
+static bool job_busy = false;
+static void (*job_proc)(int job, void *arg);
+static void *job_arg;
+static int job_count = 0;
+static int job_next = 0;
+static int job_done = 0;
+
+
+
+/* Must be called with workers_mutex locked, and job_next < job_count. */
+static void run_next_job(void)
+{
+   int job = job_next++;
+   void (*proc)(int job, void *arg) = job_proc;
+   void *arg = job_arg;
+
+   al_unlock_mutex(workers_mutex);
+   proc(job, arg);
+   al_lock_mutex(workers_mutex);
+
+   if (++job_done == job_count)
+      al_broadcast_cond(done_cond);
+}
+
+
+
+static void worker_thread_proc(_AL_THREAD *self, void *unused)
+{
+   (void)self;
+   (void)unused;
+
+   al_lock_mutex(workers_mutex);
+   while (!destroy_workers) {
+      if (job_next < job_count)
+         run_next_job();
+      else
+         al_wait_cond(job_cond, workers_mutex);
+   }
+   al_unlock_mutex(workers_mutex);
+}
+
+
+
+static int get_max_worker_threads(void)
+{
+   int n = al_get_cpu_count() - 1;
+
+   if (n < requested_worker_threads)
+      n = requested_worker_threads;
+   if (n < 0)
+      n = 0;
+   if (n > MAX_WORKER_THREADS)
+      n = MAX_WORKER_THREADS;
+   return n;
+}
+
+
+
+/* Starts worker threads until there are n.  Must be called with
+ * workers_mutex locked.
+ */
+static void add_workers(int n)
+{
+   int old = num_worker_threads;
+
+   if (n <= num_worker_threads)
+      return;
+
+   if (!worker_threads) {
+      worker_threads = al_calloc(MAX_WORKER_THREADS, sizeof(*worker_threads));
+      if (!worker_threads)
+         return;
+   }
+
+   while (num_worker_threads < n) {
+      _al_thread_create(&worker_threads[num_worker_threads],
+         worker_thread_proc, NULL);
+      num_worker_threads++;
+   }
+
+   ALLEGRO_INFO("Started %d worker threads\n", num_worker_threads - old);
+}
+
+
+
+/* Must be called with workers_mutex locked. */
+static bool start_workers(void)
+{
+   if (num_worker_threads >= 0)
+      return num_worker_threads > 0;
+
+   num_worker_threads = 0;
+   add_workers(get_max_worker_threads());
+   return num_worker_threads > 0;
+}
+
+
+
+static void shutdown_workers(void)
+{
+   int i;
+
+   al_lock_mutex(workers_mutex);
+   destroy_workers = true;
+   al_broadcast_cond(job_cond);
+   al_unlock_mutex(workers_mutex);
+
+   for (i = 0; i < num_worker_threads; i++)
+      _al_thread_join(&worker_threads[i]);
+
+   al_free(worker_threads);
+   worker_threads = NULL;
+   num_worker_threads = -1;
+   requested_worker_threads = 0;
+   destroy_workers = false;
+
+   al_destroy_mutex(workers_mutex);
+   al_destroy_cond(job_cond);
+   al_destroy_cond(done_cond);
+   workers_mutex = NULL;
+   job_cond = NULL;
+   done_cond = NULL;
+}
+
+
+
+/* Internal function: _al_init_workers
+ */
+void _al_init_workers(void)
+{
+   workers_mutex = al_create_mutex();
+   job_cond = al_create_cond();
+   done_cond = al_create_cond();
+   _al_add_exit_func(shutdown_workers, "shutdown_workers");
+}
+
+
+
+/* Internal function: _al_get_num_workers
+ */
+int _al_get_num_workers(void)
+{
+   int n;
+
+   if (!workers_mutex)
+      return 1;
+
+   al_lock_mutex(workers_mutex);
+   n = (num_worker_threads >= 0) ? num_worker_threads
+      : get_max_worker_threads();
+   al_unlock_mutex(workers_mutex);
+
+   return n + 1;
+}
+
+
+
+/* Internal function: _al_request_workers
+ */
+void _al_request_workers(int num_threads)
+{
+   if (!workers_mutex)
+      return;
+
+   al_lock_mutex(workers_mutex);
+   if (num_threads - 1 > requested_worker_threads) {
+      requested_worker_threads = _ALLEGRO_MIN(num_threads - 1,
+         MAX_WORKER_THREADS);
+   }
+   /* A pool which is running already grows now, otherwise on first use. */
+   if (num_worker_threads >= 0)
+      add_workers(get_max_worker_threads());
+   al_unlock_mutex(workers_mutex);
+}
+
+
+
+/* Internal function: _al_run_parallel
+ */
+void _al_run_parallel(int num_jobs, void (*proc)(int job, void *arg),
+   void *arg)
+{
+   int i;
+   ASSERT(proc);
+
+   if (num_jobs > 1 && workers_mutex) {
+      al_lock_mutex(workers_mutex);
+
+      if (!job_busy && start_workers()) {
+         job_busy = true;
+         job_proc = proc;
+         job_arg = arg;
+         job_count = num_jobs;
+         job_next = 0;
+         job_done = 0;
+         al_broadcast_cond(job_cond);
+
+         /* The calling thread takes jobs too, then waits for the workers
+          * still busy with the last ones.
+          */
+         while (job_next < job_count)
+            run_next_job();
+         while (job_done < job_count)
+            al_wait_cond(done_cond, workers_mutex);
+
+         job_count = job_next = job_done = 0;
+         job_busy = false;
+         al_unlock_mutex(workers_mutex);
+         return;
+      }
+
+      al_unlock_mutex(workers_mutex);
+   }
+
+   for (i = 0; i < num_jobs; i++)
+      proc(i, arg);
+}
+
+/* vim: set sts=3 sw=3 et: */
@@ -0,0 +1,358 @@
+/*
+ *    Plays a stream loaded from a WAV file through the null audio driver,
+ *    with the feeders shared between streams as configured by the [audio]
+ *    stream_feeder_threads key.  Reading the file blocks until the voice has
+ *    played a few more buffers, so the voice must keep going while the
+ *    stream is being decoded, or the read times out and the test fails.
+ *    Also checks that the stream never runs out of fragments, and the
+ *    profiling counters of the stream and voice.
+ */
+
+#define ALLEGRO_UNSTABLE
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <allegro5/allegro.h>
+#include <allegro5/allegro_audio.h>
+#include <allegro5/allegro_acodec.h>
+
+#define FREQUENCY       44100
+#define FRAGMENTS       4
+#define FRAGMENT_FRAMES 4096
+#define VOICE_FRAMES    512
+#define PLAY_FRAMES     (FREQUENCY * 2)
+
+/* Enough that the stream does not end before PLAY_FRAMES were played. */
+#define FILE_FRAMES     (PLAY_FRAMES + 2 * FRAGMENTS * FRAGMENT_FRAMES)
+#define HEADER_SIZE     44
+
+/* Each read of the file waits for the voice to play this many buffers, a
+ * bit over half a fragment.  If the voice has not got that far after
+ * STALL_SECS, it is taken to be waiting for the read.
+ */
+#define WAIT_BUFFERS    (FRAGMENT_FRAMES / VOICE_FRAMES / 2 + 1)
+#define STALL_SECS      2.0
+
+typedef struct SLOW_FILE {
+   unsigned char *data;
+   int64_t size;
+   int64_t pos;
+} SLOW_FILE;
+
+static ALLEGRO_MUTEX *mutex;
+static ALLEGRO_COND *cond;
+static int buffers_played = 0;
+static int reads_waited = 0;
+static int reads_stalled = 0;
+
+static int frames_played = 0;
+static int first_frame = -1;
+static float gain;
+static int bad_frames = 0;
+static volatile bool done = false;
+
+static float ramp(int frame)
+{
+   /* Exactly representable, and never silence. */
+   return (frame % 1000 + 1) / 1024.0f;
+}
+
+static void put16(unsigned char *p, int v)
+{
+   p[0] = v & 0xff;
+   p[1] = (v >> 8) & 0xff;
+}
+
+static void put32(unsigned char *p, int v)
+{
+   put16(p, v & 0xffff);
+   put16(p + 2, (v >> 16) & 0xffff);
+}
+
+/* Makes a mono 16-bit WAV file of the ramp. */
+static void make_wav(SLOW_FILE *sf)
+{
+   unsigned char *p;
+   int data_size = FILE_FRAMES * 2;
+   int i;
+
+   sf->size = HEADER_SIZE + data_size;
+   sf->pos = 0;
+   sf->data = p = malloc(sf->size);
+
+   memcpy(p, "RIFF", 4);
+   put32(p + 4, (int)sf->size - 8);
+   memcpy(p + 8, "WAVEfmt ", 8);
+   put32(p + 16, 16);
+   put16(p + 20, 1);             /* PCM */
+   put16(p + 22, 1);             /* channels */
+   put32(p + 24, FREQUENCY);
+   put32(p + 28, FREQUENCY * 2);
+   put16(p + 32, 2);             /* block align */
+   put16(p + 34, 16);            /* bits */
+   memcpy(p + 36, "data", 4);
+   put32(p + 40, data_size);
+
+   for (i = 0; i < FILE_FRAMES; i++)
+      put16(p + HEADER_SIZE + i * 2, (i % 1000 + 1) * 16);
+}
+
+/* Waits until the voice has played WAIT_BUFFERS more buffers, once it has
+ * started, and counts the reads for which it did not.  After the first
+ * stall the reads no longer wait, so that a failing test ends soon.
+ */
+static void wait_for_voice(void)
+{
+   ALLEGRO_TIMEOUT timeout;
+   bool ok = true;
+   int target;
+
+   al_lock_mutex(mutex);
+   if (buffers_played > 0 && !done && reads_stalled == 0) {
+      target = buffers_played + WAIT_BUFFERS;
+      al_init_timeout(&timeout, STALL_SECS);
+      while (buffers_played < target && !done) {
+         if (al_wait_cond_until(cond, mutex, &timeout) == -1) {
+            ok = buffers_played >= target || done;
+            break;
+         }
+      }
+      reads_waited++;
+      if (!ok)
+         reads_stalled++;
+   }
+   al_unlock_mutex(mutex);
+}
+
+static size_t slow_fread(ALLEGRO_FILE *f, void *ptr, size_t size)
+{
+   SLOW_FILE *sf = al_get_file_userdata(f);
+
+   /* Only the sample data is read slowly, not the header. */
+   if (sf->pos >= HEADER_SIZE)
+      wait_for_voice();
+
+   if ((int64_t)size > sf->size - sf->pos)
+      size = sf->size - sf->pos;
+   memcpy(ptr, sf->data + sf->pos, size);
+   sf->pos += size;
+   return size;
+}
+
+static bool slow_fclose(ALLEGRO_FILE *f)
+{
+   SLOW_FILE *sf = al_get_file_userdata(f);
+   free(sf->data);
+   sf->data = NULL;
+   return true;
+}
+
+static size_t slow_fwrite(ALLEGRO_FILE *f, const void *ptr, size_t size)
+{
+   (void)f;
+   (void)ptr;
+   (void)size;
+   return 0;
+}
+
+static bool slow_fflush(ALLEGRO_FILE *f)
+{
+   (void)f;
+   return true;
+}
+
+static int64_t slow_ftell(ALLEGRO_FILE *f)
+{
+   SLOW_FILE *sf = al_get_file_userdata(f);
+   return sf->pos;
+}
+
+static bool slow_fseek(ALLEGRO_FILE *f, int64_t offset, int whence)
+{
+   SLOW_FILE *sf = al_get_file_userdata(f);
+
+   if (whence == ALLEGRO_SEEK_CUR)
+      offset += sf->pos;
+   else if (whence == ALLEGRO_SEEK_END)
+      offset += sf->size;
+   if (offset < 0 || offset > sf->size)
+      return false;
+   sf->pos = offset;
+   return true;
+}
+
+static bool slow_feof(ALLEGRO_FILE *f)
+{
+   SLOW_FILE *sf = al_get_file_userdata(f);
+   return sf->pos >= sf->size;
+}
+
+static int slow_ferror(ALLEGRO_FILE *f)
+{
+   (void)f;
+   return 0;
+}
+
+static const char *slow_ferrmsg(ALLEGRO_FILE *f)
+{
+   (void)f;
+   return "";
+}
+
+static void slow_fclearerr(ALLEGRO_FILE *f)
+{
+   (void)f;
+}
+
+static off_t slow_fsize(ALLEGRO_FILE *f)
+{
+   SLOW_FILE *sf = al_get_file_userdata(f);
+   return sf->size;
+}
+
+static const ALLEGRO_FILE_INTERFACE slow_file_vt = {
+   NULL,
+   slow_fclose,
+   slow_fread,
+   slow_fwrite,
+   slow_fflush,
+   slow_ftell,
+   slow_fseek,
+   slow_feof,
+   slow_ferror,
+   slow_ferrmsg,
+   slow_fclearerr,
+   NULL,
+   slow_fsize
+};
+
+static void voice_callback(ALLEGRO_VOICE *voice, const void *buf,
+   unsigned int samples, void *data)
+{
+   const float *out = buf;
+   unsigned int i;
+   (void)voice;
+   (void)data;
+
+   al_lock_mutex(mutex);
+   buffers_played++;
+   al_broadcast_cond(cond);
+   al_unlock_mutex(mutex);
+
+   if (done)
+      return;
+
+   /* The mixer may delay the stream by a few frames and scale it, but after
+    * that any difference, in particular silence, means it ran out of data.
+    */
+   for (i = 0; i < samples; i++) {
+      int frame = frames_played + i;
+
+      if (first_frame < 0) {
+         if (out[i] == 0.0f)
+            continue;
+         first_frame = frame;
+         gain = out[i] / ramp(0);
+      }
+      if (fabs(out[i] - gain * ramp(frame - first_frame)) > 1e-6)
+         bad_frames++;
+   }
+
+   frames_played += samples;
+   if (frames_played >= PLAY_FRAMES)
+      done = true;
+}
+
+int main(void)
+{
+   ALLEGRO_CONFIG *config;
+   ALLEGRO_VOICE *voice;
+   ALLEGRO_MIXER *mixer;
+   ALLEGRO_AUDIO_STREAM *stream;
+   ALLEGRO_AUDIO_STATS stream_stats;
+   ALLEGRO_AUDIO_STATS voice_stats;
+   ALLEGRO_FILE *fp;
+   SLOW_FILE sf;
+   bool failed;
+   bool stats_failed;
+
+   if (!al_init()) {
+      printf("FAIL could not init Allegro\n");
+      return EXIT_FAILURE;
+   }
+
+   config = al_get_system_config();
+   al_set_config_value(config, "audio", "driver", "null");
+   al_set_config_value(config, "audio", "stream_feeder_threads", "1");
+   al_set_config_value(config, "null", "speed", "1");
+   al_set_config_value(config, "null", "buffer_size", "512");
+
+   if (!al_install_audio() || !al_init_acodec_addon()) {
+      printf("FAIL could not install the null audio driver\n");
+      return EXIT_FAILURE;
+   }
+
+   mutex = al_create_mutex();
+   cond = al_create_cond();
+
+   make_wav(&sf);
+   fp = al_create_file_handle(&slow_file_vt, &sf);
+
+   voice = al_create_voice(FREQUENCY, ALLEGRO_AUDIO_DEPTH_FLOAT32,
+      ALLEGRO_CHANNEL_CONF_1);
+   mixer = al_create_mixer(FREQUENCY, ALLEGRO_AUDIO_DEPTH_FLOAT32,
+      ALLEGRO_CHANNEL_CONF_1);
+   stream = al_load_audio_stream_f(fp, ".wav", FRAGMENTS, FRAGMENT_FRAMES);
+   if (!voice || !mixer || !stream) {
+      printf("FAIL could not create the voice, mixer or stream\n");
+      return EXIT_FAILURE;
+   }
+   al_set_null_voice_callback(voice, voice_callback, NULL);
+   al_attach_audio_stream_to_mixer(stream, mixer);
+
+   /* Start playing once the decoder has filled every fragment. */
+   while (al_get_available_audio_stream_fragments(stream) > 0)
+      al_rest(0.001);
+   al_attach_mixer_to_voice(mixer, voice);
+
+   while (!done)
+      al_rest(0.01);
+
+   al_get_audio_stream_stats(stream, &stream_stats);
+   al_get_voice_stats(voice, &voice_stats);
+
+   al_destroy_audio_stream(stream);
+   al_destroy_mixer(mixer);
+   al_destroy_voice(voice);
+   al_uninstall_audio();
+
+   failed = first_frame < 0 || bad_frames > 0 || reads_waited == 0 ||
+      reads_stalled > 0;
+   printf("%s %d frames played, %d wrong, %d of %d reads waited for the "
+      "voice in vain\n",
+      failed ? "FAIL" : "OK  ", frames_played, bad_frames,
+      reads_stalled, reads_waited);
+
+   /* The profiling counters should agree with what we saw. */
+   stats_failed = stream_stats.underruns > 0 ||
+      stream_stats.late_fragments > 0 ||
+      stream_stats.fed_fragments < PLAY_FRAMES / FRAGMENT_FRAMES ||
+      stream_stats.frames < (uint64_t)(PLAY_FRAMES - FRAGMENTS * FRAGMENT_FRAMES) ||
+      voice_stats.frames < (uint64_t)PLAY_FRAMES;
+   printf("%s %u fragments fed, %u underruns, %.1f ms decoding per "
+      "fragment, refilled after %.1f ms on average\n",
+      stats_failed ? "FAIL" : "OK  ",
+      (unsigned)stream_stats.fed_fragments, stream_stats.underruns,
+      stream_stats.fed_fragments ?
+         stream_stats.decode_time * 1000.0 / stream_stats.fed_fragments : 0.0,
+      stream_stats.mean_refill_latency * 1000.0);
+   failed = failed || stats_failed;
+
+   al_destroy_cond(cond);
+   al_destroy_mutex(mutex);
+
+   return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/* vim: set sts=3 sw=3 et: */
@@ -0,0 +1,119 @@
+/*
+ *    Checks that the SIMD pixel format converters generated by
+ *    misc/make_converters.py produce exactly the same output as the scalar
+ *    reference converters, for every instruction set this CPU supports.
+ *
+ *    The converters are internal, so this program is built from
+ *    src/convert.c and src/convert_simd.c directly.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <allegro5/allegro.h>
+
+/* The internal headers expect this, as when building Allegro itself. */
+#define ASSERT(x) ALLEGRO_ASSERT(x)
+#include <allegro5/internal/aintern_bitmap.h>
+#include <allegro5/internal/aintern_cpu.h>
+
+#define MAX_W     67
+#define MAX_H     5
+#define MAX_OFS   3
+#define PITCH_PAD 13
+
+static const struct {
+   int features;
+   char const *name;
+} isas[] = {
+   { _AL_CPU_SSE2, "SSE2" },
+   { _AL_CPU_SSE2 | _AL_CPU_SSSE3, "SSSE3" },
+   { _AL_CPU_SSE2 | _AL_CPU_SSSE3 | _AL_CPU_AVX2, "AVX2" },
+   { _AL_CPU_NEON, "NEON" }
+};
+
+static unsigned char src_buf[(MAX_W + MAX_OFS + PITCH_PAD) * 16 *
+   (MAX_H + MAX_OFS)];
+static unsigned char ref_buf[sizeof(src_buf)];
+static unsigned char out_buf[sizeof(src_buf)];
+
+static void fill_random(unsigned char *buf, size_t size)
+{
+   size_t i;
+   for (i = 0; i < size; i++)
+      buf[i] = rand();
+}
+
+static bool check(int src_format, int dst_format, _AL_CONVERT_FUNC ref,
+   _AL_CONVERT_FUNC func)
+{
+   int src_size = al_get_pixel_size(src_format);
+   int dst_size = al_get_pixel_size(dst_format);
+   int src_pitch, dst_pitch;
+   int w, h, sx, sy, dx, dy;
+
+   for (w = 1; w <= MAX_W; w++) {
+      h = 1 + w % MAX_H;
+      sx = w % MAX_OFS;
+      sy = w % 2;
+      dx = (w + 1) % MAX_OFS;
+      dy = (w + 1) % 2;
+      /* The scalar converters require whole pixels of padding. */
+      src_pitch = (sx + w + w % PITCH_PAD) * src_size;
+      dst_pitch = (dx + w + w % PITCH_PAD) * dst_size;
+
+      fill_random(src_buf, sizeof(src_buf));
+      fill_random(ref_buf, sizeof(ref_buf));
+      memcpy(out_buf, ref_buf, sizeof(out_buf));
+
+      ref(src_buf, src_pitch, ref_buf, dst_pitch, sx, sy, dx, dy, w, h);
+      func(src_buf, src_pitch, out_buf, dst_pitch, sx, sy, dx, dy, w, h);
+
+      if (memcmp(ref_buf, out_buf, sizeof(out_buf)) != 0) {
+         printf("FAIL format %d -> %d, width %d\n", src_format, dst_format, w);
+         return false;
+      }
+   }
+
+   return true;
+}
+
+int main(void)
+{
+   int features = _al_get_cpu_features();
+   int failed = 0;
+   unsigned i;
+   int a, b;
+
+   for (i = 0; i < sizeof(isas) / sizeof(isas[0]); i++) {
+      int tested = 0;
+      int isa_failed = 0;
+
+      if ((features & isas[i].features) != isas[i].features)
+         continue;
+
+      for (a = ALLEGRO_PIXEL_FORMAT_ARGB_8888; a < ALLEGRO_NUM_PIXEL_FORMATS; a++) {
+         for (b = ALLEGRO_PIXEL_FORMAT_ARGB_8888; b < ALLEGRO_NUM_PIXEL_FORMATS; b++) {
+            _AL_CONVERT_FUNC ref, func;
+
+            if (a == b)
+               continue;
+            ref = _al_convert_funcs[a][b];
+            func = _al_get_simd_convert_func(a, b, isas[i].features);
+            if (!ref || !func)
+               continue;
+            if (!check(a, b, ref, func))
+               isa_failed++;
+            tested++;
+         }
+      }
+
+      printf("%s %s - %d converters\n", isa_failed ? "FAIL" : "OK  ",
+         isas[i].name, tested);
+      failed += isa_failed;
+   }
+
+   return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/* vim: set sts=3 sw=3 et: */
@@ -1237,6 +1237,10 @@ static bool do_test(ALLEGRO_CONFIG *cfg, char const *testname,
             get_lock_bitmap_flags(V(6)));
          continue;
       }
+      if (SCAN("al_mark_locked_bitmap_rows", 3)) {
+         al_mark_locked_bitmap_rows(B(0), I(1), I(2));
+         continue;
+      }
       if (SCAN("al_unlock_bitmap", 1)) {
          al_unlock_bitmap(B(0));
          lock_region.lr = NULL;
@@ -1763,6 +1767,7 @@ const char* help_str =
 "file, but individual TEST_NAMEs can be specified after each CONFIG_FILE.\n"
 "\n"
 "Options:\n"
+" -c, --config FILE     merge FILE into the system configuration\n"
 " -d, --delay           duration (in sec) to wait between tests\n"
 " --force-d3d           force using D3D (Windows only)\n"
 " --force-opengl-1.2    force using OpenGL 1.2\n"
@@ -1793,10 +1798,6 @@ int main(int _argc, char *_argv[])
    if (!al_init()) {
       fatal_error("failed to initialise Allegro");
    }
-   al_init_image_addon();
-   al_init_font_addon();
-   al_init_ttf_addon();
-   al_init_primitives_addon();
 
    for (; argc > 0; argc--, argv++) {
       char const *opt = argv[0];
@@ -1833,6 +1834,15 @@ int main(int _argc, char *_argv[])
          al_set_config_value(cfg, "opengl", "force_opengl_version", "2.0");
          display_flags |= ALLEGRO_OPENGL;
       }
+      else if ((streq(opt, "-c") || streq(opt, "--config")) && argc > 1) {
+         ALLEGRO_CONFIG *cfg = al_load_config_file(argv[1]);
+         if (!cfg)
+            fatal_error("failed to load config file %s", argv[1]);
+         al_merge_config_into(al_get_system_config(), cfg);
+         al_destroy_config(cfg);
+         argc--;
+         argv++;
+      }
       else if (streq(opt, "--force-opengl")) {
          display_flags |= ALLEGRO_OPENGL;
       }
@@ -1852,6 +1862,12 @@ int main(int _argc, char *_argv[])
       }
    }
 
+   /* After the options, so that the addons see the merged config. */
+   al_init_image_addon();
+   al_init_font_addon();
+   al_init_ttf_addon();
+   al_init_primitives_addon();
+
    if (want_display) {
       al_set_new_display_flags(display_flags);
       display = al_create_display(640, 480);
@@ -0,0 +1,275 @@
+/*
+ *    Plays an impulse followed by a decaying tone through each type of mixer
+ *    effect, and through a chain of all of them, with the null audio driver.
+ *    Checks that the SSE2 code gives the same output as the plain C code,
+ *    and that the effects change the sound at all.
+ */
+
+#define ALLEGRO_UNSTABLE
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <allegro5/allegro.h>
+#include <allegro5/allegro_audio.h>
+#include <allegro5/internal/aintern_cpu.h>
+
+#define FREQUENCY    44100
+#define CHANNELS     2
+/* Long enough for two echoes of the default delay time. */
+#define FRAMES       32768
+#define TIMEOUT_SECS 10.0
+#define TOLERANCE    1e-5f
+
+#define CHAIN        0     /* all effect types at once */
+
+static const struct {
+   ALLEGRO_MIXER_EFFECT_TYPE type;
+   const char *name;
+} types[] = {
+   { ALLEGRO_MIXER_EFFECT_LOWPASS, "lowpass" },
+   { ALLEGRO_MIXER_EFFECT_HIGHPASS, "highpass" },
+   { ALLEGRO_MIXER_EFFECT_PEAKING, "peaking" },
+   { ALLEGRO_MIXER_EFFECT_LOW_SHELF, "low shelf" },
+   { ALLEGRO_MIXER_EFFECT_HIGH_SHELF, "high shelf" },
+   { ALLEGRO_MIXER_EFFECT_COMPRESSOR, "compressor" },
+   { ALLEGRO_MIXER_EFFECT_DELAY, "delay" }
+};
+
+#define NUM_TYPES (int)(sizeof(types) / sizeof(types[0]))
+
+static ALLEGRO_MUTEX *mutex;
+static ALLEGRO_COND *cond;
+static float *capture;
+static int captured;
+
+static void voice_callback(ALLEGRO_VOICE *voice, const void *buf,
+   unsigned int samples, void *data)
+{
+   const float *in = buf;
+   unsigned int i = 0;
+   (void)voice;
+   (void)data;
+
+   al_lock_mutex(mutex);
+
+   /* The voice plays silence until the mixer is attached, and the impulse
+    * is never silent.
+    */
+   if (captured == 0) {
+      while (i < samples && in[i * CHANNELS] == 0.0f)
+         i++;
+   }
+
+   for (; i < samples && captured < FRAMES; i++, captured++) {
+      capture[captured * CHANNELS] = in[i * CHANNELS];
+      capture[captured * CHANNELS + 1] = in[i * CHANNELS + 1];
+   }
+
+   if (captured == FRAMES)
+      al_broadcast_cond(cond);
+   al_unlock_mutex(mutex);
+}
+
+static ALLEGRO_SAMPLE *create_input(void)
+{
+   float *buf = calloc(FRAMES * CHANNELS, sizeof(float));
+   int i;
+
+   buf[0] = 1.0f;
+   buf[1] = -0.5f;
+   for (i = 1; i < FRAMES / 2; i++) {
+      double t = (double)i / FREQUENCY;
+      double env = 0.8 * exp(-t * 6.0);
+      buf[i * CHANNELS] = env * sin(2.0 * ALLEGRO_PI * 440.0 * t);
+      buf[i * CHANNELS + 1] = env * 0.5 * cos(2.0 * ALLEGRO_PI * 660.0 * t);
+   }
+
+   return al_create_sample(buf, FRAMES, FREQUENCY, ALLEGRO_AUDIO_DEPTH_FLOAT32,
+      ALLEGRO_CHANNEL_CONF_2, true);
+}
+
+static ALLEGRO_MIXER_EFFECT *create_effect(ALLEGRO_MIXER_EFFECT_TYPE type)
+{
+   ALLEGRO_MIXER_EFFECT *effect = al_create_mixer_effect(type);
+
+   switch (type) {
+      case ALLEGRO_MIXER_EFFECT_LOWPASS:
+         al_set_mixer_effect_param(effect, ALLEGRO_MIXER_EFFECT_FREQUENCY, 2000);
+         break;
+      case ALLEGRO_MIXER_EFFECT_HIGHPASS:
+         al_set_mixer_effect_param(effect, ALLEGRO_MIXER_EFFECT_FREQUENCY, 500);
+         break;
+      case ALLEGRO_MIXER_EFFECT_PEAKING:
+         al_set_mixer_effect_param(effect, ALLEGRO_MIXER_EFFECT_Q, 2);
+         al_set_mixer_effect_param(effect, ALLEGRO_MIXER_EFFECT_GAIN, 6);
+         break;
+      case ALLEGRO_MIXER_EFFECT_LOW_SHELF:
+         al_set_mixer_effect_param(effect, ALLEGRO_MIXER_EFFECT_FREQUENCY, 300);
+         al_set_mixer_effect_param(effect, ALLEGRO_MIXER_EFFECT_GAIN, -6);
+         break;
+      case ALLEGRO_MIXER_EFFECT_HIGH_SHELF:
+         al_set_mixer_effect_param(effect, ALLEGRO_MIXER_EFFECT_FREQUENCY, 3000);
+         al_set_mixer_effect_param(effect, ALLEGRO_MIXER_EFFECT_GAIN, 6);
+         break;
+      case ALLEGRO_MIXER_EFFECT_COMPRESSOR:
+         al_set_mixer_effect_param(effect, ALLEGRO_MIXER_EFFECT_THRESHOLD, -20);
+         al_set_mixer_effect_param(effect, ALLEGRO_MIXER_EFFECT_RATIO, 8);
+         al_set_mixer_effect_param(effect, ALLEGRO_MIXER_EFFECT_GAIN, 3);
+         break;
+      case ALLEGRO_MIXER_EFFECT_DELAY:
+         al_set_mixer_effect_param(effect, ALLEGRO_MIXER_EFFECT_FEEDBACK, 0.5);
+         break;
+   }
+
+   return effect;
+}
+
+/* Plays the input through the effect, or all of them for CHAIN, or none for
+ * -1, into out.
+ */
+static bool play(ALLEGRO_SAMPLE *input, int type, float *out)
+{
+   ALLEGRO_MIXER_EFFECT *effects[NUM_TYPES];
+   int num_effects = 0;
+   ALLEGRO_VOICE *voice;
+   ALLEGRO_MIXER *mixer;
+   ALLEGRO_SAMPLE_INSTANCE *instance;
+   ALLEGRO_TIMEOUT timeout;
+   bool ok = true;
+   int i;
+
+   voice = al_create_voice(FREQUENCY, ALLEGRO_AUDIO_DEPTH_FLOAT32,
+      ALLEGRO_CHANNEL_CONF_2);
+   mixer = al_create_mixer(FREQUENCY, ALLEGRO_AUDIO_DEPTH_FLOAT32,
+      ALLEGRO_CHANNEL_CONF_2);
+   instance = al_create_sample_instance(input);
+   if (!voice || !mixer || !instance)
+      return false;
+
+   for (i = 0; i < NUM_TYPES; i++) {
+      if (type == CHAIN || type == (int)types[i].type) {
+         effects[num_effects] = create_effect(types[i].type);
+         if (!al_attach_mixer_effect(mixer, effects[num_effects]))
+            ok = false;
+         num_effects++;
+      }
+   }
+
+   capture = out;
+   captured = 0;
+   al_set_null_voice_callback(voice, voice_callback, NULL);
+   al_attach_sample_instance_to_mixer(instance, mixer);
+   al_play_sample_instance(instance);
+   al_attach_mixer_to_voice(mixer, voice);
+
+   al_init_timeout(&timeout, TIMEOUT_SECS);
+   al_lock_mutex(mutex);
+   while (captured < FRAMES) {
+      if (al_wait_cond_until(cond, mutex, &timeout) == -1) {
+         ok = captured == FRAMES;
+         break;
+      }
+   }
+   al_unlock_mutex(mutex);
+
+   al_destroy_voice(voice);
+   al_destroy_sample_instance(instance);
+   al_destroy_mixer(mixer);
+   for (i = 0; i < num_effects; i++)
+      al_destroy_mixer_effect(effects[i]);
+
+   return ok;
+}
+
+static float max_difference(const float *a, const float *b)
+{
+   float max = 0.0f;
+   int i;
+
+   for (i = 0; i < FRAMES * CHANNELS; i++) {
+      float d = fabsf(a[i] - b[i]);
+      /* Also catches NaN. */
+      if (!(d <= max))
+         max = isnan(d) ? INFINITY : d;
+   }
+   return max;
+}
+
+static bool test_effect(ALLEGRO_SAMPLE *input, int type, const char *name,
+   const float *dry, int simd)
+{
+   float *c_out = calloc(FRAMES * CHANNELS, sizeof(float));
+   float *simd_out = calloc(FRAMES * CHANNELS, sizeof(float));
+   float simd_diff, wet_diff;
+   bool played, failed;
+
+   _al_mask_cpu_features(0);
+   played = play(input, type, c_out);
+   _al_mask_cpu_features(~0);
+   played = play(input, type, simd_out) && played;
+
+   simd_diff = max_difference(c_out, simd_out);
+   wet_diff = max_difference(c_out, dry);
+   failed = !played || !(simd_diff <= TOLERANCE) || wet_diff < 1e-3f;
+
+   printf("%s %s: %s, C and %s differ by %g, %g from the dry sound\n",
+      failed ? "FAIL" : "OK  ", name, played ? "played" : "timed out",
+      simd ? "SSE2" : "C", simd_diff, wet_diff);
+
+   free(c_out);
+   free(simd_out);
+   return !failed;
+}
+
+int main(void)
+{
+   ALLEGRO_CONFIG *config;
+   ALLEGRO_SAMPLE *input;
+   float *dry;
+   bool ok = true;
+   int simd;
+   int i;
+
+   if (!al_init()) {
+      printf("FAIL could not init Allegro\n");
+      return EXIT_FAILURE;
+   }
+
+   config = al_get_system_config();
+   al_set_config_value(config, "audio", "driver", "null");
+   al_set_config_value(config, "null", "speed", "0");
+   al_set_config_value(config, "null", "buffer_size", "1000");
+
+   if (!al_install_audio()) {
+      printf("FAIL could not install the null audio driver\n");
+      return EXIT_FAILURE;
+   }
+
+   mutex = al_create_mutex();
+   cond = al_create_cond();
+   input = create_input();
+   simd = _al_get_cpu_features() & _AL_CPU_SSE2;
+
+   dry = calloc(FRAMES * CHANNELS, sizeof(float));
+   if (!play(input, -1, dry)) {
+      printf("FAIL could not play the input\n");
+      return EXIT_FAILURE;
+   }
+
+   for (i = 0; i < NUM_TYPES; i++) {
+      if (!test_effect(input, types[i].type, types[i].name, dry, simd))
+         ok = false;
+   }
+   if (!test_effect(input, CHAIN, "chain", dry, simd))
+      ok = false;
+
+   free(dry);
+   al_destroy_sample(input);
+   al_uninstall_audio();
+   al_destroy_cond(cond);
+   al_destroy_mutex(mutex);
+
+   return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* vim: set sts=3 sw=3 et: */
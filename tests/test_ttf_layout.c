@@ -0,0 +1,149 @@
+/*
+ *    Checks that text layouts draw the same as al_draw_ustr, also after the
+ *    glyph pages they use were evicted from the font's cache.
+ *
+ *    Run from the tests directory of the build, or pass the font file.
+ */
+
+#define ALLEGRO_UNSTABLE
+#include <stdio.h>
+#include <stdlib.h>
+#include <allegro5/allegro.h>
+#include <allegro5/allegro_font.h>
+#include <allegro5/allegro_ttf.h>
+
+#include "ttf_common.c"
+
+#define WIDTH     640
+
+static const char *texts[] = {
+   "",
+   " ",
+   "Hamburgefonstiv 0123456789",
+   "AVATAR Type Wave LTA Yo Te",
+   "Caf\xc3\xa9 cr\xc3\xa8me br\xc3\xbbl\xc3\xa9" "e, na\xc3\xafve fa\xc3\xa7" "ade",
+   "\xce\x91\xce\xb8\xce\xae\xce\xbd\xce\xb1 \xd0\x9c\xd0\xbe\xd1\x81\xd0\xba\xd0\xb2\xd0\xb0"
+};
+
+#define NUM_TEXTS (int)(sizeof(texts) / sizeof(texts[0]))
+
+static const int aligns[] = {
+   ALLEGRO_ALIGN_LEFT, ALLEGRO_ALIGN_CENTRE, ALLEGRO_ALIGN_RIGHT
+};
+
+#define NUM_ALIGNS (int)(sizeof(aligns) / sizeof(aligns[0]))
+
+static ALLEGRO_BITMAP *target;
+
+static uint64_t draw_ustr(ALLEGRO_FONT *font, const char *text, int flags)
+{
+   ALLEGRO_USTR_INFO info;
+
+   al_set_target_bitmap(target);
+   al_clear_to_color(al_map_rgba(0, 0, 0, 0));
+   al_draw_ustr(font, al_map_rgb(255, 255, 255), WIDTH / 2, 4, flags,
+      al_ref_cstr(&info, text));
+   return hash_bitmap(target);
+}
+
+static uint64_t draw_layout(ALLEGRO_TTF_TEXT_LAYOUT *layout, int flags)
+{
+   al_set_target_bitmap(target);
+   al_clear_to_color(al_map_rgba(0, 0, 0, 0));
+   al_draw_ttf_text_layout(layout, al_map_rgb(255, 255, 255), WIDTH / 2, 4,
+      flags);
+   return hash_bitmap(target);
+}
+
+static bool test_texts(ALLEGRO_FONT *font, const char *what)
+{
+   ALLEGRO_TTF_TEXT_LAYOUT *layouts[NUM_TEXTS];
+   ALLEGRO_TTF_CACHE_STATS before, after;
+   int wrong = 0;
+   int wrong_width = 0;
+   bool failed;
+   int i, j;
+
+   for (i = 0; i < NUM_TEXTS; i++) {
+      ALLEGRO_USTR_INFO info;
+      const ALLEGRO_USTR *text = al_ref_cstr(&info, texts[i]);
+      layouts[i] = al_create_ttf_text_layout(font, text);
+      if (!layouts[i]) {
+         printf("FAIL could not create a layout\n");
+         return false;
+      }
+      if (al_get_ttf_text_layout_width(layouts[i]) !=
+            al_get_ustr_width(font, text))
+         wrong_width++;
+   }
+
+   /* Lay out everything first, so the pages get evicted in between. */
+   al_get_ttf_cache_stats(font, &before);
+   for (j = 0; j < 2; j++) {
+      for (i = 0; i < NUM_TEXTS; i++) {
+         int k;
+         for (k = 0; k < NUM_ALIGNS; k++) {
+            if (draw_layout(layouts[i], aligns[k]) !=
+                  draw_ustr(font, texts[i], aligns[k]))
+               wrong++;
+         }
+      }
+      cache_all_glyphs(font);
+   }
+   al_get_ttf_cache_stats(font, &after);
+
+   for (i = 0; i < NUM_TEXTS; i++)
+      al_destroy_ttf_text_layout(layouts[i]);
+
+   failed = wrong > 0 || wrong_width > 0;
+   printf("%s %s: %d of %d draws differ, %d widths differ, "
+      "%u pages evicted\n",
+      failed ? "FAIL" : "OK  ", what, wrong, 2 * NUM_TEXTS * NUM_ALIGNS,
+      wrong_width, after.evicted_pages - before.evicted_pages);
+
+   return !failed;
+}
+
+int main(int argc, char **argv)
+{
+   const char *filename = "../examples/data/DejaVuSans.ttf";
+   /* The small one makes caching all glyphs evict every page. */
+   static const int cache_sizes[] = { 0, 512 };
+   bool ok = true;
+   int i;
+
+   if (argc > 1)
+      filename = argv[1];
+
+   if (!al_init() || !al_init_font_addon() || !al_init_ttf_addon()) {
+      printf("FAIL could not init Allegro\n");
+      return EXIT_FAILURE;
+   }
+
+   al_set_new_bitmap_flags(ALLEGRO_MEMORY_BITMAP);
+
+   for (i = 0; i < (int)(sizeof(cache_sizes) / sizeof(cache_sizes[0])); i++) {
+      char what[32];
+      ALLEGRO_FONT *font = al_load_ttf_font(filename, 20, 0);
+      if (!font) {
+         printf("FAIL could not load %s\n", filename);
+         return EXIT_FAILURE;
+      }
+      al_set_ttf_cache_size(font, cache_sizes[i] * 1024);
+      target = al_create_bitmap(WIDTH, al_get_font_line_height(font) + 8);
+
+      if (cache_sizes[i])
+         sprintf(what, "%d kB cache", cache_sizes[i]);
+      else
+         sprintf(what, "unbounded cache");
+      if (!test_texts(font, what))
+         ok = false;
+
+      al_destroy_bitmap(target);
+      al_destroy_font(font);
+   }
+
+   return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* vim: set sts=3 sw=3 et: */
@@ -0,0 +1,181 @@
+/*
+ *    Caches every glyph of a TTF font at a few sizes and reports how much
+ *    of the glyph pages the glyphs cover.  Also checks that no two glyphs
+ *    overlap and that text still draws the same afterwards.
+ *
+ *    Run from the tests directory of the build, or pass the font file.
+ */
+
+#define ALLEGRO_UNSTABLE
+#include <stdio.h>
+#include <stdlib.h>
+#include <allegro5/allegro.h>
+#include <allegro5/allegro_font.h>
+#include <allegro5/allegro_ttf.h>
+
+#include "ttf_common.c"
+
+/* How much of the pages the glyphs must cover, counting them with their
+ * 1 pixel border and rounded up to 4 pixels as the packer places them.
+ */
+#define MIN_FILL_RATIO  0.8
+
+typedef struct RECT {
+   ALLEGRO_BITMAP *bitmap;
+   int x1, y1, x2, y2;
+} RECT;
+
+static const char *probe = "Hamburgefonstiv 0123456789 \xc3\xa5\xc3\xa9\xc3\xb1";
+
+static uint64_t draw_probe(ALLEGRO_FONT *font)
+{
+   ALLEGRO_BITMAP *bmp;
+   uint64_t hash;
+   int w = al_get_text_width(font, probe) + 8;
+   int h = al_get_font_line_height(font);
+
+   bmp = al_create_bitmap(w, h);
+   al_set_target_bitmap(bmp);
+   al_clear_to_color(al_map_rgba(0, 0, 0, 0));
+   al_draw_text(font, al_map_rgb(255, 255, 255), 4, 0, 0, probe);
+
+   hash = hash_bitmap(bmp);
+   al_destroy_bitmap(bmp);
+
+   return hash;
+}
+
+static int compare_rects(const void *a, const void *b)
+{
+   const RECT *ra = a;
+   const RECT *rb = b;
+
+   if (ra->bitmap != rb->bitmap)
+      return ra->bitmap < rb->bitmap ? -1 : 1;
+   return ra->x1 - rb->x1;
+}
+
+/* Gets the rectangle of every cached glyph, including its border, and
+ * returns how many of them overlap another one or the page edge.
+ */
+static int count_overlaps(ALLEGRO_FONT *font, int *ranges, int num_ranges)
+{
+   RECT *rects;
+   int count = 0;
+   int bad = 0;
+   int i, j;
+
+   for (i = 0; i < num_ranges; i++)
+      count += ranges[i * 2 + 1] - ranges[i * 2] + 1;
+   rects = calloc(count, sizeof(*rects));
+
+   count = 0;
+   for (i = 0; i < num_ranges; i++) {
+      int ch;
+      for (ch = ranges[i * 2]; ch <= ranges[i * 2 + 1]; ch++) {
+         ALLEGRO_GLYPH g;
+         if (!al_get_glyph(font, -1, ch, &g) || !g.bitmap)
+            continue;
+         rects[count].bitmap = g.bitmap;
+         rects[count].x1 = g.x - 1;
+         rects[count].y1 = g.y - 1;
+         rects[count].x2 = g.x + g.w + 1;
+         rects[count].y2 = g.y + g.h + 1;
+         count++;
+      }
+   }
+
+   qsort(rects, count, sizeof(*rects), compare_rects);
+
+   for (i = 0; i < count; i++) {
+      RECT *a = &rects[i];
+      if (a->x1 < 0 || a->y1 < 0 || a->x2 > al_get_bitmap_width(a->bitmap) ||
+            a->y2 > al_get_bitmap_height(a->bitmap)) {
+         bad++;
+         continue;
+      }
+      for (j = i + 1; j < count; j++) {
+         RECT *b = &rects[j];
+         if (b->bitmap != a->bitmap || b->x1 >= a->x2)
+            break;
+         /* The same glyph may be used for several code points. */
+         if (b->x1 == a->x1 && b->y1 == a->y1)
+            continue;
+         if (b->y1 < a->y2 && a->y1 < b->y2) {
+            bad++;
+            break;
+         }
+      }
+   }
+
+   free(rects);
+   return bad;
+}
+
+static bool test_size(const char *filename, int size)
+{
+   ALLEGRO_FONT *font;
+   ALLEGRO_TTF_CACHE_STATS stats;
+   int *ranges;
+   int num_ranges;
+   uint64_t before, after;
+   double fill;
+   int overlaps;
+   bool failed;
+
+   font = al_load_ttf_font(filename, size, 0);
+   if (!font) {
+      printf("FAIL could not load %s\n", filename);
+      return false;
+   }
+
+   before = draw_probe(font);
+
+   cache_all_glyphs(font);
+
+   num_ranges = al_get_font_ranges(font, 0, NULL);
+   ranges = calloc(num_ranges * 2, sizeof(int));
+   al_get_font_ranges(font, num_ranges, ranges);
+
+   al_get_ttf_cache_stats(font, &stats);
+   overlaps = count_overlaps(font, ranges, num_ranges);
+   after = draw_probe(font);
+
+   fill = (double)stats.used / stats.size;
+
+   failed = overlaps > 0 || before != after || fill < MIN_FILL_RATIO;
+   printf("%s size %2d: %u glyphs on %u pages, %u kB, %.1f%% full, "
+      "%d overlapping%s\n",
+      failed ? "FAIL" : "OK  ", size, (unsigned)stats.misses, stats.pages,
+      (unsigned)(stats.size / 1024), fill * 100.0,
+      overlaps, before != after ? ", text changed" : "");
+
+   free(ranges);
+   al_destroy_font(font);
+   return !failed;
+}
+
+int main(int argc, char **argv)
+{
+   const char *filename = "../examples/data/DejaVuSans.ttf";
+   static const int sizes[] = { 12, 24, 48 };
+   bool ok = true;
+   int i;
+
+   if (argc > 1)
+      filename = argv[1];
+
+   if (!al_init() || !al_init_font_addon() || !al_init_ttf_addon()) {
+      printf("FAIL could not init Allegro\n");
+      return EXIT_FAILURE;
+   }
+
+   for (i = 0; i < (int)(sizeof(sizes) / sizeof(sizes[0])); i++) {
+      if (!test_size(filename, sizes[i]))
+         ok = false;
+   }
+
+   return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* vim: set sts=3 sw=3 et: */
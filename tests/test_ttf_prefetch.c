@@ -0,0 +1,154 @@
+/*
+ *    Checks that text draws the same with prefetched glyphs as without,
+ *    both while the glyphs are still being rendered and once they are all
+ *    done, with and without the skip_cache_misses option.
+ *
+ *    Run from the tests directory of the build, or pass the font file.
+ */
+
+#define ALLEGRO_UNSTABLE
+#include <stdio.h>
+#include <stdlib.h>
+#include <allegro5/allegro.h>
+#include <allegro5/allegro_font.h>
+#include <allegro5/allegro_ttf.h>
+
+#define TTF_COMMON_NO_CACHE_ALL_GLYPHS
+#include "ttf_common.c"
+
+#define WIDTH        640
+#define TIMEOUT_SECS 30.0
+
+static const char *texts[] = {
+   "Hamburgefonstiv 0123456789",
+   "AVATAR Type Wave LTA Yo Te",
+   "Caf\xc3\xa9 cr\xc3\xa8me br\xc3\xbbl\xc3\xa9" "e, na\xc3\xafve fa\xc3\xa7" "ade",
+   "\xce\x91\xce\xb8\xce\xae\xce\xbd\xce\xb1 \xd0\x9c\xd0\xbe\xd1\x81\xd0\xba\xd0\xb2\xd0\xb0"
+};
+
+#define NUM_TEXTS (int)(sizeof(texts) / sizeof(texts[0]))
+
+static ALLEGRO_BITMAP *target;
+
+static uint64_t draw_text(ALLEGRO_FONT *font, const char *text)
+{
+   ALLEGRO_USTR_INFO info;
+
+   al_set_target_bitmap(target);
+   al_clear_to_color(al_map_rgba(0, 0, 0, 0));
+   al_draw_ustr(font, al_map_rgb(255, 255, 255), 4, 4, 0,
+      al_ref_cstr(&info, text));
+   return hash_bitmap(target);
+}
+
+static ALLEGRO_FONT *load_font(const char *filename, bool skip_cache_misses)
+{
+   al_set_config_value(al_get_system_config(), "ttf", "skip_cache_misses",
+      skip_cache_misses ? "true" : "false");
+   return al_load_ttf_font(filename, 20, 0);
+}
+
+static bool test_prefetch(const char *filename, bool skip_cache_misses,
+   const uint64_t *expected)
+{
+   const char *what = skip_cache_misses ? "skip_cache_misses" : "default";
+   ALLEGRO_FONT *font = load_font(filename, skip_cache_misses);
+   double start;
+   int wrong_pending = 0;
+   int draws_pending = 0;
+   int wrong = 0;
+   bool timed_out = false;
+   bool failed;
+   int i;
+
+   if (!font) {
+      printf("FAIL could not load %s\n", filename);
+      return false;
+   }
+
+   /* Glyphs requested last are rendered first, so the range keeps the
+    * glyphs of the texts pending for a while.
+    */
+   for (i = 0; i < NUM_TEXTS; i++) {
+      ALLEGRO_USTR_INFO info;
+      if (!al_prefetch_ttf_glyphs(font, al_ref_cstr(&info, texts[i]))) {
+         printf("FAIL %s: could not prefetch\n", what);
+         al_destroy_font(font);
+         return false;
+      }
+   }
+   al_prefetch_ttf_glyph_range(font, 0x20, 0x24ff);
+
+   /* Without skip_cache_misses, glyphs which have not arrived yet are
+    * rendered right away, so the text must always look the same.  With it,
+    * they are left out until they arrive.
+    */
+   start = al_get_time();
+   while (al_get_ttf_pending_glyphs(font) > 0) {
+      if (al_get_time() - start > TIMEOUT_SECS) {
+         timed_out = true;
+         break;
+      }
+      for (i = 0; i < NUM_TEXTS; i++) {
+         if (draw_text(font, texts[i]) != expected[i] && !skip_cache_misses)
+            wrong_pending++;
+         draws_pending++;
+      }
+   }
+
+   /* The next draw puts the last glyphs on the pages. */
+   for (i = 0; i < NUM_TEXTS; i++) {
+      if (draw_text(font, texts[i]) != expected[i])
+         wrong++;
+   }
+
+   al_destroy_font(font);
+
+   failed = timed_out || wrong > 0 || wrong_pending > 0;
+   printf("%s %s: %d of %d draws differ afterwards, %d of %d while "
+      "pending%s\n",
+      failed ? "FAIL" : "OK  ", what, wrong, NUM_TEXTS, wrong_pending,
+      draws_pending, timed_out ? ", timed out" : "");
+
+   return !failed;
+}
+
+int main(int argc, char **argv)
+{
+   const char *filename = "../examples/data/DejaVuSans.ttf";
+   uint64_t expected[NUM_TEXTS];
+   ALLEGRO_FONT *font;
+   bool ok = true;
+   int i;
+
+   if (argc > 1)
+      filename = argv[1];
+
+   if (!al_init() || !al_init_font_addon() || !al_init_ttf_addon()) {
+      printf("FAIL could not init Allegro\n");
+      return EXIT_FAILURE;
+   }
+
+   al_set_new_bitmap_flags(ALLEGRO_MEMORY_BITMAP);
+
+   font = load_font(filename, false);
+   if (!font) {
+      printf("FAIL could not load %s\n", filename);
+      return EXIT_FAILURE;
+   }
+   target = al_create_bitmap(WIDTH, al_get_font_line_height(font) + 8);
+   for (i = 0; i < NUM_TEXTS; i++)
+      expected[i] = draw_text(font, texts[i]);
+   al_destroy_font(font);
+
+   if (!test_prefetch(filename, false, expected))
+      ok = false;
+   if (!test_prefetch(filename, true, expected))
+      ok = false;
+
+   al_destroy_bitmap(target);
+
+   return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* vim: set sts=3 sw=3 et: */
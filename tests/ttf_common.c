@@ -0,0 +1,45 @@
+/*
+ *    Helpers shared by the TTF tests, included directly by each of them.
+ */
+
+/* Returns the FNV-1a hash of the bitmap's pixels as ABGR_8888. */
+static uint64_t hash_bitmap(ALLEGRO_BITMAP *bmp)
+{
+   ALLEGRO_LOCKED_REGION *lr;
+   uint64_t hash = 14695981039346656037ULL;
+   int w = al_get_bitmap_width(bmp);
+   int h = al_get_bitmap_height(bmp);
+   int x, y;
+
+   lr = al_lock_bitmap(bmp, ALLEGRO_PIXEL_FORMAT_ABGR_8888,
+      ALLEGRO_LOCK_READONLY);
+   for (y = 0; y < h; y++) {
+      const unsigned char *p = (const unsigned char *)lr->data + y * lr->pitch;
+      for (x = 0; x < w * 4; x++)
+         hash = (hash ^ p[x]) * 1099511628211ULL;
+   }
+   al_unlock_bitmap(bmp);
+
+   return hash;
+}
+
+#ifndef TTF_COMMON_NO_CACHE_ALL_GLYPHS
+/* Caches every glyph of the font, evicting pages once the cache is full. */
+static void cache_all_glyphs(ALLEGRO_FONT *font)
+{
+   int num_ranges = al_get_font_ranges(font, 0, NULL);
+   int *ranges = calloc(num_ranges * 2, sizeof(int));
+   int i, ch;
+
+   al_get_font_ranges(font, num_ranges, ranges);
+   for (i = 0; i < num_ranges; i++) {
+      for (ch = ranges[i * 2]; ch <= ranges[i * 2 + 1]; ch++) {
+         ALLEGRO_GLYPH g;
+         al_get_glyph(font, -1, ch, &g);
+      }
+   }
+   free(ranges);
+}
+#endif
+
+/* vim: set sts=3 sw=3 et: */